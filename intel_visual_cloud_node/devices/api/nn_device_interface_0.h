@@ -101,6 +101,14 @@ From creation to execution:
     User pushes <workload> execution request through the device interface, passing sets of input
     and output buffers along with the <workload> pointer. Execution is done asynchronously.
     User specifies condition variable to be updated with value of execution status.
+    Status is set to NN_API_WORK_IN_PROGRESS when request is queued, and to NN_API_WORK_FINISHED
+    (or error code) when it is done. Input & output buffers must stay valid until then.
+    Batch of execution is taken from batch dimension of inputs & outputs. It can be anything
+    from 1 up to batch <workload> was compiled for, so one <workload> serves requests of varying size.
+
+[wait for workload]
+    User blocks until execution request (identified by its status variable) or all requests
+    pushed for <workload> are finished. Until then host thread is free to prepare next inputs.
 
 */
 
@@ -190,13 +198,44 @@ typedef enum {
 } NN_NORMALIZATION_MODE;
 
 
-/* parameters for parameter_get_function
-   Current unused. */
+/* parameters for parameter_get_function & parameter_set_function
+   Support for specific parameters is device specific. */
 typedef enum {
     NN_PARAMETER_ = 0,
-    NN_PARAMETER_LAST = NN_PARAMETER_
+    NN_PARAMETER_CPU_THREAD_PLACEMENT,          /* NN_CPU_THREAD_PLACEMENT [uint32_t], pinning of CPU device threads */
+    NN_PARAMETER_CPU_TUNING_DATABASE,           /* [char[]] path of CPU kernel tuning database, empty string disables autotuning */
+    NN_PARAMETER_CPU_THREAD_COUNT,              /* [uint32_t] number of CPU device threads, including thread calling execute */
+    NN_PARAMETER_CPU_PROFILING,                 /* [uint32_t] 1 - record timings of executed work items, 0 - stop recording */
+    NN_PARAMETER_CPU_PROFILING_TRACE,           /* [char[]] (set only) path of file recorded timings are written to as Chrome trace; clears them */
+    NN_PARAMETER_CPU_PROFILING_COUNTERS,        /* [uint32_t] 1 - add hardware performance counters to recorded work items, 0 - timings only;
+                                                   setting 1 fails with NN_API_STATUS_ERROR_OTHER where counters are not available */
+    NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE,     /* [float] error of convolution outputs, relative to their largest magnitude, accepted from
+                                                   faster algorithms (Winograd) in workflows compiled afterwards; 0 (default) - direct only */
+    NN_PARAMETER_CPU_ISA,                       /* NN_CPU_ISA [uint32_t], instruction set of CPU kernels; best one supported by host is
+                                                   selected at device load, setting one the host does not support fails */
+    NN_PARAMETER_CPU_METRICS_BATCHES,           /* [uint32_t[]] batch sizes of variants reported by workflow metrics query, ended by 0 or
+                                                   end of buffer; empty list (default) - 1, thread count & 8 images per thread */
+    NN_PARAMETER_LAST = NN_PARAMETER_CPU_METRICS_BATCHES
 } NN_PARAMETER;
 
+/* placement of CPU device worker threads
+   With any mode other than NONE worker threads are pinned to logical processors and buffers
+   of workloads compiled afterwards are placed on NUMA nodes of those processors. */
+typedef enum {
+    NN_CPU_THREAD_PLACEMENT_NONE = 0,           /* threads are scheduled by operating system */
+    NN_CPU_THREAD_PLACEMENT_COMPACT,            /* fill physical cores of one socket first, then hyperthreads, then next socket */
+    NN_CPU_THREAD_PLACEMENT_SCATTER,            /* distribute threads evenly across sockets */
+    NN_CPU_THREAD_PLACEMENT_LAST = NN_CPU_THREAD_PLACEMENT_SCATTER
+} NN_CPU_THREAD_PLACEMENT;
+
+/* instruction sets of CPU device kernels (NN_PARAMETER_CPU_ISA).
+   Kernels without AVX-512 version run their AVX2 version with either setting. */
+typedef enum {
+    NN_CPU_ISA_AVX2 = 0,                        /* AVX2 & FMA, required by CPU device */
+    NN_CPU_ISA_AVX512,                          /* AVX-512 foundation & byte/word instructions */
+    NN_CPU_ISA_LAST = NN_CPU_ISA_AVX512
+} NN_CPU_ISA;
+
 
 /* types of data provided as input/output to/from workflow.
    Enumeration defines data format but not resolution.
@@ -491,7 +530,9 @@ typedef struct nn_workload {
     const uint32_t               output_count;  /* count of outputs in this workload */
     NN_WORKLOAD_DATA_TYPE *const input_format;  /* array containing formats of inputs */
     NN_WORKLOAD_DATA_TYPE *const output_format; /* array containing formats of outputs */
-    const uint32_t               batch;         /* batch size for this workload */
+    const uint32_t               batch;         /* maximum batch size for this workload */
+    const uint64_t               activation_memory; /* planned peak size of intermediate results in bytes (0 if unknown) */
+    const uint64_t               parameter_memory;  /* size of weights & biases owned by workload in bytes (0 if unknown) */
 } nn_workload_t;
 
 
@@ -511,6 +552,7 @@ typedef struct nn_workflow_metrics {
 typedef struct nn_workflow_metrics_array {
     const uint32_t      input_count;    /* count of inputs in this workload */
     const uint32_t      output_count;   /* count of outputs in this workload */
+    const uint32_t      variant_count;  /* count of entries in array */
     nn_workflow_metrics_t **array;      /* array of variant entries */
 } nn_workflow_metrics_array_t;
 
@@ -609,6 +651,31 @@ typedef NN_API_STATUS (NN_API_CALL_CONVENTION *nn_workload_execute_function_t)(
     NN_API_STATUS          *status          /* asynchronous status */
     );
 
+/* waits until execution reporting to status (or every execution of workload if status is NULL) is finished
+   Returns NN_API_STATUS_OK or error that execution failed with. */
+typedef NN_API_STATUS (NN_API_CALL_CONVENTION *nn_workload_wait_function_t)(
+    nn_workload_t          *workload,       /* workload to wait for */
+    NN_API_STATUS          *status          /* status passed to execute function, or NULL */
+    );
+
+/* saves compiled workload (packed parameters & tuning choices) to cache file */
+typedef NN_API_STATUS (NN_API_CALL_CONVENTION *nn_workload_save_function_t)(
+    nn_workload_t          *workload,       /* workload to be saved */
+    const char             *path            /* path of cache file */
+    );
+
+/* creates workload from cache file without repacking parameters & tuning
+   Workflow must have the same structure as the one cached workload was compiled from; only headers of its
+   parameters (sizes) are used. Batch & formats of inputs & outputs are taken from cache.
+   Returns NN_API_STATUS_ERROR_INVALID_WORKFLOW if workflow does not match cache, NN_API_STATUS_ERROR_OTHER
+   if file is not a valid cache. */
+typedef NN_API_STATUS (NN_API_CALL_CONVENTION *nn_workload_load_function_t)(
+    nn_workload_t         **workload,       /* resulting workload */
+    nn_device_t            *device,         /* device context */
+    nn_workflow_t          *workflow,       /* workflow cached workload was compiled from */
+    const char             *path            /* path of cache file */
+    );
+
 /* delete work item */
 typedef NN_API_STATUS (NN_API_CALL_CONVENTION *nn_workflow_item_delete_function_t)(
     nn_workflow_item_t     *work_item       /* work item to be deleted */
@@ -680,4 +747,7 @@ typedef struct nn_device_interface_0_t {
     nn_device_parameter_get_function_t              parameter_get_function;
     nn_device_parameter_set_function_t              parameter_set_function;
     nn_translate_api_status_function_t              translate_api_status_function;
+    nn_workload_wait_function_t                     workload_wait_function;
+    nn_workload_save_function_t                     workload_save_function;
+    nn_workload_load_function_t                     workload_load_function;
 } nn_device_interface_0_t;
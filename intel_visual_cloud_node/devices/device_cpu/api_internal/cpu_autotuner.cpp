@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpu_autotuner.h"
+
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#if defined _MSC_VER
+#   include <intrin.h>
+#else
+#   include <cpuid.h>
+#endif
+
+std::string nn_cpu_model_name()
+{
+    uint32_t registers[12] = {};
+    for (uint32_t leaf = 0; leaf < 3; ++leaf)
+    {
+#if defined _MSC_VER
+        __cpuid(reinterpret_cast<int *>(registers + 4 * leaf), 0x80000002 + leaf);
+#else
+        __get_cpuid(0x80000002 + leaf, registers + 4 * leaf, registers + 4 * leaf + 1, registers + 4 * leaf + 2, registers + 4 * leaf + 3);
+#endif
+    }
+    char brand[sizeof(registers) + 1] = {};
+    std::memcpy(brand, registers, sizeof(registers));
+
+    std::string result;
+    for (auto character : std::string(brand))
+    {
+        if (std::isspace(static_cast<unsigned char>(character)))
+        {
+            if (!result.empty() && result.back() != '_') result.push_back('_');
+        }
+        else
+            result.push_back(character);
+    }
+    while (!result.empty() && result.back() == '_') result.pop_back();
+    return result.empty() ? std::string("unknown_cpu") : result;
+}
+
+std::vector<nn_cpu_tuning_t> nn_cpu_job_count_candidates(uint32_t num_threads, uint32_t default_count)
+{
+    std::vector<nn_cpu_tuning_t> candidates(1, nn_cpu_tuning_t{0, 0});
+    if (num_threads < 2) return candidates;
+    for (uint32_t count = 1; count < num_threads; count *= 2)
+        if (count != default_count) candidates.push_back(nn_cpu_tuning_t{0, count});
+    if (num_threads != default_count) candidates.push_back(nn_cpu_tuning_t{0, num_threads});
+    return candidates;
+}
+
+void nn_cpu_tuning_database::set_path(const std::string &new_path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    path = new_path;
+    entries.clear();
+    if (path.empty()) return;
+
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        std::string key;
+        nn_cpu_tuning_t tuning;
+        if (fields >> key >> tuning.kernel >> tuning.partition) entries[key] = tuning;
+    }
+}
+
+std::string nn_cpu_tuning_database::get_path()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return path;
+}
+
+bool nn_cpu_tuning_database::enabled()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return !path.empty();
+}
+
+std::string nn_cpu_tuning_database::make_key(const std::string &signature, uint32_t num_threads, NN_CPU_ISA isa)
+{
+    static const std::string model = nn_cpu_model_name();
+    return model + "/threads=" + std::to_string(num_threads) + (isa == NN_CPU_ISA_AVX512 ? "/avx512/" : "/") + signature;
+}
+
+bool nn_cpu_tuning_database::find(const std::string &key, nn_cpu_tuning_t &tuning)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto entry = entries.find(key);
+    if (entry == entries.end()) return false;
+    tuning = entry->second;
+    return true;
+}
+
+void nn_cpu_tuning_database::store(const std::string &key, const nn_cpu_tuning_t &tuning)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (path.empty()) return;
+    entries[key] = tuning;
+
+    std::ofstream file(path, std::ios::trunc);
+    for (auto &entry : entries)
+        file << entry.first << " " << entry.second.kernel << " " << entry.second.partition << "\n";
+}
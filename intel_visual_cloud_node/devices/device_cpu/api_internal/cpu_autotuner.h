@@ -0,0 +1,101 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "../../api/nn_device_interface_0.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* This file contains autotuner of CPU device primitives.
+
+Primitives that can run in more than one way (different kernels, different split of work into jobs)
+derive from nn_cpu_tunable and list candidate execution parameters. When tuning database is set on device
+(NN_PARAMETER_CPU_TUNING_DATABASE), workflow compilation times all candidates of every tunable work item
+on buffers of compiled workload and keeps the fastest one.
+
+Choices are stored in a text file, one per line: "<key> <kernel> <partition>". Key consists of CPU model,
+number of device threads, instruction set of kernels (when it is not AVX2) and layer signature, so later compilations of the same layer on the same machine
+reuse stored choice without timing.
+*/
+
+// Execution parameters of primitive; meaning of fields is specific to primitive, zero selects its default.
+struct nn_cpu_tuning_t
+{
+    uint32_t kernel;        // kernel variant
+    uint32_t partition;     // split of work into jobs
+};
+
+// Base of primitives that can be tuned.
+class nn_cpu_tunable
+{
+public:
+    nn_cpu_tunable() : tuning() {}
+
+    // Candidates to be timed; first one is the default.
+    virtual std::vector<nn_cpu_tuning_t> get_tuning_candidates() = 0;
+
+    // Description of all layer parameters that influence choice.
+    virtual std::string get_tuning_signature() = 0;
+
+    nn_cpu_tuning_t tuning;
+
+protected:
+    ~nn_cpu_tunable() {}
+};
+
+class nn_cpu_tuning_database
+{
+public:
+    // Sets file choices are read from & written to and loads its contents; empty path disables autotuning.
+    void set_path(const std::string &path);
+    std::string get_path();
+    bool enabled();
+
+    // Key identifying tuned layer on this machine.
+    static std::string make_key(const std::string &signature, uint32_t num_threads, NN_CPU_ISA isa);
+
+    bool find(const std::string &key, nn_cpu_tuning_t &tuning);
+
+    // Adds choice and rewrites the file.
+    void store(const std::string &key, const nn_cpu_tuning_t &tuning);
+
+private:
+    std::mutex mutex;
+    std::string path;
+    std::map<std::string, nn_cpu_tuning_t> entries;
+};
+
+// Candidates of primitives tuned by number of jobs only: default first, then powers of two & all threads.
+std::vector<nn_cpu_tuning_t> nn_cpu_job_count_candidates(uint32_t num_threads, uint32_t default_count);
+
+// Processor name from CPUID brand string, with whitespace replaced by underscores.
+std::string nn_cpu_model_name();
@@ -0,0 +1,320 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpu_cost_model.h"
+#include "cpu_device_internal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+#include <immintrin.h>
+
+namespace
+{
+    // Power per busy thread assumed when package energy counters cannot be read.
+    const double C_nominal_thread_power_w = 5.0;
+
+    // Images per thread of largest default metrics variant - enough to amortize weight reads & job overhead.
+    const uint32_t C_metrics_images_per_thread = 8;
+
+    uint64_t output_size(const nn_workflow_item_t* item)
+    {
+        const auto& format = item->output_format;
+        uint64_t size = format.format_1d.size[0];
+        if (format.format >= NN_DATA_FORMAT_2D) size *= format.format_2d.size[1];
+        if (format.format >= NN_DATA_FORMAT_3D) size *= format.format_3d.size[2];
+        return size;
+    }
+
+    uint64_t data_size(const nn_data_t* data)
+    {
+        if (!data) return 0;
+        uint64_t size = 1;
+        for (uint8_t dimension = 0; dimension < data->dimension; ++dimension)
+            size *= data->size[dimension];
+        return size;
+    }
+
+    uint64_t data_bytes(const nn_data_t* data)
+    {
+        return data ? data_size(data) * data->sizeof_value : 0;
+    }
+
+    bool is_fixedpoint(NN_WORK_ITEM_TYPE type)
+    {
+        switch (type)
+        {
+        case NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT:
+        case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT:
+        case NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT:
+        case NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN:
+        case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN:
+        case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN:
+        case NN_WORK_ITEM_TYPE_SOFTMAX_FIXEDPOINT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Convolution: each output value is a dot product of weights of single output feature map with input.
+    uint64_t convolution_operations(uint64_t outputs, const nn_data_t* weights, uint32_t output_feature_maps)
+    {
+        return 2 * outputs * data_size(weights) / std::max(output_feature_maps, 1u);
+    }
+
+    template <typename T_function>
+    double measure_best_ns(uint32_t runs, const T_function& function)
+    {
+        double best = 0.0;
+        for (uint32_t run = 0; run < runs; ++run)
+        {
+            auto start = std::chrono::steady_clock::now();
+            function();
+            double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            if (run == 0 || elapsed < best) best = elapsed;
+        }
+        return std::max(best, 1.0);
+    }
+
+    // Sum of energy counters of all packages in microjoules, 0 if they are not available.
+    uint64_t read_package_energy_uj()
+    {
+        uint64_t energy = 0;
+        for (uint32_t package = 0;; ++package)
+        {
+            std::ifstream counter("/sys/class/powercap/intel-rapl:" + std::to_string(package) + "/energy_uj");
+            uint64_t value = 0;
+            if (!(counter >> value)) break;
+            energy += value;
+        }
+        return energy;
+    }
+}
+
+nn_cpu_work_item_cost nn_cpu_work_item_cost_estimate(const nn_workflow_item_t* item, uint32_t batch)
+{
+    const uint64_t value_size = is_fixedpoint(item->type) ? sizeof(int16_t) : sizeof(float);
+    const uint64_t outputs = output_size(item) * batch;
+    uint64_t inputs = 0;
+    for (uint32_t index = 0; index < item->input_count; ++index)
+        inputs += output_size(item->input[index]) * batch;
+    const uint32_t output_feature_maps = item->output_format.format >= NN_DATA_FORMAT_3D ? item->output_format.format_3d.size[2] : 1;
+
+    nn_cpu_work_item_cost cost = {0, (inputs + outputs) * value_size, true};
+    switch (item->type)
+    {
+    case NN_WORK_ITEM_TYPE_INPUT:
+    case NN_WORK_ITEM_TYPE_VIEW:
+    case NN_WORK_ITEM_TYPE_MERGE:
+        // views of other buffers - nothing is computed nor moved
+        cost.bytes = 0;
+        cost.parallel = false;
+        break;
+    case NN_WORK_ITEM_TYPE_OUTPUT:
+        cost.parallel = false;
+        break;
+    case NN_WORK_ITEM_TYPE_CONVOLUTION:
+        cost.operations = convolution_operations(outputs, item->arguments.forward_convolution.weights, output_feature_maps);
+        cost.bytes += data_bytes(item->arguments.forward_convolution.weights) + data_bytes(item->arguments.forward_convolution.biases);
+        break;
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2: {
+        auto& arguments = item->arguments.forward_convolution_pooling_max_2x2_stride_2x2;
+        cost.operations = convolution_operations(outputs * 4, arguments.weights, output_feature_maps) + outputs * 4;
+        cost.bytes += data_bytes(arguments.weights) + data_bytes(arguments.biases);
+        break;
+    }
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT:
+        cost.operations = convolution_operations(outputs, item->arguments.forward_convolution_int16_fixedpoint.weights, output_feature_maps);
+        cost.bytes += data_bytes(item->arguments.forward_convolution_int16_fixedpoint.weights) + data_bytes(item->arguments.forward_convolution_int16_fixedpoint.biases);
+        break;
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT: {
+        auto& arguments = item->arguments.forward_convolution_pooling_fixedpoint;
+        cost.operations = convolution_operations(outputs * 4, arguments.weights, output_feature_maps) + outputs * 4;
+        cost.bytes += data_bytes(arguments.weights) + data_bytes(arguments.biases);
+        break;
+    }
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED:
+        cost.operations = 2 * data_size(item->arguments.forward_fully_connected.weights) * batch;
+        cost.bytes += data_bytes(item->arguments.forward_fully_connected.weights) + data_bytes(item->arguments.forward_fully_connected.biases);
+        break;
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN:
+        cost.operations = 2 * data_size(item->arguments.fully_connected_forward_i16qn_i16qn.weights) * batch;
+        cost.bytes += data_bytes(item->arguments.fully_connected_forward_i16qn_i16qn.weights) + data_bytes(item->arguments.fully_connected_forward_i16qn_i16qn.biases);
+        break;
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN:
+        cost.operations = 2 * data_size(item->arguments.fully_connected_forward_i16qn_i32qn.weights) * batch;
+        cost.bytes += data_bytes(item->arguments.fully_connected_forward_i16qn_i32qn.weights) + data_bytes(item->arguments.fully_connected_forward_i16qn_i32qn.biases);
+        break;
+    case NN_WORK_ITEM_TYPE_POOLING:
+        cost.operations = outputs * item->arguments.forward_pooling.size[0] * item->arguments.forward_pooling.size[1];
+        break;
+    case NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT:
+        cost.operations = outputs * item->arguments.forward_pooling_fixedpoint.pool_size[0] * item->arguments.forward_pooling_fixedpoint.pool_size[1];
+        break;
+    case NN_WORK_ITEM_TYPE_NORMALIZATION:
+        // sum of squares over neighbourhood, then power & division
+        cost.operations = outputs * (2 * std::max(item->arguments.forward_normalization.normalization.n, 1u) + 10);
+        break;
+    case NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN:
+        cost.operations = outputs * (2 * std::max(item->arguments.normalization_response_across_maps_forward_i16qn.n, 1u) + 10);
+        break;
+    case NN_WORK_ITEM_TYPE_SOFTMAX:
+    case NN_WORK_ITEM_TYPE_SOFTMAX_FIXEDPOINT:
+        // exponent, sum & division
+        cost.operations = outputs * 12;
+        break;
+    case NN_WORK_ITEM_TYPE_ARITHMETIC:
+        cost.operations = outputs;
+        cost.bytes += data_bytes(item->arguments.forward_arithmetic.factor);
+        break;
+    default:
+        // data conversions only move memory
+        break;
+    }
+    return cost;
+}
+
+const nn_cpu_host_calibration& nn_cpu_cost_model::get_calibration(nn_thread_worker_pool& pool)
+{
+    std::call_once(calibrated, [&]() { calibration = calibrate(pool); });
+    return calibration;
+}
+
+nn_cpu_host_calibration nn_cpu_cost_model::calibrate(nn_thread_worker_pool& pool)
+{
+    const uint32_t jobs = std::max(pool.get_num_threads(), 1u);
+    nn_cpu_host_calibration result;
+
+    { // FMA throughput - 8 independent chains per thread hide latency of FMA units
+        const uint32_t iterations = 1 << 16;
+        std::vector<float> sink(jobs);
+        auto compute = [&]() {
+            pool.parallel_for(jobs, [&](uint32_t job) {
+                const __m256 multiplier = _mm256_set1_ps(0.999999f), addend = _mm256_set1_ps(0.000001f);
+                __m256 acc[8];
+                for (auto& value : acc) value = _mm256_set1_ps(static_cast<float>(job));
+                for (uint32_t iteration = 0; iteration < iterations; ++iteration)
+                    for (auto& value : acc) value = _mm256_fmadd_ps(value, multiplier, addend);
+                __m256 sum = _mm256_setzero_ps();
+                for (auto& value : acc) sum = _mm256_add_ps(sum, value);
+                float values[8];
+                _mm256_storeu_ps(values, sum);
+                sink[job] = values[0];
+            });
+        };
+
+        const auto energy_before = read_package_energy_uj();
+        const auto start = std::chrono::steady_clock::now();
+        const double best_ns = measure_best_ns(8, compute);
+        const double total_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        const auto energy_after = read_package_energy_uj();
+
+        result.operations_per_ns = 2.0 * 8 * 8 * iterations * jobs / best_ns;
+        result.power_w = (energy_after > energy_before) ? (energy_after - energy_before) * 1000.0 / total_ns
+                                                        : C_nominal_thread_power_w * jobs;
+    }
+
+    { // streaming read bandwidth over buffer much larger than caches
+        const size_t values_per_job = (8u << 20) / sizeof(float);
+        std::unique_ptr<float[]> buffer(new float[values_per_job * jobs + 8]);
+        float* aligned = reinterpret_cast<float*>((reinterpret_cast<uintptr_t>(buffer.get()) + 31) & ~uintptr_t(31));
+        std::fill(aligned, aligned + values_per_job * jobs, 1.0f);
+        std::vector<float> sink(jobs);
+        auto stream = [&]() {
+            pool.parallel_for(jobs, [&](uint32_t job) {
+                const float* data = aligned + job * values_per_job;
+                __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+                for (size_t index = 0; index < values_per_job; index += 32)
+                {
+                    acc0 = _mm256_add_ps(acc0, _mm256_load_ps(data + index));
+                    acc1 = _mm256_add_ps(acc1, _mm256_load_ps(data + index + 8));
+                    acc2 = _mm256_add_ps(acc2, _mm256_load_ps(data + index + 16));
+                    acc3 = _mm256_add_ps(acc3, _mm256_load_ps(data + index + 24));
+                }
+                float values[8];
+                _mm256_storeu_ps(values, _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+                sink[job] = values[0];
+            });
+        };
+        result.bytes_per_ns = static_cast<double>(values_per_job * jobs * sizeof(float)) / measure_best_ns(3, stream);
+    }
+
+    { // fork/join of empty job
+        const uint32_t runs = 64;
+        auto fork_join = [&]() {
+            for (uint32_t run = 0; run < runs; ++run)
+                pool.parallel_for(jobs, [](uint32_t) {});
+        };
+        result.fork_join_ns = measure_best_ns(3, fork_join) / runs;
+    }
+
+    return result;
+}
+
+double nn_cpu_cost_model::estimate_time_ns(const nn_cpu_host_calibration& calibration, const nn_cpu_work_item_cost& cost)
+{
+    const double compute_ns = cost.operations / calibration.operations_per_ns;
+    const double memory_ns = cost.bytes / calibration.bytes_per_ns;
+    return std::max(compute_ns, memory_ns) + (cost.parallel ? calibration.fork_join_ns : 0.0);
+}
+
+void nn_cpu_cost_model::estimate_workflow(const nn_cpu_host_calibration& calibration,
+                                          nn_workflow_t* workflow,
+                                          uint32_t batch,
+                                          uint64_t& time_ns,
+                                          uint64_t& energy_nj)
+{
+    double total_ns = 0.0;
+    std::queue<nn_workflow_item_t*> todo;
+    std::set<nn_workflow_item_t*> done;
+    for (uint32_t index = 0; index < workflow->input_count; ++index)
+        todo.push(workflow->input[index]);
+    while (!todo.empty())
+    {
+        auto item = todo.front();
+        todo.pop();
+        if (!done.insert(item).second) continue;
+        total_ns += estimate_time_ns(calibration, nn_cpu_work_item_cost_estimate(item, batch));
+        for (uint32_t index = 0; index < item->use_count; ++index)
+            todo.push(item->use[index]);
+    }
+
+    time_ns = static_cast<uint64_t>(total_ns);
+    energy_nj = static_cast<uint64_t>(total_ns * calibration.power_w);
+}
+
+std::vector<uint32_t> nn_cpu_cost_model::default_batches(uint32_t num_threads)
+{
+    std::vector<uint32_t> batches = {1, num_threads, num_threads * C_metrics_images_per_thread};
+    batches.erase(std::unique(batches.begin(), batches.end()), batches.end());
+    return batches;
+}
@@ -0,0 +1,94 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "../../api/nn_device_interface_0.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class nn_thread_worker_pool;
+
+/* This file contains cost model used to estimate time & energy of workflow execution on CPU device.
+
+Every work item is described by number of arithmetic operations and bytes of memory it reads & writes.
+Its time is estimated with roofline model against throughput of the host measured with short microbenchmarks
+on device thread pool, plus fork/join overhead of work items split into jobs.
+Energy is time multiplied by package power measured during calibration (RAPL), or by nominal power
+per thread if power counters are not available.
+*/
+
+// Work of single workflow item.
+struct nn_cpu_work_item_cost
+{
+    uint64_t operations;    // arithmetic operations (multiply-add counts as two)
+    uint64_t bytes;         // memory read & written: inputs, outputs & parameters
+    bool     parallel;      // item is split into jobs of thread pool
+};
+
+// Returns work of workflow item for given batch.
+nn_cpu_work_item_cost nn_cpu_work_item_cost_estimate(const nn_workflow_item_t* item, uint32_t batch);
+
+// Throughput of the host measured on device thread pool.
+struct nn_cpu_host_calibration
+{
+    double operations_per_ns;   // single precision FMA throughput of all threads
+    double bytes_per_ns;        // streaming read bandwidth of all threads
+    double fork_join_ns;        // overhead of single parallel job
+    double power_w;             // package power while all threads compute
+};
+
+class nn_cpu_cost_model
+{
+public:
+    nn_cpu_cost_model() : calibration() {}
+
+    // Measures host on first call, later returns the same results.
+    const nn_cpu_host_calibration& get_calibration(nn_thread_worker_pool& pool);
+
+    static nn_cpu_host_calibration calibrate(nn_thread_worker_pool& pool);
+
+    // Estimated time of work item in nanoseconds.
+    static double estimate_time_ns(const nn_cpu_host_calibration& calibration, const nn_cpu_work_item_cost& cost);
+
+    // Estimated time (nanoseconds) & energy (nanojoules) of all items of workflow compiled for given batch.
+    static void estimate_workflow(const nn_cpu_host_calibration& calibration,
+                                  nn_workflow_t* workflow,
+                                  uint32_t batch,
+                                  uint64_t& time_ns,
+                                  uint64_t& energy_nj);
+
+    // Batches of variants reported by workflow metrics query when none are set: single image (latency),
+    // one image per thread, and C_metrics_images_per_thread images per thread (throughput).
+    static std::vector<uint32_t> default_batches(uint32_t num_threads);
+
+private:
+    std::once_flag calibrated;
+    nn_cpu_host_calibration calibration;
+};
@@ -28,16 +28,25 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "../../common/nn_device_internal.h"
+#include "cpu_topology.h"
+#include "cpu_cost_model.h"
+#include "cpu_autotuner.h"
+#include "cpu_profiler.h"
+#include "cpu_isa.h"
 
 #include <cstdint>
 
 #include <algorithm>
+#include <functional>
 #include <thread>
 #include <atomic>
 #include <mutex>
 #include <queue>
+#include <deque>
+#include <vector>
 #include <memory>
 #include <condition_variable>
+#include <immintrin.h>
 #include <assert.h>
 
 /* This file contains internal device structure implementation as well as thread pool class.
@@ -49,10 +58,25 @@ Thread pool usage:
        request_handle that is also sent inside request.
     3. Specific implementation of opaque internal structure can be made if required.
     4. After 'job' is created, use push_job function.
-        - This function blocks execution until all worker threads complete their work.
-        - You can't send 'job' that have more requests than there are threads available.
-          Such action will result in assertion.
+        - This function blocks execution until all requests of the job are completed.
+        - Job can contain any number of requests, they are load balanced between threads.
+        - Calling thread takes part in processing of its own job.
+        - push_job can be called from inside of a request (nested parallel region),
+          nested job is then processed by the same pool without blocking any thread.
         - This function does not clear nor deallocate job vector, you must do it by yourself.
+    5. For simple index-based loops parallel_for(count, function) can be used instead,
+       it calls function(index) for every index in [0, count) and joins.
+    6. set_placement pins worker threads according to processor topology, get_memory_nodes
+       then returns NUMA nodes on which buffers used by the workers should be placed.
+    7. set_num_threads recreates workers with new thread count, e.g. when cores are split between
+       devices of co-resident workloads (NN_PARAMETER_CPU_THREAD_COUNT).
+
+Scheduling:
+    Every worker thread owns a task deque. Worker pushes and pops its own tasks at the back
+    (newest first, data is still in cache), idle workers steal from the front of other deques
+    (oldest first, biggest chunks of remaining work). Jobs pushed by threads from outside of
+    the pool are put into a shared injection deque. Idle workers spin for a short time before
+    going to sleep, so back-to-back jobs (consecutive layers) do not pay for OS wake ups.
 */
 
 // Internal implementation of request handle used by the thread pool.
@@ -73,270 +97,593 @@ struct nn_multithreaded_request
     void* request_handle;
 };
 
-// Semaphore class used in thread pool implementation.
-class nn_semaphore
+// Single schedulable unit - request together with counter of unfinished requests of its job.
+struct nn_thread_task
+{
+    nn_multithreaded_request* request;
+    std::atomic<uint32_t>* pending;
+    nn_cpu_profile_job* profile;    // null unless job was pushed by profiled work item
+};
+
+// Double-ended task queue owned by one worker.
+class nn_task_deque
 {
 public:
-    // Setup semaphore and clear its counter.
-    nn_semaphore() 
-        : mtx(),
-          mtx_lock(mtx, std::defer_lock),
-          count(0) {}
-
-    // Set semaphore specific value that will be later decremented.
-    void set_semaphore(uint32_t _count) 
-    { 
-        // Thread pool queue should be cleared which is indicated by semaphore value (==0).
-        mtx_lock.lock();
-        assert(count == 0); 
-        count = _count; 
-    }
+    nn_task_deque() : size(0) {}
 
-    // Notifies waiters, decrements semaphore value and atomically clears working state 
-    // under semaphore lock. This method is called under wake lock also - as should 
-    // be every place changing request value.
-    void atomic_clear_state_and_notify(nn_multithreaded_request** request)
+    // Owner side - adds tasks at the back.
+    void push_back(nn_thread_task* first, size_t count)
     {
-        std::unique_lock<std::mutex> lck(mtx);
-        *request = nullptr;
-        --count;
-        cv.notify_one();
+        std::lock_guard<std::mutex> lock(mtx);
+        tasks.insert(tasks.end(), first, first + count);
+        size.store(tasks.size(), std::memory_order_release);
     }
 
-    // Waits until tasks count will be equal to zero.
-    void wait_for_all_and_clear()
+    // Owner side - takes newest task.
+    bool pop_back(nn_thread_task& task)
     {
-        cv.wait(mtx_lock, [this]() { return count == 0; });
-        mtx_lock.unlock();
+        if (size.load(std::memory_order_acquire) == 0) return false;
+        std::lock_guard<std::mutex> lock(mtx);
+        if (tasks.empty()) return false;
+        task = tasks.back();
+        tasks.pop_back();
+        size.store(tasks.size(), std::memory_order_release);
+        return true;
     }
 
-    // Wait until any thread is done
-    void wait_change()
+    // Thief side - takes oldest task.
+    bool steal_front(nn_thread_task& task)
     {
-        cv.wait(mtx_lock);
+        if (size.load(std::memory_order_acquire) == 0) return false;
+        std::lock_guard<std::mutex> lock(mtx);
+        if (tasks.empty()) return false;
+        task = tasks.front();
+        tasks.pop_front();
+        size.store(tasks.size(), std::memory_order_release);
+        return true;
     }
 
 private:
-    // This mutex is locked so 'count' member can't be accessed in more than one thread.
     std::mutex mtx;
-    std::unique_lock<std::mutex> mtx_lock;
-    std::condition_variable cv;
+    std::deque<nn_thread_task> tasks;
 
-    // Number of tasks in pool queue.
-    uint32_t count;
+    // Lock-free hint used to skip empty deques without touching the mutex.
+    std::atomic<size_t> size;
 };
 
-// Basic thread worker class.
-class nn_thread_worker
+// Work-stealing thread pool implementation.
+class nn_thread_worker_pool
 {
 public:
-    nn_thread_worker(uint32_t id, nn_semaphore* semaphore)
-        : hypervisor_semaphore(semaphore),
-        current_request(nullptr),
-        thread_id(id),
-        worker_awaken(false),
-        close_worker(false),
-        worker_thread(&nn_thread_worker::task_loop, this)
-    {
-        // Wait until OS complete thread creation and call main thread function.
-        while (!worker_awaken)
-            ;
-    }
-
-    ~nn_thread_worker()
+    // Basic constructor.
+    nn_thread_worker_pool(uint32_t cfg_num_threads = 0)
+        : placement(NN_CPU_THREAD_PLACEMENT_NONE),
+          close_workers(false),
+          sleeping_workers(0),
+          work_epoch(0),
+          resizing(false),
+          external_jobs(0)
     {
+        if (cfg_num_threads == 0)
+        {
+            // Check system to get number of HW threads available.
+            // TODO: add specific implementation for windows/linux to get exact value of cores.
+            num_threads = std::thread::hardware_concurrency() / 2; // take half, to work on 1 of 2 sockets
+        }
+        else
         {
-            // Set termination flag and wake up thread. Mutex will make
-            // sure it wont happen during current task processing.
-            std::lock_guard<std::mutex> wake_lock(wake_mutex);
-            close_worker = true;
-            wake_condition.notify_one();
+            // Get number of threads specified by user.
+            num_threads = cfg_num_threads;
         }
 
-        // Wait for termination.
-        worker_thread.join();
+        if (num_threads == 0) num_threads = 1;
+
+        start_workers();
     }
 
+    ~nn_thread_worker_pool()
+    {
+        stop_workers();
+    }
 
-    // Adds request to the thread.
-    void add_request(nn_multithreaded_request* request)
+    // Changes number of threads. Waits until jobs pushed from outside of the pool are finished and holds new
+    // ones until workers are recreated, so it can be called while other threads use the pool, but not from
+    // inside of a job. Placement is applied again to the new workers.
+    void set_num_threads(uint32_t new_num_threads)
     {
-        if (request == nullptr) throw std::invalid_argument("null request sent");
-        {
-            // Locks wake mutex - it will get unlocked after worker
-            // thread will cleanup itself after previous work.
-            std::lock_guard<std::mutex> wake_lock(wake_mutex);
-            current_request = request;
-            wake_condition.notify_one();
-        }
+        if (new_num_threads == 0) new_num_threads = 1;
+
+        std::unique_lock<std::mutex> lock(resize_mutex);
+        resize_condition.wait(lock, [this]() { return !resizing; });
+        if (new_num_threads == num_threads) return;
+        resizing = true;
+        resize_condition.wait(lock, [this]() { return external_jobs == 0; });
+
+        stop_workers();
+        num_threads = new_num_threads;
+        start_workers();
+        if (placement != NN_CPU_THREAD_PLACEMENT_NONE)
+            apply_placement(placement);
+
+        resizing = false;
+        resize_condition.notify_all();
     }
 
-    // Checks if there is any request processed.
-    bool is_ready() const
+    // Get number of worker threads available.
+    uint32_t get_num_threads()
     {
-        return current_request == nullptr;
+        return num_threads;
     }
 
-private:
-    // Main worker thread routine.
-    void task_loop()
+    // Pin worker threads to logical processors selected from topology.
+    // Slot 0 is left for thread that pushes jobs - it is owned by the user and is not pinned.
+    // Workers are accessed under the resize lock, so placement can be changed while pool is resized.
+    void set_placement(NN_CPU_THREAD_PLACEMENT new_placement)
+    {
+        std::unique_lock<std::mutex> lock(resize_mutex);
+        resize_condition.wait(lock, [this]() { return !resizing; });
+        apply_placement(new_placement);
+    }
+
+    // Identifiers of worker threads, in order of their deques.
+    std::vector<std::thread::id> get_worker_ids() const
     {
-        // Aquire wake mutex so no other thread can incorrectly interfere in thread values.
-        std::unique_lock<std::mutex> wake_lock(wake_mutex);
+        std::lock_guard<std::mutex> lock(resize_mutex);
+        std::vector<std::thread::id> result;
+        for (auto& worker : workers)
+            result.push_back(worker.get_id());
+        return result;
+    }
 
-        // Let constructor know that thread is fully created and safely locked.
-        worker_awaken = true;
+    NN_CPU_THREAD_PLACEMENT get_placement() const
+    {
+        std::lock_guard<std::mutex> lock(resize_mutex);
+        return placement;
+    }
 
-        // Main loop.
-        while (!close_worker)
+    // NUMA nodes of pinned threads, empty if threads are not pinned.
+    std::vector<uint32_t> get_memory_nodes() const
+    {
+        std::lock_guard<std::mutex> lock(resize_mutex);
+        return memory_nodes;
+    }
+
+    // Push job queue.
+    void push_job(std::vector<nn_multithreaded_request>& requests)
+    {
+        if (requests.empty()) return;
+
+        external_job_guard guard(*this);
+
+        // Job of profiled work item - its requests are timed.
+        nn_cpu_profile_job job_profile;
+        nn_cpu_profile_job* profile = nullptr;
+        if (auto item = nn_cpu_profiler::current_item())
         {
-            // Waits for notification that can be caused by new task or destructor.
-            // When thread is in waiting state, it removes lock so other threads can push
-            // new jobs into it or check its state. But after thread is notified, it locks 
-            // it again, so no code under this mutex can interfere during task processing.
-            // It also causes thread to wait until all other threads changing its state
-            // complete their work before thread starts.
-            wake_condition.wait(wake_lock);
-
-            // Safety check for spurious wake up or other wake up that shouldnt cause thread
-            // to work on data - e.g. it could be termination call.
-            bool assign_check;
+            job_profile.item = item;
+            job_profile.pushed_ns = nn_cpu_profiler::now_ns();
+            job_profile.started = false;
+            ++item->jobs;
+            profile = &job_profile;
+        }
+
+        if (workers.empty())
+        {
+            // Singlethreaded pool... run tasks sequentially by itself.
+            for (auto& request : requests)
             {
-                assign_check = current_request != nullptr;
+                run_request(request, profile);
+            }
+            return;
+        }
+
+        std::atomic<uint32_t> pending(static_cast<uint32_t>(requests.size()));
 
-                if (assign_check)
-                {
-                    // Call user callback with sent request handle.
-                    current_request->callback(current_request->request_handle);
+        std::vector<nn_thread_task> tasks(requests.size());
+        for (size_t index = 0; index < requests.size(); ++index)
+            tasks[index] = nn_thread_task{ &requests[index], &pending, profile };
 
-                    // Safely clears request state and notifies pool semaphore.
-                    hypervisor_semaphore->atomic_clear_state_and_notify(&current_request);
-                }
+        // Nested job goes to the deque of current worker, external job to the injection deque.
+        const uint32_t own_deque = current_deque_id();
+        deques[own_deque]->push_back(tasks.data(), tasks.size());
+        wake_workers();
+
+        // Join - help processing until every request of this job is done.
+        uint32_t idle_spins = 0;
+        while (pending.load(std::memory_order_acquire) != 0)
+        {
+            nn_thread_task task;
+            if (acquire_task(own_deque, task))
+            {
+                execute(task);
+                idle_spins = 0;
+            }
+            else if (++idle_spins < C_spin_count)
+            {
+                _mm_pause();
+            }
+            else
+            {
+                std::this_thread::yield();
             }
         }
     }
 
-     // Semaphore of thread pool, shader by all threads.
-    nn_semaphore* hypervisor_semaphore;
+    // Fork/join over index range - calls function(index) for each index in [0, count).
+    template <typename T_function>
+    void parallel_for(uint32_t count, const T_function& function)
+    {
+        std::vector<nn_multithreaded_request> job(count);
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            job[index].callback = [&function](void* handle) { function(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(handle))); };
+            job[index].request_handle = reinterpret_cast<void*>(static_cast<uintptr_t>(index));
+        }
 
-    // Value used both as request handle and indicator of thread state.
-    nn_multithreaded_request* current_request;
+        push_job(job);
+    }
 
-    // ID of thread visible by thread pool.
-    uint32_t thread_id;
+private:
+    // Number of idle iterations before worker gives up spinning and goes to sleep.
+    static const uint32_t C_spin_count = 4096;
 
-    // Special controlling values.
-    volatile bool worker_awaken;
-    volatile bool close_worker;
+    // Registers job pushed by thread from outside of the pool, so set_num_threads does not recreate workers
+    // under it. Nested jobs of such thread are already covered by the outermost one.
+    class external_job_guard
+    {
+    public:
+        external_job_guard(nn_thread_worker_pool& pool) : pool(pool), registered(false)
+        {
+            auto context = current_worker();
+            if ((context != nullptr && context->pool == &pool) || current_external_pool() == &pool) return;
+
+            std::unique_lock<std::mutex> lock(pool.resize_mutex);
+            pool.resize_condition.wait(lock, [&pool]() { return !pool.resizing; });
+            ++pool.external_jobs;
+            current_external_pool() = &pool;
+            registered = true;
+        }
 
-    // Mutexes used by a thread.
-    mutable std::mutex wake_mutex;
-    std::condition_variable wake_condition;
+        ~external_job_guard()
+        {
+            if (!registered) return;
 
-    // Main object of worker thread.
-    std::thread worker_thread;
-};
+            current_external_pool() = nullptr;
+            std::lock_guard<std::mutex> lock(pool.resize_mutex);
+            if (--pool.external_jobs == 0)
+                pool.resize_condition.notify_all();
+        }
 
-// Thread pool implementation.
-class nn_thread_worker_pool
-{
-public:
-    // Basic constructor.
-    nn_thread_worker_pool(uint32_t cfg_num_threads = 0)
+    private:
+        external_job_guard(const external_job_guard&) = delete;
+        external_job_guard& operator=(const external_job_guard&) = delete;
+
+        nn_thread_worker_pool& pool;
+        bool registered;
+    };
+
+    static nn_thread_worker_pool*& current_external_pool()
     {
-        uint32_t num_threads;
+        static thread_local nn_thread_worker_pool* pool = nullptr;
+        return pool;
+    }
 
-        if (cfg_num_threads == 0)
+    // Pins workers; called with resize lock held.
+    void apply_placement(NN_CPU_THREAD_PLACEMENT new_placement)
+    {
+        auto& topology = nn_cpu_topology::get();
+        auto cpus = topology.select_cpus(num_threads, new_placement);
+
+        for (size_t worker = 0; worker < workers.size(); ++worker)
+            nn_cpu_pin_thread(workers[worker], cpus.empty() ? -1 : static_cast<int32_t>(cpus[worker + 1]));
+
+        placement = new_placement;
+        memory_nodes = topology.get_nodes(cpus);
+    }
+
+    void start_workers()
+    {
+        // Thread pushing the job processes it too, so one thread less is created.
+        // Last deque is the injection queue for jobs pushed from outside of the pool.
+        const uint32_t num_workers = num_threads - 1;
+        for (uint32_t deque_id = 0; deque_id <= num_workers; ++deque_id)
+            deques.push_back(std::unique_ptr<nn_task_deque>(new nn_task_deque));
+
+        // If there is only one thread available - do not create 
+        // subthreads, pool will process all jobs on its own.
+        if (num_threads > 1)
         {
-            // Check system to get number of HW threads available.
-            // TODO: add specific implementation for windows/linux to get exact value of cores.
-            num_threads = std::thread::hardware_concurrency() / 2; // take half, to work on 1 of 2 sockets
-            
+            for (uint32_t thread_id = 0; thread_id < num_workers; ++thread_id)
+                workers.push_back(std::thread(&nn_thread_worker_pool::worker_loop, this, thread_id));
         }
-        else
+    }
+
+    void stop_workers()
+    {
         {
-            // Get number of threads specified by user.
-            num_threads = cfg_num_threads;
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            close_workers = true;
+            sleep_condition.notify_all();
         }
 
+        for (auto& worker : workers)
+            worker.join();
 
-        // If there is only one thread available - do not create 
-        // subthreads, pool will process all jobs on its own.
-        if (num_threads > 1)
+        workers.clear();
+        deques.clear();
+        close_workers = false;
+    }
+
+    // Identifies pool and deque of the current worker thread (nullptr for external threads).
+    struct worker_context
+    {
+        nn_thread_worker_pool* pool;
+        uint32_t deque_id;
+    };
+
+    static worker_context*& current_worker()
+    {
+        static thread_local worker_context* context = nullptr;
+        return context;
+    }
+
+    uint32_t current_deque_id()
+    {
+        auto context = current_worker();
+        return (context != nullptr && context->pool == this) ? context->deque_id : injection_deque_id();
+    }
+
+    uint32_t injection_deque_id() const
+    {
+        return static_cast<uint32_t>(deques.size() - 1);
+    }
+
+    // Gets task from own deque, then from injection deque, then steals from other workers.
+    bool acquire_task(uint32_t own_deque, nn_thread_task& task)
+    {
+        if (own_deque != injection_deque_id() && deques[own_deque]->pop_back(task))
+            return true;
+
+        if (deques[injection_deque_id()]->steal_front(task))
+            return true;
+
+        const uint32_t num_worker_deques = injection_deque_id();
+        for (uint32_t offset = 1; offset <= num_worker_deques; ++offset)
         {
-            for (uint32_t thread_id = 0; thread_id < num_threads; ++thread_id)
-            {
-                auto thread = std::unique_ptr<nn_thread_worker>(new nn_thread_worker(thread_id, &semaphore));
-                threads.push_back(std::move(thread));
-            }
+            const uint32_t victim = (own_deque + offset) % num_worker_deques;
+            if (victim != own_deque && deques[victim]->steal_front(task))
+                return true;
         }
+
+        return false;
     }
 
-    ~nn_thread_worker_pool()
+    void execute(const nn_thread_task& task)
     {
+        run_request(*task.request, task.profile);
+        task.pending->fetch_sub(1, std::memory_order_acq_rel);
     }
 
-    // Get number of worker threads available.
-    uint32_t get_num_threads()
+    // Runs request; for profiled jobs its time is added to busy time of current thread in item profile.
+    // Requests nested in profiled request are already covered by its time.
+    void run_request(nn_multithreaded_request& request, nn_cpu_profile_job* profile)
     {
-        // If there are no worker threads, then one thread is available - the pool thread.
-        if (threads.size()) return threads.size();
-        else return 1;
+        static thread_local bool in_profiled_request = false;
+        if (profile == nullptr || in_profiled_request)
+        {
+            request.callback(request.request_handle);
+            return;
+        }
+
+        auto item = profile->item;
+        const auto begin = nn_cpu_profiler::now_ns();
+        if (!profile->started.exchange(true))
+            item->dispatch_ns += begin - profile->pushed_ns;
+
+        // Jobs pushed from inside of request belong to the same item.
+        auto& current_item = nn_cpu_profiler::current_item();
+        auto outer_item = current_item;
+        current_item = item;
+        in_profiled_request = true;
+
+        // Hardware counters of this thread, unless it is the item's own thread that already counts them.
+        auto& counting = nn_cpu_profiler::thread_counting();
+        nn_cpu_counter_values begin_counters;
+        const bool counted = item->counted && !counting && nn_cpu_perf_counters::read(begin_counters);
+        if (counted) counting = true;
+
+        struct restore_t
+        {
+            nn_cpu_profile_item*& current_item;
+            nn_cpu_profile_item* outer_item;
+            bool& counting;
+            bool counted;
+            ~restore_t() { current_item = outer_item; in_profiled_request = false; if (counted) counting = false; }
+        } restore = { current_item, outer_item, counting, counted };
+
+        request.callback(request.request_handle);
+
+        if (counted)
+        {
+            nn_cpu_counter_values end_counters;
+            if (nn_cpu_perf_counters::read(end_counters))
+                item->add_counters(begin_counters, end_counters);
+        }
+
+        // Last slot belongs to threads from outside of the pool; workers created after item started are skipped.
+        auto context = current_worker();
+        const size_t caller_slot = item->busy_ns.size() - 1;
+        const bool worker = context != nullptr && context->pool == this;
+        if (!worker || context->deque_id < caller_slot)
+            item->busy_ns[worker ? context->deque_id : caller_slot] += nn_cpu_profiler::now_ns() - begin;
     }
 
-    // Push job queue.
-    void push_job(std::vector<nn_multithreaded_request>& requests)
+    void wake_workers()
     {
-        // Sent requests to worker threads.
-        if (threads.size() != 0)
+        ++work_epoch;
+        if (sleeping_workers.load() != 0)
         {
-            // Setup semaphore and lock its mutex.
-            semaphore.set_semaphore(requests.size());
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            sleep_condition.notify_all();
+        }
+    }
 
-            auto threads_begin = std::begin(threads);
-            auto threads_end = std::end(threads);
+    // Main worker thread routine.
+    void worker_loop(uint32_t deque_id)
+    {
+        worker_context context = { this, deque_id };
+        current_worker() = &context;
 
-            // Run tasks.
-            for (auto& request : requests)
+        uint32_t idle_spins = 0;
+        while (!close_workers)
+        {
+            const uint64_t epoch = work_epoch.load();
+
+            nn_thread_task task;
+            if (acquire_task(deque_id, task))
+            {
+                execute(task);
+                idle_spins = 0;
+                continue;
+            }
+
+            if (++idle_spins < C_spin_count)
             {
-                auto ready_thread = threads_end;
-
-                // Find waiting thread.
-                do{
-                    ready_thread = std::find_if(threads_begin, threads_end,
-                        [&](std::unique_ptr<nn_thread_worker> const& thread) { return thread->is_ready(); });
-                    if (ready_thread != threads_end)
-                        break;
-                    semaphore.wait_change();
-                } while (ready_thread == threads_end);
-
-                // It will hit if there are no ready threads.
-                assert(ready_thread != threads_end);
-
-                // Add request to ready thread found.
-                (**ready_thread).add_request(&request);
+                _mm_pause();
+                continue;
             }
 
-            // Wait for all threads and clear semaphore locks.
-            semaphore.wait_for_all_and_clear();
+            // Nothing to do for a while - sleep until new work is pushed or pool is closed.
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            ++sleeping_workers;
+            sleep_condition.wait(lock, [&]() { return close_workers || work_epoch.load() != epoch; });
+            --sleeping_workers;
+            idle_spins = 0;
         }
-        else
+
+        current_worker() = nullptr;
+    }
+
+    uint32_t num_threads;
+
+    // Thread placement & NUMA nodes of selected processors.
+    NN_CPU_THREAD_PLACEMENT placement;
+    std::vector<uint32_t> memory_nodes;
+
+    // Task deques - one per worker thread and the injection deque as the last one.
+    std::vector<std::unique_ptr<nn_task_deque>> deques;
+
+    // Worker threads.
+    std::vector<std::thread> workers;
+
+    // Sleep/wake up handling.
+    std::atomic<bool> close_workers;
+    std::atomic<uint32_t> sleeping_workers;
+    std::atomic<uint64_t> work_epoch;
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_condition;
+    // Resizing - jobs pushed from outside of the pool are counted, workers are recreated when there are none.
+    bool resizing;
+    uint32_t external_jobs;
+    mutable std::mutex resize_mutex;
+    std::condition_variable resize_condition;
+};
+
+// Queue of asynchronous requests (workload executions) processed in order of arrival by dispatcher threads.
+// Dispatchers only drive requests, parallel work inside of them is pushed to the thread pool.
+// Dispatchers are started on demand, so devices that are never used asynchronously do not own any.
+class nn_async_request_queue
+{
+public:
+    nn_async_request_queue() : close_dispatchers(false), idle_dispatchers(0) {}
+
+    // Processes all requests that are still queued, then stops dispatchers.
+    ~nn_async_request_queue()
+    {
         {
-            // Singlethreaded pool... run tasks sequentially by itself.
-            for (auto& request : requests)
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            close_dispatchers = true;
+        }
+        request_condition.notify_all();
+
+        for (auto& dispatcher : dispatchers)
+            dispatcher.join();
+    }
+
+    // Requests run concurrently on up to C_max_dispatchers threads, each of them pushes its jobs to device thread pool.
+    // Function on_queued publishes state the request updates when it is done - it is called under the queue lock
+    // once request is queued, so request cannot finish before it. If push throws, nothing is queued nor published.
+    template <typename T_function>
+    void push(std::function<void()> request, const T_function& on_queued)
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (idle_dispatchers <= requests.size() && dispatchers.size() < C_max_dispatchers)
+        {
+            try
+            {
+                dispatchers.emplace_back(&nn_async_request_queue::dispatcher_loop, this);
+            }
+            catch (...)
             {
-                request.callback(request.request_handle);
+                // request is still served by running dispatchers, unless there are none
+                if (dispatchers.empty()) throw;
             }
         }
+        requests.push(std::move(request));
+        on_queued();
+
+        request_condition.notify_one();
+    }
+
+    // Updates state shared with waiters - function is called under the queue lock, then waiters are woken up.
+    template <typename T_function>
+    void publish(const T_function& function)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            function();
+        }
+        completion_condition.notify_all();
+    }
+
+    // Blocks until condition (evaluated under the queue lock) is met. Must not be called from inside of a request.
+    template <typename T_condition>
+    void wait(const T_condition& condition)
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        completion_condition.wait(lock, condition);
     }
 
 private:
+    // Limit of requests running at the same time - more of them would only compete for the same workers.
+    static const size_t C_max_dispatchers = 4;
 
-    // Main semaphore, visible by all worker threads.
-    nn_semaphore semaphore;
+    void dispatcher_loop()
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        for (;;)
+        {
+            ++idle_dispatchers;
+            request_condition.wait(lock, [this]() { return close_dispatchers || !requests.empty(); });
+            --idle_dispatchers;
+            if (requests.empty()) return;
 
-    // Vector of worker threads.
-    std::vector<std::unique_ptr<nn_thread_worker>> threads;
+            auto request = std::move(requests.front());
+            requests.pop();
+
+            lock.unlock();
+            request();
+            lock.lock();
+        }
+    }
+
+    std::queue<std::function<void()>> requests;
+    bool close_dispatchers;
+    size_t idle_dispatchers;
+    std::mutex queue_mutex;
+    std::condition_variable request_condition;
+    std::condition_variable completion_condition;
+    std::vector<std::thread> dispatchers;
 };
 
 // Internal implementation of device structure.
@@ -346,4 +693,25 @@ struct nn_device_internal : nn_device_t
     nn_device_internal(uint32_t num_threads) : thread_pool(num_threads) {};
 
     nn_thread_worker_pool thread_pool;
+
+    // Host throughput used by workflow metrics, measured on first query.
+    nn_cpu_cost_model cost_model;
+
+    // Batches of workflow metrics variants (NN_PARAMETER_CPU_METRICS_BATCHES), empty - derived from thread count.
+    std::vector<uint32_t> metrics_batches;
+
+    // Kernel choices of tunable primitives; compilation autotunes when it has a file set.
+    nn_cpu_tuning_database tuning_database;
+
+    // Per work item timings, collected while NN_PARAMETER_CPU_PROFILING is on.
+    nn_cpu_profiler profiler;
+
+    // Relative error of convolutions accepted by compilation (NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE).
+    float convolution_tolerance = 0.0f;
+
+    // Instruction set of kernels (NN_PARAMETER_CPU_ISA), best one of host when device is loaded.
+    NN_CPU_ISA isa = nn_cpu_isa_detect();
+
+    // Declared after thread pool - destroyed (and drained) before it.
+    nn_async_request_queue request_queue;
 };
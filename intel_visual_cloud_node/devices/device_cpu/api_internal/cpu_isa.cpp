@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "cpu_isa.h"
+
+#include <cstdint>
+#if defined _MSC_VER
+#   include <intrin.h>
+#   include <immintrin.h>
+#else
+#   include <cpuid.h>
+#endif
+
+namespace
+{
+// CPUID.1:ECX
+const uint32_t C_cpuid_osxsave = 1u << 27;
+// CPUID.(EAX=7,ECX=0):EBX
+const uint32_t C_cpuid_avx512f = 1u << 16;
+const uint32_t C_cpuid_avx512bw = 1u << 30;
+// XCR0: SSE, AVX (upper halves of YMM), opmask, upper halves of ZMM0-15, ZMM16-31
+const uint64_t C_xcr0_avx512_state = 0x2 | 0x4 | 0x20 | 0x40 | 0x80;
+
+bool cpuid(uint32_t leaf, uint32_t subleaf, uint32_t registers[4])
+{
+#if defined _MSC_VER
+    int values[4];
+    __cpuid(values, 0);
+    if (static_cast<uint32_t>(values[0]) < leaf) return false;
+    __cpuidex(values, leaf, subleaf);
+    for (int index = 0; index < 4; ++index) registers[index] = static_cast<uint32_t>(values[index]);
+    return true;
+#else
+    if (__get_cpuid_max(0, nullptr) < leaf) return false;
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+    return true;
+#endif
+}
+
+uint64_t xcr0()
+{
+#if defined _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+bool avx512_supported()
+{
+    uint32_t registers[4];
+    if (!cpuid(1, 0, registers) || !(registers[2] & C_cpuid_osxsave)) return false;
+    if ((xcr0() & C_xcr0_avx512_state) != C_xcr0_avx512_state) return false;
+    if (!cpuid(7, 0, registers)) return false;
+    return (registers[1] & C_cpuid_avx512f) && (registers[1] & C_cpuid_avx512bw);
+}
+} // namespace
+
+NN_CPU_ISA nn_cpu_isa_detect()
+{
+    static const NN_CPU_ISA isa = avx512_supported() ? NN_CPU_ISA_AVX512 : NN_CPU_ISA_AVX2;
+    return isa;
+}
+
+bool nn_cpu_isa_supported(NN_CPU_ISA isa)
+{
+    return isa <= nn_cpu_isa_detect();
+}
@@ -0,0 +1,268 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpu_jit.h"
+
+#include <cstring>
+#include <new>
+#if defined(_WIN32)
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#   define NN_CPU_JIT_SUPPORTED 1
+#else
+#   define NN_CPU_JIT_SUPPORTED 0
+#endif
+
+namespace
+{
+// Microsoft x64 ABI: low halves of xmm6-xmm15 are preserved by callee, saved below pushed rdi & rsi.
+const int32_t C_saved_xmm_count = 10;
+const int32_t C_saved_xmm_area = C_saved_xmm_count * 16 + 8; // keeps rsp 16-byte aligned
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// executable memory
+
+nn_cpu_jit_code::nn_cpu_jit_code(const std::vector<uint8_t>& code)
+    : memory(nullptr), size(code.size())
+{
+#if defined(_WIN32)
+    memory = static_cast<uint8_t*>(VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+    if (memory == nullptr) throw std::bad_alloc();
+    std::memcpy(memory, code.data(), size);
+    DWORD old_protection;
+    if (!VirtualProtect(memory, size, PAGE_EXECUTE_READ, &old_protection))
+    {
+        VirtualFree(memory, 0, MEM_RELEASE);
+        throw std::bad_alloc();
+    }
+    FlushInstructionCache(GetCurrentProcess(), memory, size);
+#else
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) throw std::bad_alloc();
+    memory = static_cast<uint8_t*>(mapping);
+    std::memcpy(memory, code.data(), size);
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(memory, size);
+        throw std::bad_alloc();
+    }
+#endif
+}
+
+nn_cpu_jit_code::~nn_cpu_jit_code()
+{
+#if defined(_WIN32)
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, size);
+#endif
+}
+
+bool nn_cpu_jit_code::is_supported()
+{
+    return NN_CPU_JIT_SUPPORTED != 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// function entry & exit
+
+nn_cpu_jit_emitter::gpr nn_cpu_jit_emitter::argument(uint32_t index)
+{
+    static const gpr arguments[] = { rdi, rsi, rdx, rcx };
+    return arguments[index];
+}
+
+void nn_cpu_jit_emitter::prologue()
+{
+    if (!microsoft_abi) return;
+
+    push(rdi);
+    push(rsi);
+    sub(rsp, C_saved_xmm_area);
+    for (uint8_t xmm = 0; xmm < C_saved_xmm_count; ++xmm)
+        vex_memory(0, 1, 0x11, 6 + xmm, 0, rsp, xmm * 16, false);
+
+    // rcx, rdx, r8, r9 -> rdi, rsi, rdx, rcx
+    mov(rdi, rcx);
+    mov(rsi, rdx);
+    mov(rdx, r8);
+    mov(rcx, r9);
+}
+
+void nn_cpu_jit_emitter::epilogue()
+{
+    vzeroupper();
+    if (microsoft_abi)
+    {
+        for (uint8_t xmm = 0; xmm < C_saved_xmm_count; ++xmm)
+            vex_memory(0, 1, 0x10, 6 + xmm, 0, rsp, xmm * 16, false);
+        add(rsp, C_saved_xmm_area);
+        pop(rsi);
+        pop(rdi);
+    }
+    ret();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// encoding
+
+void nn_cpu_jit_emitter::dword(uint32_t value)
+{
+    for (auto shift = 0u; shift < 32; shift += 8)
+        byte(static_cast<uint8_t>(value >> shift));
+}
+
+// Three-byte VEX prefix: map 1 - 0F, 2 - 0F38; pp 0 - none, 1 - 66. B bit is set by caller through rm/base.
+void nn_cpu_jit_emitter::vex(uint8_t pp, uint8_t map, bool wide, bool ymm, uint8_t opcode, uint8_t reg, uint8_t vvvv)
+{
+    byte(0xc4);
+    byte(static_cast<uint8_t>(((~reg >> 3) & 1) << 7 | 1 << 6 | 1 << 5 | map));
+    byte(static_cast<uint8_t>((wide ? 1 : 0) << 7 | ((~vvvv) & 15) << 3 | (ymm ? 1 : 0) << 2 | pp));
+    byte(opcode);
+}
+
+void nn_cpu_jit_emitter::modrm_register(uint8_t reg, uint8_t rm)
+{
+    byte(static_cast<uint8_t>(0xc0 | (reg & 7) << 3 | (rm & 7)));
+}
+
+void nn_cpu_jit_emitter::modrm_memory(uint8_t reg, gpr base, int32_t displacement)
+{
+    const uint8_t base_low = base & 7;
+    uint8_t mod = 2;
+    if (displacement == 0 && base_low != rbp) mod = 0;
+    else if (displacement >= -128 && displacement <= 127) mod = 1;
+
+    byte(static_cast<uint8_t>(mod << 6 | (reg & 7) << 3 | base_low));
+    if (base_low == rsp) byte(0x24); // SIB: base only
+    if (mod == 1) byte(static_cast<uint8_t>(displacement));
+    if (mod == 2) dword(static_cast<uint32_t>(displacement));
+}
+
+void nn_cpu_jit_emitter::vex_register(uint8_t pp, uint8_t map, uint8_t opcode, uint8_t reg, uint8_t vvvv, uint8_t rm, bool ymm)
+{
+    vex(pp, map, false, ymm, opcode, reg, vvvv);
+    if (rm >= 8) code[code.size() - 3] &= ~(1 << 5); // VEX.B
+    modrm_register(reg, rm);
+}
+
+void nn_cpu_jit_emitter::vex_memory(uint8_t pp, uint8_t map, uint8_t opcode, uint8_t reg, uint8_t vvvv, gpr base, int32_t displacement, bool ymm)
+{
+    vex(pp, map, false, ymm, opcode, reg, vvvv);
+    if (base >= 8) code[code.size() - 3] &= ~(1 << 5); // VEX.B
+    modrm_memory(reg, base, displacement);
+}
+
+void nn_cpu_jit_emitter::rex(bool wide, uint8_t reg, uint8_t rm)
+{
+    const uint8_t value = static_cast<uint8_t>(0x40 | (wide ? 8 : 0) | ((reg >> 3) & 1) << 2 | ((rm >> 3) & 1));
+    if (value != 0x40) byte(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// instructions
+
+void nn_cpu_jit_emitter::vxorps(uint8_t dst, uint8_t src1, uint8_t src2)                    { vex_register(0, 1, 0x57, dst, src1, src2); }
+void nn_cpu_jit_emitter::vmovups(uint8_t dst, gpr base, int32_t displacement)               { vex_memory(0, 1, 0x10, dst, 0, base, displacement); }
+void nn_cpu_jit_emitter::vmovups(gpr base, int32_t displacement, uint8_t src)               { vex_memory(0, 1, 0x11, src, 0, base, displacement); }
+void nn_cpu_jit_emitter::vbroadcastss(uint8_t dst, gpr base, int32_t displacement)          { vex_memory(1, 2, 0x18, dst, 0, base, displacement); }
+void nn_cpu_jit_emitter::vfmadd231ps(uint8_t acc, uint8_t src1, uint8_t src2)               { vex_register(1, 2, 0xb8, acc, src1, src2); }
+void nn_cpu_jit_emitter::vaddps(uint8_t dst, uint8_t src, gpr base, int32_t displacement)   { vex_memory(0, 1, 0x58, dst, src, base, displacement); }
+void nn_cpu_jit_emitter::vmaxps(uint8_t dst, uint8_t src1, uint8_t src2)                    { vex_register(0, 1, 0x5f, dst, src1, src2); }
+
+void nn_cpu_jit_emitter::vzeroupper()
+{
+    byte(0xc5);
+    byte(0xf8);
+    byte(0x77);
+}
+
+void nn_cpu_jit_emitter::mov(gpr dst, gpr src)
+{
+    rex(true, src, dst);
+    byte(0x89);
+    modrm_register(src, dst);
+}
+
+void nn_cpu_jit_emitter::mov(gpr dst, uint32_t immediate)
+{
+    rex(false, 0, dst);
+    byte(static_cast<uint8_t>(0xb8 + (dst & 7)));
+    dword(immediate);
+}
+
+void nn_cpu_jit_emitter::add(gpr dst, int32_t immediate)
+{
+    rex(true, 0, dst);
+    byte(0x81);
+    modrm_register(0, dst);
+    dword(static_cast<uint32_t>(immediate));
+}
+
+void nn_cpu_jit_emitter::sub(gpr dst, int32_t immediate)
+{
+    rex(true, 0, dst);
+    byte(0x81);
+    modrm_register(5, dst);
+    dword(static_cast<uint32_t>(immediate));
+}
+
+void nn_cpu_jit_emitter::dec(gpr dst)
+{
+    rex(false, 0, dst);
+    byte(0xff);
+    modrm_register(1, dst);
+}
+
+void nn_cpu_jit_emitter::push(gpr src)
+{
+    rex(false, 0, src);
+    byte(static_cast<uint8_t>(0x50 + (src & 7)));
+}
+
+void nn_cpu_jit_emitter::pop(gpr dst)
+{
+    rex(false, 0, dst);
+    byte(static_cast<uint8_t>(0x58 + (dst & 7)));
+}
+
+void nn_cpu_jit_emitter::jnz(size_t target)
+{
+    byte(0x0f);
+    byte(0x85);
+    dword(static_cast<uint32_t>(static_cast<int32_t>(target) - static_cast<int32_t>(position() + 4)));
+}
+
+void nn_cpu_jit_emitter::ret()
+{
+    byte(0xc3);
+}
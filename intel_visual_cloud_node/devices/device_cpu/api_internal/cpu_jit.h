@@ -0,0 +1,125 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* This file contains minimal x86-64 code emitter used by layers to generate kernels at run time.
+
+Only instructions needed by generated kernels are available: AVX/AVX2/FMA operations on ymm registers
+with [base + displacement] memory operands and few general purpose register operations for counted loops.
+Code is emitted to byte buffer and then copied to executable memory (nn_cpu_jit_code), which is never
+writable and executable at the same time.
+Generated functions follow native calling convention: System V on Linux, Microsoft x64 on Windows - the
+emitter's prologue() & epilogue() save registers that callee must preserve and move arguments to
+nn_cpu_jit_emitter::argument(0..3), the same registers on both systems.
+On other architectures code generation is not available (nn_cpu_jit_code::is_supported() is false).
+*/
+
+class nn_cpu_jit_code
+{
+public:
+    // Copies code to executable memory; throws std::bad_alloc on failure.
+    explicit nn_cpu_jit_code(const std::vector<uint8_t>& code);
+    ~nn_cpu_jit_code();
+
+    nn_cpu_jit_code(const nn_cpu_jit_code&) = delete;
+    nn_cpu_jit_code& operator=(const nn_cpu_jit_code&) = delete;
+
+    // Address of function starting at given offset of code.
+    template<typename T_function> T_function get(size_t offset) const
+    {
+        return reinterpret_cast<T_function>(memory + offset);
+    }
+
+    static bool is_supported();
+
+private:
+    uint8_t* memory;
+    size_t size;
+};
+
+class nn_cpu_jit_emitter
+{
+public:
+    enum gpr : uint8_t { rax = 0, rcx, rdx, rbx, rsp, rbp, rsi, rdi, r8, r9, r10, r11, r12, r13, r14, r15 };
+
+    // Registers holding integer/pointer arguments 0-3 after prologue().
+    static gpr argument(uint32_t index);
+
+    explicit nn_cpu_jit_emitter(bool microsoft_abi = C_native_microsoft_abi) : microsoft_abi(microsoft_abi) {}
+
+    const std::vector<uint8_t>& get_code() const { return code; }
+    size_t position() const { return code.size(); }
+
+    // Function entry & exit. Functions may use all ymm registers and rax, rcx, rdx, rsi, rdi, r8-r11.
+    void prologue();
+    void epilogue(); // includes vzeroupper & ret
+
+    // AVX: ymm registers 0-15, memory operand is [base + displacement].
+    void vxorps(uint8_t dst, uint8_t src1, uint8_t src2);
+    void vmovups(uint8_t dst, gpr base, int32_t displacement);
+    void vmovups(gpr base, int32_t displacement, uint8_t src);
+    void vbroadcastss(uint8_t dst, gpr base, int32_t displacement);
+    void vfmadd231ps(uint8_t acc, uint8_t src1, uint8_t src2);
+    void vaddps(uint8_t dst, uint8_t src, gpr base, int32_t displacement);
+    void vmaxps(uint8_t dst, uint8_t src1, uint8_t src2);
+    void vzeroupper();
+
+    // General purpose: 64-bit mov, add/sub of sign-extended immediate; 32-bit immediate load & decrement.
+    void mov(gpr dst, gpr src);
+    void mov(gpr dst, uint32_t immediate);
+    void add(gpr dst, int32_t immediate);
+    void sub(gpr dst, int32_t immediate);
+    void dec(gpr dst);
+    void push(gpr src);
+    void pop(gpr dst);
+    // Jump if not zero to earlier position (loop back-edge).
+    void jnz(size_t target);
+    void ret();
+
+#if defined(_WIN32)
+    static const bool C_native_microsoft_abi = true;
+#else
+    static const bool C_native_microsoft_abi = false;
+#endif
+
+private:
+    void byte(uint8_t value) { code.push_back(value); }
+    void dword(uint32_t value);
+    void vex(uint8_t pp, uint8_t map, bool wide, bool ymm, uint8_t opcode, uint8_t reg, uint8_t vvvv);
+    void modrm_register(uint8_t reg, uint8_t rm);
+    void modrm_memory(uint8_t reg, gpr base, int32_t displacement);
+    void vex_register(uint8_t pp, uint8_t map, uint8_t opcode, uint8_t reg, uint8_t vvvv, uint8_t rm, bool ymm = true);
+    void vex_memory(uint8_t pp, uint8_t map, uint8_t opcode, uint8_t reg, uint8_t vvvv, gpr base, int32_t displacement, bool ymm = true);
+    void rex(bool wide, uint8_t reg, uint8_t rm);
+
+    std::vector<uint8_t> code;
+    const bool microsoft_abi;
+};
@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "cpu_partition.h"
+
+#include <algorithm>
+
+nn_cpu_partition nn_cpu_partition_choose(const nn_cpu_partition_work &work, uint32_t num_threads, uint32_t slices_per_job)
+{
+    const uint32_t num_images = std::max(work.num_images, 1u);
+    const uint32_t num_slices = std::max(work.num_slices, 1u);
+    const uint32_t num_rows = std::max(work.num_rows, 1u);
+    const uint32_t row_block = std::min(std::max(work.row_block, 1u), num_rows);
+    num_threads = std::max(num_threads, 1u);
+    if (slices_per_job != 0 && num_slices % slices_per_job != 0)
+        slices_per_job = 0;
+
+    nn_cpu_partition best = {num_slices, num_rows, num_images};
+    uint64_t best_span = UINT64_MAX, best_excess = 0, best_bytes = 0;
+    for (uint32_t slices = 1; slices <= num_slices; ++slices)
+    {
+        if (num_slices % slices != 0 || (slices_per_job != 0 && slices != slices_per_job))
+            continue;
+
+        for (uint32_t rows = row_block; rows < num_rows + row_block; rows += row_block)
+        {
+            const uint32_t clamped_rows = std::min(rows, num_rows);
+            const uint32_t num_row_ranges = (num_rows + clamped_rows - 1) / clamped_rows;
+            const uint32_t num_jobs = num_images * (num_slices / slices) * num_row_ranges;
+            if (num_row_ranges > 1 && num_jobs > num_threads * C_cpu_jobs_per_thread)
+                continue;
+
+            // Work of the busiest thread in slice-rows; working set counts only when it does not fit in cache.
+            const uint64_t span = static_cast<uint64_t>((num_jobs + num_threads - 1) / num_threads) * slices * clamped_rows;
+            const uint64_t bytes = slices * work.slice_bytes + work.window_bytes;
+            const uint64_t excess = bytes > C_cpu_job_working_set_bytes ? bytes : 0;
+
+            if (span < best_span ||
+                (span == best_span && (excess < best_excess ||
+                (excess == best_excess && (num_jobs < best.num_jobs ||
+                (num_jobs == best.num_jobs && bytes < best_bytes))))))
+            {
+                best = nn_cpu_partition{slices, clamped_rows, num_jobs};
+                best_span = span;
+                best_excess = excess;
+                best_bytes = bytes;
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,70 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <cstdint>
+
+/* This file contains choice of split of convolution output between jobs of CPU device thread pool.
+
+Output is split by images, ranges of output feature map slices and ranges of output rows. Batches split
+by images & slices give enough jobs, but single image of layer with few output feature maps (e.g. first
+layer of network) leaves threads idle, so ranges of rows are split as well; neighbouring ranges of rows
+read input rows shared by their kernel windows twice, but compute nothing twice.
+
+Split is chosen to minimize the longest work of a thread (jobs run in waves of thread count), then to keep
+working set of a job - weights of its slices & input rows of one row of kernel windows - within per-core cache,
+then to create the fewest jobs. Rows are split only into as many jobs as C_cpu_jobs_per_thread allows, so cost
+of scheduling & input read twice stays small compared to work of a job.
+*/
+
+// Bytes of weights & input single job should work on (per-core L2 cache).
+const uint64_t C_cpu_job_working_set_bytes = 256 * 1024;
+
+// Limit of jobs per thread when rows are split.
+const uint32_t C_cpu_jobs_per_thread = 4;
+
+// Work of layer to be split.
+struct nn_cpu_partition_work
+{
+    uint32_t num_images;
+    uint32_t num_slices;    // output feature map slices, split into ranges of equal size
+    uint32_t num_rows;      // output rows
+    uint32_t row_block;     // rows computed at once by kernel, ranges of rows are its multiples
+    uint64_t slice_bytes;   // weights of single slice
+    uint64_t window_bytes;  // input rows read for single output row
+};
+
+struct nn_cpu_partition
+{
+    uint32_t slices_per_job;
+    uint32_t rows_per_job;  // last range of rows may be shorter
+    uint32_t num_jobs;      // images * ranges of slices * ranges of rows
+};
+
+// Chooses split for given number of threads; slices_per_job other than 0 (tuned layers) fixes size of slice
+// ranges if it divides number of slices, then only rows are split.
+nn_cpu_partition nn_cpu_partition_choose(const nn_cpu_partition_work &work, uint32_t num_threads, uint32_t slices_per_job = 0);
@@ -0,0 +1,164 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpu_perf_counters.h"
+
+#include <cstring>
+#if defined(__linux__)
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#   include <cpuid.h>
+#endif
+
+namespace
+{
+// FP_ARITH_INST_RETIRED (event 0xC7), umask: scalar double/single, 128 & 256 bit packed double/single,
+// and 512 bit packed double/single where processor has AVX-512F.
+const uint64_t C_fp_arith_inst_retired = 0xc7;
+const uint64_t C_fp_arith_umask = 0x3f;
+const uint64_t C_fp_arith_umask_avx512 = 0xc0;
+
+#if defined(__linux__)
+bool is_intel()
+{
+    uint32_t eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return false;
+    char vendor[12];
+    std::memcpy(vendor, &ebx, 4);
+    std::memcpy(vendor + 4, &edx, 4);
+    std::memcpy(vendor + 8, &ecx, 4);
+    return std::memcmp(vendor, "GenuineIntel", 12) == 0;
+}
+
+bool has_avx512f()
+{
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, nullptr) < 7) return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1u << 16)) != 0;
+}
+
+int open_event(uint32_t type, uint64_t config, int group)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0 /* calling thread */, -1 /* any cpu */, group, 0));
+}
+#endif
+} // namespace
+
+nn_cpu_perf_counters::nn_cpu_perf_counters()
+{
+    for (auto &fd : descriptor) fd = -1;
+#if defined(__linux__)
+    // cycles lead the group, so all events are scheduled on PMU together
+    descriptor[NN_CPU_COUNTER_CYCLES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    const int leader = descriptor[NN_CPU_COUNTER_CYCLES];
+    if (leader < 0) return;
+
+    descriptor[NN_CPU_COUNTER_INSTRUCTIONS] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, leader);
+    descriptor[NN_CPU_COUNTER_LLC_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, leader);
+    if (is_intel())
+        descriptor[NN_CPU_COUNTER_FP_INSTRUCTIONS] = open_event(PERF_TYPE_RAW, fp_arith_event(has_avx512f()), leader);
+#endif
+}
+
+nn_cpu_perf_counters::~nn_cpu_perf_counters()
+{
+#if defined(__linux__)
+    // members of group first, leader last
+    for (int counter = NN_CPU_COUNTER_COUNT - 1; counter >= 0; --counter)
+        if (descriptor[counter] >= 0) close(descriptor[counter]);
+#endif
+}
+
+nn_cpu_perf_counters &nn_cpu_perf_counters::of_current_thread()
+{
+    static thread_local nn_cpu_perf_counters counters;
+    return counters;
+}
+
+bool nn_cpu_perf_counters::read_values(nn_cpu_counter_values &values)
+{
+    std::memset(&values, 0, sizeof(values));
+#if defined(__linux__)
+    if (descriptor[NN_CPU_COUNTER_CYCLES] < 0) return false;
+
+    // group read: number of events, then their values in order they were added to group
+    uint64_t buffer[1 + NN_CPU_COUNTER_COUNT];
+    const auto size = ::read(descriptor[NN_CPU_COUNTER_CYCLES], buffer, sizeof(buffer));
+    if (size < static_cast<ssize_t>(2 * sizeof(uint64_t))) return false;
+
+    uint64_t index = 1;
+    for (int counter = 0; counter < NN_CPU_COUNTER_COUNT && index <= buffer[0]; ++counter)
+        if (descriptor[counter] >= 0)
+            values.value[counter] = buffer[index++];
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool nn_cpu_perf_counters::read(nn_cpu_counter_values &values)
+{
+    return of_current_thread().read_values(values);
+}
+
+bool nn_cpu_perf_counters::available()
+{
+    static const bool result = []() {
+        nn_cpu_counter_values values;
+        return read(values);
+    }();
+    return result;
+}
+
+const char *nn_cpu_perf_counters::name(NN_CPU_COUNTER counter)
+{
+    switch (counter)
+    {
+    case NN_CPU_COUNTER_CYCLES:          return "cycles";
+    case NN_CPU_COUNTER_INSTRUCTIONS:    return "instructions";
+    case NN_CPU_COUNTER_LLC_MISSES:      return "llc_misses";
+    case NN_CPU_COUNTER_FP_INSTRUCTIONS: return "fp_instructions";
+    default:                             return "";
+    }
+}
+
+uint64_t nn_cpu_perf_counters::fp_arith_event(bool avx512f)
+{
+    const auto umask = avx512f ? C_fp_arith_umask | C_fp_arith_umask_avx512 : C_fp_arith_umask;
+    return (umask << 8) | C_fp_arith_inst_retired;
+}
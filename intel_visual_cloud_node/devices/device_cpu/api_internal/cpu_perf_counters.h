@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+/* This file contains hardware performance counters of CPU device threads.
+
+Counters are opened with perf_event_open for the calling thread (user space only, so they work with default
+perf_event_paranoid setting) on its first read and stay open until the thread exits. Counted events:
+  - cycles & instructions - instructions per cycle tell how well layer uses the core,
+  - last level cache misses - high count per instruction marks memory-bound layer,
+  - floating point arithmetic instructions (FP_ARITH_INST_RETIRED, scalar & packed SSE/AVX, and AVX-512 on
+    processors with AVX-512F) - only on Intel processors that have the event; reads as zero elsewhere.
+On systems without perf events (or when access to them is denied) counters are not available.
+*/
+
+enum NN_CPU_COUNTER
+{
+    NN_CPU_COUNTER_CYCLES = 0,
+    NN_CPU_COUNTER_INSTRUCTIONS,
+    NN_CPU_COUNTER_LLC_MISSES,
+    NN_CPU_COUNTER_FP_INSTRUCTIONS,
+    NN_CPU_COUNTER_COUNT
+};
+
+struct nn_cpu_counter_values
+{
+    uint64_t value[NN_CPU_COUNTER_COUNT];
+};
+
+class nn_cpu_perf_counters
+{
+public:
+    // Reads counters of calling thread, opening them on first use. Returns false if they are not available.
+    static bool read(nn_cpu_counter_values &values);
+
+    // True if counters can be opened on this system (checked once, on calling thread).
+    static bool available();
+
+    // Name of counter used in reports.
+    static const char *name(NN_CPU_COUNTER counter);
+
+    // Raw config of FP_ARITH_INST_RETIRED; 512 bit packed instructions are counted only by processors with AVX-512F.
+    static uint64_t fp_arith_event(bool avx512f);
+
+    ~nn_cpu_perf_counters();
+
+private:
+    nn_cpu_perf_counters();
+    nn_cpu_perf_counters(const nn_cpu_perf_counters &) = delete;
+    nn_cpu_perf_counters &operator=(const nn_cpu_perf_counters &) = delete;
+
+    static nn_cpu_perf_counters &of_current_thread();
+    bool read_values(nn_cpu_counter_values &values);
+
+    int descriptor[NN_CPU_COUNTER_COUNT];   // -1 for events that could not be opened
+};
@@ -0,0 +1,195 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpu_profiler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+std::string json_string(const std::string &text)
+{
+    std::ostringstream result;
+    result << '"';
+    for (auto character : text)
+    {
+        switch (character)
+        {
+        case '"':  result << "\\\""; break;
+        case '\\': result << "\\\\"; break;
+        case '\n': result << "\\n"; break;
+        case '\t': result << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(character) < 0x20)
+                result << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(character) << std::dec;
+            else
+                result << character;
+        }
+    }
+    result << '"';
+    return result.str();
+}
+
+// Writes counters (and instructions per cycle) as members of JSON object.
+void write_counters(std::ostream &trace, const uint64_t (&counters)[NN_CPU_COUNTER_COUNT])
+{
+    for (int counter = 0; counter < NN_CPU_COUNTER_COUNT; ++counter)
+        trace << ",\"" << nn_cpu_perf_counters::name(static_cast<NN_CPU_COUNTER>(counter)) << "\":" << counters[counter];
+    const auto cycles = counters[NN_CPU_COUNTER_CYCLES];
+    trace << ",\"ipc\":" << (cycles ? static_cast<double>(counters[NN_CPU_COUNTER_INSTRUCTIONS]) / cycles : 0.0);
+}
+} // namespace
+
+void nn_cpu_profiler::set_enabled(bool value)
+{
+    enabled.store(value);
+}
+
+bool nn_cpu_profiler::set_counters_enabled(bool value)
+{
+    if (value && !nn_cpu_perf_counters::available()) return false;
+    counters_enabled.store(value);
+    return true;
+}
+
+void nn_cpu_profiler::add(std::unique_ptr<nn_cpu_profile_item> item)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (records.size() < C_max_records)
+        records.push_back(std::move(item));
+    else
+        ++dropped;
+}
+
+void nn_cpu_profiler::write_trace(const std::string &path, const std::map<std::thread::id, std::string> &thread_names)
+{
+    std::vector<std::unique_ptr<nn_cpu_profile_item>> items;
+    uint64_t items_dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.swap(records);
+        items_dropped = dropped;
+        dropped = 0;
+    }
+
+    // workloads are shown as processes, threads that ran items as their threads
+    std::map<const void *, uint32_t> pids;
+    std::map<std::thread::id, uint32_t> tids;
+    std::set<std::pair<uint32_t, uint32_t>> named_threads;
+
+    // hardware counters summed over all executions of every work item (of the same type & name)
+    struct counters_summary_t
+    {
+        uint64_t executions;
+        uint64_t counters[NN_CPU_COUNTER_COUNT];
+    };
+    std::map<std::pair<std::string, std::string>, counters_summary_t> summaries;
+    for (auto &item : items)
+    {
+        if (!item->counted) continue;
+        auto &summary = summaries.insert({{item->type, item->name.empty() ? item->type : item->name}, counters_summary_t{}}).first->second;
+        ++summary.executions;
+        for (int counter = 0; counter < NN_CPU_COUNTER_COUNT; ++counter)
+            summary.counters[counter] += item->counters[counter].load();
+    }
+
+    std::ostringstream trace;
+    trace << std::fixed << std::setprecision(3);
+    trace << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_records\":" << items_dropped;
+    if (!summaries.empty())
+    {
+        trace << ",\"counters\":[";
+        const char *summary_separator = "";
+        for (auto &summary : summaries)
+        {
+            trace << summary_separator << "{\"name\":" << json_string(summary.first.second) << ",\"cat\":" << json_string(summary.first.first)
+                  << ",\"executions\":" << summary.second.executions;
+            write_counters(trace, summary.second.counters);
+            trace << '}';
+            summary_separator = ",";
+        }
+        trace << ']';
+    }
+    trace << "},\"traceEvents\":[";
+    const char *separator = "\n";
+    for (auto &item : items)
+    {
+        auto pid = pids.insert({item->workload, static_cast<uint32_t>(pids.size() + 1)});
+        auto tid = tids.insert({item->thread, static_cast<uint32_t>(tids.size() + 1)});
+        if (pid.second)
+        {
+            trace << separator << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid.first->second
+                  << ",\"args\":{\"name\":\"workload " << pid.first->second << " (batch " << item->batch << ")\"}}";
+            separator = ",\n";
+        }
+        if (named_threads.insert({pid.first->second, tid.first->second}).second)
+        {
+            auto name = thread_names.find(item->thread);
+            trace << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid.first->second << ",\"tid\":" << tid.first->second
+                  << ",\"args\":{\"name\":" << json_string(name != thread_names.end() ? name->second : "thread " + std::to_string(tid.first->second)) << "}}";
+            separator = ",\n";
+        }
+
+        trace << separator << "{\"name\":" << json_string(item->name.empty() ? item->type : item->name)
+              << ",\"cat\":" << json_string(item->type)
+              << ",\"ph\":\"X\",\"pid\":" << pid.first->second << ",\"tid\":" << tid.first->second
+              << ",\"ts\":" << (item->begin_ns - start_ns) / 1000.0
+              << ",\"dur\":" << (item->end_ns - item->begin_ns) / 1000.0
+              << ",\"args\":{\"execution\":" << item->execution
+              << ",\"jobs\":" << item->jobs.load()
+              << ",\"dispatch_us\":" << item->dispatch_ns.load() / 1000.0
+              << ",\"busy_us\":{";
+        for (size_t slot = 0; slot < item->busy_ns.size(); ++slot)
+        {
+            if (slot) trace << ',';
+            if (slot + 1 == item->busy_ns.size())
+                trace << "\"caller\":";
+            else
+                trace << "\"worker " << slot << "\":";
+            trace << item->busy_ns[slot].load() / 1000.0;
+        }
+        trace << '}';
+        if (item->counted)
+        {
+            uint64_t counters[NN_CPU_COUNTER_COUNT];
+            for (int counter = 0; counter < NN_CPU_COUNTER_COUNT; ++counter)
+                counters[counter] = item->counters[counter].load();
+            write_counters(trace, counters);
+        }
+        trace << "}}";
+        separator = ",\n";
+    }
+    trace << "\n]}\n";
+
+    std::ofstream file(path, std::ios::trunc);
+    file << trace.str();
+    if (!file) throw std::runtime_error("cannot write profiling trace to " + path);
+}
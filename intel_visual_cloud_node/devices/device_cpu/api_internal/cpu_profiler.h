@@ -0,0 +1,213 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpu_perf_counters.h"
+
+/* This file contains runtime profiler of CPU device.
+
+Profiling is switched on & off on running device with NN_PARAMETER_CPU_PROFILING. While it is on, every executed
+work item gets a record with:
+  - wall time of the item (begin & end, thread that ran it),
+  - dispatch time - for every job the item pushed to thread pool, time from push until first of its requests
+    started, summed over jobs,
+  - busy time of every thread of the pool - time it spent running requests of the item's jobs (nested jobs
+    are accounted to the item that pushed the outermost one).
+With NN_PARAMETER_CPU_PROFILING_COUNTERS also on, records get hardware counters (see cpu_perf_counters.h) of
+every thread that worked on the item - item's own thread for its whole duration, pool threads for requests of
+its jobs - so IPC or cache misses of a layer include the parallel part of its work.
+Setting NN_PARAMETER_CPU_PROFILING_TRACE writes records collected so far to a file in Chrome trace event format
+(chrome://tracing, JSON readable by dashboards) and clears them.
+
+Records are passed to thread pool through thread-local "current item", so layers do not need to know about
+profiling; when profiling is off, the only cost is a null check per pushed job.
+*/
+
+// Profile of single execution of work item.
+struct nn_cpu_profile_item
+{
+    nn_cpu_profile_item(uint32_t num_threads) : dispatch_ns(0), jobs(0), busy_ns(num_threads), counted(false)
+    {
+        for (auto &counter : counters) counter = 0;
+    }
+
+    const char             *type;       // type of work item
+    std::string             name;       // name of work item
+    const void             *workload;   // workload item belongs to
+    uint64_t                execution;  // number of workload execution on device
+    uint32_t                batch;
+    int64_t                 begin_ns;   // wall time (nn_cpu_profiler::now_ns)
+    int64_t                 end_ns;
+    std::thread::id         thread;     // thread running the item
+
+    std::atomic<uint64_t>   dispatch_ns;
+    std::atomic<uint32_t>   jobs;
+    std::vector<std::atomic<uint64_t>> busy_ns; // [worker], last entry: threads from outside of pool
+
+    bool                    counted;    // hardware counters were captured for this item
+    std::atomic<uint64_t>   counters[NN_CPU_COUNTER_COUNT];
+
+    // Adds counter deltas between two reads of one thread.
+    void add_counters(const nn_cpu_counter_values &begin, const nn_cpu_counter_values &end)
+    {
+        for (int counter = 0; counter < NN_CPU_COUNTER_COUNT; ++counter)
+            counters[counter] += end.value[counter] - begin.value[counter];
+    }
+};
+
+// Profile of job pushed to thread pool on behalf of work item.
+struct nn_cpu_profile_job
+{
+    nn_cpu_profile_item    *item;
+    int64_t                 pushed_ns;
+    std::atomic<bool>       started;
+};
+
+class nn_cpu_profiler
+{
+public:
+    nn_cpu_profiler() : enabled(false), counters_enabled(false), executions(0), dropped(0), start_ns(now_ns()) {}
+
+    void set_enabled(bool value);
+    bool is_enabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Returns false (and leaves counters off) if hardware counters are not available.
+    bool set_counters_enabled(bool value);
+    bool is_counters_enabled() const { return counters_enabled.load(std::memory_order_relaxed); }
+
+    // Steady clock time in nanoseconds; used for all timestamps of records.
+    static int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    uint64_t next_execution() { return executions++; }
+
+    // Stores finished record; records above limit are dropped (and counted in trace).
+    void add(std::unique_ptr<nn_cpu_profile_item> item);
+
+    // Writes collected records as Chrome trace & clears them; throws std::runtime_error if file cannot be written.
+    // Threads are named after thread_names (threads missing there get numbers).
+    void write_trace(const std::string &path, const std::map<std::thread::id, std::string> &thread_names);
+
+    // Work item profiled by current thread - jobs it pushes are accounted to it.
+    static nn_cpu_profile_item *&current_item()
+    {
+        static thread_local nn_cpu_profile_item *item = nullptr;
+        return item;
+    }
+
+    // True while current thread counts events for some item - nested reads would count them twice.
+    static bool &thread_counting()
+    {
+        static thread_local bool counting = false;
+        return counting;
+    }
+
+private:
+    static const size_t C_max_records = 1 << 20;
+
+    std::atomic<bool> enabled;
+    std::atomic<bool> counters_enabled;
+    std::atomic<uint64_t> executions;
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<nn_cpu_profile_item>> records;
+    uint64_t dropped;
+    const int64_t start_ns;  // trace timestamps are relative to it
+};
+
+// Profiles work item executed in its lifetime (if profiling is enabled); record is stored when scope ends.
+class nn_cpu_profile_scope
+{
+public:
+    nn_cpu_profile_scope(nn_cpu_profiler &profiler,
+                         uint32_t num_threads,
+                         const char *type,
+                         const std::string &name,
+                         const void *workload,
+                         uint64_t execution,
+                         uint32_t batch)
+        : profiler(profiler), outer_item(nn_cpu_profiler::current_item())
+    {
+        if (!profiler.is_enabled()) return;
+
+        item.reset(new nn_cpu_profile_item(num_threads));
+        item->type = type;
+        item->name = name;
+        item->workload = workload;
+        item->execution = execution;
+        item->batch = batch;
+        item->thread = std::this_thread::get_id();
+        nn_cpu_profiler::current_item() = item.get();
+        if (profiler.is_counters_enabled() && !nn_cpu_profiler::thread_counting())
+            item->counted = nn_cpu_profiler::thread_counting() = nn_cpu_perf_counters::read(begin_counters);
+        item->begin_ns = nn_cpu_profiler::now_ns();
+    }
+
+    ~nn_cpu_profile_scope()
+    {
+        if (!item) return;
+
+        item->end_ns = nn_cpu_profiler::now_ns();
+        if (item->counted)
+        {
+            nn_cpu_counter_values end_counters;
+            if (nn_cpu_perf_counters::read(end_counters))
+                item->add_counters(begin_counters, end_counters);
+            nn_cpu_profiler::thread_counting() = false;
+        }
+        nn_cpu_profiler::current_item() = outer_item;
+        try
+        {
+            profiler.add(std::move(item));
+        }
+        catch (...)
+        {
+        }
+    }
+
+private:
+    nn_cpu_profile_scope(const nn_cpu_profile_scope &) = delete;
+    nn_cpu_profile_scope &operator=(const nn_cpu_profile_scope &) = delete;
+
+    nn_cpu_profiler &profiler;
+    nn_cpu_profile_item *outer_item;
+    std::unique_ptr<nn_cpu_profile_item> item;
+    nn_cpu_counter_values begin_counters;
+};
@@ -0,0 +1,259 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpu_topology.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+#if defined(__linux__)
+// Memory policy constants from linux/mempolicy.h, defined here to avoid dependency on libnuma headers.
+const int C_mpol_bind = 2;
+const int C_mpol_interleave = 3;
+const unsigned C_mpol_mf_move = 1 << 1;
+
+bool read_line(const std::string& path, std::string& line)
+{
+    std::ifstream file(path);
+    return file && std::getline(file, line);
+}
+
+bool read_value(const std::string& path, uint32_t& value)
+{
+    std::string line;
+    if (!read_line(path, line)) return false;
+    std::istringstream stream(line);
+    return static_cast<bool>(stream >> value);
+}
+
+std::vector<nn_cpu_logical_processor> read_sysfs_topology()
+{
+    std::vector<nn_cpu_logical_processor> result;
+
+    std::string online;
+    if (!read_line("/sys/devices/system/cpu/online", online)) return result;
+
+    std::map<uint32_t, uint32_t> cpu_to_node;
+    std::string possible_nodes;
+    if (read_line("/sys/devices/system/node/online", possible_nodes))
+    {
+        for (auto node : nn_cpu_topology::parse_cpu_list(possible_nodes))
+        {
+            std::string cpulist;
+            if (read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", cpulist))
+                for (auto cpu : nn_cpu_topology::parse_cpu_list(cpulist))
+                    cpu_to_node[cpu] = node;
+        }
+    }
+
+    for (auto cpu : nn_cpu_topology::parse_cpu_list(online))
+    {
+        const std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        nn_cpu_logical_processor processor = { cpu, 0, cpu, 0 };
+        read_value(topology + "physical_package_id", processor.package);
+        read_value(topology + "core_id", processor.core);
+        auto node = cpu_to_node.find(cpu);
+        if (node != cpu_to_node.end()) processor.node = node->second;
+        result.push_back(processor);
+    }
+
+    return result;
+}
+#endif // defined(__linux__)
+
+std::vector<nn_cpu_logical_processor> flat_topology()
+{
+    std::vector<nn_cpu_logical_processor> result;
+    const uint32_t count = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32_t cpu = 0; cpu < count; ++cpu)
+        result.push_back(nn_cpu_logical_processor{ cpu, 0, cpu, 0 });
+    return result;
+}
+} // namespace
+
+nn_cpu_topology::nn_cpu_topology(const std::vector<nn_cpu_logical_processor>& processors)
+    : processors(processors)
+{
+}
+
+const nn_cpu_topology& nn_cpu_topology::get()
+{
+    static const nn_cpu_topology topology([]()
+    {
+        std::vector<nn_cpu_logical_processor> processors;
+#if defined(__linux__)
+        processors = read_sysfs_topology();
+#endif
+        return processors.empty() ? flat_topology() : processors;
+    }());
+
+    return topology;
+}
+
+std::vector<uint32_t> nn_cpu_topology::parse_cpu_list(const std::string& list)
+{
+    std::vector<uint32_t> result;
+    std::istringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ','))
+    {
+        uint32_t first = 0, last = 0;
+        char dash = 0;
+        std::istringstream range_stream(range);
+        if (!(range_stream >> first)) continue;
+        last = first;
+        if (range_stream >> dash && dash == '-' && !(range_stream >> last)) last = first;
+        for (uint32_t cpu = first; cpu <= last; ++cpu)
+            result.push_back(cpu);
+    }
+    return result;
+}
+
+std::vector<uint32_t> nn_cpu_topology::select_cpus(uint32_t num_threads, NN_CPU_THREAD_PLACEMENT placement) const
+{
+    std::vector<uint32_t> result;
+    if (placement == NN_CPU_THREAD_PLACEMENT_NONE || processors.empty() || num_threads == 0)
+        return result;
+
+    // Per socket: first hardware thread of every core, then second hardware threads and so on.
+    std::map<uint32_t, std::vector<uint32_t>> package_order;
+    {
+        std::map<uint32_t, std::map<uint32_t, std::vector<uint32_t>>> siblings; // package -> core -> cpus
+        for (auto& processor : processors)
+            siblings[processor.package][processor.core].push_back(processor.cpu);
+
+        for (auto& package : siblings)
+        {
+            size_t package_size = 0;
+            for (auto& core : package.second)
+                package_size += core.second.size();
+
+            auto& order = package_order[package.first];
+            for (size_t level = 0; order.size() < package_size; ++level)
+                for (auto& core : package.second)
+                    if (level < core.second.size())
+                        order.push_back(core.second[level]);
+        }
+    }
+
+    std::vector<uint32_t> order;
+    if (placement == NN_CPU_THREAD_PLACEMENT_COMPACT)
+    {
+        for (auto& package : package_order)
+            order.insert(order.end(), package.second.begin(), package.second.end());
+    }
+    else
+    {
+        for (size_t index = 0; order.size() < processors.size(); ++index)
+            for (auto& package : package_order)
+                if (index < package.second.size())
+                    order.push_back(package.second[index]);
+    }
+
+    // More threads than logical processors - wrap around.
+    for (uint32_t thread = 0; thread < num_threads; ++thread)
+        result.push_back(order[thread % order.size()]);
+
+    return result;
+}
+
+std::vector<uint32_t> nn_cpu_topology::get_nodes(const std::vector<uint32_t>& cpus) const
+{
+    std::set<uint32_t> nodes;
+    for (auto cpu : cpus)
+        for (auto& processor : processors)
+            if (processor.cpu == cpu)
+                nodes.insert(processor.node);
+
+    return std::vector<uint32_t>(nodes.begin(), nodes.end());
+}
+
+uint32_t nn_cpu_topology::get_num_nodes() const
+{
+    std::set<uint32_t> nodes;
+    for (auto& processor : processors)
+        nodes.insert(processor.node);
+
+    return static_cast<uint32_t>(nodes.size());
+}
+
+bool nn_cpu_pin_thread(std::thread& thread, int32_t cpu)
+{
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (cpu >= 0)
+    {
+        CPU_SET(cpu, &cpu_set);
+    }
+    else
+    {
+        for (auto& processor : nn_cpu_topology::get().get_processors())
+            CPU_SET(processor.cpu, &cpu_set);
+    }
+
+    return 0 == pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set);
+#else
+    return false;
+#endif
+}
+
+bool nn_cpu_bind_memory(void* buffer, size_t size, const std::vector<uint32_t>& nodes)
+{
+#if defined(__linux__) && defined(__NR_mbind)
+    if (buffer == nullptr || nodes.empty() || nn_cpu_topology::get().get_num_nodes() < 2)
+        return true;
+
+    // Only whole pages inside of the range are bound, pages shared with neighbouring allocations are left alone.
+    const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(buffer) + page_size - 1) / page_size * page_size;
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(buffer) + size) / page_size * page_size;
+    if (end <= begin) return true;
+
+    const size_t bits_per_mask = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> mask(*std::max_element(nodes.begin(), nodes.end()) / bits_per_mask + 1, 0);
+    for (auto node : nodes)
+        mask[node / bits_per_mask] |= 1ul << (node % bits_per_mask);
+
+    const int mode = nodes.size() == 1 ? C_mpol_bind : C_mpol_interleave;
+    return 0 == syscall(__NR_mbind, begin, end - begin, mode, mask.data(), mask.size() * bits_per_mask + 1, C_mpol_mf_move);
+#else
+    return false;
+#endif
+}
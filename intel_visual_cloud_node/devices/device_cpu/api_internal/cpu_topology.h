@@ -0,0 +1,85 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "../../api/nn_device_interface_0.h"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* This file contains description of processor topology used to place CPU device threads & buffers.
+
+Topology is read once from sysfs (/sys/devices/system/cpu, /sys/devices/system/node).
+On systems where it is not available every logical processor is treated as separate core
+of single socket and single NUMA node, and placement requests become no-ops.
+*/
+
+// Single logical processor.
+struct nn_cpu_logical_processor
+{
+    uint32_t cpu;       // logical processor id (as used by affinity masks)
+    uint32_t package;   // physical socket
+    uint32_t core;      // physical core within socket
+    uint32_t node;      // NUMA node
+};
+
+class nn_cpu_topology
+{
+public:
+    nn_cpu_topology() {}
+    nn_cpu_topology(const std::vector<nn_cpu_logical_processor>& processors);
+
+    // Topology of the machine, read on first call.
+    static const nn_cpu_topology& get();
+
+    // Parses sysfs list format, e.g. "0-3,8,10-11".
+    static std::vector<uint32_t> parse_cpu_list(const std::string& list);
+
+    // Selects logical processors for given number of threads, index 0 is used by thread pushing jobs.
+    // Returns empty vector for NN_CPU_THREAD_PLACEMENT_NONE.
+    std::vector<uint32_t> select_cpus(uint32_t num_threads, NN_CPU_THREAD_PLACEMENT placement) const;
+
+    // NUMA nodes used by given logical processors, sorted & unique.
+    std::vector<uint32_t> get_nodes(const std::vector<uint32_t>& cpus) const;
+
+    uint32_t get_num_nodes() const;
+
+    const std::vector<nn_cpu_logical_processor>& get_processors() const { return processors; }
+
+private:
+    std::vector<nn_cpu_logical_processor> processors;
+};
+
+// Pins thread to single logical processor, or to all of them if cpu is negative. Returns false on failure.
+bool nn_cpu_pin_thread(std::thread& thread, int32_t cpu);
+
+// Binds pages of memory range to given NUMA nodes (interleaved if more than one), moving already touched pages.
+// Does nothing on single node systems. Returns false on failure.
+bool nn_cpu_bind_memory(void* buffer, size_t size, const std::vector<uint32_t>& nodes);
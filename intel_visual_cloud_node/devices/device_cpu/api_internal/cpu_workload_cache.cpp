@@ -0,0 +1,276 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpu_workload_cache.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+const uint64_t C_page_size = 4096;
+const char C_magic[8] = {'I', 'D', 'L', 'F', 'W', 'L', 'C', '\0'};
+
+struct file_header_t
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t header_size;           // sizes of structures written by saving process
+    uint32_t parameter_size;
+    uint32_t tuning_size;
+    uint64_t fingerprint;
+    uint32_t batch;
+    uint32_t input_count;
+    uint32_t output_count;
+    uint32_t parameter_count;
+    uint32_t tuning_count;
+    uint32_t reserved;
+    uint64_t file_size;
+};
+
+uint64_t align_to_page(uint64_t size) { return (size + C_page_size - 1) / C_page_size * C_page_size; }
+
+uint64_t metadata_size(const file_header_t &header)
+{
+    return sizeof(file_header_t) +
+           sizeof(uint32_t) * (uint64_t(header.input_count) + header.output_count) +
+           sizeof(nn_cpu_workload_cache_parameter_t) * uint64_t(header.parameter_count) +
+           sizeof(nn_cpu_tuning_t) * uint64_t(header.tuning_count);
+}
+} // namespace
+
+nn_cpu_workload_cache::nn_cpu_workload_cache()
+    : fingerprint(0), batch(0), mapping(nullptr), mapping_size(0), allocation(nullptr)
+{
+}
+
+nn_cpu_workload_cache::~nn_cpu_workload_cache() { close(); }
+
+void nn_cpu_workload_cache::close()
+{
+#if defined(__linux__)
+    if (mapping && !allocation) munmap(mapping, mapping_size);
+#endif
+    delete[] allocation;
+    mapping = nullptr;
+    mapping_size = 0;
+    allocation = nullptr;
+}
+
+void nn_cpu_workload_cache::save(const std::string &path,
+                                 uint64_t fingerprint,
+                                 uint32_t batch,
+                                 const std::vector<NN_WORKLOAD_DATA_TYPE> &input_format,
+                                 const std::vector<NN_WORKLOAD_DATA_TYPE> &output_format,
+                                 const std::vector<nn_workload_data_t *> &parameters,
+                                 const std::vector<nn_cpu_tuning_t> &tunings)
+{
+    file_header_t header = {};
+    std::memcpy(header.magic, C_magic, sizeof(C_magic));
+    header.version = version;
+    header.header_size = sizeof(file_header_t);
+    header.parameter_size = sizeof(nn_cpu_workload_cache_parameter_t);
+    header.tuning_size = sizeof(nn_cpu_tuning_t);
+    header.fingerprint = fingerprint;
+    header.batch = batch;
+    header.input_count = static_cast<uint32_t>(input_format.size());
+    header.output_count = static_cast<uint32_t>(output_format.size());
+    header.parameter_count = static_cast<uint32_t>(parameters.size());
+    header.tuning_count = static_cast<uint32_t>(tunings.size());
+
+    // place data of every buffer on its own pages, so it can be used in place after mapping;
+    // descriptors are value-initialized, so padding written to file is zeroed
+    std::vector<nn_cpu_workload_cache_parameter_t> descriptors(parameters.size());
+    uint64_t offset = align_to_page(metadata_size(header));
+    for (size_t index = 0; index < parameters.size(); ++index)
+    {
+        auto &descriptor = descriptors[index];
+        descriptor.lengths = parameters[index]->parent->lengths;
+        descriptor.layout = parameters[index]->parent->layout;
+        descriptor.view_begin = parameters[index]->view_begin;
+        descriptor.view_end = parameters[index]->view_end;
+        descriptor.offset = offset;
+        descriptor.size = parameters[index]->parent->buffer_size;
+        offset = align_to_page(offset + descriptor.size);
+    }
+    header.file_size = offset;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("cannot create workload cache file: " + path);
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (auto format : input_format)
+    {
+        uint32_t value = format;
+        file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    for (auto format : output_format)
+    {
+        uint32_t value = format;
+        file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    if (!descriptors.empty())
+        file.write(reinterpret_cast<const char *>(descriptors.data()), sizeof(descriptors[0]) * descriptors.size());
+    if (!tunings.empty())
+        file.write(reinterpret_cast<const char *>(tunings.data()), sizeof(tunings[0]) * tunings.size());
+
+    const std::vector<char> zeros(C_page_size, 0);
+    uint64_t position = metadata_size(header);
+    for (size_t index = 0; index < parameters.size(); ++index)
+    {
+        file.write(zeros.data(), descriptors[index].offset - position);
+        file.write(static_cast<const char *>(parameters[index]->parent->data_buffer), descriptors[index].size);
+        position = descriptors[index].offset + descriptors[index].size;
+    }
+    file.write(zeros.data(), header.file_size - position);
+
+    file.close();
+    if (!file) throw std::runtime_error("cannot write workload cache file: " + path);
+}
+
+bool nn_cpu_workload_cache::open(const std::string &path)
+{
+    close();
+
+    uint64_t size = 0;
+#if defined(__linux__)
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+    struct stat status;
+    if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+    {
+        size = static_cast<uint64_t>(status.st_size);
+        // private mapping: pages are shared with page cache until something writes to them
+        void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+        if (address != MAP_FAILED)
+        {
+            mapping = static_cast<uint8_t *>(address);
+            mapping_size = size;
+        }
+    }
+    ::close(descriptor);
+#endif
+    if (!mapping)
+    {
+        // no mapping available - read file into page aligned memory
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        size = static_cast<uint64_t>(file.tellg());
+        if (size == 0) return false;
+        allocation = new uint8_t[size + C_page_size];
+        mapping = allocation + (C_page_size - reinterpret_cast<uintptr_t>(allocation) % C_page_size) % C_page_size;
+        mapping_size = size;
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char *>(mapping), size))
+        {
+            close();
+            return false;
+        }
+    }
+
+    file_header_t header;
+    if (size < sizeof(header))
+    {
+        close();
+        return false;
+    }
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.magic, C_magic, sizeof(C_magic)) != 0 ||
+        header.version != version ||
+        header.header_size != sizeof(file_header_t) ||
+        header.parameter_size != sizeof(nn_cpu_workload_cache_parameter_t) ||
+        header.tuning_size != sizeof(nn_cpu_tuning_t) ||
+        header.file_size != size ||
+        metadata_size(header) > size)
+    {
+        close();
+        return false;
+    }
+
+    auto position = mapping + sizeof(header);
+    fingerprint = header.fingerprint;
+    batch = header.batch;
+    input_format.resize(header.input_count);
+    for (auto &format : input_format)
+    {
+        uint32_t value;
+        std::memcpy(&value, position, sizeof(value));
+        format = static_cast<NN_WORKLOAD_DATA_TYPE>(value);
+        position += sizeof(value);
+    }
+    output_format.resize(header.output_count);
+    for (auto &format : output_format)
+    {
+        uint32_t value;
+        std::memcpy(&value, position, sizeof(value));
+        format = static_cast<NN_WORKLOAD_DATA_TYPE>(value);
+        position += sizeof(value);
+    }
+    parameters.resize(header.parameter_count);
+    if (!parameters.empty()) std::memcpy(parameters.data(), position, sizeof(parameters[0]) * parameters.size());
+    position += sizeof(nn_cpu_workload_cache_parameter_t) * parameters.size();
+    tunings.resize(header.tuning_count);
+    if (!tunings.empty()) std::memcpy(tunings.data(), position, sizeof(tunings[0]) * tunings.size());
+
+    for (auto &parameter : parameters)
+    {
+        bool valid = parameter.offset % C_page_size == 0 && parameter.offset <= size && parameter.size <= size - parameter.offset;
+        for (uint32_t coord = 0; coord < NN_DIMENSION_COUNT; ++coord)
+            valid &= parameter.view_begin.t[coord] <= parameter.view_end.t[coord] &&
+                     parameter.view_end.t[coord] < parameter.lengths.t[coord];
+        if (!valid)
+        {
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+nn_workload_data_t *nn_cpu_workload_cache::create_parameter(size_t index)
+{
+    const auto &parameter = parameters.at(index);
+    /* NOTE: template type is disregarded when buffer is given, actual type is specified in layout */
+    auto data = new nn::nn_workload_data_t<float>(mapping + parameter.offset, parameter.lengths, parameter.layout);
+    if (data->parent->buffer_size > parameter.size)
+    {
+        delete data;
+        throw std::runtime_error("parameter buffer in workload cache is truncated");
+    }
+    data->view_begin = parameter.view_begin;
+    data->view_end = parameter.view_end;
+    return data;
+}
@@ -0,0 +1,110 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "../../api/nn_device_interface_0.h"
+#include "../../common/nn_workload_data.h"
+#include "cpu_autotuner.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* This file contains cache of compiled workloads.
+
+Compilation of big workflow is dominated by repacking of weights into layouts required by kernels and by
+autotuning. Cache file stores results of both: packed parameter buffers (weights, biases, factors) of work items
+and execution parameters chosen for tunable primitives. New process creates workload from cache and workflow
+with the same topology; packed parameters are used directly from mapped file, so its pages are shared between
+processes and loaded lazily.
+
+File layout (native endianness, all offsets in bytes from beginning of file):
+    header
+    input formats, output formats                   [uint32_t each]
+    parameter descriptors                           [one per parameter buffer, in order of execution of items]
+    tuning choices                                  [one per tunable item, in order of execution of items]
+    padding to page boundary
+    data of parameter buffers                       [each one starts on page boundary]
+*/
+
+// Description of single parameter buffer stored in cache.
+struct nn_cpu_workload_cache_parameter_t
+{
+    nn_workload_data_coords_t lengths;      // lengths of buffer
+    nn_workload_data_layout_t layout;       // layout of buffer
+    nn_workload_data_coords_t view_begin;   // view of buffer used by work item
+    nn_workload_data_coords_t view_end;
+    uint64_t offset;                        // position of data in file, page aligned
+    uint64_t size;                          // size of data
+};
+
+class nn_cpu_workload_cache
+{
+public:
+    // Version of file format & of layouts of stored parameters; files of other versions are rejected.
+    // Stored weights are mapped as they are, so it is increased with every change of weights packing of primitives
+    // (and of meaning of stored tunings):
+    //   1 - initial
+    //   2 - fully connected weights packed in panels of 12 outputs for batched GEMM
+    //   3 - stored convolution tuning (kernel 0, partition 0) no longer means implicit GEMM on AVX-512 devices
+    static const uint32_t version = 3;
+
+    nn_cpu_workload_cache();
+    ~nn_cpu_workload_cache();
+
+    // Writes cache file; throws std::runtime_error if file cannot be written.
+    static void save(const std::string &path,
+                     uint64_t fingerprint,
+                     uint32_t batch,
+                     const std::vector<NN_WORKLOAD_DATA_TYPE> &input_format,
+                     const std::vector<NN_WORKLOAD_DATA_TYPE> &output_format,
+                     const std::vector<nn_workload_data_t *> &parameters,
+                     const std::vector<nn_cpu_tuning_t> &tunings);
+
+    // Maps cache file; returns false if file cannot be read or is not a valid cache of this version.
+    bool open(const std::string &path);
+
+    // Creates view of parameter buffer with data in mapped file; it is valid as long as cache is alive.
+    nn_workload_data_t *create_parameter(size_t index);
+
+    uint64_t fingerprint;
+    uint32_t batch;
+    std::vector<NN_WORKLOAD_DATA_TYPE> input_format;
+    std::vector<NN_WORKLOAD_DATA_TYPE> output_format;
+    std::vector<nn_cpu_workload_cache_parameter_t> parameters;
+    std::vector<nn_cpu_tuning_t> tunings;
+
+private:
+    nn_cpu_workload_cache(const nn_cpu_workload_cache &) = delete;
+    nn_cpu_workload_cache &operator=(const nn_cpu_workload_cache &) = delete;
+    void close();
+
+    uint8_t *mapping;       // contents of file
+    uint64_t mapping_size;
+    uint8_t *allocation;    // memory holding contents if file could not be mapped
+};
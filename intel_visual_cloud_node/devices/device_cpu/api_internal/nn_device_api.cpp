@@ -46,7 +46,10 @@ nn_device_interface_0_t device_interface_0 = {
     nn_workflow_item_delete_0_function,
     nn_device_parameter_get_0_function,
     nn_device_parameter_set_0_function,
-    nn_translate_api_status_0_function
+    nn_translate_api_status_0_function,
+    nn_workload_wait_0_function,
+    nn_workload_save_0_function,
+    nn_workload_load_0_function
 };
 
 /* loads & initializes device
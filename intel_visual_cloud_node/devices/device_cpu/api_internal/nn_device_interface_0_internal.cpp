@@ -29,6 +29,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../common/nn_workload_data.h"
 #include "../core/layer_convolution_avx2.h"
 #include "../core/layer_convolution_pooling_avx2.h"
+#include "../core/layer_convolution_winograd_avx2.h"
 #include "../core/layer_fully_connected_avx2.h"
 #include "../core/layer_softmax_avx2.h"
 #include "../core/layer_pooling_avx2.h"
@@ -46,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <memory>
 #include <algorithm>
 #include <numeric>
+#include <stdexcept>
 #include <immintrin.h>
 
 #define ENABLE_WORKLOAD_MONITORING 0
@@ -56,6 +58,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <exception>
+#include <mutex>
+#include <chrono>
+#include <limits>
 
 void nn_workload_item_data_marshaling(nn_workload_item* item, int stage_num) {
 
@@ -268,6 +274,34 @@ static void nn_workflow_compile_0_function_calculate_output_padding(const nn_wor
     }
 }
 
+/* returns pooling that will be fused with convolution (its only user), nullptr if there is none
+   Fused item uses convolution_pooling_f32 primitive, so convolution must not get Winograd one & its weights. */
+static nn_workflow_item_t *nn_workflow_compile_0_function_fused_pooling(nn_workflow_item_t *flow_item) {
+    if(flow_item->type!=NN_WORK_ITEM_TYPE_CONVOLUTION || flow_item->use_count!=1) return nullptr;
+    auto pool_flow_item = flow_item->use[0];
+    if(pool_flow_item->type!=NN_WORK_ITEM_TYPE_POOLING || pool_flow_item->input_count!=1) return nullptr;
+    auto &pooling = pool_flow_item->arguments.forward_pooling;
+    if(pooling.mode!=NN_POOLING_MODE_MAX && pooling.mode!=NN_POOLING_MODE_AVERAGE) return nullptr;
+    return pool_flow_item;
+}
+
+/* tile size of Winograd algorithm used for convolution, 0 if direct one is used */
+static uint32_t nn_workflow_compile_0_function_winograd_tile_size(nn_workflow_item_t *flow_item, nn_device_internal *device) {
+    auto &args = flow_item->arguments.forward_convolution;
+    if(!args.weights || args.weights->dimension!=4 || nn_workflow_compile_0_function_fused_pooling(flow_item)) return 0;
+    return layer::convolution_winograd_f32::choose_tile_size(
+        args.weights->size[0],
+        args.weights->size[1],
+        args.stride[0],
+        args.stride[1],
+        args.weights->size[2],
+        args.weights->size[3],
+        flow_item->output_format.format_1d.size[0],
+        flow_item->output_format.format >= NN_DATA_FORMAT_2D ? flow_item->output_format.format_2d.size[1] : 1,
+        args.activation,
+        device->convolution_tolerance);
+}
+
 void nn_workflow_compile_0_function_create_primitive(nn_workload_item_t *load_item,
                                                      nn_workflow_item_t *flow_item,
                                                      uint32_t batch,
@@ -279,6 +313,22 @@ void nn_workflow_compile_0_function_create_primitive(nn_workload_item_t *load_it
                                                                      : 1) == args.weights->size[3]);
         assert(args.padding == NN_PADDING_MODE_DATA_OR_ZERO);
 
+        const auto winograd_tile_size = nn_workflow_compile_0_function_winograd_tile_size(flow_item, device);
+        if(winograd_tile_size) {
+            load_item->primitive = layer::convolution_winograd_f32::create(
+                winograd_tile_size,
+                args.weights->size[2],
+                args.weights->size[3],
+                flow_item->output_format.format_1d.size[0],
+                flow_item->output_format.format >= NN_DATA_FORMAT_2D ? flow_item->output_format.format_2d.size[1] : 1,
+                args.center_offset[0],
+                args.center_offset[1],
+                args.activation,
+                batch,
+                reinterpret_cast<nn_device_t *>(device));
+            break;
+        }
+
         load_item->primitive = layer::convolution_f32::create(
             args.weights->size[0],
             args.weights->size[1],
@@ -410,7 +460,8 @@ void nn_workflow_compile_0_function_copy_item(
              nn_workflow_item_t *flow_item,
              uint32_t batch,
              std::map<nn_workflow_item_t *, nn_workload_item_t *> &flow_to_work,
-             nn_device_internal *device
+             nn_device_internal *device,
+             bool pack_parameters   /* false if parameters are set later (taken from workload cache) */
              ){
 
             // copy name
@@ -701,7 +752,11 @@ void nn_workflow_compile_0_function_copy_item(
             assert(sizeof(load_item->arguments) >= sizeof(flow_item->arguments));
             std::memcpy(&load_item->arguments, &flow_item->arguments, sizeof(load_item->arguments));
 
-            switch(load_item->type) {
+            if(!pack_parameters) {
+                auto parameters = nn_workload_item_parameter_buffers(load_item);
+                nn_workload_item_set_parameter_buffers(load_item, std::vector<nn_workload_data_t *>(parameters.size(), nullptr));
+            }
+            else switch(load_item->type) {
             case NN_WORK_ITEM_TYPE_CONVOLUTION: {
                 load_item->arguments.forward_convolution.biases =
                     static_cast<layer::convolution_f32 *>(load_item->primitive)
@@ -915,297 +970,846 @@ void nn_workflow_compile_0_function_copy_item(
 } // end of function nn_workflow_compile_0_function_copy_item
 } // end of namespace
 
-void nn_workflow_compile_0_function_add_conversions(
-    nn_workload_item_t *load_item,
-    nn_workflow_item_t *flow_item,
-    uint32_t            batch,
-    NN_WORKLOAD_DATA_TYPE  *input_format,   /* array containing formats of inputs */
-    NN_WORKLOAD_DATA_TYPE  *output_format  /* array containing formats of outputs */
-    ){
-    if (batch > 1){
-        // add type2 conversions
-        auto init_type2_conversion = [&batch, &flow_item, &load_item] {
-            auto conversion = new nn_workload_item_t;
-            conversion->type = NN_WORK_ITEM_TYPE_CONVERT_DATA_LAYOUT;
-            conversion->arguments.convert_data_layout.type = 2;
-
-            nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
-                                                {0, 0, 0, 0, 0, 0}, // alignment
-                                                {NN_DATA_COORD_n, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_p, NN_DATA_COORD_q}, // ordering
-                                                NN_DATATYPE_INT32};
-
-            const uint32_t OutBlock = 2;
-            nn_workload_data_coords_t size = {
-                batch,
-                1,
-                1,
-                flow_item->output_format.format_1d.size[0] / OutBlock,
-                OutBlock,
-                1};
-
-            conversion->output = new nn::nn_workload_data_t<std::int32_t>(size, layout);
-            conversion->input.push_back(load_item);
-            return conversion;
-        };
-
-        if (load_item->output != nullptr && load_item->output->parent->layout.ordering.t[0] != NN_DATA_COORD_n) {
-            for (auto &next_load_item : load_item->use) {
-                if (next_load_item->type == NN_WORK_ITEM_TYPE_SOFTMAX_FIXEDPOINT) {
-                    auto type2_conversion = init_type2_conversion();
-                    type2_conversion->name = std::string("convert_layout2_before_") + next_load_item->name;
-
-                    for (auto &useinput : next_load_item->input)
-                    if (useinput == load_item) {
-                        useinput = type2_conversion;
-                        type2_conversion->use.push_back(next_load_item);
-                    }
-
-                    next_load_item = type2_conversion;
-                }
-            }
-        }
+/* conversion of data layout needed between producer & consumer items: its type or -1 if consumer loads layout
+   producer stores; first matching rule applies */
+static int nn_workflow_compile_0_function_required_conversion(
+    nn_workload_item_t     *producer,
+    nn_workflow_item_t     *producer_flow_item,
+    nn_workload_item_t     *consumer,
+    uint32_t                batch,
+    NN_WORKLOAD_DATA_TYPE  *input_format) {
+    const auto output = producer->output;
+    if (batch > 1) {
+        // int32 fully connected -> softmax
+        if (output != nullptr && output->parent->layout.ordering.t[0] != NN_DATA_COORD_n &&
+            consumer->type == NN_WORK_ITEM_TYPE_SOFTMAX_FIXEDPOINT)
+            return 2;
+
+        // int16 convolution -> fully connected
+        if (output != nullptr && output->parent->layout.ordering.t[1] != NN_DATA_COORD_n &&
+            (consumer->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN ||
+             consumer->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN))
+            return 3;
+
+        // float batch8 conversion between conv and fc
+        if (output != nullptr && output->parent->layout.ordering.t[0] != NN_DATA_COORD_n &&
+            (producer->type == NN_WORK_ITEM_TYPE_CONVOLUTION ||
+             producer->type == NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2 ||
+             producer->type == NN_WORK_ITEM_TYPE_POOLING) &&
+            consumer->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED &&
+            consumer->output->parent->layout.ordering.t[0] == NN_DATA_COORD_n)
+            return 4;
+
+        // float input -> layers loading batch-first layout
+        if (producer->type == NN_WORK_ITEM_TYPE_INPUT &&
+            (consumer->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED || consumer->type == NN_WORK_ITEM_TYPE_SOFTMAX))
+            return 4;
+    }
+    else { // batch == 1
+        // non-batched int16 convolution -> fully connected
+        if (output != nullptr && producer_flow_item->output_format.format == NN_DATA_FORMAT_3D &&
+            (consumer->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN ||
+             consumer->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN))
+            return 0;
+    }
 
-        // add type3 conversions
-        auto init_type3_conversion = [&batch, &flow_item, &load_item] {
-            auto conversion = new nn_workload_item_t;
-            conversion->type = NN_WORK_ITEM_TYPE_CONVERT_DATA_LAYOUT;
-            conversion->arguments.convert_data_layout.type = 3;
+    // input zxyn -> z<block>xyzn for int16 layers
+    if (producer->type == NN_WORK_ITEM_TYPE_INPUT &&
+        (consumer->type == NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN ||
+         consumer->type == NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT ||
+         consumer->type == NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT ||
+         consumer->type == NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT)) {
+        assert(input_format[producer->arguments.input.index] == NN_WORKLOAD_DATA_TYPE_I16_ZXY); // TODO support other formats
+        return 5;
+    }
 
-            nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
-                                                {0, 0, 0, 0, 0, 0}, // alignment
-                                                {NN_DATA_COORD_p, NN_DATA_COORD_n, NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_q}, // ordering
-                                                NN_DATATYPE_INT16};
+    // z<block>xyzn -> zxyn for int16 layers writing workload output
+    if (((producer->type == NN_WORK_ITEM_TYPE_MERGE && producer->input[0]->output->parent->layout.data_type == NN_DATATYPE_INT16) ||
+         producer->type == NN_WORK_ITEM_TYPE_CONVERT_FLOAT_TO_INT16_FIXEDPOINT ||
+         producer->type == NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN ||
+         producer->type == NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT ||
+         producer->type == NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT ||
+         producer->type == NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT) &&
+        consumer->type == NN_WORK_ITEM_TYPE_OUTPUT)
+        return 6;
+
+    return -1;
+}
 
-            const uint32_t OutBlock = 2;
-            nn_workload_data_coords_t size = {
-                batch,
-                1,
-                1,
-                flow_item->output_format.format_3d.size[0] * flow_item->output_format.format_3d.size[1] * flow_item->output_format.format_3d.size[2] / OutBlock,
-                OutBlock,
-                1};
-
-            conversion->output = new nn::nn_workload_data_t<std::int16_t>(size, layout);
-            conversion->input.push_back(load_item);
-            return conversion;
-        };
+/* creates conversion of producer's output to layout of given conversion type */
+static nn_workload_item_t *nn_workflow_compile_0_function_create_conversion(
+    int                 type,
+    nn_workload_item_t *producer,
+    nn_workflow_item_t *producer_flow_item,
+    uint32_t            batch) {
+    const auto &format = producer_flow_item->output_format;
+    const uint32_t size_x = format.format_1d.size[0];
+    const uint32_t size_y = format.format >= NN_DATA_FORMAT_2D ? format.format_2d.size[1] : 1;
+    const uint32_t size_z = format.format >= NN_DATA_FORMAT_3D ? format.format_3d.size[2] : 1;
+
+    std::unique_ptr<nn_workload_item_t> conversion(new nn_workload_item_t);
+    conversion->type = NN_WORK_ITEM_TYPE_CONVERT_DATA_LAYOUT;
+    conversion->arguments.convert_data_layout.type = type;
+    conversion->primitive = nullptr;
+
+    switch (type) {
+    case 0:   // non-batched int16 convolution -> fully connected
+    case 3: { // int16 convolution -> fully connected
+        nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
+                                            {0, 0, 0, 0, 0, 0}, // alignment
+                                            {NN_DATA_COORD_p, NN_DATA_COORD_n, NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_q}, // ordering
+                                            NN_DATATYPE_INT16};
 
-        if (load_item->output != nullptr && load_item->output->parent->layout.ordering.t[1] != NN_DATA_COORD_n) {
-            for (auto &next_load_item : load_item->use) {
-                if (next_load_item->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN ||
-                    next_load_item->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN) {
-                    auto type3_conversion = init_type3_conversion();
-                    type3_conversion->name = std::string("convert_layout3_before_") + next_load_item->name;
-
-                    for (auto &useinput : next_load_item->input)
-                    if (useinput == load_item) {
-                        useinput = type3_conversion;
-                        type3_conversion->use.push_back(next_load_item);
-                    }
+        const uint32_t OutBlock = 2;
+        nn_workload_data_coords_t size = {batch, 1, 1, format.format_3d.size[0] * format.format_3d.size[1] * format.format_3d.size[2] / OutBlock, OutBlock, 1};
+        conversion->output = new nn::nn_workload_data_t<std::int16_t>(size, layout);
+        break;
+    }
+    case 2: { // int32 fully connected -> softmax
+        nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
+                                            {0, 0, 0, 0, 0, 0}, // alignment
+                                            {NN_DATA_COORD_n, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_p, NN_DATA_COORD_q}, // ordering
+                                            NN_DATATYPE_INT32};
 
-                    next_load_item = type3_conversion;
-                }
-            }
-        }
+        const uint32_t OutBlock = 2;
+        nn_workload_data_coords_t size = {batch, 1, 1, size_x / OutBlock, OutBlock, 1};
+        conversion->output = new nn::nn_workload_data_t<std::int32_t>(size, layout);
+        break;
+    }
+    case 4: { // float convolution or input -> fully connected
+        nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
+                                            {0, 0, 0, 0, 0, 0}, // alignment
+                                            {NN_DATA_COORD_n, NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_p, NN_DATA_COORD_q}, // ordering
+                                            NN_DATATYPE_FLOAT};
 
-        // Add type4 conversions - float batch8 conversion between conv and fc
-        auto init_type4_conversion = [&batch, &flow_item, &load_item]
-        {
-            auto conversion = new nn_workload_item_t;
-            conversion->type = NN_WORK_ITEM_TYPE_CONVERT_DATA_LAYOUT;
-            conversion->arguments.convert_data_layout.type = 4;
+        nn_workload_data_coords_t size = {batch, size_x, size_y, size_z, 1, 1};
+        conversion->output = new nn::nn_workload_data_t<float>(size, layout);
+        break;
+    }
+    case 5: { // input zxyn -> z<block>xyzn for int16 layers
+        nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
+                                            {0, 0, 0, 0, 0, 0}, // alignment
+                                            {NN_DATA_COORD_p, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_n, NN_DATA_COORD_q}, // ordering
+                                            NN_DATATYPE_INT16};
 
-            nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
-                                                {0, 0, 0, 0, 0, 0}, // alignment
-                                                {NN_DATA_COORD_n, NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_p, NN_DATA_COORD_q}, // ordering
-                                                NN_DATATYPE_FLOAT};
+        const uint32_t z_block = size_z > 4 ? 8 : 4;
+        nn_workload_data_coords_t size = {batch, size_x, size_y, (size_z - 1) / z_block + 1, z_block, 1};
+        conversion->output = new nn::nn_workload_data_t<float>(size, layout);
+        break;
+    }
+    case 6: { // z<block>xyzn -> zxyn
+        nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
+                                            {0, 0, 0, 0, 0, 0}, // alignment
+                                            {NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_n, NN_DATA_COORD_p, NN_DATA_COORD_q}, // ordering
+                                            NN_DATATYPE_INT16};
 
-            nn_workload_data_coords_t size = {
-                batch,
-                flow_item->output_format.format_1d.size[0],
-                flow_item->output_format.format >= NN_DATA_FORMAT_2D ? flow_item->output_format.format_2d.size[1] : 1,
-                flow_item->output_format.format >= NN_DATA_FORMAT_3D ? flow_item->output_format.format_3d.size[2] : 1,
-                1,
-                1 };
+        nn_workload_data_coords_t size = {batch, size_x, size_y, size_z, 1, 1};
+        conversion->output = new nn::nn_workload_data_t<float>(size, layout);
+        break;
+    }
+    default:
+        assert(0);
+    }
 
-            conversion->output = new nn::nn_workload_data_t<float>(size, layout);
-            conversion->input.push_back(load_item);
-            return conversion;
-        };
+    conversion->input.push_back(producer);
+    return conversion.release();
+}
 
-        if (load_item->output != nullptr &&
-            load_item->output->parent->layout.ordering.t[0] != NN_DATA_COORD_n &&
-            (load_item->type == NN_WORK_ITEM_TYPE_CONVOLUTION ||
-             load_item->type == NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2 ||
-             load_item->type == NN_WORK_ITEM_TYPE_POOLING))
-        {
-            for (auto &next_load_item : load_item->use)
-            {
-                if (next_load_item->output->parent->layout.ordering.t[0] == NN_DATA_COORD_n &&
-                    next_load_item->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED)
-                {
-                    auto type4_conversion = init_type4_conversion();
-                    type4_conversion->name = std::string("convert_layout4_before_") + next_load_item->name;
+/* true if producer's kernel can store layout of conversion type itself */
+static bool nn_workflow_compile_0_function_stores_conversion(nn_workload_item_t *producer, int type) {
+    if (type != 4 || producer->type != NN_WORK_ITEM_TYPE_CONVOLUTION) return false;
 
-                    for (auto &useinput : next_load_item->input)
-                    if (useinput == load_item)
-                    {
-                        useinput = type4_conversion;
-                        type4_conversion->use.push_back(next_load_item);
-                    }
+    // fused convolution & pooling stores pooled values one by one, in any untiled layout of unpadded buffer
+    const auto output = producer->output;
+    for (auto dimension = 0u; dimension < NN_DIMENSION_COUNT; ++dimension)
+        if (output->view_begin.t[dimension] != 0 || output->view_end.t[dimension] + 1 != output->parent->lengths.t[dimension])
+            return false;
+    return dynamic_cast<layer::convolution_pooling_f32 *>(static_cast<layer::convolution_f32 *>(producer->primitive)) != nullptr;
+}
 
-                    next_load_item = type4_conversion;
-                }
+/* assigns data layouts to outputs of workload items, adding conversions where consumer loads other layout
+   Kernels load fixed layouts, so layouts demanded by all consumers of every output are known up front and outputs can
+   be decided independently of each other. Consumers demanding the same layout share single conversion. When all of
+   them demand layout the producer can store itself, producer writes it directly and no conversion is added. */
+static void nn_workflow_compile_0_function_assign_layouts(
+    nn_workflow_t                                         *workflow,
+    std::map<nn_workflow_item_t *, nn_workload_item_t *> &flow_to_work,
+    uint32_t                                               batch,
+    NN_WORKLOAD_DATA_TYPE                                 *input_format) {
+    // workflow item describing result of every workload item; for fused items it is the last one of them
+    std::map<nn_workload_item_t *, nn_workflow_item_t *> work_to_flow;
+    std::vector<nn_workload_item_t *> producers;
+    {
+        std::queue<nn_workflow_item_t *> todo;
+        std::set<nn_workflow_item_t *> done;
+        for(auto index = 0u; index<workflow->input_count; ++index)
+            todo.push(workflow->input[index]);
+        while(!todo.empty()) {
+            auto flow_item = todo.front();
+            todo.pop();
+            if(done.insert(flow_item).second) {
+                auto load_item = flow_to_work[flow_item];
+                if(work_to_flow.find(load_item)==work_to_flow.end()) producers.push_back(load_item);
+                work_to_flow[load_item] = flow_item;
+                for(auto index = 0u; index<flow_item->use_count; ++index)
+                    todo.push(flow_item->use[index]);
             }
         }
     }
-    else { // batch == 1
-        // add type0 conversions
-        auto init_type0_conversion = [&batch, &flow_item, &load_item] {
-            auto conversion = new nn_workload_item_t;
-            conversion->type = NN_WORK_ITEM_TYPE_CONVERT_DATA_LAYOUT;
-            conversion->arguments.convert_data_layout.type = 0;
-
-            nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
-                                                {0, 0, 0, 0, 0, 0}, // alignment
-                                                {NN_DATA_COORD_p, NN_DATA_COORD_n, NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_q}, // ordering
-                                                NN_DATATYPE_INT16};
-
-            const uint32_t OutBlock = 2;
-            nn_workload_data_coords_t size = {
-                batch,
-                1,
-                1,
-                flow_item->output_format.format_3d.size[0] * flow_item->output_format.format_3d.size[1] * flow_item->output_format.format_3d.size[2] / OutBlock,
-                OutBlock,
-                1};
-
-            conversion->output = new nn::nn_workload_data_t<std::int16_t>(size, layout);
-            conversion->input.push_back(load_item);
-            return conversion;
-        };
 
-        if (load_item->output != nullptr && flow_item->output_format.format == NN_DATA_FORMAT_3D) {
-            for (auto &next_load_item : load_item->use) {
-                if (next_load_item->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN ||
-                    next_load_item->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN) {
-                    auto type3_conversion = init_type0_conversion();
-                    type3_conversion->name = std::string("convert_layout3_before_") + next_load_item->name;
-
-                    for (auto &useinput : next_load_item->input)
-                    if (useinput == load_item) {
-                        useinput = type3_conversion;
-                        type3_conversion->use.push_back(next_load_item);
-                    }
+    for(auto producer : producers) {
+        auto flow_item = work_to_flow[producer];
+        std::map<int, std::vector<nn_workload_item_t *>> demands;
+        for(auto consumer : producer->use) {
+            auto type = nn_workflow_compile_0_function_required_conversion(producer, flow_item, consumer, batch, input_format);
+            if(type>=0 && std::find(demands[type].begin(), demands[type].end(), consumer)==demands[type].end())
+                demands[type].push_back(consumer);
+        }
 
-                    next_load_item = type3_conversion;
-                }
+        for(auto &demand : demands) {
+            auto conversion = nn_workflow_compile_0_function_create_conversion(demand.first, producer, flow_item, batch);
+            auto &consumers = demand.second;
+            if(consumers.size()==producer->use.size() && nn_workflow_compile_0_function_stores_conversion(producer, demand.first)) {
+                delete producer->output;
+                producer->output = conversion->output;
+                delete conversion;
+                continue;
             }
+
+            conversion->name = std::string("convert_layout") + std::to_string(demand.first) + "_before_" + consumers[0]->name;
+            conversion->use = consumers;
+            for(auto consumer : consumers)
+                for(auto &input_item : consumer->input)
+                    if(input_item==producer) input_item = conversion;
+
+            std::vector<nn_workload_item_t *> use;
+            for(auto use_item : producer->use)
+                if(std::find(consumers.begin(), consumers.end(), use_item)==consumers.end()) use.push_back(use_item);
+            use.push_back(conversion);
+            producer->use = use;
         }
     }
+}
 
-    auto init_type5_conversion = [&batch, &flow_item, &load_item]
-    {
-        auto conversion = new nn_workload_item_t;
-        conversion->type = NN_WORK_ITEM_TYPE_CONVERT_DATA_LAYOUT;
-        conversion->arguments.convert_data_layout.type = 5;
+/* fuses convolution with pooling that is its only user
+   Fused item keeps convolution type & arguments, but computes pooled output straight into buffer of pooling,
+   so convolution output is never written to memory as a whole. Returns true if items were fused. */
+static bool nn_workflow_compile_0_function_fuse_convolution_pooling(
+    nn_workflow_item_t *flow_item,
+    std::map<nn_workflow_item_t *, nn_workload_item_t *> &flow_to_work,
+    uint32_t batch,
+    nn_device_internal *device) {
+    auto pool_flow_item = nn_workflow_compile_0_function_fused_pooling(flow_item);
+    if(!pool_flow_item) return false;
+    auto &pooling = pool_flow_item->arguments.forward_pooling;
+
+    // conversions could have been added in between; convolution output must not be padded for other users
+    auto conv = flow_to_work[flow_item];
+    auto pool = flow_to_work[pool_flow_item];
+    if(conv->type!=NN_WORK_ITEM_TYPE_CONVOLUTION || conv->use.size()!=1 || conv->use[0]!=pool) return false;
+    if(pool->type!=NN_WORK_ITEM_TYPE_POOLING || pool->input.size()!=1) return false;
+    auto conv_output = reinterpret_cast<nn::nn_workload_data_t<float> *>(conv->output);
+    for(auto dimension : {NN_DATA_COORD_x, NN_DATA_COORD_y})
+        if(conv_output->view_begin.t[dimension]!=0 || conv_output->get_length(dimension)!=conv_output->parent->lengths.t[dimension])
+            return false;
+
+    auto &args = flow_item->arguments.forward_convolution;
+    std::unique_ptr<layer::convolution_pooling_f32> primitive(layer::convolution_pooling_f32::create(
+        args.weights->size[0],
+        args.weights->size[1],
+        args.weights->size[2],
+        args.weights->size[3],
+        get_format_size<0>(pool_flow_item->output_format),
+        get_format_size<1>(pool_flow_item->output_format),
+        args.center_offset[0],
+        args.center_offset[1],
+        args.stride[0],
+        args.stride[1],
+        args.activation,
+        pooling.mode,
+        pooling.size[0],
+        pooling.size[1],
+        pooling.stride[0],
+        pooling.stride[1],
+        batch,
+        reinterpret_cast<nn_device_t *>(device)));
+
+    delete static_cast<layer::convolution_f32 *>(conv->primitive);
+    conv->primitive = primitive.release();
+    delete conv->output;
+    conv->output = pool->output;
+    conv->use = pool->use;
+    for(auto use_item : conv->use)
+        for(auto &input_item : use_item->input)
+            if(input_item==pool) input_item = conv;
+    if(!pool->name.empty()) conv->name += "+" + pool->name;
+
+    delete static_cast<layer::pooling_f32 *>(pool->primitive);
+    delete pool;
+    flow_to_work[pool_flow_item] = conv;
+    return true;
+}
 
-        nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
-                                            {0, 0, 0, 0, 0, 0}, // alignment
-                                            {NN_DATA_COORD_p, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_n, NN_DATA_COORD_q}, // ordering
-                                            NN_DATATYPE_INT16};
+/* returns buffers with parameters (weights, biases, factors) of workload item */
+std::vector<nn_workload_data_t *> nn_workload_item_parameter_buffers(nn_workload_item_t *load_item) {
+    switch(load_item->type) {
+    case NN_WORK_ITEM_TYPE_CONVOLUTION:
+        return { load_item->arguments.forward_convolution.weights, load_item->arguments.forward_convolution.biases };
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2:
+        return { load_item->arguments.forward_convolution_pooling_max_2x2_stride_2x2.weights,
+                 load_item->arguments.forward_convolution_pooling_max_2x2_stride_2x2.biases };
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED:
+        return { load_item->arguments.forward_fully_connected.weights, load_item->arguments.forward_fully_connected.biases };
+    case NN_WORK_ITEM_TYPE_ARITHMETIC:
+        return { load_item->arguments.forward_arithmetic.factor };
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT:
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT:
+        return { load_item->arguments.forward_convolution_fixedpoint.weights, load_item->arguments.forward_convolution_fixedpoint.biases };
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN:
+        return { load_item->arguments.fully_connected_forward_i16qn_i16qn.weights, load_item->arguments.fully_connected_forward_i16qn_i16qn.biases };
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN:
+        return { load_item->arguments.fully_connected_forward_i16qn_i32qn.weights, load_item->arguments.fully_connected_forward_i16qn_i32qn.biases };
+    default:
+        return {};
+    }
+}
 
-        uint32_t z_size = flow_item->output_format.format >= NN_DATA_FORMAT_3D ? flow_item->output_format.format_3d.size[2] : 1;
-        uint32_t z_block = z_size > 4 ? 8 : 4;
+/* sets buffers with parameters of workload item, in order returned by nn_workload_item_parameter_buffers */
+void nn_workload_item_set_parameter_buffers(nn_workload_item_t *load_item, const std::vector<nn_workload_data_t *> &parameters) {
+    switch(load_item->type) {
+    case NN_WORK_ITEM_TYPE_CONVOLUTION:
+        load_item->arguments.forward_convolution.weights = parameters.at(0);
+        load_item->arguments.forward_convolution.biases  = parameters.at(1);
+        break;
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2:
+        load_item->arguments.forward_convolution_pooling_max_2x2_stride_2x2.weights = parameters.at(0);
+        load_item->arguments.forward_convolution_pooling_max_2x2_stride_2x2.biases  = parameters.at(1);
+        break;
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED:
+        load_item->arguments.forward_fully_connected.weights = parameters.at(0);
+        load_item->arguments.forward_fully_connected.biases  = parameters.at(1);
+        break;
+    case NN_WORK_ITEM_TYPE_ARITHMETIC:
+        load_item->arguments.forward_arithmetic.factor = static_cast<nn::nn_workload_data_t<float> *>(parameters.at(0));
+        break;
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT:
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT:
+        load_item->arguments.forward_convolution_fixedpoint.weights = parameters.at(0);
+        load_item->arguments.forward_convolution_fixedpoint.biases  = parameters.at(1);
+        break;
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN:
+        load_item->arguments.fully_connected_forward_i16qn_i16qn.weights = parameters.at(0);
+        load_item->arguments.fully_connected_forward_i16qn_i16qn.biases  = parameters.at(1);
+        break;
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN:
+        load_item->arguments.fully_connected_forward_i16qn_i32qn.weights = parameters.at(0);
+        load_item->arguments.fully_connected_forward_i16qn_i32qn.biases  = parameters.at(1);
+        break;
+    default:
+        assert(parameters.empty());
+    }
+}
 
-        nn_workload_data_coords_t size = {
-            batch,
-            flow_item->output_format.format_1d.size[0],
-            flow_item->output_format.format >= NN_DATA_FORMAT_2D ? flow_item->output_format.format_2d.size[1] : 1,
-            (z_size - 1) / z_block + 1,
-            z_block,
-            1 };
+/* layout of workload inputs & outputs of given format */
+static nn_workload_data_layout_t get_workload_layout(NN_WORKLOAD_DATA_TYPE type) {
+    switch (type) {
+        case NN_WORKLOAD_DATA_TYPE_F32_1D:
+        case NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH:
+        case NN_WORKLOAD_DATA_TYPE_F32_2D:
+        case NN_WORKLOAD_DATA_TYPE_F32_2D_BATCH:
+        case NN_WORKLOAD_DATA_TYPE_F32_3D:
+        case NN_WORKLOAD_DATA_TYPE_F32_3D_BATCH:
+            return nn_workload_data_layout_t{ { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
+            { 0, 0, 0, 0, 0, 0 }, // alignment
+            { NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_p, NN_DATA_COORD_q, NN_DATA_COORD_n },
+            NN_DATATYPE_FLOAT };
+
+        case NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH:
+        case NN_WORKLOAD_DATA_TYPE_F32_ZXY:
+            return nn_workload_data_layout_t{ { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
+            { 0, 0, 0, 0, 0, 0 }, // alignment
+            { NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_n, NN_DATA_COORD_p, NN_DATA_COORD_q },
+            NN_DATATYPE_FLOAT };
+
+        case NN_WORKLOAD_DATA_TYPE_I16_1D:
+        case NN_WORKLOAD_DATA_TYPE_I16_1D_BATCH:
+        case NN_WORKLOAD_DATA_TYPE_I16_3D:
+        case NN_WORKLOAD_DATA_TYPE_I16_3D_BATCH:
+            return nn_workload_data_layout_t{ { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
+            { 0, 0, 0, 0, 0, 0 }, // alignment
+            { NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_p, NN_DATA_COORD_q, NN_DATA_COORD_n },
+            NN_DATATYPE_INT16 };
+
+        case NN_WORKLOAD_DATA_TYPE_I16_ZXY:
+        case NN_WORKLOAD_DATA_TYPE_I16_ZXY_BATCH:
+            return nn_workload_data_layout_t{ { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
+            { 0, 0, 0, 0, 0, 0 }, // alignment
+            { NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_n, NN_DATA_COORD_p, NN_DATA_COORD_q },
+            NN_DATATYPE_INT16 };
+
+        case NN_WORKLOAD_DATA_TYPE_I32_1D:
+        case NN_WORKLOAD_DATA_TYPE_I32_1D_BATCH:
+            return nn_workload_data_layout_t{ { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
+            { 0, 0, 0, 0, 0, 0 }, // alignment
+            { NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_p, NN_DATA_COORD_q, NN_DATA_COORD_n },
+            NN_DATATYPE_INT32 };
 
-        conversion->output = new nn::nn_workload_data_t<float>(size, layout);
-        conversion->input.push_back(load_item);
-        return conversion;
+        default:
+            throw std::out_of_range("unsupported data type");
+    }
+}
+
+/* checks if data of given lengths is placed in memory the same way in both layouts
+   Order of dimensions with length 1 does not matter. */
+static bool same_memory_layout(const nn_workload_data_layout_t &lhs, const nn_workload_data_layout_t &rhs, const nn_workload_data_coords_t &lengths) {
+    if(lhs.data_type!=rhs.data_type) return false;
+    for(auto coord = 0u; coord<NN_DIMENSION_COUNT; ++coord)
+        if(lhs.tile_lengths_log2.t[coord] || rhs.tile_lengths_log2.t[coord] || lhs.alignment_log2.t[coord] || rhs.alignment_log2.t[coord])
+            return false;
+    auto significant_ordering = [&](const nn_workload_data_layout_t &layout) {
+        std::vector<uint32_t> ordering;
+        for(auto index = 0u; index<NN_DIMENSION_COUNT; ++index)
+            if(lengths.t[layout.ordering.t[index]]>1) ordering.push_back(layout.ordering.t[index]);
+        return ordering;
     };
+    return significant_ordering(lhs)==significant_ordering(rhs);
+}
 
-    if (load_item->type == NN_WORK_ITEM_TYPE_INPUT) {
-        for (auto &next_load_item : load_item->use) {
-            if (next_load_item->type == NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN ||
-                next_load_item->type == NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT ||
-                next_load_item->type == NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT ||
-                next_load_item->type == NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT) {
-                assert(input_format[load_item->arguments.input.index] == NN_WORKLOAD_DATA_TYPE_I16_ZXY); // TODO support other formats
-                auto type5_conversion = init_type5_conversion();
-                type5_conversion->name = std::string("convert_layout5_before_") + next_load_item->name;
-
-                for (auto &useinput : next_load_item->input)
-                if (useinput == load_item) {
-                    useinput = type5_conversion;
-                    type5_conversion->use.push_back(next_load_item);
-                }
+/* find items that can write their results straight into user output buffers
+   Such item has to be the only user of its buffer (no paddings, views or merges) and its layout has to match output format.
+   User buffer is bound at execution only if it is aligned for stores of kernels, otherwise result is copied. */
+static void nn_workflow_compile_0_function_find_direct_outputs(nn_workload_t *workload_public, nn_workload_opaque_t *workload_opaque) {
+    workload_opaque->direct_output.assign(workload_opaque->output.size(), nullptr);
+    for(auto index = 0u; index<workload_opaque->output.size(); ++index) {
+        auto load_item = workload_opaque->output[index]->input[0];
+        if(load_item->type==NN_WORK_ITEM_TYPE_INPUT || load_item->type==NN_WORK_ITEM_TYPE_VIEW || load_item->type==NN_WORK_ITEM_TYPE_MERGE) continue;
+        if(std::find(workload_opaque->direct_output.begin(), workload_opaque->direct_output.end(), load_item)!=workload_opaque->direct_output.end()) continue;
+
+        auto buffer = load_item->output->parent.get();
+        bool whole = true;
+        for(auto coord = 0u; coord<NN_DIMENSION_COUNT; ++coord)
+            whole &= load_item->output->view_begin.t[coord]==0 && load_item->output->view_end.t[coord]+1==buffer->lengths.t[coord];
+        if(!whole) continue;
+
+        bool shared = false;
+        for(auto other_item : workload_opaque->order_of_execution)
+            if(other_item!=load_item && other_item->type!=NN_WORK_ITEM_TYPE_INPUT && other_item->type!=NN_WORK_ITEM_TYPE_OUTPUT)
+                shared |= other_item->output && other_item->output->parent.get()==buffer;
+        if(shared) continue;
+
+        if(!same_memory_layout(get_workload_layout(workload_public->output_format[index]), buffer->layout, buffer->lengths)) continue;
+        workload_opaque->direct_output[index] = load_item;
+    }
+}
 
-                next_load_item = type5_conversion;
+/* pack activations of compiled workload into single arena
+   Lifetime of buffer spans from first wave writing it to last wave reading it. Buffers are placed largest first,
+   each at lowest offset that does not collide with already placed buffers of overlapping lifetime.
+   Returns planned peak footprint in bytes. */
+static uint64_t nn_workflow_compile_0_function_plan_activations(nn_workload_opaque_t *workload_opaque) {
+    const size_t alignment = 4096;
+    struct buffer_plan {
+        nn_workload_data_core_t *buffer;
+        uint32_t first_wave, last_wave;
+        size_t size, offset;
+        bool padded; // not all of buffer is covered by views - paddings have to stay zeroed
+    };
+    std::map<nn_workload_data_core_t *, buffer_plan> plans;
+    auto &arena = workload_opaque->arena;
+    arena.clear.resize(workload_opaque->execution_waves.size());
+
+    auto activation = [](nn_workload_item_t *load_item) -> nn_workload_data_core_t * {
+        // input & output items get their buffers from user during execution
+        if(load_item->type==NN_WORK_ITEM_TYPE_INPUT || load_item->type==NN_WORK_ITEM_TYPE_OUTPUT) return nullptr;
+        if(!load_item->output || load_item->output->parent->use_client_buffer) return nullptr;
+        return load_item->output->parent.get();
+    };
+    for(auto wave = 0u; wave<workload_opaque->execution_waves.size(); ++wave)
+        for(auto load_item : workload_opaque->execution_waves[wave]) {
+            if(auto buffer = activation(load_item)) {
+                auto result = plans.insert({buffer, buffer_plan{buffer, wave, wave, (buffer->buffer_size+alignment-1)/alignment*alignment, 0, true}});
+                auto &plan = result.first->second;
+                plan.first_wave = std::min(plan.first_wave, wave);
+                plan.last_wave = std::max(plan.last_wave, wave);
+                bool whole = true;
+                for(auto coord = 0u; coord<NN_DIMENSION_COUNT; ++coord)
+                    whole &= load_item->output->view_begin.t[coord]==0 && load_item->output->view_end.t[coord]+1==buffer->lengths.t[coord];
+                if(whole) plan.padded = false;
             }
+            for(auto input_item : load_item->input)
+                if(auto buffer = activation(input_item))
+                    plans.at(buffer).last_wave = std::max(plans.at(buffer).last_wave, wave);
         }
+
+    std::vector<buffer_plan *> order;
+    for(auto &plan : plans) order.push_back(&plan.second);
+    std::stable_sort(order.begin(), order.end(), [](buffer_plan *lhs, buffer_plan *rhs) { return lhs->size>rhs->size; });
+
+    size_t arena_size = 0;
+    std::vector<buffer_plan *> placed;
+    for(auto plan : order) {
+        std::vector<std::pair<size_t, size_t>> taken;
+        for(auto other : placed)
+            if(other->first_wave<=plan->last_wave && plan->first_wave<=other->last_wave)
+                taken.push_back({other->offset, other->offset+other->size});
+        std::sort(taken.begin(), taken.end());
+        for(auto &range : taken)
+            if(plan->offset+plan->size>range.first && plan->offset<range.second)
+                plan->offset = std::max(plan->offset, range.second);
+        placed.push_back(plan);
+        arena_size = std::max(arena_size, plan->offset+plan->size);
+        arena.unplanned_size += plan->size;
     }
+    if(arena_size==0) return 0;
 
-    auto init_type6_conversion = [&batch, &flow_item, &load_item]
-    {
-        auto conversion = new nn_workload_item_t;
-        conversion->type = NN_WORK_ITEM_TYPE_CONVERT_DATA_LAYOUT;
-        conversion->arguments.convert_data_layout.type = 6;
+    nn_workload_data_layout_t layout = {
+        { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
+        { 0, 0, 0, 0, 0, 0 }, // alignment
+        { NN_DATA_COORD_n, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_p, NN_DATA_COORD_q }, // ordering
+        NN_DATATYPE_FLOAT
+    };
+    arena.buffer.reset(new nn_workload_data_core_t(1, nn_workload_data_coords_t(static_cast<uint32_t>(arena_size), 1, 1, 1, 1, 1), layout, nullptr));
+    auto arena_buffer = static_cast<uint8_t *>(arena.buffer->data_buffer);
+    std::memset(arena_buffer, 0, arena_size);
+
+    // move views of items to buffers inside of arena, original buffers are released with their last view
+    std::map<nn_workload_data_core_t *, std::shared_ptr<nn_workload_data_core_t>> moved;
+    for(auto plan : placed)
+        moved[plan->buffer] = std::make_shared<nn_workload_data_core_t>(
+            plan->buffer->data_type_size, plan->buffer->lengths, plan->buffer->layout, arena_buffer+plan->offset);
+    for(auto load_item : workload_opaque->order_of_execution)
+        if(auto buffer = activation(load_item))
+            load_item->output->parent = moved.at(buffer);
+
+    for(auto plan : placed) {
+        arena.offset[moved[plan->buffer].get()] = plan->offset;
+        if(!plan->padded) continue;
+        for(auto other : placed)
+            if(other!=plan && plan->offset<other->offset+other->size && other->offset<plan->offset+plan->size) {
+                arena.clear[plan->first_wave].push_back({plan->offset, plan->size});
+                break;
+            }
+    }
 
-        nn_workload_data_layout_t layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
-                                            {0, 0, 0, 0, 0, 0}, // alignment
-                                            {NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_n, NN_DATA_COORD_p, NN_DATA_COORD_q}, // ordering
-                                            NN_DATATYPE_INT16};
+    return arena_size;
+}
+
+/* place activations & parameters of compiled workload on NUMA nodes of device threads */
+static void nn_workflow_compile_0_function_bind_memory(nn_workload_opaque_t *workload_opaque, nn_device_internal *device) {
+    const auto &nodes = device->thread_pool.get_memory_nodes();
+    if(nodes.empty()) return;
+
+    std::set<nn_workload_data_core_t *> done;
+    auto bind = [&](nn_workload_data_t *data) {
+        if(data==nullptr || !data->parent || data->parent->use_client_buffer) return;
+        if(!done.insert(data->parent.get()).second) return;
+        nn_cpu_bind_memory(data->parent->data_buffer, data->parent->buffer_size, nodes);
+    };
+
+    // activations are placed in arena
+    if(workload_opaque->arena.buffer)
+        nn_cpu_bind_memory(workload_opaque->arena.buffer->data_buffer, workload_opaque->arena.buffer->buffer_size, nodes);
 
+    for(auto load_item : workload_opaque->order_of_execution) {
+        // input & output items get their buffers from user during execution
+        if(load_item->type==NN_WORK_ITEM_TYPE_INPUT || load_item->type==NN_WORK_ITEM_TYPE_OUTPUT) continue;
+        bind(load_item->output);
+        for(auto parameter : nn_workload_item_parameter_buffers(load_item))
+            bind(parameter);
+    }
+}
+
+/* size of parameter buffers (weights, biases, ...) of compiled workload; buffers shared by items are counted once */
+static uint64_t nn_workflow_compile_0_function_parameter_memory(nn_workload_opaque_t *workload_opaque) {
+    std::set<nn_workload_data_core_t *> counted;
+    uint64_t result = 0;
+    for(auto load_item : workload_opaque->order_of_execution)
+        for(auto parameter : nn_workload_item_parameter_buffers(load_item))
+            if(parameter && parameter->parent && counted.insert(parameter->parent.get()).second)
+                result += parameter->parent->buffer_size;
+    return result;
+}
+
+/* returns tuning interface of item primitive, nullptr if primitive cannot be tuned */
+static nn_cpu_tunable *nn_workload_item_tunable(nn_workload_item_t *load_item) {
+    switch(load_item->type) {
+    case NN_WORK_ITEM_TYPE_CONVOLUTION:
+        return static_cast<layer::convolution_f32 *>(load_item->primitive);
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED:
+        return static_cast<layer::fully_connected_f32 *>(load_item->primitive);
+    case NN_WORK_ITEM_TYPE_NORMALIZATION:
+        if(load_item->arguments.forward_normalization.mode==NN_NORMALIZATION_MODE_RESPONSE_ACROSS_MAPS)
+            return static_cast<layer::normalization_response_across_maps_f32 *>(load_item->primitive);
+        return nullptr;
+    default:
+        return nullptr;
+    }
+}
+
+/* choose execution parameters of tunable items
+   Choices found in tuning database are reused. Remaining items time all their candidates on buffers of
+   the workload (items fed by workload input get zeroed scratch input) and fastest one is stored. */
+static void nn_workflow_compile_0_function_autotune(
+    nn_workload_t          *workload_public,
+    nn_workload_opaque_t   *workload_opaque,
+    nn_workflow_t          *workflow,
+    nn_device_internal     *device) {
+    auto &database = device->tuning_database;
+    if(!database.enabled()) return;
+
+    const uint32_t C_timed_runs = 3;
+    auto run_item = [device](nn_workload_item_t *load_item) {
+        switch(load_item->type) {
+        case NN_WORK_ITEM_TYPE_CONVOLUTION:     layer::run_multithreaded_convolve_work_item(load_item, device); break;
+        case NN_WORK_ITEM_TYPE_FULLY_CONNECTED: layer::wrapper_fully_connected_work_item(load_item); break;
+        case NN_WORK_ITEM_TYPE_NORMALIZATION:   layer::wrapper_normalization_work_item(load_item, device); break;
+        default: break;
+        }
+    };
+
+    // input items get their buffers from user during execution - scratch ones are used for timing
+    struct scratch_inputs_t {
+        std::vector<nn_workload_item_t *> items;
+        ~scratch_inputs_t() {
+            for(auto load_item : items) {
+                delete load_item->output;
+                load_item->output = nullptr;
+            }
+        }
+    } scratch_inputs;
+    for(auto load_item : workload_opaque->input) {
+        const auto index = load_item->arguments.input.index;
+        const auto &format = workflow->input[index]->output_format;
         nn_workload_data_coords_t size = {
-            batch,
-            flow_item->output_format.format_1d.size[0],
-            flow_item->output_format.format >= NN_DATA_FORMAT_2D ? flow_item->output_format.format_2d.size[1] : 1,
-            flow_item->output_format.format >= NN_DATA_FORMAT_3D ? flow_item->output_format.format_3d.size[2] : 1,
+            workload_public->batch,
+            format.format_1d.size[0],
+            format.format >= NN_DATA_FORMAT_2D ? format.format_2d.size[1] : 1,
+            format.format >= NN_DATA_FORMAT_3D ? format.format_3d.size[2] : 1,
             1,
-            1 };
+            1};
+        load_item->output = new nn::nn_workload_data_t<float /* NOTE: this type is disregarded in this case */ >(size, get_workload_layout(workload_public->input_format[index]));
+        scratch_inputs.items.push_back(load_item);
+        std::memset(load_item->output->parent->data_buffer, 0, load_item->output->parent->buffer_size);
+    }
 
-        conversion->output = new nn::nn_workload_data_t<float>(size, layout);
-        conversion->input.push_back(load_item);
-        return conversion;
+    for(auto load_item : workload_opaque->order_of_execution) {
+        auto tunable = nn_workload_item_tunable(load_item);
+        if(!tunable) continue;
+
+        const auto key = nn_cpu_tuning_database::make_key(tunable->get_tuning_signature(), device->thread_pool.get_num_threads(), device->isa);
+        if(database.find(key, tunable->tuning)) continue;
+
+        auto candidates = tunable->get_tuning_candidates();
+        auto best = candidates.front();
+        auto best_time = std::numeric_limits<double>::max();
+        for(auto &candidate : candidates) {
+            if(candidates.size()==1) break;
+            tunable->tuning = candidate;
+            run_item(load_item); // warm-up: caches & lazily touched pages
+            for(auto run = 0u; run<C_timed_runs; ++run) {
+                auto start = std::chrono::steady_clock::now();
+                run_item(load_item);
+                auto time = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+                if(time<best_time) {
+                    best_time = time;
+                    best = candidate;
+                }
+            }
+        }
+        tunable->tuning = best;
+        database.store(key, best);
+    }
+}
+
+/* hash of workflow structure: types, formats & connections of items, their arguments & sizes of parameters,
+   and algorithms chosen by device settings where they change layouts of parameters (Winograd convolutions)
+   Values of parameters are not included - workload loaded from cache uses parameters stored in it. */
+static uint64_t nn_workflow_fingerprint(nn_workflow_t *workflow, nn_device_internal *device) {
+    uint64_t hash = 14695981039346656037ull; // FNV-1a
+    auto add = [&hash](uint64_t value) {
+        for(auto byte = 0u; byte<sizeof(value); ++byte) {
+            hash ^= (value>>(8*byte)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+    auto add_float = [&add](float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        add(bits);
+    };
+    auto add_data = [&add](const nn_data_t *data) {
+        if(!data) return add(0);
+        add(data->dimension);
+        add(data->sizeof_value);
+        for(auto index = 0u; index<data->dimension; ++index)
+            add(data->size[index]);
+    };
+    auto add_activation = [&add, &add_float](const nn_argument_activation_t &activation) {
+        add(activation.function);
+        if(activation.function==NN_ACTIVATION_FUNCTION_TANH) {
+            add_float(activation.data.fp32_tanh.a);
+            add_float(activation.data.fp32_tanh.b);
+        }
+    };
+    auto add_activation_fixedpoint = [&add, &add_activation](const nn_argument_activation_fixedpoint_t &activation) {
+        add_activation(activation.basic_arguments);
+        add(activation.fractions.accumulator);
+        add(activation.fractions.output);
     };
 
-    if ((load_item->type == NN_WORK_ITEM_TYPE_MERGE && load_item->input[0]->output->parent->layout.data_type == NN_DATATYPE_INT16) ||
-        load_item->type == NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN ||
-        load_item->type == NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT ||
-        load_item->type == NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT ||
-        load_item->type == NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT) {
-        for (auto &next_load_item : load_item->use) {
-            if (next_load_item->type == NN_WORK_ITEM_TYPE_OUTPUT) {
-                auto type6_conversion = init_type6_conversion();
-                type6_conversion->name = std::string("convert_layout6_before_") + next_load_item->name;
-
-                for (auto &useinput : next_load_item->input)
-                if (useinput == load_item) {
-                    useinput = type6_conversion;
-                    type6_conversion->use.push_back(next_load_item);
-                }
+    // number items in order of traversal from inputs
+    std::vector<nn_workflow_item_t *> items;
+    std::map<nn_workflow_item_t *, uint32_t> index_of;
+    std::queue<nn_workflow_item_t *> todo;
+    for(auto index = 0u; index<workflow->input_count; ++index)
+        todo.push(workflow->input[index]);
+    while(!todo.empty()) {
+        auto flow_item = todo.front();
+        todo.pop();
+        if(index_of.find(flow_item)!=index_of.end()) continue;
+        index_of[flow_item] = static_cast<uint32_t>(items.size());
+        items.push_back(flow_item);
+        for(auto index = 0u; index<flow_item->use_count; ++index)
+            todo.push(flow_item->use[index]);
+    }
 
-                next_load_item = type6_conversion;
-            }
+    for(auto flow_item : items) {
+        add(flow_item->type);
+        add(flow_item->output_format.format);
+        add(get_format_size<0>(flow_item->output_format));
+        add(get_format_size<1>(flow_item->output_format));
+        add(get_format_size<2>(flow_item->output_format));
+        add(flow_item->input_count);
+        for(auto index = 0u; index<flow_item->input_count; ++index)
+            add(index_of.count(flow_item->input[index]) ? index_of[flow_item->input[index]] : ~0u);
+        add(flow_item->use_count);
+
+        const auto &arguments = flow_item->arguments;
+        switch(flow_item->type) {
+        case NN_WORK_ITEM_TYPE_INPUT:
+            add(arguments.input.index);
+            break;
+        case NN_WORK_ITEM_TYPE_OUTPUT:
+            add(arguments.output.index);
+            break;
+        case NN_WORK_ITEM_TYPE_VIEW:
+            for(auto coord : arguments.view.origin) add(coord);
+            break;
+        case NN_WORK_ITEM_TYPE_MERGE:
+            add(arguments.forward_merge.axis);
+            break;
+        case NN_WORK_ITEM_TYPE_ARITHMETIC:
+            add(arguments.forward_arithmetic.arithmetic_function);
+            add_data(arguments.forward_arithmetic.factor);
+            break;
+        case NN_WORK_ITEM_TYPE_CONVOLUTION: {
+            auto &args = arguments.forward_convolution;
+            add(args.padding);
+            for(auto value : args.center_offset) add(value);
+            for(auto value : args.stride) add(value);
+            add_activation(args.activation);
+            add_data(args.weights);
+            add_data(args.biases);
+            add(nn_workflow_compile_0_function_winograd_tile_size(flow_item, device));
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2: {
+            auto &args = arguments.forward_convolution_pooling_max_2x2_stride_2x2;
+            add(args.padding);
+            for(auto value : args.center_offset) add(value);
+            for(auto value : args.stride) add(value);
+            add_activation(args.activation);
+            add_data(args.weights);
+            add_data(args.biases);
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_FULLY_CONNECTED:
+            add_activation(arguments.forward_fully_connected.activation);
+            add_data(arguments.forward_fully_connected.weights);
+            add_data(arguments.forward_fully_connected.biases);
+            break;
+        case NN_WORK_ITEM_TYPE_POOLING:
+            add(arguments.forward_pooling.mode);
+            for(auto value : arguments.forward_pooling.size) add(value);
+            for(auto value : arguments.forward_pooling.stride) add(value);
+            break;
+        case NN_WORK_ITEM_TYPE_NORMALIZATION: {
+            auto &args = arguments.forward_normalization.normalization;
+            add(args.mode);
+            add_float(args.alpha);
+            add_float(args.beta);
+            add(args.k);
+            add(args.n);
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT: {
+            auto &args = arguments.forward_convolution_int16_fixedpoint;
+            add(args.padding);
+            for(auto value : args.center_offset) add(value);
+            for(auto value : args.stride) add(value);
+            add_activation_fixedpoint(args.activation);
+            add_data(args.weights);
+            add_data(args.biases);
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT: {
+            auto &args = arguments.forward_convolution_pooling_fixedpoint;
+            add(args.padding);
+            for(auto value : args.center_offset) add(value);
+            for(auto value : args.stride) add(value);
+            add_activation_fixedpoint(args.activation);
+            add_data(args.weights);
+            add_data(args.biases);
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN:
+            add_activation_fixedpoint(arguments.fully_connected_forward_i16qn_i16qn.activation);
+            add_data(arguments.fully_connected_forward_i16qn_i16qn.weights);
+            add_data(arguments.fully_connected_forward_i16qn_i16qn.biases);
+            break;
+        case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN:
+            add_activation_fixedpoint(arguments.fully_connected_forward_i16qn_i32qn.activation);
+            add_data(arguments.fully_connected_forward_i16qn_i32qn.weights);
+            add_data(arguments.fully_connected_forward_i16qn_i32qn.biases);
+            break;
+        case NN_WORK_ITEM_TYPE_SOFTMAX_FIXEDPOINT:
+            add(arguments.forward_softmax_fixedpoint.input_fraction);
+            break;
+        case NN_WORK_ITEM_TYPE_CONVERT_FLOAT_TO_INT16_FIXEDPOINT:
+            add(arguments.forward_convert_float_to_int16_fixedpoint.output_fraction);
+            break;
+        case NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT:
+            for(auto value : arguments.forward_pooling_fixedpoint.pool_size) add(value);
+            for(auto value : arguments.forward_pooling_fixedpoint.pool_stride) add(value);
+            break;
+        case NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN: {
+            auto &args = arguments.normalization_response_across_maps_forward_i16qn;
+            add_float(args.alpha);
+            add_float(args.beta);
+            add(args.k);
+            add(args.n);
+            add(args.fractions.input);
+            add(args.fractions.output);
+            break;
+        }
+        default:
+            // no arguments
+            break;
         }
     }
+    return hash;
 }
 
-/* compile workflow into workload */
-NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_compile_0_function(
+/* compile workflow into workload
+   If cache is given, parameters & tuning choices are taken from it instead of being packed & tuned. */
+static NN_API_STATUS nn_workflow_compile_0_function_compile(
     nn_workload_t         **workload,       /* resulting workload */
     nn_device_t            *device,         /* device context */
     nn_workflow_t          *workflow,       /* workflow to be compiled */
     NN_WORKLOAD_DATA_TYPE  *input_format,   /* array containing formats of inputs */
     NN_WORKLOAD_DATA_TYPE  *output_format,  /* array containing formats of outputs */
-    uint32_t                batch           /* batch size for compilation */
+    uint32_t                batch,          /* batch size for compilation */
+    std::unique_ptr<nn_cpu_workload_cache> cache
     ) {
     if(!workload || !device || !workflow)       return NN_API_STATUS_ERROR_INVALID_POINTER;
     if(workflow->input_count!=1)                return NN_API_STATUS_ERROR_INVALID_INPUT_COUNT;
@@ -1219,6 +1823,9 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_compile_0_function(
         if(workflow->output[index]->type!=NN_WORK_ITEM_TYPE_OUTPUT)
             return NN_API_STATUS_ERROR_INVALID_WORKFLOW; // TODO: more granular error code here
     try {
+        const auto fingerprint = nn_workflow_fingerprint(workflow, reinterpret_cast<nn_device_internal*>(device));
+        if(cache && cache->fingerprint!=fingerprint) return NN_API_STATUS_ERROR_INVALID_WORKFLOW;
+
         // allocate memory for workload (public & opaque parts & data buffers);
         const size_t  input_size = sizeof(NN_WORKLOAD_DATA_TYPE)*workflow-> input_count;
         const size_t output_size = sizeof(NN_WORKLOAD_DATA_TYPE)*workflow->output_count;
@@ -1268,27 +1875,32 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_compile_0_function(
                 if(done.find(flow_item)==done.end()) {
                     done.insert(flow_item);
                     nn_workload_item_t *load_item = flow_to_work[flow_item];
-                    nn_workflow_compile_0_function_copy_item(load_item, flow_item, batch, flow_to_work, reinterpret_cast<nn_device_internal*>(device));
+                    nn_workflow_compile_0_function_copy_item(load_item, flow_item, batch, flow_to_work, reinterpret_cast<nn_device_internal*>(device), !cache);
                     for(auto index=0u; index<flow_item->use_count; ++index)
                         todo.push(flow_item->use[index]);
                 }
             }
         }
 
-        { // add data layout conversions if required
+        { // fuse convolutions with following pooling
             std::queue<nn_workflow_item_t *> todo;
-            for (auto index = 0u; index < workflow->input_count; ++index)
+            std::set<nn_workflow_item_t *> done;
+            for(auto index = 0u; index<workflow->input_count; ++index)
                 todo.push(workflow->input[index]);
-            while (!todo.empty()) {
+            while(!todo.empty()) {
                 auto flow_item = todo.front();
-                auto load_item = flow_to_work[flow_item];
                 todo.pop();
-                nn_workflow_compile_0_function_add_conversions(load_item, flow_item, batch, input_format, output_format);
-                for (auto index = 0u; index < flow_item->use_count; ++index)
-                    todo.push(flow_item->use[index]);
+                if(done.insert(flow_item).second) {
+                    nn_workflow_compile_0_function_fuse_convolution_pooling(flow_item, flow_to_work, batch, reinterpret_cast<nn_device_internal*>(device));
+                    for(auto index = 0u; index<flow_item->use_count; ++index)
+                        todo.push(flow_item->use[index]);
+                }
             }
         }
 
+        // choose layouts of item outputs & add data layout conversions if required
+        nn_workflow_compile_0_function_assign_layouts(workflow, flow_to_work, batch, input_format);
+
         // copying inputs & outputs
         workload_opaque->input.resize(workflow->input_count);
         for(auto index=0u; index<workflow->input_count; ++index)
@@ -1315,6 +1927,60 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_compile_0_function(
             }
         }
 
+        if(cache) { // parameters packed during original compilation are used straight from cache file
+            size_t index = 0;
+            for(auto load_item : workload_opaque->order_of_execution) {
+                auto parameters = nn_workload_item_parameter_buffers(load_item);
+                for(auto &parameter : parameters) {
+                    if(index>=cache->parameters.size()) throw std::runtime_error("workload cache does not match workflow");
+                    parameter = cache->create_parameter(index++);
+                }
+                nn_workload_item_set_parameter_buffers(load_item, parameters);
+            }
+            if(index!=cache->parameters.size()) throw std::runtime_error("workload cache does not match workflow");
+        }
+
+        { // grouping items into waves - item depends only on items from earlier waves
+            std::map<nn_workload_item_t *, uint32_t> wave_of;
+            for(bool changed = true; changed;) {
+                changed = false;
+                for(auto load_item : workload_opaque->order_of_execution) {
+                    uint32_t wave = 0;
+                    for(auto input_item : load_item->input)
+                        wave = std::max(wave, wave_of[input_item]+1);
+                    if(wave_of[load_item]!=wave) {
+                        wave_of[load_item] = wave;
+                        changed = true;
+                    }
+                }
+            }
+            for(auto load_item : workload_opaque->order_of_execution) {
+                auto wave = wave_of[load_item];
+                if(workload_opaque->execution_waves.size()<=wave)
+                    workload_opaque->execution_waves.resize(wave+1);
+                workload_opaque->execution_waves[wave].push_back(load_item);
+            }
+        }
+
+        nn_workflow_compile_0_function_find_direct_outputs(workload_public, workload_opaque);
+
+        *const_cast<uint64_t *>(&workload_public->activation_memory) = nn_workflow_compile_0_function_plan_activations(workload_opaque);
+
+        nn_workflow_compile_0_function_bind_memory(workload_opaque, reinterpret_cast<nn_device_internal*>(device));
+        *const_cast<uint64_t *>(&workload_public->parameter_memory) = nn_workflow_compile_0_function_parameter_memory(workload_opaque);
+
+        if(cache) {
+            size_t index = 0;
+            for(auto load_item : workload_opaque->order_of_execution)
+                if(auto tunable = nn_workload_item_tunable(load_item))
+                    tunable->tuning = cache->tunings.at(index++);
+        }
+        else
+            nn_workflow_compile_0_function_autotune(workload_public, workload_opaque, workflow, reinterpret_cast<nn_device_internal*>(device));
+
+        workload_opaque->fingerprint = fingerprint;
+        workload_opaque->cache = std::move(cache);
+
         // set result
         *workload = workload_public;
     }
@@ -1325,65 +1991,222 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_compile_0_function(
     return NN_API_STATUS_OK;
 }
 
-/* executes workload with given inputs & outputs */
-NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_execute_0_function(
-    nn_workload_t      *workload_public,/* workload to be started */
-    void *             *input,          /* array of pointers with input data;  format is in workload->input_format */
-    void *             *output,         /* array of pointers with output data; format is in workload->output_format */
-    NN_API_STATUS      *status          /* asynchronous status */
+/* compile workflow into workload */
+NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_compile_0_function(
+    nn_workload_t         **workload,       /* resulting workload */
+    nn_device_t            *device,         /* device context */
+    nn_workflow_t          *workflow,       /* workflow to be compiled */
+    NN_WORKLOAD_DATA_TYPE  *input_format,   /* array containing formats of inputs */
+    NN_WORKLOAD_DATA_TYPE  *output_format,  /* array containing formats of outputs */
+    uint32_t                batch           /* batch size for compilation */
     ) {
-    if(!workload_public || !input || !output) return NN_API_STATUS_ERROR_INVALID_POINTER;
-    else {
-        try {
-            // layout for inputs & outputs
-            auto get_workload_layout = [](NN_WORKLOAD_DATA_TYPE type) -> nn_workload_data_layout_t {
-                switch (type) {
-                    case NN_WORKLOAD_DATA_TYPE_F32_1D:
-                    case NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH:
-                    case NN_WORKLOAD_DATA_TYPE_F32_2D:
-                    case NN_WORKLOAD_DATA_TYPE_F32_2D_BATCH:
-                    case NN_WORKLOAD_DATA_TYPE_F32_3D:
-                    case NN_WORKLOAD_DATA_TYPE_F32_3D_BATCH:
-                        return nn_workload_data_layout_t{ { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
-                        { 0, 0, 0, 0, 0, 0 }, // alignment
-                        { NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_p, NN_DATA_COORD_q, NN_DATA_COORD_n },
-                        NN_DATATYPE_FLOAT };
+    return nn_workflow_compile_0_function_compile(workload, device, workflow, input_format, output_format, batch, nullptr);
+}
 
-                    case NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH:
-                    case NN_WORKLOAD_DATA_TYPE_F32_ZXY:
-                        return nn_workload_data_layout_t{ { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
-                        { 0, 0, 0, 0, 0, 0 }, // alignment
-                        { NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_n, NN_DATA_COORD_p, NN_DATA_COORD_q },
-                        NN_DATATYPE_FLOAT };
+/* save compiled workload to cache file */
+NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_save_0_function(
+    nn_workload_t          *workload_public, /* workload to be saved */
+    const char             *path             /* path of cache file */
+    ) {
+    if(!workload_public || !path) return NN_API_STATUS_ERROR_INVALID_POINTER;
+    try {
+        auto workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload_public + 1);
+        std::vector<nn_workload_data_t *> parameters;
+        std::vector<nn_cpu_tuning_t> tunings;
+        for(auto load_item : workload_opaque->order_of_execution) {
+            for(auto parameter : nn_workload_item_parameter_buffers(load_item))
+                parameters.push_back(parameter);
+            if(auto tunable = nn_workload_item_tunable(load_item))
+                tunings.push_back(tunable->tuning);
+        }
+        nn_cpu_workload_cache::save(
+            path,
+            workload_opaque->fingerprint,
+            workload_public->batch,
+            std::vector<NN_WORKLOAD_DATA_TYPE>(workload_public->input_format, workload_public->input_format+workload_public->input_count),
+            std::vector<NN_WORKLOAD_DATA_TYPE>(workload_public->output_format, workload_public->output_format+workload_public->output_count),
+            parameters,
+            tunings);
+    }
+    catch(std::runtime_error &) {
+        return NN_API_STATUS_ERROR_OTHER;
+    }
+    catch(...) {
+        return NN_API_STATUS_ERROR_OUT_OF_MEMORY;
+    }
+    return NN_API_STATUS_OK;
+}
 
-                    case NN_WORKLOAD_DATA_TYPE_I16_1D:
-                    case NN_WORKLOAD_DATA_TYPE_I16_1D_BATCH:
-                    case NN_WORKLOAD_DATA_TYPE_I16_3D:
-                    case NN_WORKLOAD_DATA_TYPE_I16_3D_BATCH:
-                        return nn_workload_data_layout_t{ { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
-                        { 0, 0, 0, 0, 0, 0 }, // alignment
-                        { NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_p, NN_DATA_COORD_q, NN_DATA_COORD_n },
-                        NN_DATATYPE_INT16 };
+/* create workload from cache file & workflow it was compiled from */
+NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_load_0_function(
+    nn_workload_t         **workload,       /* resulting workload */
+    nn_device_t            *device,         /* device context */
+    nn_workflow_t          *workflow,       /* workflow with the same structure as compiled one */
+    const char             *path            /* path of cache file */
+    ) {
+    if(!workload || !device || !workflow || !path) return NN_API_STATUS_ERROR_INVALID_POINTER;
+    try {
+        std::unique_ptr<nn_cpu_workload_cache> cache(new nn_cpu_workload_cache);
+        if(!cache->open(path)) return NN_API_STATUS_ERROR_OTHER;
+        if(cache->input_format.size()!=workflow->input_count)   return NN_API_STATUS_ERROR_INVALID_INPUT_COUNT;
+        if(cache->output_format.size()!=workflow->output_count) return NN_API_STATUS_ERROR_INVALID_OUTPUT_COUNT;
+
+        auto input_format = cache->input_format.data();
+        auto output_format = cache->output_format.data();
+        auto batch = cache->batch;
+        return nn_workflow_compile_0_function_compile(workload, device, workflow, input_format, output_format, batch, std::move(cache));
+    }
+    catch(...) {
+        return NN_API_STATUS_ERROR_OUT_OF_MEMORY;
+    }
+}
 
-                    case NN_WORKLOAD_DATA_TYPE_I16_ZXY:
-                    case NN_WORKLOAD_DATA_TYPE_I16_ZXY_BATCH:
-                        return nn_workload_data_layout_t{ { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
-                        { 0, 0, 0, 0, 0, 0 }, // alignment
-                        { NN_DATA_COORD_z, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_n, NN_DATA_COORD_p, NN_DATA_COORD_q },
-                        NN_DATATYPE_INT16 };
+/* creates execution context of workload
+   First context works on arena created during compilation, every next one gets its own copy of it. */
+static nn_workload_execution_context_t *nn_workload_execution_context_create(nn_workload_opaque_t *workload_opaque, nn_device_internal *device) {
+    std::unique_ptr<nn_workload_execution_context_t> context(new nn_workload_execution_context_t);
+    auto &arena = workload_opaque->arena;
+    const bool copy_activations = !workload_opaque->execution_contexts.empty() && arena.buffer;
+
+    context->arena_buffer = arena.buffer ? static_cast<uint8_t *>(arena.buffer->data_buffer) : nullptr;
+    if(copy_activations) {
+        context->arena.reset(new nn_workload_data_core_t(1, arena.buffer->lengths, arena.buffer->layout, nullptr));
+        context->arena_buffer = static_cast<uint8_t *>(context->arena->data_buffer);
+        // paddings were zeroed during compilation and are never written by layers
+        std::memcpy(context->arena_buffer, arena.buffer->data_buffer, arena.buffer->buffer_size);
+        const auto &nodes = device->thread_pool.get_memory_nodes();
+        if(!nodes.empty())
+            nn_cpu_bind_memory(context->arena_buffer, context->arena->buffer_size, nodes);
+    }
 
-                    case NN_WORKLOAD_DATA_TYPE_I32_1D:
-                    case NN_WORKLOAD_DATA_TYPE_I32_1D_BATCH:
-                        return nn_workload_data_layout_t{ { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
-                        { 0, 0, 0, 0, 0, 0 }, // alignment
-                        { NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_z, NN_DATA_COORD_p, NN_DATA_COORD_q, NN_DATA_COORD_n },
-                        NN_DATATYPE_INT32 };
+    std::map<nn_workload_item_t *, nn_workload_item_t *> context_item;
+    for(auto compiled_item : workload_opaque->order_of_execution) {
+        context->items.emplace_back(new nn_workload_item_t(*compiled_item));
+        context_item[compiled_item] = context->items.back().get();
+        context->compiled_item[context->items.back().get()] = compiled_item;
+    }
 
-                    default:
-                        throw std::out_of_range("unsupported data type");
-                }
-            };
+    std::map<nn_workload_data_core_t *, std::unique_ptr<nn::nn_workload_data_t<float>>> copied_buffers;
+    for(auto &item : context->items) {
+        for(auto &input_item : item->input) input_item = context_item[input_item];
+        for(auto &use_item : item->use) use_item = context_item[use_item];
+
+        // input & output items get their buffers from user during execution
+        if(item->type==NN_WORK_ITEM_TYPE_INPUT || item->type==NN_WORK_ITEM_TYPE_OUTPUT) {
+            item->output = nullptr;
+            continue;
+        }
+        auto compiled_output = item->output;
+        if(!copy_activations || !compiled_output) continue;
+
+        // items sharing a buffer (views, merges, paddings) have to share its copy as well
+        auto compiled_buffer = compiled_output->parent.get();
+        auto &buffer = copied_buffers[compiled_buffer];
+        if(!buffer)
+            buffer.reset(new nn::nn_workload_data_t<float>(
+                context->arena_buffer+arena.offset.at(compiled_buffer), compiled_buffer->lengths, compiled_buffer->layout));
+        item->output = new nn::nn_workload_data_t<float>(*buffer, compiled_output->view_begin, compiled_output->view_end);
+        context->activations.emplace_back(item->output);
+    }
+
+    for(auto &item : context->items) {
+        auto view = item->output;
+        if(!view || view->view_begin.t[NN_DATA_COORD_n]!=0 || view->view_end.t[NN_DATA_COORD_n]+1!=view->parent->lengths.t[NN_DATA_COORD_n]) continue;
+        if(std::find(context->batch_views.begin(), context->batch_views.end(), view)==context->batch_views.end())
+            context->batch_views.push_back(view);
+    }
+
+    for(auto compiled_item : workload_opaque->direct_output)
+        context->direct_output.push_back(compiled_item ? context_item[compiled_item] : nullptr);
+
+    for(auto &wave : workload_opaque->execution_waves) {
+        context->execution_waves.emplace_back();
+        for(auto compiled_item : wave)
+            context->execution_waves.back().push_back(context_item[compiled_item]);
+    }
+
+    workload_opaque->execution_contexts.emplace_back(std::move(context));
+    return workload_opaque->execution_contexts.back().get();
+}
+
+/* holds execution context of workload for the time of single execution
+   Idle context is reused, new one is created only if all of them are used by concurrent executions. */
+class nn_workload_execution_context_lease {
+public:
+    nn_workload_execution_context_lease(nn_workload_opaque_t *workload_opaque, nn_device_internal *device)
+        : workload_opaque(workload_opaque) {
+        std::lock_guard<std::mutex> lock(workload_opaque->execution_contexts_mutex);
+        if(workload_opaque->idle_execution_contexts.empty()) {
+            context = nn_workload_execution_context_create(workload_opaque, device);
+        } else {
+            context = workload_opaque->idle_execution_contexts.back();
+            workload_opaque->idle_execution_contexts.pop_back();
+        }
+    }
+
+    ~nn_workload_execution_context_lease() {
+        // views of first context are compiled ones, batch they span has to be restored
+        for(auto view : context->batch_views)
+            view->view_end.t[NN_DATA_COORD_n] = view->parent->lengths.t[NN_DATA_COORD_n] - 1;
+        // remove views of user inputs & outputs created during execution
+        for(auto &item : context->items)
+            if(item->type==NN_WORK_ITEM_TYPE_INPUT) {
+                delete item->output;
+                item->output = nullptr;
+            }
+        for(auto &bound : context->bound_outputs) {
+            delete bound.first->output;
+            bound.first->output = bound.second;
+        }
+        context->bound_outputs.clear();
+        std::lock_guard<std::mutex> lock(workload_opaque->execution_contexts_mutex);
+        workload_opaque->idle_execution_contexts.push_back(context);
+    }
+
+    nn_workload_execution_context_t *operator->() const { return context; }
+
+private:
+    nn_workload_opaque_t *workload_opaque;
+    nn_workload_execution_context_t *context;
+};
+
+/* short name of work item type used in profiles */
+static const char *nn_workload_item_type_name(NN_WORK_ITEM_TYPE type) {
+    switch(type) {
+    case NN_WORK_ITEM_TYPE_NORMALIZATION: return "norm";
+    case NN_WORK_ITEM_TYPE_CONVERT_DATA_LAYOUT: return "conv_layout";
+    case NN_WORK_ITEM_TYPE_CONVERT_FLOAT_TO_INT16_FIXEDPOINT: return "conv_float2int";
+    case NN_WORK_ITEM_TYPE_CONVOLUTION: return "cnn_f32";
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2: return "cnn+pool2x2_f32";
+    case NN_WORK_ITEM_TYPE_POOLING: return "pooling_f32";
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED: return "fc_f32";
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT: return "cnn_i16";
+    case NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT: return "pool_i16";
+    case NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN: return "lrn_i16";
+    case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT: return "cnn+pool2x2_i16";
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN:
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN: return "fc_i16";
+    case NN_WORK_ITEM_TYPE_SOFTMAX: return "softmax_f32";
+    case NN_WORK_ITEM_TYPE_SOFTMAX_FIXEDPOINT: return "softmax_i16";
+    case NN_WORK_ITEM_TYPE_MERGE: return "merge";
+    case NN_WORK_ITEM_TYPE_ARITHMETIC: return "arithmetic";
+    case NN_WORK_ITEM_TYPE_VIEW: return "view";
+    case NN_WORK_ITEM_TYPE_INPUT: return "input";
+    case NN_WORK_ITEM_TYPE_OUTPUT: return "output";
+    default: return "unknown";
+    }
+}
 
+/* runs all items of workload on calling thread, returns when execution is finished
+   Reentrant - concurrent executions of the same workload run on separate execution contexts. */
+static NN_API_STATUS nn_workload_execute_0_function_run(
+    nn_workload_t      *workload_public,/* workload to be run */
+    void *             *input,          /* array of pointers with input data;  format is in workload->input_format */
+    void *             *output          /* array of pointers with output data; format is in workload->output_format */
+    ) {
+    if(!workload_public || !input || !output) return NN_API_STATUS_ERROR_INVALID_POINTER;
+    else {
+        try {
             // calculates 6D size from nn::data, returns it as nn_workload_data_coords_t
             auto calculate_size = [](uint32_t batch, NN_WORKLOAD_DATA_TYPE type, nn_data_t *data) -> nn_workload_data_coords_t {
                 uint32_t size_n=batch, size_x=1, size_y=1, size_z=1, size_p=1, size_q=1;
@@ -1438,16 +2261,56 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_execute_0_function(
                 return nn_workload_data_coords_t{size_n, size_x, size_y, size_z, size_p, size_q};
             };
 
-            *status = NN_API_WORK_IN_PROGRESS;
+            // batch of execution is taken from user inputs & outputs - it can be anything up to batch workload was compiled for
+            auto batch_of = [&](NN_WORKLOAD_DATA_TYPE type, void *data) {
+                return calculate_size(workload_public->batch, type, reinterpret_cast<nn_data_t*>(data)).t[NN_DATA_COORD_n];
+            };
+            const uint32_t batch = batch_of(workload_public->input_format[0], input[0]);
+            if(batch==0 || batch>workload_public->batch) return NN_API_STATUS_ERROR_INVALID_MEMORY_LAYOUT;
+            for(auto index = 0u; index<workload_public->input_count; ++index)
+                if(batch_of(workload_public->input_format[index], input[index])!=batch) return NN_API_STATUS_ERROR_INVALID_MEMORY_LAYOUT;
+            for(auto index = 0u; index<workload_public->output_count; ++index)
+                if(batch_of(workload_public->output_format[index], output[index])!=batch) return NN_API_STATUS_ERROR_INVALID_MEMORY_LAYOUT;
+
             nn_workload_opaque_t *workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload_public + 1);
+            auto device = reinterpret_cast<nn_device_internal*>(workload_public->device);
+            nn_workload_execution_context_lease context(workload_opaque, device);
+
+            // Smaller batch is computed only for images passed in - views spanning batch are limited to them.
+            // Batch is the outermost dimension of workload formats, so these images are a prefix of every buffer.
+            for(auto view : context->batch_views)
+                view->view_end.t[NN_DATA_COORD_n] = batch - 1;
+
+            // items producing outputs write straight into user buffers, unless those are of different size or are
+            // not aligned for aligned vector stores of kernels (the copy has no such requirement)
+            const uintptr_t output_alignment = device->isa==NN_CPU_ISA_AVX512 ? 64 : 32;
+            for(auto index = 0u; index<context->direct_output.size(); ++index) {
+                auto load_item = context->direct_output[index];
+                if(!load_item) continue;
+                // fixed-point fully connected & softmax layers compute whole batch of their buffers
+                if(batch!=workload_public->batch &&
+                   (load_item->type==NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN ||
+                    load_item->type==NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN ||
+                    load_item->type==NN_WORK_ITEM_TYPE_SOFTMAX_FIXEDPOINT)) continue;
+                auto item_output = reinterpret_cast<nn_data_t*>(output[index]);
+                if(reinterpret_cast<uintptr_t>(item_output->buffer)%output_alignment!=0) continue;
+                auto item_output_size = calculate_size(batch, workload_public->output_format[index], item_output);
+                item_output_size.t[NN_DATA_COORD_n] = workload_public->batch;
+                const auto &buffer = load_item->output->parent;
+                if(std::memcmp(&item_output_size, &buffer->lengths, sizeof(item_output_size))!=0) continue;
+                std::unique_ptr<nn_workload_data_t> bound_output(new nn::nn_workload_data_t<float /* NOTE: this type is disregarded in this case */ >(item_output->buffer, buffer->lengths, buffer->layout));
+                bound_output->view_end.t[NN_DATA_COORD_n] = batch - 1;
+                context->bound_outputs.push_back({load_item, load_item->output});
+                load_item->output = bound_output.release();
+            }
+
 #if  ENABLE_WORKLOAD_MONITORING
             uint16_t  item_count=0;
 #endif // ENABLE_WORKLOAD_MONITORING
-            for(auto item : workload_opaque->order_of_execution) {
-#if ENABLE_WORKLOAD_PROFILING
-
-                auto t0 = __rdtsc();
-#endif
+            const auto execution = device->profiler.next_execution();
+            auto execute_item = [&](nn_workload_item *item) {
+                nn_cpu_profile_scope profile(device->profiler, device->thread_pool.get_num_threads(), nn_workload_item_type_name(item->type),
+                                             item->name, workload_public, execution, batch);
 
                 switch(item->type) {
                 case NN_WORK_ITEM_TYPE_INPUT: {
@@ -1455,20 +2318,37 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_execute_0_function(
                     auto index = item->arguments.input.index;
                     auto item_input = reinterpret_cast<nn_data_t*>(input[index]);
                     auto item_input_format = workload_public->input_format[index];
-                    auto item_input_size = calculate_size(workload_public->batch, item_input_format, item_input);
+                    // buffer has lengths of compiled batch, so layers see strides they were compiled for; view limits it to images passed in
+                    auto item_input_size = calculate_size(batch, item_input_format, item_input);
+                    item_input_size.t[NN_DATA_COORD_n] = workload_public->batch;
                     auto item_input_layout = get_workload_layout(item_input_format);
                     item->output = new nn::nn_workload_data_t<float /* NOTE: this type is disregarded in this case */ >(item_input->buffer, item_input_size, item_input_layout);
+                    item->output->view_end.t[NN_DATA_COORD_n] = batch - 1;
                     break;
                 }
                 case NN_WORK_ITEM_TYPE_OUTPUT: {
-                    // Copy result to workload output.
+                    // Copy result to workload output, unless it was written there directly.
                     auto index = item->arguments.output.index;
                     auto item_output = reinterpret_cast<nn_data_t*>(output[index]);
+                    if(item->input[0]->output->parent->data_buffer==item_output->buffer) break;
                     auto item_output_format = workload_public->output_format[index];
-                    auto item_output_size = calculate_size(workload_public->batch, item_output_format, item_output);
+                    auto item_output_size = calculate_size(batch, item_output_format, item_output);
                     auto item_output_layout = get_workload_layout(item_output_format);
                     auto workload_output_wrapper = new nn::nn_workload_data_t<float /* NOTE: this type is disregarded in this case */ >(item_output->buffer, item_output_size, item_output_layout);
-                    nn_workload_data_copy(workload_output_wrapper, item->input[0]->output);
+                    // partial batch copies only samples that were passed in
+                    auto result = item->input[0]->output;
+                    std::unique_ptr<nn_workload_data_t> result_view;
+                    if(batch!=workload_public->batch) {
+                        nn_workload_data_coords_t view_begin = {0, 0, 0, 0, 0, 0};
+                        nn_workload_data_coords_t view_end;
+                        for(uint32_t dimension = 0; dimension<NN_DIMENSION_COUNT; ++dimension)
+                            view_end.t[dimension] = result->view_end.t[dimension] - result->view_begin.t[dimension];
+                        view_end.t[NN_DATA_COORD_n] = batch - 1;
+                        result_view.reset(nn_workload_data_create_view(result, &view_begin, &view_end));
+                        if(!result_view) throw std::bad_alloc();
+                        result = result_view.get();
+                    }
+                    nn_workload_data_copy(workload_output_wrapper, result);
                     delete workload_output_wrapper;
                     break;
                 }
@@ -1543,25 +2423,51 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_execute_0_function(
                     NN_UNREACHABLE_CODE;
                 } // switch
 
-#if ENABLE_WORKLOAD_PROFILING
-                auto t1 = __rdtsc();
-                workload_opaque->profiling_data.work_item_cycles[item].push_back(t1 - t0);
-#endif
-
 #if ENABLE_WORKLOAD_MONITORING
                 nn_workload_item_data_marshaling(item, ++item_count);
 #endif // ENABLE_WORKLOAD_MONITORING
-            }
+            };
 
-            // remove all created views
-            for(auto item : workload_opaque->order_of_execution) {
-                if(item->type==NN_WORK_ITEM_TYPE_INPUT)
-                    delete item->output;
+            // Items of one wave are independent, so they are run as concurrent jobs of device thread pool.
+            // Layers push their own jobs to the same pool - idle workers steal them, so cores are shared
+            // between branches dynamically. Monitoring bookkeeping is not thread-safe.
+#if ENABLE_WORKLOAD_MONITORING
+            const bool run_waves_concurrently = false;
+#else
+            const bool run_waves_concurrently = true;
+#endif
+            for(auto wave_index = 0u; wave_index<context->execution_waves.size(); ++wave_index) {
+                auto &wave = context->execution_waves[wave_index];
+                // buffers reusing memory of earlier ones need clean paddings
+                for(auto &range : workload_opaque->arena.clear[wave_index])
+                    std::memset(context->arena_buffer+range.first, 0, range.second);
+
+                if(!run_waves_concurrently || wave.size()==1) {
+                    for(auto item : wave)
+                        execute_item(item);
+                } else {
+                    std::exception_ptr failure;
+                    std::mutex failure_mutex;
+                    device->thread_pool.parallel_for(static_cast<uint32_t>(wave.size()), [&](uint32_t index) {
+                        try {
+                            execute_item(wave[index]);
+                        }
+                        catch(...) {
+                            std::lock_guard<std::mutex> lock(failure_mutex);
+                            if(!failure) failure = std::current_exception();
+                        }
+                    });
+                    if(failure) std::rethrow_exception(failure);
+                }
             }
         }
         catch(NN_API_STATUS status) {
             return status;
         }
+        catch(std::invalid_argument &) {
+            // kernels reject views of layout they do not handle
+            return NN_API_STATUS_ERROR_INVALID_MEMORY_LAYOUT;
+        }
         catch(...) {
             return NN_API_STATUS_ERROR_OUT_OF_MEMORY;
         }
@@ -1569,47 +2475,65 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_execute_0_function(
     return NN_API_STATUS_OK;
 }
 
-#if ENABLE_WORKLOAD_PROFILING
-void nn_workload_print_profiling_data(nn_workload_opaque_t* workload_opaque){
-    printf("\n------------profiling--------------\n");
-    printf("%20s %20s %10s %10s\n", "layer_type", "layer_name", "cycles", "");
-    printf("%20s %20s %10s %10s\n", "", "", "minimum", "average");
-    for (const auto &item : workload_opaque->order_of_execution) {
-        const auto &times = workload_opaque->profiling_data.work_item_cycles[item];
-        double avg = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
-        uint64_t minimum = *std::min_element(times.begin(), times.end());
-
-        auto item_name = [](nn_workload_item* item){
-            switch (item->type){
-            case NN_WORK_ITEM_TYPE_NORMALIZATION: return "norm";
-            case NN_WORK_ITEM_TYPE_CONVERT_DATA_LAYOUT: return "conv_layout";
-            case NN_WORK_ITEM_TYPE_CONVERT_FLOAT_TO_INT16_FIXEDPOINT: return "conv_float2int";
-            case NN_WORK_ITEM_TYPE_CONVOLUTION: return "cnn_f32";
-            case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2: return "cnn+pool2x2_f32";
-            case NN_WORK_ITEM_TYPE_POOLING: return "pooling_f32";
-            case NN_WORK_ITEM_TYPE_FULLY_CONNECTED: return "fc_f32";
-            case NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT: return "cnn_i16";
-            case NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT: return "pool_i16";
-            case NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN: return "lrn_i16";
-            case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT: return "cnn+pool2x2_i16";
-            case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN:
-            case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN: return "fc_i16";
-            case NN_WORK_ITEM_TYPE_SOFTMAX: return "softmax_f32";
-            case NN_WORK_ITEM_TYPE_SOFTMAX_FIXEDPOINT: return "softmax_i16";
-            case NN_WORK_ITEM_TYPE_MERGE: return "merge";
-            case NN_WORK_ITEM_TYPE_ARITHMETIC: return "arithmetic";
-            case NN_WORK_ITEM_TYPE_VIEW: return "view";
-            case NN_WORK_ITEM_TYPE_INPUT: return "input";
-            case NN_WORK_ITEM_TYPE_OUTPUT: return "output";
-            default: return "";
-            }
+/* executes workload with given inputs & outputs
+   Request is queued on device and function returns immediately, *status is updated when it is done. */
+NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_execute_0_function(
+    nn_workload_t      *workload_public,/* workload to be started */
+    void *             *input,          /* array of pointers with input data;  format is in workload->input_format */
+    void *             *output,         /* array of pointers with output data; format is in workload->output_format */
+    NN_API_STATUS      *status          /* asynchronous status */
+    ) {
+    if(!workload_public || !input || !output || !status) return NN_API_STATUS_ERROR_INVALID_POINTER;
+    try {
+        auto device = reinterpret_cast<nn_device_internal*>(workload_public->device);
+        auto workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload_public + 1);
+
+        // arrays of buffer pointers may be temporaries of the caller - copy them
+        std::vector<void *>  input_buffers(input,  input  + workload_public->input_count);
+        std::vector<void *> output_buffers(output, output + workload_public->output_count);
+
+        std::function<void()> request = [=]() mutable {
+            auto result = nn_workload_execute_0_function_run(workload_public, input_buffers.data(), output_buffers.data());
+            device->request_queue.publish([&]() {
+                *status = (result==NN_API_STATUS_OK) ? NN_API_WORK_FINISHED : result;
+                --workload_opaque->pending_executions;
+            });
         };
 
-        printf("%20s %20s %10llu %10.0f\n", item_name(item), item->name.c_str(), minimum, avg);
+        // pending state is published together with queuing - failed push leaves no execution to wait for
+        device->request_queue.push(std::move(request), [&]() {
+            *status = NN_API_WORK_IN_PROGRESS;
+            ++workload_opaque->pending_executions;
+        });
     }
-    printf("\n-----------------------------------\n");
+    catch(...) {
+        return NN_API_STATUS_ERROR_OUT_OF_MEMORY;
+    }
+    return NN_API_STATUS_OK;
 }
-#endif
+
+/* waits for execution of workload */
+NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_wait_0_function(
+    nn_workload_t      *workload_public,/* workload to wait for */
+    NN_API_STATUS      *status          /* status of single execution or NULL for all executions */
+    ) {
+    if(!workload_public) return NN_API_STATUS_ERROR_INVALID_POINTER;
+    auto device = reinterpret_cast<nn_device_internal*>(workload_public->device);
+    auto workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload_public + 1);
+
+    if(status) {
+        NN_API_STATUS result = NN_API_STATUS_OK;
+        device->request_queue.wait([&]() {
+            result = *status;
+            return result!=NN_API_WORK_IN_PROGRESS;
+        });
+        return (result==NN_API_WORK_FINISHED) ? NN_API_STATUS_OK : result;
+    }
+
+    device->request_queue.wait([&]() { return workload_opaque->pending_executions==0; });
+    return NN_API_STATUS_OK;
+}
+
 
 
 
@@ -1620,13 +2544,12 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_delete_0_function(
     if(!workload_public) return NN_API_STATUS_ERROR_INVALID_POINTER;
     else {
         try {
+            // workload cannot be released while its executions are queued
+            nn_workload_wait_0_function(workload_public, nullptr);
+
             uint8_t *buffer = reinterpret_cast<uint8_t *>(workload_public);
             nn_workload_opaque_t *workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(buffer + sizeof(nn_workload_t));
 
-#if ENABLE_WORKLOAD_PROFILING
-            nn_workload_print_profiling_data(workload_opaque);
-#endif
-
             std::stack<nn_workload_item_t *> todo;
             std::set<nn_workload_item_t *> done;
             for(auto element : workload_opaque->input) todo.push(element);
@@ -1655,14 +2578,101 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_metrics_query_0_function(
     nn_device_t        *device,         /* device context */
     nn_workflow_t      *workflow        /* workflow to be querried */
     ) {
-    return NN_API_STATUS_ERROR_OTHER;
+    if(!array)    return NN_API_STATUS_ERROR_INVALID_POINTER;
+    if(!device)   return NN_API_STATUS_ERROR_INVALID_POINTER;
+    if(!workflow) return NN_API_STATUS_ERROR_INVALID_POINTER;
+    if(workflow->input_count!=1)  return NN_API_STATUS_ERROR_INVALID_INPUT_COUNT;
+    if(workflow->output_count!=1) return NN_API_STATUS_ERROR_INVALID_OUTPUT_COUNT;
+    for(uint32_t index=0; index<workflow->input_count; ++index)
+        if(!workflow->input[index]) return NN_API_STATUS_ERROR_INVALID_WORKFLOW;
+    for(uint32_t index=0; index<workflow->output_count; ++index)
+        if(!workflow->output[index] || !workflow->output[index]->input_count) return NN_API_STATUS_ERROR_INVALID_WORKFLOW;
+
+    // workloads run any batch, so variants are just points of interest: batches set by NN_PARAMETER_CPU_METRICS_BATCHES
+    // or ones derived from thread count; formats are the ones compilation uses without conversions
+    const uint32_t metric_count = 2;
+
+    auto input_format = [](nn_workflow_item_t *input) {
+        bool int16_consumer = false;
+        for(uint32_t index=0; index<input->use_count; ++index)
+            switch(input->use[index]->type) {
+            case NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT:
+            case NN_WORK_ITEM_TYPE_CONVOLUTION_POOLING_MAX_2x2_STRIDE_2x2_INT16_FIXEDPOINT:
+                int16_consumer = true;
+                break;
+            default:
+                break;
+            }
+        if(int16_consumer) return NN_WORKLOAD_DATA_TYPE_I16_ZXY;
+        switch(input->output_format.format) {
+        case NN_DATA_FORMAT_1D: return NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH;
+        case NN_DATA_FORMAT_2D: return NN_WORKLOAD_DATA_TYPE_F32_2D_BATCH;
+        default:                return NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH;
+        }
+    };
+    auto output_format = [](nn_workflow_item_t *output) {
+        switch(output->input[0]->type) {
+        case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN: return NN_WORKLOAD_DATA_TYPE_I16_1D_BATCH;
+        case NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN: return NN_WORKLOAD_DATA_TYPE_I32_1D_BATCH;
+        default:
+            break;
+        }
+        switch(output->output_format.format) {
+        case NN_DATA_FORMAT_1D: return NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH;
+        case NN_DATA_FORMAT_2D: return NN_WORKLOAD_DATA_TYPE_F32_2D_BATCH;
+        default:                return NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH;
+        }
+    };
+
+    nn_workflow_metrics_array_t *result = nullptr;
+    try {
+        auto device_internal = reinterpret_cast<nn_device_internal*>(device);
+        auto &calibration = device_internal->cost_model.get_calibration(device_internal->thread_pool);
+        const auto batches = device_internal->metrics_batches.empty()
+            ? nn_cpu_cost_model::default_batches(device_internal->thread_pool.get_num_threads())
+            : device_internal->metrics_batches;
+        const auto variant_count = static_cast<uint32_t>(batches.size());
+
+        // single allocation per variant: entry with overindexed metric table, followed by format arrays
+        const size_t entry_size = sizeof(nn_workflow_metrics_t) + sizeof(uint64_t)*(metric_count-1);
+        const size_t formats_size = sizeof(NN_WORKLOAD_DATA_TYPE)*(workflow->input_count+workflow->output_count);
+
+        result = new nn_workflow_metrics_array_t{workflow->input_count, workflow->output_count, 0, new nn_workflow_metrics_t *[variant_count]()};
+        for(uint32_t variant=0; variant<variant_count; ++variant) {
+            uint8_t *buffer = new uint8_t[entry_size+formats_size]();
+            auto entry = reinterpret_cast<nn_workflow_metrics_t *>(buffer);
+            auto formats = reinterpret_cast<NN_WORKLOAD_DATA_TYPE *>(buffer+entry_size);
+            result->array[variant] = entry;
+            *const_cast<uint32_t *>(&result->variant_count) = variant+1;
+
+            for(uint32_t index=0; index<workflow->input_count; ++index)
+                formats[index] = input_format(workflow->input[index]);
+            for(uint32_t index=0; index<workflow->output_count; ++index)
+                formats[workflow->input_count+index] = output_format(workflow->output[index]);
+            *const_cast<NN_WORKLOAD_DATA_TYPE **>(&entry->input_format) = formats;
+            *const_cast<NN_WORKLOAD_DATA_TYPE **>(&entry->output_format) = formats+workflow->input_count;
+            *const_cast<uint32_t *>(&entry->batch) = batches[variant];
+            nn_cpu_cost_model::estimate_workflow(calibration, workflow, batches[variant], entry->metric[0], entry->metric[1]);
+        }
+        *array = result;
+    }
+    catch(...) {
+        nn_workflow_metrics_delete_0_function(result);
+        return NN_API_STATUS_ERROR_OUT_OF_MEMORY;
+    }
+    return NN_API_STATUS_OK;
 }
 
 /* delete array of workload metrics */
 NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_metrics_delete_0_function(
     nn_workflow_metrics_array_t *array  /* array to delete */
     ) {
-    return NN_API_STATUS_ERROR_OTHER;
+    if(!array) return NN_API_STATUS_ERROR_INVALID_POINTER;
+    for(uint32_t variant=0; variant<array->variant_count; ++variant)
+        delete[] reinterpret_cast<uint8_t *>(array->array[variant]);
+    delete[] array->array;
+    delete array;
+    return NN_API_STATUS_OK;
 }
 
 /* validate parameters of work_item for this particular device */
@@ -1679,7 +2689,49 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_device_parameter_get_0_function(
     void               *buffer,         /* buffer to store result to */
     uint32_t            size            /* size of buffer */
     ) {
-    return NN_API_STATUS_ERROR_OTHER;
+    if(!device || !buffer) return NN_API_STATUS_ERROR_INVALID_POINTER;
+    auto device_internal = reinterpret_cast<nn_device_internal*>(device);
+    switch(parameter) {
+    case NN_PARAMETER_CPU_THREAD_PLACEMENT:
+        if(size < sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        *static_cast<uint32_t *>(buffer) = device_internal->thread_pool.get_placement();
+        return NN_API_STATUS_OK;
+    case NN_PARAMETER_CPU_TUNING_DATABASE: {
+        const auto path = device_internal->tuning_database.get_path();
+        if(size < path.size()+1) return NN_API_STATUS_ERROR_OTHER;
+        std::memcpy(buffer, path.c_str(), path.size()+1);
+        return NN_API_STATUS_OK;
+    }
+    case NN_PARAMETER_CPU_THREAD_COUNT:
+        if(size < sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        *static_cast<uint32_t *>(buffer) = device_internal->thread_pool.get_num_threads();
+        return NN_API_STATUS_OK;
+    case NN_PARAMETER_CPU_PROFILING:
+        if(size < sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        *static_cast<uint32_t *>(buffer) = device_internal->profiler.is_enabled() ? 1 : 0;
+        return NN_API_STATUS_OK;
+    case NN_PARAMETER_CPU_PROFILING_COUNTERS:
+        if(size < sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        *static_cast<uint32_t *>(buffer) = device_internal->profiler.is_counters_enabled() ? 1 : 0;
+        return NN_API_STATUS_OK;
+    case NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE:
+        if(size < sizeof(float)) return NN_API_STATUS_ERROR_OTHER;
+        *static_cast<float *>(buffer) = device_internal->convolution_tolerance;
+        return NN_API_STATUS_OK;
+    case NN_PARAMETER_CPU_ISA:
+        if(size < sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        *static_cast<uint32_t *>(buffer) = device_internal->isa;
+        return NN_API_STATUS_OK;
+    case NN_PARAMETER_CPU_METRICS_BATCHES: {
+        const auto &batches = device_internal->metrics_batches;
+        if(size < (batches.size()+1)*sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        std::copy(batches.begin(), batches.end(), static_cast<uint32_t *>(buffer));
+        static_cast<uint32_t *>(buffer)[batches.size()] = 0;
+        return NN_API_STATUS_OK;
+    }
+    default:
+        return NN_API_STATUS_ERROR_OTHER;
+    }
 }
 
 NN_API_STATUS NN_API_CALL_CONVENTION nn_device_parameter_set_0_function(
@@ -1688,5 +2740,92 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_device_parameter_set_0_function(
     void               *buffer,         /* buffer with argument */
     uint32_t            size            /* size of buffer */
     ) {
-    return NN_API_STATUS_ERROR_OTHER;
+    if(!device || !buffer) return NN_API_STATUS_ERROR_INVALID_POINTER;
+    auto device_internal = reinterpret_cast<nn_device_internal*>(device);
+    switch(parameter) {
+    case NN_PARAMETER_CPU_THREAD_PLACEMENT: {
+        if(size < sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        const auto placement = *static_cast<uint32_t *>(buffer);
+        if(placement > NN_CPU_THREAD_PLACEMENT_LAST) return NN_API_STATUS_ERROR_OTHER;
+        device_internal->thread_pool.set_placement(static_cast<NN_CPU_THREAD_PLACEMENT>(placement));
+        return NN_API_STATUS_OK;
+    }
+    case NN_PARAMETER_CPU_TUNING_DATABASE: {
+        auto path = static_cast<const char *>(buffer);
+        device_internal->tuning_database.set_path(std::string(path, std::find(path, path+size, '\0')));
+        return NN_API_STATUS_OK;
+    }
+    case NN_PARAMETER_CPU_THREAD_COUNT: {
+        if(size < sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        const auto num_threads = *static_cast<uint32_t *>(buffer);
+        if(num_threads == 0) return NN_API_STATUS_ERROR_OTHER;
+        try {
+            device_internal->thread_pool.set_num_threads(num_threads);
+        }
+        catch(...) {
+            return NN_API_STATUS_ERROR_OUT_OF_MEMORY;
+        }
+        return NN_API_STATUS_OK;
+    }
+    case NN_PARAMETER_CPU_PROFILING: {
+        if(size < sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        const auto enabled = *static_cast<uint32_t *>(buffer);
+        if(enabled > 1) return NN_API_STATUS_ERROR_OTHER;
+        device_internal->profiler.set_enabled(enabled != 0);
+        return NN_API_STATUS_OK;
+    }
+    case NN_PARAMETER_CPU_PROFILING_COUNTERS: {
+        if(size < sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        const auto enabled = *static_cast<uint32_t *>(buffer);
+        if(enabled > 1) return NN_API_STATUS_ERROR_OTHER;
+        if(!device_internal->profiler.set_counters_enabled(enabled != 0)) return NN_API_STATUS_ERROR_OTHER;
+        return NN_API_STATUS_OK;
+    }
+    case NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE: {
+        if(size < sizeof(float)) return NN_API_STATUS_ERROR_OTHER;
+        const auto tolerance = *static_cast<float *>(buffer);
+        if(!(tolerance >= 0.0f && tolerance <= 1.0f)) return NN_API_STATUS_ERROR_OTHER;
+        device_internal->convolution_tolerance = tolerance;
+        return NN_API_STATUS_OK;
+    }
+    case NN_PARAMETER_CPU_ISA: {
+        if(size < sizeof(uint32_t)) return NN_API_STATUS_ERROR_OTHER;
+        const auto isa = *static_cast<uint32_t *>(buffer);
+        if(isa > NN_CPU_ISA_LAST || !nn_cpu_isa_supported(static_cast<NN_CPU_ISA>(isa))) return NN_API_STATUS_ERROR_OTHER;
+        device_internal->isa = static_cast<NN_CPU_ISA>(isa);
+        return NN_API_STATUS_OK;
+    }
+    case NN_PARAMETER_CPU_METRICS_BATCHES: {
+        auto batches = static_cast<const uint32_t *>(buffer);
+        try {
+            std::vector<uint32_t> list(batches, std::find(batches, batches+size/sizeof(uint32_t), 0u));
+            std::sort(list.begin(), list.end());
+            list.erase(std::unique(list.begin(), list.end()), list.end());
+            device_internal->metrics_batches = std::move(list);
+        }
+        catch(...) {
+            return NN_API_STATUS_ERROR_OUT_OF_MEMORY;
+        }
+        return NN_API_STATUS_OK;
+    }
+    case NN_PARAMETER_CPU_PROFILING_TRACE: {
+        auto path = static_cast<const char *>(buffer);
+        try {
+            std::map<std::thread::id, std::string> thread_names;
+            const auto workers = device_internal->thread_pool.get_worker_ids();
+            for(size_t index = 0; index < workers.size(); ++index)
+                thread_names[workers[index]] = "worker " + std::to_string(index);
+            device_internal->profiler.write_trace(std::string(path, std::find(path, path+size, '\0')), thread_names);
+        }
+        catch(std::bad_alloc &) {
+            return NN_API_STATUS_ERROR_OUT_OF_MEMORY;
+        }
+        catch(...) {
+            return NN_API_STATUS_ERROR_OTHER;
+        }
+        return NN_API_STATUS_OK;
+    }
+    default:
+        return NN_API_STATUS_ERROR_OTHER;
+    }
 }
@@ -30,11 +30,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../api/nn_device_interface_0.h"
 #include "../../common/nn_workload_data.h"
 #include "cpu_device_internal.h"
+#include "cpu_workload_cache.h"
 #include <vector>
 #include <deque>
 #include <map>
-
-#define ENABLE_WORKLOAD_PROFILING 0
+#include <memory>
+#include <mutex>
 
 const uint32_t max_threads = 18;
 
@@ -176,20 +177,60 @@ typedef struct nn_workload_item {
     nn_primitive_handle_t primitive;
 } nn_workload_item_t;
 
-typedef struct profiling_data{
-    std::map<nn_workload_item*, std::vector<uint64_t>> work_item_cycles;
-} profiling_data_t;
+/* activations of workload packed into single arena
+   Buffers of items with disjoint lifetimes (in waves of execution) share the same memory. */
+typedef struct nn_workload_arena {
+    std::unique_ptr<nn_workload_data_core_t>            buffer;  /* memory of all activations */
+    std::map<nn_workload_data_core_t *, size_t>         offset;  /* placement of activation buffers in arena */
+    std::vector<std::vector<std::pair<size_t, size_t>>> clear;   /* per wave: ranges (offset, size) zeroed before it runs -
+                                                                    padded buffers placed over memory of other ones */
+    uint64_t                                            unplanned_size = 0; /* sum of sizes of all activation buffers */
+} nn_workload_arena_t;
+
+/* per-request state of workload execution
+   Compiled items are shared by all executions and are not modified by them. Every running execution has its own
+   context with copies of work items - they share parameters & primitives, but have private activations & views. */
+typedef struct nn_workload_execution_context {
+    std::vector<std::unique_ptr<nn_workload_item_t>> items;           /* copies of compiled items */
+    std::map<nn_workload_item_t *, nn_workload_item_t *> compiled_item; /* context item -> compiled item */
+    std::vector<std::unique_ptr<nn_workload_data_t>> activations;     /* outputs owned by context (empty if compiled ones are used) */
+    std::unique_ptr<nn_workload_data_core_t>         arena;           /* copy of workload arena (empty if compiled one is used) */
+    uint8_t                                         *arena_buffer;    /* memory of activations used by context */
+    std::vector<std::vector<nn_workload_item_t *>>   execution_waves; /* waves of workload with context items */
+    std::vector<nn_workload_item_t *>                direct_output;   /* context items writing straight to user outputs */
+    std::vector<nn_workload_data_t *>                batch_views;     /* activation views spanning whole batch - narrowed to
+                                                                         images submitted by execution of smaller batch */
+    std::vector<std::pair<nn_workload_item_t *, nn_workload_data_t *>> bound_outputs; /* items bound to user outputs
+                                                                                         during execution & their own outputs */
+} nn_workload_execution_context_t;
 
 /* opaque (invisible to user) part of workload */
 typedef struct nn_workload_opaque {
     std::vector<nn_workload_item_t *> input;
     std::vector<nn_workload_item_t *> output;
     std::deque <nn_workload_item_t *> order_of_execution;
-#if ENABLE_WORKLOAD_PROFILING
-    profiling_data_t                  profiling_data;
-#endif
+    std::vector<std::vector<nn_workload_item_t *>> execution_waves; /* items grouped by dependency depth; items of one wave are independent */
+    nn_workload_arena_t               arena;
+    std::vector<nn_workload_item_t *> direct_output; /* per output: item writing straight to user buffer (or null if it is copied) */
+    uint32_t                          pending_executions = 0; /* queued & running executions, guarded by device request queue */
+    std::vector<std::unique_ptr<nn_workload_execution_context_t>> execution_contexts; /* all contexts created so far */
+    std::vector<nn_workload_execution_context_t *> idle_execution_contexts;          /* contexts not used by running executions */
+    std::mutex                        execution_contexts_mutex;
+    uint64_t                          fingerprint = 0; /* hash of structure of workflow workload was compiled from */
+    std::unique_ptr<nn_cpu_workload_cache> cache;    /* cache file workload was loaded from (holds its parameters) */
 } nn_workload_opaque_t;
 
+/* returns buffers with parameters (weights, biases, factors) of workload item */
+std::vector<nn_workload_data_t *> nn_workload_item_parameter_buffers(
+    nn_workload_item_t *load_item
+    );
+
+/* sets buffers with parameters of workload item, in order returned by nn_workload_item_parameter_buffers */
+void nn_workload_item_set_parameter_buffers(
+    nn_workload_item_t *load_item,
+    const std::vector<nn_workload_data_t *> &parameters
+    );
+
 /* create empty workflow */
 NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_create_0_function(
     nn_workflow_t *    *workflow,       /* workflow to be created */
@@ -212,6 +253,20 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_compile_0_function(
     uint32_t                batch           /* batch size for compilation */
     );
 
+/* save compiled workload to cache file */
+NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_save_0_function(
+    nn_workload_t          *workload,       /* workload to be saved */
+    const char             *path            /* path of cache file */
+    );
+
+/* create workload from cache file & workflow it was compiled from */
+NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_load_0_function(
+    nn_workload_t         **workload,       /* resulting workload */
+    nn_device_t            *device,         /* device context */
+    nn_workflow_t          *workflow,       /* workflow with the same structure as compiled one */
+    const char             *path            /* path of cache file */
+    );
+
 /* executes workload with given inputs & outputs */
 NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_execute_0_function(
     nn_workload_t      *workload,       /* workload to be started */
@@ -220,6 +275,12 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_execute_0_function(
     NN_API_STATUS      *status          /* asynchronous status */
     );
 
+/* waits for execution of workload */
+NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_wait_0_function(
+    nn_workload_t      *workload,       /* workload to wait for */
+    NN_API_STATUS      *status          /* status of single execution or NULL for all executions */
+    );
+
 /* delete workload */
 NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_delete_0_function(
     nn_workload_t       *workload       /* workload to be deleted */
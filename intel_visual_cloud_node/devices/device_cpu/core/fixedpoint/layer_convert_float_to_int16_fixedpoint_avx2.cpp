@@ -32,6 +32,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <immintrin.h>
 #include <string.h>
 #include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 // NN_CODE_UNREACHABLE signal to supporting compiler that specific location in code cannot be reached
@@ -58,7 +59,6 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 const auto C_simd_width = sizeof(__m256) / sizeof(float);
 
 // SIMD width for this implementation
-static const auto C_max_acc = 12u;
 static const auto C_batch_size = C_simd_width;
 
 namespace int16_fixedpoint {
@@ -136,269 +136,29 @@ namespace int16_fixedpoint {
     }
     }*/
 
-#define CONVERT_TO_SAT_INT16(N, V1, V2) \
-    if (T_SIZE < N) \
-    V1 = _mm256_castsi256_ps(_mm256_packs_epi32(_mm256_castps_si256(V1), _mm256_setzero_si256())); \
-else \
-    V1 = _mm256_castsi256_ps(_mm256_packs_epi32(_mm256_castps_si256(V1), _mm256_castps_si256(V2)))
-
-#define PERMUTE_4x64(N, V1) \
-    if (T_SIZE >= 1) \
-    acc0 = _mm256_castsi256_ps(_mm256_permute4x64_epi64(_mm256_castps_si256(acc0), 0xd8))
-
-#define STORE(ADR, N, V1) \
-    if (T_SIZE >= (N + 1)) \
-    { \
-    if (T_SIZE < (N + 2)) \
-    _mm256_maskstore_epi32((int32_t *)ADR + (N / 2) * C_batch_size, _mm256_castps_si256(V1), mask); \
-    else \
-    _mm256_storeu_si256((__m256i *)ADR + (N / 2) * C_batch_size, _mm256_castps_si256(V1)); \
-}
-
-
-    template<uint32_t T_SIZE>
-    void convert_float_toint16_compute_block_shiftR(
-        const float* &input_ptr,
-        int16_t* &output_ptr,
-        __m256 &multiplier)
-    {
-        // We are not using table of registers and unroll pragmas
-        // due to compiler which have issues with register allocation
-        // and needs special, obvious treatment. Template immediate
-        // arguments matching will remove all conditions in this code.
-        __m256  acc0, acc1, acc2, acc3, acc4,
-            acc5, acc6, acc7, acc8, acc9,
-            acc10, acc11, acc12, acc13, acc14, acc15;
-
-        // Load inputs and perform e^x
-        if (T_SIZE >= 1)  {
-            acc0 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 0 * C_batch_size), multiplier);
-            acc1 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 1 * C_batch_size), multiplier);
-        }
-        if (T_SIZE >= 3)  {
-            acc2 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 2 * C_batch_size), multiplier);
-            acc3 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 3 * C_batch_size), multiplier);
-        }
-        if (T_SIZE >= 5)  {
-            acc4 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 4 * C_batch_size), multiplier);
-            acc5 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 5 * C_batch_size), multiplier);
-        }
-        if (T_SIZE >= 7)  {
-            acc6 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 6 * C_batch_size), multiplier);
-            acc7 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 7 * C_batch_size), multiplier);
-        }
-        if (T_SIZE >= 9)  {
-            acc8 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 8 * C_batch_size), multiplier);
-            acc9 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 9 * C_batch_size), multiplier);
-        }
-        if (T_SIZE >= 11) {
-            acc10 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 10 * C_batch_size), multiplier);
-            acc11 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 11 * C_batch_size), multiplier);
-        }
-        if (T_SIZE >= 13) {
-            acc12 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 12 * C_batch_size), multiplier);
-            acc13 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 13 * C_batch_size), multiplier);
-        }
-        if (T_SIZE >= 15){
-            acc14 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 14 * C_batch_size), multiplier);
-            acc15 = _mm256_div_ps(_mm256_loadu_ps(input_ptr + 15 * C_batch_size), multiplier);
-        }
-
-        // round results.
-        if (T_SIZE >= 1){
-            acc0 = _mm256_round_ps(acc0, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-            acc1 = _mm256_round_ps(acc1, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-        }
-        if (T_SIZE >= 3) {
-            acc2 = _mm256_round_ps(acc2, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-            acc3 = _mm256_round_ps(acc3, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-        }
-        if (T_SIZE >= 5) {
-            acc4 = _mm256_round_ps(acc4, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-            acc5 = _mm256_round_ps(acc5, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-        }
-        if (T_SIZE >= 7) {
-            acc6 = _mm256_round_ps(acc6, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-            acc7 = _mm256_round_ps(acc7, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-        }
-        if (T_SIZE >= 9) {
-            acc8 = _mm256_round_ps(acc8, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-            acc9 = _mm256_round_ps(acc9, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-        }
-        if (T_SIZE >= 11) {
-            acc10 = _mm256_round_ps(acc10, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-            acc11 = _mm256_round_ps(acc11, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-        }
-        if (T_SIZE >= 13) {
-            acc12 = _mm256_round_ps(acc12, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-            acc13 = _mm256_round_ps(acc13, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-        }
-        if (T_SIZE >= 15) {
-            acc14 = _mm256_round_ps(acc14, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-            acc15 = _mm256_round_ps(acc15, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
-        }
-
-        // convert to int32
-        if (T_SIZE >= 1) {
-            acc0 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc0));
-            acc1 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc1));
-        }
-        if (T_SIZE >= 3){
-            acc2 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc2));
-            acc3 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc3));
-        }
-        if (T_SIZE >= 5) {
-            acc4 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc4));
-            acc5 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc5));
-        }
-        if (T_SIZE >= 7) {
-            acc6 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc6));
-            acc7 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc7));
-        }
-        if (T_SIZE >= 9) {
-            acc8 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc8));
-            acc9 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc9));
-        }
-        if (T_SIZE >= 11) {
-            acc10 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc10));
-            acc11 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc11));
-        }
-        if (T_SIZE >= 13){
-            acc12 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc12));
-            acc13 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc13));
-        }
-        if (T_SIZE >= 15){
-            acc14 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc14));
-            acc15 = _mm256_castsi256_ps(_mm256_cvttps_epi32(acc15));
-        }
-
-        ////convert to saturated int16
-        if (T_SIZE >= 1)
-        {
-            CONVERT_TO_SAT_INT16(2, acc0, acc1);
-        }
-        if (T_SIZE >= 3)
-        {
-            CONVERT_TO_SAT_INT16(4, acc2, acc3);
-        }
-        if (T_SIZE >= 5)
-        {
-            CONVERT_TO_SAT_INT16(6, acc4, acc5);
-        }
-        if (T_SIZE >= 7)
-        {
-            CONVERT_TO_SAT_INT16(8, acc6, acc7);
-        }
-        if (T_SIZE >= 9)
-        {
-            CONVERT_TO_SAT_INT16(10, acc8, acc9);
-        }
-        if (T_SIZE >= 11)
-        {
-            CONVERT_TO_SAT_INT16(12, acc10, acc11);
-        }
-        if (T_SIZE >= 13)
-        {
-            CONVERT_TO_SAT_INT16(14, acc12, acc13);
-        }
-        if (T_SIZE >= 15)
-        {
-            CONVERT_TO_SAT_INT16(16, acc14, acc15);
-        }
-
-        PERMUTE_4x64(1, acc0);
-        PERMUTE_4x64(3, acc2);
-        PERMUTE_4x64(5, acc4);
-        PERMUTE_4x64(7, acc6);
-        PERMUTE_4x64(9, acc8);
-        PERMUTE_4x64(11, acc10);
-        PERMUTE_4x64(13, acc12);
-        PERMUTE_4x64(15, acc14);
-
-        __m256i mask = _mm256_set_epi32(0, 0, 0, 0, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff);
-        // Store results.
-
-        STORE(output_ptr, 0, acc0);
-        STORE(output_ptr, 2, acc2);
-        STORE(output_ptr, 4, acc4);
-        STORE(output_ptr, 6, acc6);
-        STORE(output_ptr, 8, acc8);
-        STORE(output_ptr, 10, acc10);
-        STORE(output_ptr, 12, acc12);
-        STORE(output_ptr, 14, acc14);
-
-        input_ptr += C_batch_size*T_SIZE;
-        output_ptr += C_batch_size*T_SIZE;
-    }
-
+    // Converts buffer of output_width floats: output = saturate(round(input * 2^output_fraction)).
     void convert_float_to_int16_fixedpoint_contiguous(
         const nn_arguments_forward_convert_float_to_int16_fixedpoint_t &arguments,
         size_t output_width,
         const float *input_ptr,
         std::int16_t *output_ptr) {
-        const auto num_full_blocks = output_width / C_max_acc;
-        const auto partial_block_size = output_width % C_max_acc;
+        const float scale = std::ldexp(1.0f, arguments.output_fraction);
+        const __m256 scaler = _mm256_set1_ps(scale);
+        const size_t block_size = 2 * C_batch_size;
 
-        const auto out_fraction = arguments.output_fraction;
-        __m256 multiplier;
-        if (out_fraction > 8)
-            multiplier = _mm256_set1_ps((float)(1 << out_fraction));
-        else
-            multiplier = _mm256_set1_ps((float)(1 / (1 << -out_fraction)));
+        size_t i = 0;
+        for (; i + block_size <= output_width; i += block_size) {
+            __m256i low = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(input_ptr + i), scaler));
+            __m256i high = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(input_ptr + i + C_batch_size), scaler));
 
-        for (auto block = 0u; block < num_full_blocks; ++block) {
-            // Run computation.
-            convert_float_toint16_compute_block_shiftR<C_max_acc>(input_ptr, output_ptr, multiplier);
+            // packing works within 128-bit lanes, permutation restores order of elements
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xd8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(output_ptr + i), packed);
         }
 
-        switch (partial_block_size) {
-        case 0:
-            break;
-        case 1:
-            convert_float_toint16_compute_block_shiftR<1>(input_ptr, output_ptr, multiplier);
-            break;
-        case 2:
-            convert_float_toint16_compute_block_shiftR<2>(input_ptr, output_ptr, multiplier);
-            break;
-        case 3:
-            convert_float_toint16_compute_block_shiftR<3>(input_ptr, output_ptr, multiplier);
-            break;
-        case 4:
-            convert_float_toint16_compute_block_shiftR<4>(input_ptr, output_ptr, multiplier);
-            break;
-        case 5:
-            convert_float_toint16_compute_block_shiftR<5>(input_ptr, output_ptr, multiplier);
-            break;
-        case 6:
-            convert_float_toint16_compute_block_shiftR<6>(input_ptr, output_ptr, multiplier);
-            break;
-        case 7:
-            convert_float_toint16_compute_block_shiftR<7>(input_ptr, output_ptr, multiplier);
-            break;
-        case 8:
-            convert_float_toint16_compute_block_shiftR<8>(input_ptr, output_ptr, multiplier);
-            break;
-        case 9:
-            convert_float_toint16_compute_block_shiftR<9>(input_ptr, output_ptr, multiplier);
-            break;
-        case 10:
-            convert_float_toint16_compute_block_shiftR<10>(input_ptr, output_ptr, multiplier);
-            break;
-        case 11:
-            convert_float_toint16_compute_block_shiftR<11>(input_ptr, output_ptr, multiplier);
-            break;
-        case 12:
-            convert_float_toint16_compute_block_shiftR<12>(input_ptr, output_ptr, multiplier);
-            break;
-        case 13:
-            convert_float_toint16_compute_block_shiftR<13>(input_ptr, output_ptr, multiplier);
-            break;
-        case 14:
-            convert_float_toint16_compute_block_shiftR<14>(input_ptr, output_ptr, multiplier);
-            break;
-        default:
-            NN_UNREACHABLE_CODE;
-        }
+        for (; i < output_width; ++i)
+            output_ptr[i] = static_cast<std::int16_t>(_mm_extract_epi16(
+                _mm_packs_epi32(_mm_cvtps_epi32(_mm_set_ss(input_ptr[i] * scale)), _mm_setzero_si128()), 0));
     }
 
     void
@@ -418,7 +178,7 @@ else \
     {
             const size_t input_block_size = sizeof(__m256) / sizeof(float)* 3;
             const size_t output_block_size = sizeof(__m256i) / sizeof(std::int16_t) * 2;
-            const float scale = (1.0f * (1 << arguments.output_fraction));
+            const float scale = std::ldexp(1.0f, arguments.output_fraction);
             const __m256 scaler = _mm256_set1_ps(scale);
             size_t i;
 
@@ -508,6 +268,26 @@ else \
             }
         }
 
+    // Elements in single image of buffer if view spans whole images and batch is outermost dimension of buffer,
+    // so images of view are one contiguous range of it; zero otherwise.
+    static size_t get_contiguous_image_size(const nn_workload_data_t *view) {
+        size_t image_size = 1;
+        bool outer = false;
+        for (auto index = 0u; index < NN_DIMENSION_COUNT; ++index) {
+            const auto dimension = view->parent->layout.ordering.t[index];
+            const auto length = view->parent->lengths.t[dimension];
+            if (dimension == NN_DATA_COORD_n) {
+                outer = true;
+                continue;
+            }
+            if (outer && length != 1) return 0;
+            if (view->view_begin.t[dimension] != 0 || view->view_end.t[dimension] + 1 != length) return 0;
+            image_size *= length;
+        }
+        return image_size * view->parent->lengths.t[NN_DATA_COORD_n] * view->parent->data_type_size == view->parent->buffer_size
+            ? image_size : 0;
+    }
+
     void run_convert_float_to_int16_fp_work_item(nn_workload_item *const work_item) {
         auto input_view = reinterpret_cast<nn::nn_workload_data_t<float> *>(work_item->input[0]->output);
         auto output_view = reinterpret_cast<nn::nn_workload_data_t<std::int16_t> *>(work_item->output);
@@ -538,6 +318,16 @@ else \
             input_width)) {
             convert_float_to_int16_fixedpoint_contiguous(arguments, input_width, input_ptr, output_ptr);
         }
+        else if (get_contiguous_image_size(input_view) != 0 &&
+            get_contiguous_image_size(input_view) == get_contiguous_image_size(output_view) &&
+            input_view->view_begin.t[NN_DATA_COORD_n] == output_view->view_begin.t[NN_DATA_COORD_n] &&
+            input_view->view_end.t[NN_DATA_COORD_n] == output_view->view_end.t[NN_DATA_COORD_n]) {
+            // views limited to part of batch, as by execution of smaller batch, convert their images as one range
+            const auto image_size = get_contiguous_image_size(input_view);
+            const auto offset = input_view->view_begin.t[NN_DATA_COORD_n] * image_size;
+            convert_float_to_int16_fixedpoint_contiguous(
+                arguments, input_view->get_length(NN_DATA_COORD_n) * image_size, input_ptr + offset, output_ptr + offset);
+        }
         else if ((input_view->parent->lengths.t[NN_DATA_COORD_z] == 3 &&
             input_view->parent->lengths.t[NN_DATA_COORD_p] == 1 &&
             input_view->parent->lengths.t[NN_DATA_COORD_q] == 1) &&
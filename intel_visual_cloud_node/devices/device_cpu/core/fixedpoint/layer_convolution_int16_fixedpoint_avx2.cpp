@@ -27,6 +27,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "../../../common/nn_workload_data.h"
 #include "../../api_internal/nn_device_interface_0_internal.h"
+#include "../../api_internal/cpu_partition.h"
 #include "layer_convolution_int16_fixedpoint_avx2.h"
 
 #include <iostream>
@@ -689,13 +690,35 @@ namespace int16_fixedpoint
             (work_item->output->view_end.t[NN_DATA_COORD_z] - work_item->output->view_begin.t[NN_DATA_COORD_z] + 1) *
             ofm_out_block_size;
 
-        const auto batch_size = work_item->output->parent->lengths.t[NN_DATA_COORD_n];
+        const auto batch_size = work_item->output->view_end.t[NN_DATA_COORD_n] - work_item->output->view_begin.t[NN_DATA_COORD_n] + 1;
 
         const auto ofm_group_size = OFMBlock;
 
         const auto ofm_groups_per_batch = num_output_feature_maps / ofm_group_size;
 
-        const auto task_count = batch_size * ofm_groups_per_batch;
+        const auto cpp_master_input = reinterpret_cast<nn::nn_workload_data_t<int16_t>*>(work_item->input[0]->output);
+        const auto cpp_master_output = reinterpret_cast<nn::nn_workload_data_t<int16_t>*>(work_item->output);
+        const auto cpp_master_weights = reinterpret_cast<nn::nn_workload_data_t<int16_t>*>(master_arguments.weights);
+
+        const auto num_rows = cpp_master_output->get_length(NN_DATA_COORD_y);
+        const auto num_input_feature_maps = cpp_master_input->parent->lengths.t[NN_DATA_COORD_z] * cpp_master_input->parent->lengths.t[NN_DATA_COORD_p];
+
+        // Groups of output feature maps & rows of image computed by single job; kernel computes pairs of rows
+        // when their number is even, so ranges of rows keep them.
+        const auto partition = nn_cpu_partition_choose(
+            nn_cpu_partition_work{static_cast<uint32_t>(batch_size),
+                                  static_cast<uint32_t>(ofm_groups_per_batch),
+                                  static_cast<uint32_t>(num_rows),
+                                  num_rows % 2 == 0 ? 2u : 1u,
+                                  static_cast<uint64_t>(cpp_master_weights->parent->buffer_size) / ofm_groups_per_batch,
+                                  static_cast<uint64_t>(cpp_master_weights->parent->lengths.t[NN_DATA_COORD_x]) *
+                                      cpp_master_input->parent->lengths.t[NN_DATA_COORD_x] * num_input_feature_maps * sizeof(int16_t)},
+            threadpool_size);
+        const auto groups_per_task = partition.slices_per_job;
+        const auto rows_per_task = partition.rows_per_job;
+        const auto row_tasks = (num_rows + rows_per_task - 1) / rows_per_task;
+
+        const auto task_count = partition.num_jobs;
 
         // Check if we have enough data to cover all threads.
         if (threadpool_size < 2 || task_count < 2)
@@ -711,31 +734,29 @@ namespace int16_fixedpoint
             slave_work_items.resize(task_count);
 
             // Fill slave work items.
-            for (auto it_ofm_group = 0u; it_ofm_group < ofm_groups_per_batch; ++it_ofm_group) {
-                for (auto it_batch = 0u; it_batch < batch_size; ++it_batch) {
+            for (auto it_ofm_group = 0u; it_ofm_group < ofm_groups_per_batch / groups_per_task; ++it_ofm_group) {
+                for (auto it_task = 0u; it_task < batch_size * row_tasks; ++it_task) {
 
-                    auto& slave = slave_work_items[it_batch + it_ofm_group * batch_size];
+                    auto& slave = slave_work_items[it_task + it_ofm_group * batch_size * row_tasks];
                     auto& slave_arguments = slave.arguments.forward_convolution_fixedpoint;
 
                     // Copy all data from master.
                     slave.type = work_item->type;
                     slave_arguments = master_arguments;
 
-                    const auto cpp_master_input = reinterpret_cast<nn::nn_workload_data_t<int16_t>*>(work_item->input[0]->output);
-                    const auto cpp_master_output = reinterpret_cast<nn::nn_workload_data_t<int16_t>*>(work_item->output);
-                    const auto cpp_master_weights = reinterpret_cast<nn::nn_workload_data_t<int16_t>*>(master_arguments.weights);
+                    auto work_begin_batch = it_task / row_tasks;
+                    auto work_begin_row = it_task % row_tasks * rows_per_task;
+                    auto work_begin_ofm_out_block = it_ofm_group * groups_per_task * ofm_group_size / ofm_out_block_size;
 
-                    auto work_begin_batch = it_batch;
-                    auto work_begin_ofm_out_block = it_ofm_group * ofm_group_size / ofm_out_block_size;
-
-                    auto work_end_batch = it_batch + 1;
-                    auto work_end_ofm_out_block = work_begin_ofm_out_block + ofm_group_size / ofm_out_block_size;
+                    auto work_end_batch = work_begin_batch + 1;
+                    auto work_end_row = std::min(work_begin_row + rows_per_task, num_rows);
+                    auto work_end_ofm_out_block = work_begin_ofm_out_block + groups_per_task * ofm_group_size / ofm_out_block_size;
 
                     nn_workload_data_coords_t output_view_begin =
                     {
                         work_begin_batch,
                         0,
-                        0,
+                        work_begin_row,
                         work_begin_ofm_out_block,
                         0,
                         0
@@ -745,17 +766,18 @@ namespace int16_fixedpoint
                     {
                         work_end_batch - 1,
                         cpp_master_output->get_length(NN_DATA_COORD_x) - 1,
-                        cpp_master_output->get_length(NN_DATA_COORD_y) - 1,
+                        work_end_row - 1,
                         work_end_ofm_out_block - 1,
                         cpp_master_output->get_length(NN_DATA_COORD_p) - 1,
                         0
                     };
 
+                    // First input row of view is read by first output row.
                     nn_workload_data_coords_t input_view_begin =
                     {
                         work_begin_batch,
                         0,
-                        0,
+                        static_cast<uint32_t>(work_begin_row * master_arguments.stride[1]),
                         0,
                         0,
                         0
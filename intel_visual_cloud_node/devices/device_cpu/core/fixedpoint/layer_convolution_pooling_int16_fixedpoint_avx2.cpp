@@ -675,7 +675,7 @@ template <const int T_input_z_block_size,
             (work_item->output->view_end.t[NN_DATA_COORD_z] - work_item->output->view_begin.t[NN_DATA_COORD_z] + 1) *
             ofm_out_block_size;
 
-        const auto batch_size = work_item->output->parent->lengths.t[NN_DATA_COORD_n];
+        const auto batch_size = work_item->output->view_end.t[NN_DATA_COORD_n] - work_item->output->view_begin.t[NN_DATA_COORD_n] + 1;
 
         const auto ofm_group_size = OFMBlock;
 
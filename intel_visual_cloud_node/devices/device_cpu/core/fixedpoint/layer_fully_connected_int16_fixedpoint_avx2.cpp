@@ -29,8 +29,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../api_internal/nn_device_interface_0_internal.h"
 #include "layer_fully_connected_int16_fixedpoint_avx2.h"
 #include "activations_int16_fixedpoint.h"
+#include "../layers_avx512.h"
 
 #include <immintrin.h>
+#include <algorithm>
 #include <string.h>
 #include <thread>
 #include <vector>
@@ -256,6 +258,35 @@ namespace int16_fixedpoint {
         }
     }
 
+    // forward implementation, sums computed by AVX-512 kernel (devices running AVX-512 kernels)
+    template<class Activation, bool T_NEED_BIAS_COPY>
+    static inline void process_fully_connected_int16_fixedpoint_AVX512_output_b1(
+        const int16_t* const input,
+        const int16_t* const weights,
+        typename Activation::output_type* output,
+        uint32_t numInputs,
+        const uint32_t numAcc,
+        const int32_t* const bias,
+        int8_t in_shift,
+        int8_t out_shift)
+    {
+        alignas(64) int32_t sums[C_simd_width * OUT_GROUPING];
+        layer::avx512::fully_connected_int16_accumulate(input, weights, numInputs, numAcc, T_NEED_BIAS_COPY ? bias : nullptr, sums);
+
+        for (uint32_t out_it = 0; out_it < (numAcc / 2) * 2; out_it += 2)
+        {
+            Activation::store_activation(output + 8 * out_it,
+                                         _mm256_load_si256((__m256i*)(sums + C_simd_width * out_it)),
+                                         _mm256_load_si256((__m256i*)(sums + C_simd_width * (out_it + 1))),
+                                         in_shift, out_shift);
+        }
+
+        if (numAcc % 2)
+        {
+            Activation::store_activation(output + 8 * (numAcc - 1), _mm256_load_si256((__m256i*)(sums + C_simd_width * (numAcc - 1))), in_shift, out_shift);
+        }
+    }
+
     // forward implementation
     template<class Activation, bool T_NEED_BIAS_COPY>
     static inline void process_fully_connected_int16_fixedpoint_AVX2_output_b8(
@@ -486,6 +517,35 @@ namespace int16_fixedpoint {
         }
     }
 
+    // forward implementation for batches of 16, 24 & 32, sums computed by AVX-512 kernel (devices running AVX-512 kernels)
+    template<class Activation, bool T_NEED_BIAS_COPY>
+    static inline void process_fully_connected_int16_fixedpoint_AVX512_output_batch(
+        const int16_t* const input,
+        const int16_t* const weights,
+        typename Activation::output_type* output,
+        uint32_t numInputs,
+        uint32_t batchSize,
+        const int32_t* const bias,
+        int8_t in_shift,
+        int8_t out_shift)
+    {
+        alignas(64) int32_t sums[OUT_GROUPING * 32];
+        layer::avx512::fully_connected_int16_batch_accumulate(input, weights, numInputs, batchSize, T_NEED_BIAS_COPY ? bias : nullptr, sums);
+
+        // same order as AVX2 kernels: pairs of outputs, 8 batch items of both in each store
+        for (uint32_t out_it = 0; out_it < OUT_GROUPING; out_it += 2)
+        {
+            for (uint32_t batch_it = 0; batch_it < batchSize; batch_it += C_simd_width)
+            {
+                Activation::store_activation(output,
+                                             _mm256_load_si256((__m256i*)(sums + out_it * batchSize + batch_it)),
+                                             _mm256_load_si256((__m256i*)(sums + (out_it + 1) * batchSize + batch_it)),
+                                             in_shift, out_shift);
+                output += (2 * C_simd_width);
+            }
+        }
+    }
+
     template <typename OutputType> struct get_arguments;
 
     template <> struct get_arguments<std::int16_t> {
@@ -506,7 +566,8 @@ namespace int16_fixedpoint {
     void run_fully_connected_int16_fixedpoint_work_item_internal(
         nn_workload_item *const work_item,
         nn_workload_data_t *input_view,
-        nn_workload_data_t *output_view)
+        nn_workload_data_t *output_view,
+        bool avx512)
     {
         if(std::is_same<typename ActivationType::ImplBase::output_type, std::int32_t>::value)
             assert(work_item->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN);
@@ -538,9 +599,52 @@ namespace int16_fixedpoint {
 
         using namespace activations::int16_fixedpoint;
 
+        if (avx512 && (C_batch_size == 16 || C_batch_size == 24 || C_batch_size == 32))
+        {
+            for (uint32_t n = 0; n < outputWidth; n += OUT_GROUPING)
+            {
+                if (shift >= 0)
+                    process_fully_connected_int16_fixedpoint_AVX512_output_batch<
+                        typename ActivationType::template Impl<true, ShiftDirection::Right>, T_NEED_BIAS_COPY>(
+                        input_buffer, weights_ptr, output_ptr, numInputNeurons, C_batch_size, bias_ptr,
+                        acc_fraction, out_fraction);
+                else if (shift < 0)
+                    process_fully_connected_int16_fixedpoint_AVX512_output_batch<
+                        typename ActivationType::template Impl<true, ShiftDirection::Left>, T_NEED_BIAS_COPY>(
+                        input_buffer, weights_ptr, output_ptr, numInputNeurons, C_batch_size, bias_ptr,
+                        acc_fraction, out_fraction);
+
+                weights_ptr += numInputNeurons * OUT_GROUPING;
+                output_ptr += OUT_GROUPING * C_batch_size;
+                bias_ptr += OUT_GROUPING;
+            }
+            return;
+        }
+
         switch (C_batch_size)
         {
         case 1:
+        if (avx512)
+        {
+                  for (uint32_t n = 0; n < outputWidth; n += C_simd_width * OUT_GROUPING)
+                  {
+                      const uint32_t group = std::min<uint32_t>(outputWidth - n, C_simd_width * OUT_GROUPING) / C_simd_width;
+
+                      if (shift >= 0)
+                          process_fully_connected_int16_fixedpoint_AVX512_output_b1<
+                              typename ActivationType::template Impl<false, ShiftDirection::Right>, T_NEED_BIAS_COPY>(
+                              input_buffer, weights_ptr, output_ptr, numInputNeurons, group, bias_ptr, acc_fraction, out_fraction);
+                      else if (shift < 0)
+                          process_fully_connected_int16_fixedpoint_AVX512_output_b1<
+                              typename ActivationType::template Impl<false, ShiftDirection::Left>, T_NEED_BIAS_COPY>(
+                              input_buffer, weights_ptr, output_ptr, numInputNeurons, group, bias_ptr, acc_fraction, out_fraction);
+
+                      weights_ptr += numInputNeurons * C_simd_width * OUT_GROUPING;
+                      output_ptr += C_simd_width * OUT_GROUPING;
+                      bias_ptr += C_simd_width * OUT_GROUPING;
+                  }
+        }
+        else
         {
                   auto NumOfFullItr = outputWidth / (C_simd_width * OUT_GROUPING);
                   for (uint32_t n = 0; n < NumOfFullItr; ++n)
@@ -690,7 +794,8 @@ namespace int16_fixedpoint {
     void run_fully_connected_fixedpoint_work_item(
         nn_workload_item *const work_item,
         nn_workload_data_t *input_view,
-        nn_workload_data_t *output_view)
+        nn_workload_data_t *output_view,
+        bool avx512)
     {
         NN_ACTIVATION_FUNCTION function =
             work_item->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN
@@ -708,26 +813,26 @@ namespace int16_fixedpoint {
         if (need_bias_copy) {
             if (function == NN_ACTIVATION_FUNCTION_NONE) {
                 run_fully_connected_int16_fixedpoint_work_item_internal<None<std::int32_t>, true>(work_item, input_view,
-                                                                                                  output_view);
+                                                                                                  output_view, avx512);
             } else if (function == NN_ACTIVATION_FUNCTION_RELU) {
                 run_fully_connected_int16_fixedpoint_work_item_internal<ReLu<std::int16_t>, true>(work_item, input_view,
-                                                                                                  output_view);
+                                                                                                  output_view, avx512);
             }else if(function == NN_ACTIVATION_FUNCTION_LOGISTIC){
                 run_fully_connected_int16_fixedpoint_work_item_internal<Logistic<std::int16_t>, true>(
-                    work_item, input_view, output_view);
+                    work_item, input_view, output_view, avx512);
             }else{
                 assert(false);
             }
         } else {
             if (function == NN_ACTIVATION_FUNCTION_NONE) {
                 run_fully_connected_int16_fixedpoint_work_item_internal<None<std::int32_t>, false>(
-                    work_item, input_view, output_view);
+                    work_item, input_view, output_view, avx512);
             } else if (function == NN_ACTIVATION_FUNCTION_RELU) {
                 run_fully_connected_int16_fixedpoint_work_item_internal<ReLu<std::int16_t>, false>(
-                    work_item, input_view, output_view);
+                    work_item, input_view, output_view, avx512);
             } else if (function == NN_ACTIVATION_FUNCTION_LOGISTIC) {
                 run_fully_connected_int16_fixedpoint_work_item_internal<Logistic<std::int16_t>, false>(
-                    work_item, input_view, output_view);
+                    work_item, input_view, output_view, avx512);
             }else{
                 assert(false);
             }
@@ -735,10 +840,11 @@ namespace int16_fixedpoint {
     }
 
     void unpack_fully_connected_fixedpoint_callback_handle(
-        void* void_handle)
+        void* void_handle,
+        bool avx512)
     {
         nn_cpu_request_handle* handle = reinterpret_cast<nn_cpu_request_handle*>(void_handle);
-        run_fully_connected_fixedpoint_work_item(handle->work_item, handle->input_view, handle->output_view);
+        run_fully_connected_fixedpoint_work_item(handle->work_item, handle->input_view, handle->output_view, avx512);
     }
 
 
@@ -768,6 +874,7 @@ namespace int16_fixedpoint {
     void run_multithreaded_fully_connected_fixedpoint_work_item(nn_workload_item *const work_item, nn_device_internal* device)
     {
         auto num_hardware_threads = std::min(device->thread_pool.get_num_threads(), max_threads);
+        const bool avx512 = device->isa == NN_CPU_ISA_AVX512;
 
         const auto &weights = work_item->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN
                                   ? work_item->arguments.fully_connected_forward_i16qn_i16qn.weights
@@ -793,7 +900,7 @@ namespace int16_fixedpoint {
         if ((itemsGroups_per_thread == 0) || (num_hardware_threads == 1) || (batch_size == 1))
         {
             // Its tiny data - just do it singlethreaded way.
-            run_fully_connected_fixedpoint_work_item(work_item, input_view, output_view);
+            run_fully_connected_fixedpoint_work_item(work_item, input_view, output_view, avx512);
         }
         else
         {
@@ -873,8 +980,9 @@ namespace int16_fixedpoint {
                     0
                 };
 
+                // kernels compute whole batch of buffer, slave views only split outputs between threads
                 nn_workload_data_coords_t output_view_end = {
-                    batch_size - 1,
+                    output_view->view_end.t[NN_DATA_COORD_n] - output_view->view_begin.t[NN_DATA_COORD_n],
                     0,
                     0,
                     // Last one gets all remaining.
@@ -915,7 +1023,7 @@ namespace int16_fixedpoint {
                 request_handles[thread_id]->input_view = work_item->input[0]->output;
                 request_handles[thread_id]->output_view = slaves_work_items[thread_id]->output;
 
-                job[thread_id].callback = unpack_fully_connected_fixedpoint_callback_handle;
+                job[thread_id].callback = [avx512](void* handle) { unpack_fully_connected_fixedpoint_callback_handle(handle, avx512); };
                 job[thread_id].request_handle = request_handles[thread_id];
             }
 
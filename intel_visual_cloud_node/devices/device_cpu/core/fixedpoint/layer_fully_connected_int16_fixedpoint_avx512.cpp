@@ -0,0 +1,176 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "../layers_avx512.h"
+
+#include <immintrin.h>
+
+/* AVX-512 kernels of int16 fixed-point fully connected layer (layer_fully_connected_int16_fixedpoint_avx2.cpp).
+_mm512_madd_epi16 (AVX-512BW) does twice the work of AVX2 instruction: for batch of 1 it multiplies two pairs of inputs
+by 8 outputs of a block (lower half of accumulator sums even pairs of inputs, upper half odd ones), for batches it
+multiplies one pair of inputs of 16 batch items by weight of an output.
+*/
+
+namespace layer {
+namespace avx512 {
+namespace
+{
+const uint32_t C_block = 8;         // outputs in block of weights
+const uint32_t C_max_blocks = 8;    // blocks computed at once, as in AVX2 kernel
+
+const uint32_t C_batch_block = sizeof(__m512i) / sizeof(int32_t);
+
+template <uint32_t T_blocks>
+void accumulate_blocks(const int16_t *input, const int16_t *weights, uint32_t num_inputs, const int32_t *bias, int32_t *sums)
+{
+    const size_t block_stride = static_cast<size_t>(C_block) * num_inputs;
+    const __m512i pair_index = _mm512_set_epi32(1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    __m512i acc[T_blocks];
+#pragma unroll
+    for (uint32_t block = 0; block < T_blocks; ++block)
+        acc[block] = _mm512_setzero_si512();
+
+    uint32_t in_it = 0;
+    for (; in_it + 4 <= num_inputs; in_it += 4)
+    {
+        const __m512i pairs = _mm512_permutexvar_epi32(pair_index, _mm512_castsi128_si512(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(input + in_it))));
+
+#pragma unroll
+        for (uint32_t block = 0; block < T_blocks; ++block)
+        {
+            const __m512i w = _mm512_loadu_si512(weights + block * block_stride + in_it * C_block);
+            acc[block] = _mm512_add_epi32(acc[block], _mm512_madd_epi16(pairs, w));
+        }
+    }
+
+#pragma unroll
+    for (uint32_t block = 0; block < T_blocks; ++block)
+    {
+        __m256i sum = _mm256_add_epi32(_mm512_castsi512_si256(acc[block]), _mm512_extracti64x4_epi64(acc[block], 1));
+        if (in_it < num_inputs)
+        {
+            const __m256i pair = _mm256_set1_epi32(*reinterpret_cast<const int32_t *>(input + in_it));
+            const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + block * block_stride + in_it * C_block));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(pair, w));
+        }
+        if (bias)
+            sum = _mm256_add_epi32(sum, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bias + block * C_block)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(sums + block * C_block), sum);
+    }
+}
+// Batch of T_batch items: T_batch / 16 accumulators of 512 bits per output & one of 256 bits for remaining 8 items.
+template <uint32_t T_batch>
+void accumulate_batch(const int16_t *input, const int16_t *weights, uint32_t num_inputs, const int32_t *bias, int32_t *sums)
+{
+    const uint32_t C_zmm = T_batch / C_batch_block;
+    const bool C_ymm = T_batch % C_batch_block != 0;
+
+    __m512i acc[C_block][C_zmm];
+    __m256i tail[C_block];
+#pragma unroll
+    for (uint32_t out = 0; out < C_block; ++out)
+    {
+        const int32_t init = bias ? bias[out] : 0;
+#pragma unroll
+        for (uint32_t zmm = 0; zmm < C_zmm; ++zmm)
+            acc[out][zmm] = _mm512_set1_epi32(init);
+        tail[out] = _mm256_set1_epi32(init);
+    }
+
+    for (uint32_t in_it = 0; in_it < num_inputs; in_it += 2)
+    {
+        const int16_t *pairs = input + in_it * T_batch;
+        __m512i values[C_zmm];
+#pragma unroll
+        for (uint32_t zmm = 0; zmm < C_zmm; ++zmm)
+            values[zmm] = _mm512_loadu_si512(pairs + zmm * 2 * C_batch_block);
+        const __m256i tail_values = C_ymm ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pairs + C_zmm * 2 * C_batch_block)) : _mm256_setzero_si256();
+
+#pragma unroll
+        for (uint32_t out = 0; out < C_block; ++out)
+        {
+            const int32_t pair = *reinterpret_cast<const int32_t *>(weights + in_it * C_block + out * 2);
+            const __m512i w = _mm512_set1_epi32(pair);
+#pragma unroll
+            for (uint32_t zmm = 0; zmm < C_zmm; ++zmm)
+                acc[out][zmm] = _mm512_add_epi32(acc[out][zmm], _mm512_madd_epi16(values[zmm], w));
+            if (C_ymm)
+                tail[out] = _mm256_add_epi32(tail[out], _mm256_madd_epi16(tail_values, _mm512_castsi512_si256(w)));
+        }
+    }
+
+#pragma unroll
+    for (uint32_t out = 0; out < C_block; ++out)
+    {
+#pragma unroll
+        for (uint32_t zmm = 0; zmm < C_zmm; ++zmm)
+            _mm512_storeu_si512(sums + out * T_batch + zmm * C_batch_block, acc[out][zmm]);
+        if (C_ymm)
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(sums + out * T_batch + C_zmm * C_batch_block), tail[out]);
+    }
+}
+} // namespace
+
+void fully_connected_int16_accumulate(const int16_t *input,
+                                      const int16_t *weights,
+                                      uint32_t num_inputs,
+                                      uint32_t blocks,
+                                      const int32_t *bias,
+                                      int32_t *sums)
+{
+    static void (*const accumulate[C_max_blocks])(const int16_t *, const int16_t *, uint32_t, const int32_t *, int32_t *) = {
+        accumulate_blocks<1>, accumulate_blocks<2>, accumulate_blocks<3>, accumulate_blocks<4>,
+        accumulate_blocks<5>, accumulate_blocks<6>, accumulate_blocks<7>, accumulate_blocks<8>};
+
+    for (uint32_t block = 0; block < blocks; block += C_max_blocks)
+    {
+        const auto count = blocks - block < C_max_blocks ? blocks - block : C_max_blocks;
+        accumulate[count - 1](input,
+                              weights + static_cast<size_t>(block) * C_block * num_inputs,
+                              num_inputs,
+                              bias ? bias + block * C_block : nullptr,
+                              sums + block * C_block);
+    }
+}
+
+void fully_connected_int16_batch_accumulate(const int16_t *input,
+                                            const int16_t *weights,
+                                            uint32_t num_inputs,
+                                            uint32_t batch_size,
+                                            const int32_t *bias,
+                                            int32_t *sums)
+{
+    switch (batch_size)
+    {
+    case 16: accumulate_batch<16>(input, weights, num_inputs, bias, sums); break;
+    case 24: accumulate_batch<24>(input, weights, num_inputs, bias, sums); break;
+    case 32: accumulate_batch<32>(input, weights, num_inputs, bias, sums); break;
+    }
+}
+
+} // namespace avx512
+} // namespace layer
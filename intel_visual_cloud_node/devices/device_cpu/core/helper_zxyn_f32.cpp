@@ -60,12 +60,14 @@ nn::nn_workload_data_t<float> * primitive_zxyn_f32_base::create_input_impl(const
         memcpy(buffer->parent->data_buffer, input.buffer, buffer->parent->buffer_size);
     }
     else{
+        // parent buffer is larger by padding - data goes to its view
+        const auto &parent_size = buffer->parent->lengths;
         for (size_t n = 0u; n < size.t[0]; ++n)
             for (size_t z = 0u; z < size.t[3]; ++z)
                 for (size_t y = 0u; y < size.t[2]; ++y)
                     for (size_t x = 0u; x < size.t[1]; ++x)
                         //        n, x, y, z, p, q  =          z, x, y, n
-                        ((float *)(buffer->parent->data_buffer))[z + size.t[3] * (x + size.t[1] * (y + size.t[2] * n))] = ((float *)(input.buffer))[z + size.t[3] * (x + size.t[1] * (y + size.t[2] * n))];
+                        ((float *)(buffer->parent->data_buffer))[z + size.t[3] * ((x + padding_left) + parent_size.t[1] * ((y + padding_top) + parent_size.t[2] * n))] = ((float *)(input.buffer))[z + size.t[3] * (x + size.t[1] * (y + size.t[2] * n))];
     }
 
     buffer->view_begin.t[NN_DATA_COORD_x] += view_offset_x;
@@ -219,12 +219,13 @@ namespace layer
                                  nn::nn_workload_data_t<float> *output) {
 
         {
+            // views cover whole images, batch may be limited to images submitted for execution
             auto input_length = input->get_length();
-            assert(input_length.t[0] * input_length.t[1] * input_length.t[2] * input_length.t[3] ==
+            assert(input_length.t[1] * input_length.t[2] * input_length.t[3] * input->parent->lengths.t[NN_DATA_COORD_n] ==
                    input->parent->buffer_size / input->parent->data_type_size);
 
             auto output_length = output->get_length();
-            assert(output_length.t[0] * output_length.t[1] * output_length.t[2] * output_length.t[3] ==
+            assert(output_length.t[1] * output_length.t[2] * output_length.t[3] * output->parent->lengths.t[NN_DATA_COORD_n] ==
                    output->parent->buffer_size / output->parent->data_type_size);
         }
 
@@ -260,6 +261,10 @@ namespace layer
         nn::nn_workload_data_t<float> input_flat(input->parent->data_buffer, input_coord, input->parent->layout);
         nn::nn_workload_data_t<float> factor_flat(factor->parent->data_buffer, factor_coord, factor->parent->layout);
         nn::nn_workload_data_t<float> output_flat(output->parent->data_buffer, output_coord, output->parent->layout);
+        input_flat.view_begin.t[NN_DATA_COORD_n] = input->view_begin.t[NN_DATA_COORD_n];
+        input_flat.view_end.t[NN_DATA_COORD_n] = input->view_end.t[NN_DATA_COORD_n];
+        output_flat.view_begin.t[NN_DATA_COORD_n] = output->view_begin.t[NN_DATA_COORD_n];
+        output_flat.view_end.t[NN_DATA_COORD_n] = output->view_end.t[NN_DATA_COORD_n];
 
         // Split it for multi threading.
         auto num_hardware_threads = device->thread_pool.get_num_threads();
@@ -167,6 +167,80 @@ namespace layer{
         }
     }
 
+    // Any image size: zxyn images are transposed to batch-first layout in 8x8 blocks, remaining images one by one.
+    // Converts images of view, which starts at first image of buffer.
+    void batching_conversion_blocked(
+        const nn_workload_data_t* input_view,
+        nn_workload_data_t* output_view)
+    {
+        const auto batch = output_view->parent->lengths.t[NN_DATA_COORD_n];
+        const auto image_count = (output_view->view_end.t[NN_DATA_COORD_n] - output_view->view_begin.t[NN_DATA_COORD_n] + 1);
+        const auto image_size = input_view->parent->lengths.t[NN_DATA_COORD_x] *
+                                input_view->parent->lengths.t[NN_DATA_COORD_y] *
+                                input_view->parent->lengths.t[NN_DATA_COORD_z];
+        const auto in_data_ptr = reinterpret_cast<const float*>(input_view->parent->data_buffer);
+        auto out_data_ptr = reinterpret_cast<float*>(output_view->parent->data_buffer);
+        const auto full_image_size = image_size - image_size % C_simd_size;
+
+        const auto full_image_count = image_count - image_count % C_simd_size;
+        for (uint32_t image = 0; image < full_image_count; image += C_simd_size)
+        {
+            const auto in_ptr = in_data_ptr + image * image_size;
+            for (uint32_t element = 0; element < full_image_size; element += C_simd_size)
+            {
+                __m256 row[8];
+                for (uint32_t index = 0; index < 8; ++index)
+                    row[index] = _mm256_loadu_ps(in_ptr + index * image_size + element);
+
+                // 8x8 transpose
+                const __m256 t0 = _mm256_unpacklo_ps(row[0], row[1]), t1 = _mm256_unpackhi_ps(row[0], row[1]);
+                const __m256 t2 = _mm256_unpacklo_ps(row[2], row[3]), t3 = _mm256_unpackhi_ps(row[2], row[3]);
+                const __m256 t4 = _mm256_unpacklo_ps(row[4], row[5]), t5 = _mm256_unpackhi_ps(row[4], row[5]);
+                const __m256 t6 = _mm256_unpacklo_ps(row[6], row[7]), t7 = _mm256_unpackhi_ps(row[6], row[7]);
+                const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+                const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+                const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)), s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+                const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)), s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+                auto out_ptr = out_data_ptr + element * batch + image;
+                _mm256_storeu_ps(out_ptr + 0 * batch, _mm256_permute2f128_ps(s0, s4, 0x20));
+                _mm256_storeu_ps(out_ptr + 1 * batch, _mm256_permute2f128_ps(s1, s5, 0x20));
+                _mm256_storeu_ps(out_ptr + 2 * batch, _mm256_permute2f128_ps(s2, s6, 0x20));
+                _mm256_storeu_ps(out_ptr + 3 * batch, _mm256_permute2f128_ps(s3, s7, 0x20));
+                _mm256_storeu_ps(out_ptr + 4 * batch, _mm256_permute2f128_ps(s0, s4, 0x31));
+                _mm256_storeu_ps(out_ptr + 5 * batch, _mm256_permute2f128_ps(s1, s5, 0x31));
+                _mm256_storeu_ps(out_ptr + 6 * batch, _mm256_permute2f128_ps(s2, s6, 0x31));
+                _mm256_storeu_ps(out_ptr + 7 * batch, _mm256_permute2f128_ps(s3, s7, 0x31));
+            }
+
+            for (uint32_t element = full_image_size; element < image_size; ++element)
+                for (uint32_t index = 0; index < 8; ++index)
+                    out_data_ptr[element * batch + image + index] = in_ptr[index * image_size + element];
+        }
+
+        for (uint32_t image = full_image_count; image < image_count; ++image)
+            for (uint32_t element = 0; element < image_size; ++element)
+                out_data_ptr[element * batch + image] = in_data_ptr[image * image_size + element];
+    }
+
+    static bool is_whole_buffer(const nn_workload_data_t* view)
+    {
+        for (uint32_t dimension = 0; dimension < NN_DIMENSION_COUNT; ++dimension)
+            if (view->view_begin.t[dimension] != 0 || view->view_end.t[dimension] + 1 != view->parent->lengths.t[dimension])
+                return false;
+        return true;
+    }
+
+    // View covers whole buffer except for trailing images - as when workload runs smaller batch than compiled one.
+    static bool is_batch_prefix(const nn_workload_data_t* view)
+    {
+        for (uint32_t dimension = 0; dimension < NN_DIMENSION_COUNT; ++dimension)
+            if (view->view_begin.t[dimension] != 0 ||
+                (dimension != NN_DATA_COORD_n && view->view_end.t[dimension] + 1 != view->parent->lengths.t[dimension]))
+                return false;
+        return true;
+    }
+
     void run_convert_to_data_layout_work_item(nn_workload_item *const work_item) {
         const auto &master_arguments = work_item->arguments.convert_data_layout;
         const auto &input_view = work_item->input[0]->output;
@@ -207,14 +281,17 @@ namespace layer{
             const auto input_buffer = static_cast<int32_t *>(input_view->parent->data_buffer);
             auto output_buffer = static_cast<int32_t *>(output_view->parent->data_buffer);
 
-            for (auto itrBatch = 0; itrBatch < batchsize / 8; ++itrBatch)
-                for (auto itrSize = 0; itrSize < size; ++itrSize)
-                    for (auto itrBatch8 = 0; itrBatch8 < 8; ++itrBatch8)
-                        for (auto itrSize2 = 0; itrSize2 < size2; ++itrSize2)
-                            output_buffer[itrSize2 * 8 + itrBatch8 + itrSize * size2 * 8 +
-                                          itrBatch * size * 8 * size2] =
-                                input_buffer[itrSize2 + itrBatch8 * size2 + itrSize * size2 * batchsize +
-                                             itrBatch * 8 * size2];
+            // images are converted in place within blocks of 8, only those covered by view
+            const auto image_count = (output_view->view_end.t[NN_DATA_COORD_n] - output_view->view_begin.t[NN_DATA_COORD_n] + 1);
+            for (auto image = 0u; image < image_count; ++image) {
+                const auto itrBatch = image / 8, itrBatch8 = image % 8;
+                for (auto itrSize = 0u; itrSize < size; ++itrSize)
+                    for (auto itrSize2 = 0u; itrSize2 < size2; ++itrSize2)
+                        output_buffer[itrSize2 * 8 + itrBatch8 + itrSize * size2 * 8 +
+                                      itrBatch * size * 8 * size2] =
+                            input_buffer[itrSize2 + itrBatch8 * size2 + itrSize * size2 * batchsize +
+                                         itrBatch * 8 * size2];
+            }
         } break;
 
         case 3: // convolution -> fully connected
@@ -239,11 +316,12 @@ namespace layer{
 
             const size_t out_batch_stride = out_z_block_size,
                          out_z_block_stride = out_batch_stride * batchsize;
+            const size_t image_count = (output_view->view_end.t[NN_DATA_COORD_n] - output_view->view_begin.t[NN_DATA_COORD_n] + 1);
 
             for(size_t it_in_z_block = 0; it_in_z_block < in_z_block_count; ++it_in_z_block)
                 for(size_t it_in_y = 0; it_in_y < in_y_size; ++it_in_y)
                     for(size_t it_in_x = 0; it_in_x < in_x_size; ++it_in_x)
-                        for (size_t it_batch = 0; it_batch < batchsize; ++it_batch)
+                        for (size_t it_batch = 0; it_batch < image_count; ++it_batch)
                             for (size_t it_in_z_in_block = 0; it_in_z_in_block < in_z_block_size; ++it_in_z_in_block){
                                 const size_t out_z = it_in_x
                                                         + it_in_y * in_x_size
@@ -261,10 +339,15 @@ namespace layer{
         {
             auto image_size = input_view->parent->lengths.t[NN_DATA_COORD_x] * input_view->parent->lengths.t[NN_DATA_COORD_y] * input_view->parent->lengths.t[NN_DATA_COORD_z];
 
-            if      (batchsize ==  8 && image_size ==  9216) batching_conversion<true,  8,  9216>(input_view, output_view);
-            else if (batchsize == 48 && image_size ==  9216) batching_conversion<true, 48,  9216>(input_view, output_view);
-            else if (batchsize ==  8 && image_size == 36864) batching_conversion<true,  8, 36864>(input_view, output_view);
-            else if (batchsize == 48 && image_size == 36864) batching_conversion<true, 48, 36864>(input_view, output_view);
+            // specialized conversions process whole buffers
+            const bool whole = is_whole_buffer(input_view) && is_whole_buffer(output_view);
+            if      (whole && batchsize ==  8 && image_size ==  9216) batching_conversion<true,  8,  9216>(input_view, output_view);
+            else if (whole && batchsize == 48 && image_size ==  9216) batching_conversion<true, 48,  9216>(input_view, output_view);
+            else if (whole && batchsize ==  8 && image_size == 36864) batching_conversion<true,  8, 36864>(input_view, output_view);
+            else if (whole && batchsize == 48 && image_size == 36864) batching_conversion<true, 48, 36864>(input_view, output_view);
+            else if (is_batch_prefix(input_view) && is_batch_prefix(output_view) &&
+                     (input_view->view_end.t[NN_DATA_COORD_n] - input_view->view_begin.t[NN_DATA_COORD_n] + 1) == (output_view->view_end.t[NN_DATA_COORD_n] - output_view->view_begin.t[NN_DATA_COORD_n] + 1))
+                batching_conversion_blocked(input_view, output_view);
             else batching_conversion<false>(input_view, output_view);
 
             break;
@@ -279,7 +362,7 @@ namespace layer{
             const size_t z_block_count = output_view->parent->lengths.t[NN_DATA_COORD_z];
             const size_t x_size = output_view->parent->lengths.t[NN_DATA_COORD_x];
             const size_t y_size = output_view->parent->lengths.t[NN_DATA_COORD_y];
-            const size_t batch_size = output_view->parent->lengths.t[NN_DATA_COORD_n];
+            const size_t batch_size = (output_view->view_end.t[NN_DATA_COORD_n] - output_view->view_begin.t[NN_DATA_COORD_n] + 1);
 
             for (size_t it_batch = 0; it_batch < batch_size; ++it_batch)
                 for (size_t it_z_block = 0; it_z_block < z_block_count; ++it_z_block)
@@ -27,22 +27,21 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "../../common/nn_workload_data.h"
 #include "../api_internal/nn_device_interface_0_internal.h"
+#include "../api_internal/cpu_jit.h"
+#include "../api_internal/cpu_partition.h"
 #include "layer_convolution_avx2.h"
 #include "helper_zxyn_f32.h"
 
 #include <immintrin.h>
 #include <string.h>
 #include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 #include <tuple>
-
-// Pragmas inside macros.
-#if defined _MSC_VER 
-#   define PRAGMA_MACRO(x) __pragma(x)
-#else
-#   define PRAGMA_MACRO(x) _Pragma(#x)
-#endif
+#include <string>
 
 namespace layer {
 namespace convolution_f32_impl {
@@ -124,34 +123,16 @@ const uint32_t C_slice_size = 2 * C_simd_width;
             float *inp_ptr = init_inp_ptr + input_fmap_view_start; \
             \
             float *kernel_offset_end_ptr = kernel_offset_base_ptr + kernel_depth_size; \
-            if(T_exact_match) \
-            { \
-                PRAGMA_MACRO(unroll (T_unroll_times)) \
-                for (auto ifm = 0U; ifm < input_fmap_view_length; ++ifm) \
-                { \
-                    __m256 vwt0 = _mm256_load_ps(kernel_offset_base_ptr); \
-                    __m256 vwt1 = _mm256_load_ps(kernel_offset_base_ptr + C_simd_width); \
-                    __m256 bc; \
-                    \
-                    SIMPLE_REPLICATION_##block_size(MAD_ACC) \
-                    \
-                    ++inp_ptr; \
-                    kernel_offset_base_ptr += C_slice_size; \
-                } \
-            } \
-            else \
+            for (; kernel_offset_base_ptr < kernel_offset_end_ptr;) \
             { \
-                for (; kernel_offset_base_ptr < kernel_offset_end_ptr;) \
-                { \
-                    __m256 vwt0 = _mm256_load_ps(kernel_offset_base_ptr); \
-                    __m256 vwt1 = _mm256_load_ps(kernel_offset_base_ptr + C_simd_width); \
-                    __m256 bc; \
-                    \
-                    SIMPLE_REPLICATION_##block_size(MAD_ACC) \
-                    \
-                    ++inp_ptr; \
-                    kernel_offset_base_ptr += C_slice_size; \
-                } \
+                __m256 vwt0 = _mm256_load_ps(kernel_offset_base_ptr); \
+                __m256 vwt1 = _mm256_load_ps(kernel_offset_base_ptr + C_simd_width); \
+                __m256 bc; \
+                \
+                SIMPLE_REPLICATION_##block_size(MAD_ACC) \
+                \
+                ++inp_ptr; \
+                kernel_offset_base_ptr += C_slice_size; \
             } \
             init_kernel_offset_base_ptr += kernel_depth_size; \
             init_inp_ptr += num_input_feature_maps; \
@@ -166,22 +147,185 @@ const uint32_t C_slice_size = 2 * C_simd_width;
     SIMPLE_REPLICATION_##block_size(STORE_ACC) \
 }
 
-template<bool                  T_exact_match,
-        NN_ACTIVATION_FUNCTION T_activation,
-        uint32_t               T_unroll_times               = 0, 
-        uint32_t               T_input_width                = 0, 
-        uint32_t               T_input_height               = 0, 
-        uint32_t               T_input_feature_maps         = 0, 
-        uint32_t               T_input_fmap_view_start      = 0, 
-        uint32_t               T_input_fmap_view_length     = 0, 
-        uint32_t               T_kernel_in_fmap_view_start  = 0, 
-        uint32_t               T_kernel_width               = 0,
-        uint32_t               T_kernel_height              = 0, 
-        uint32_t               T_kernel_stride_x            = 0, 
-        uint32_t               T_kernel_stride_y            = 0,
-        uint32_t               T_output_width               = 0,
-        uint32_t               T_output_height              = 0,
-        uint32_t               T_output_feature_maps        = 0>
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// run-time generated kernels
+// Generated code computes the same block as NN_CONVOLVE_OPTIMIZED_BLOCK, with layer dimensions
+// compiled in: loops over input feature maps are unrolled (whole kernel row when it is short) and
+// offsets of inputs and weights are encoded in instructions. Code for all block sizes of a layer
+// shape is generated once, on first run of that shape, and kept for the lifetime of process.
+using jit_block_function = void (*)(const float* input, const float* weights, float* output, const float* bias);
+
+const uint32_t C_max_block_size = 6;
+const uint32_t C_jit_unroll = 8;
+const uint32_t C_jit_max_unrolled_row = 64;
+
+struct jit_convolution_kernel
+{
+    std::unique_ptr<nn_cpu_jit_code> code;
+    jit_block_function block[C_max_block_size + 1];
+};
+
+// activation, input row size, input feature maps, input feature maps view length,
+// kernel width, kernel height, stride x, output feature maps
+using jit_kernel_key = std::tuple<NN_ACTIVATION_FUNCTION, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>;
+
+// ymm0-11 are accumulators, two per output column.
+const uint8_t C_jit_weights0 = 12;
+const uint8_t C_jit_weights1 = 13;
+const uint8_t C_jit_broadcast = 14;
+const uint8_t C_jit_zero = 15;
+
+void emit_jit_step(nn_cpu_jit_emitter &emitter, uint32_t block_size, int32_t input_offset, int32_t column_stride, int32_t weight_offset)
+{
+    const auto input = nn_cpu_jit_emitter::argument(0);
+    const auto weights = nn_cpu_jit_emitter::argument(1);
+
+    emitter.vmovups(C_jit_weights0, weights, weight_offset);
+    emitter.vmovups(C_jit_weights1, weights, weight_offset + C_simd_width * sizeof(float));
+    for (uint32_t column = 0; column < block_size; ++column)
+    {
+        emitter.vbroadcastss(C_jit_broadcast, input, input_offset + column * column_stride);
+        emitter.vfmadd231ps(2 * column, C_jit_weights0, C_jit_broadcast);
+        emitter.vfmadd231ps(2 * column + 1, C_jit_weights1, C_jit_broadcast);
+    }
+}
+
+void emit_jit_block(nn_cpu_jit_emitter &emitter, uint32_t block_size, const jit_kernel_key &key)
+{
+    const auto activation = std::get<0>(key);
+    const int32_t input_row_size = std::get<1>(key) * sizeof(float);
+    const int32_t num_input_feature_maps = std::get<2>(key);
+    const int32_t input_fmap_view_length = std::get<3>(key);
+    const int32_t kernel_width = std::get<4>(key);
+    const int32_t kernel_height = std::get<5>(key);
+    const int32_t column_stride = num_input_feature_maps * std::get<6>(key) * sizeof(float);
+    const int32_t num_output_feature_maps = std::get<7>(key);
+
+    const int32_t input_step = sizeof(float);
+    const int32_t weight_step = C_slice_size * sizeof(float);
+
+    const auto input = nn_cpu_jit_emitter::argument(0);
+    const auto weights = nn_cpu_jit_emitter::argument(1);
+    const auto output = nn_cpu_jit_emitter::argument(2);
+    const auto bias = nn_cpu_jit_emitter::argument(3);
+    const auto row_counter = nn_cpu_jit_emitter::r8;
+    const auto column_counter = nn_cpu_jit_emitter::r9;
+    const auto map_counter = nn_cpu_jit_emitter::r10;
+
+    emitter.prologue();
+    for (uint32_t acc = 0; acc < 2 * block_size; ++acc)
+        emitter.vxorps(acc, acc, acc);
+
+    emitter.mov(row_counter, kernel_height);
+    const auto row_loop = emitter.position();
+    if (kernel_width * input_fmap_view_length <= static_cast<int32_t>(C_jit_max_unrolled_row))
+    {
+        // Whole kernel row unrolled, input pointer stays at row start.
+        for (int32_t kw = 0; kw < kernel_width; ++kw)
+            for (int32_t ifm = 0; ifm < input_fmap_view_length; ++ifm)
+                emit_jit_step(emitter, block_size,
+                              (kw * num_input_feature_maps + ifm) * input_step, column_stride,
+                              (kw * input_fmap_view_length + ifm) * weight_step);
+
+        emitter.add(weights, kernel_width * input_fmap_view_length * weight_step);
+        emitter.add(input, input_row_size);
+    }
+    else
+    {
+        // Loop over kernel columns and groups of C_jit_unroll input feature maps, rest of maps unrolled.
+        const int32_t unroll = C_jit_unroll;
+        const int32_t map_groups = input_fmap_view_length / unroll;
+        const int32_t map_remainder = input_fmap_view_length % unroll;
+
+        emitter.mov(column_counter, kernel_width);
+        const auto column_loop = emitter.position();
+        if (map_groups > 0)
+        {
+            emitter.mov(map_counter, map_groups);
+            const auto map_loop = emitter.position();
+            for (int32_t ifm = 0; ifm < unroll; ++ifm)
+                emit_jit_step(emitter, block_size, ifm * input_step, column_stride, ifm * weight_step);
+            emitter.add(input, unroll * input_step);
+            emitter.add(weights, unroll * weight_step);
+            emitter.dec(map_counter);
+            emitter.jnz(map_loop);
+        }
+        for (int32_t ifm = 0; ifm < map_remainder; ++ifm)
+            emit_jit_step(emitter, block_size, ifm * input_step, column_stride, ifm * weight_step);
+        if (map_remainder > 0)
+            emitter.add(weights, map_remainder * weight_step);
+        emitter.add(input, (num_input_feature_maps - map_groups * unroll) * input_step);
+        emitter.dec(column_counter);
+        emitter.jnz(column_loop);
+
+        if (input_row_size != kernel_width * num_input_feature_maps * input_step)
+            emitter.add(input, input_row_size - kernel_width * num_input_feature_maps * input_step);
+    }
+    emitter.dec(row_counter);
+    emitter.jnz(row_loop);
+
+    if (activation == NN_ACTIVATION_FUNCTION_RELU)
+        emitter.vxorps(C_jit_zero, C_jit_zero, C_jit_zero);
+    for (uint32_t column = 0; column < block_size; ++column)
+    {
+        for (uint32_t half = 0; half < 2; ++half)
+        {
+            const uint8_t acc = 2 * column + half;
+            const int32_t offset = half * C_simd_width * sizeof(float);
+            emitter.vaddps(acc, acc, bias, offset);
+            if (activation == NN_ACTIVATION_FUNCTION_RELU)
+                emitter.vmaxps(acc, acc, C_jit_zero);
+            emitter.vmovups(output, column * num_output_feature_maps * sizeof(float) + offset, acc);
+        }
+    }
+    emitter.epilogue();
+}
+
+const jit_convolution_kernel &get_jit_kernel(const jit_kernel_key &key)
+{
+    static std::mutex kernels_mutex;
+    static std::map<jit_kernel_key, std::unique_ptr<jit_convolution_kernel>> kernels;
+
+    std::lock_guard<std::mutex> lock(kernels_mutex);
+    auto &kernel = kernels[key];
+    if (!kernel)
+    {
+        nn_cpu_jit_emitter emitter;
+        size_t entry[C_max_block_size + 1] = {};
+        for (uint32_t block_size = 1; block_size <= C_max_block_size; ++block_size)
+        {
+            entry[block_size] = emitter.position();
+            emit_jit_block(emitter, block_size, key);
+        }
+
+        std::unique_ptr<jit_convolution_kernel> generated(new jit_convolution_kernel());
+        generated->code.reset(new nn_cpu_jit_code(emitter.get_code()));
+        generated->block[0] = nullptr;
+        for (uint32_t block_size = 1; block_size <= C_max_block_size; ++block_size)
+            generated->block[block_size] = generated->code->get<jit_block_function>(entry[block_size]);
+        kernel = std::move(generated);
+    }
+    return *kernel;
+}
+
+#define NN_CONVOLVE_JIT_BLOCK( \
+    block_size) \
+{ \
+    jit_kernel->block[block_size]( \
+        input + inp_offset_base + input_fmap_view_start, \
+        kernel + (kernel_feature_map / C_slice_size) * weight_offset + kernel_input_fmap_view_start * C_slice_size, \
+        output + out_offset + out_feature_map, \
+        (float*)bias->parent->data_buffer + bias_feature_map); \
+}
+
+#define NN_CONVOLVE_BLOCK( \
+    block_size) \
+{ \
+    if (T_jit) NN_CONVOLVE_JIT_BLOCK(block_size) \
+    else NN_CONVOLVE_OPTIMIZED_BLOCK(block_size) \
+}
+
+template<bool T_jit, NN_ACTIVATION_FUNCTION T_activation>
 void convolve_internal(
     const nn::nn_workload_data_t<float> *input_view,
     const size_t center_offset_x,
@@ -190,25 +334,26 @@ void convolve_internal(
     const int32_t stride_y,
     const nn::nn_workload_data_t<float> *weights,
     const nn::nn_workload_data_t<float> *bias,
-    nn::nn_workload_data_t<float> *output_view)
+    nn::nn_workload_data_t<float> *output_view,
+    const jit_convolution_kernel *jit_kernel)
 {
     float* input = (float*)input_view->parent->data_buffer;
     float* output = (float*)output_view->parent->data_buffer;
     float* kernel = (float*)weights->parent->data_buffer;
 
-    const auto num_output_feature_maps      = (T_exact_match) ? T_output_feature_maps : output_view->parent->lengths.t[NN_DATA_COORD_z];
-    const auto num_input_feature_maps       = (T_exact_match) ? T_input_feature_maps : input_view->parent->lengths.t[NN_DATA_COORD_z];
-    const auto output_feature_map_width     = (T_exact_match) ? T_output_width : output_view->parent->lengths.t[NN_DATA_COORD_x];
-    const auto output_feature_map_height    = (T_exact_match) ? T_output_height : output_view->parent->lengths.t[NN_DATA_COORD_y];
-    const auto input_feature_map_width      = (T_exact_match) ? T_input_width : input_view->parent->lengths.t[NN_DATA_COORD_x];
-    const auto input_feature_map_height     = (T_exact_match) ? T_input_height : input_view->parent->lengths.t[NN_DATA_COORD_y];
-    const auto kernel_width                 = (T_exact_match) ? T_kernel_width : weights->parent->lengths.t[NN_DATA_COORD_x];
-    const auto kernel_height                = (T_exact_match) ? T_kernel_height : weights->parent->lengths.t[NN_DATA_COORD_y];
-    const auto kernel_stride_x              = (T_exact_match) ? T_kernel_stride_x : stride_x;
-    const auto kernel_stride_y              = (T_exact_match) ? T_kernel_stride_y : stride_y;
-    const auto kernel_input_fmap_view_start = (T_exact_match) ? T_kernel_in_fmap_view_start : weights->view_begin.t[NN_DATA_COORD_z];
-    const auto input_fmap_view_start        = (T_exact_match) ? T_input_fmap_view_start : input_view->view_begin.t[NN_DATA_COORD_z];
-    const auto input_fmap_view_length       = (T_exact_match) ? T_input_fmap_view_length : input_view->view_end.t[NN_DATA_COORD_z] - input_fmap_view_start + 1;
+    const auto num_output_feature_maps      = output_view->parent->lengths.t[NN_DATA_COORD_z];
+    const auto num_input_feature_maps       = input_view->parent->lengths.t[NN_DATA_COORD_z];
+    const auto output_feature_map_width     = output_view->parent->lengths.t[NN_DATA_COORD_x];
+    const auto output_feature_map_height    = output_view->parent->lengths.t[NN_DATA_COORD_y];
+    const auto input_feature_map_width      = input_view->parent->lengths.t[NN_DATA_COORD_x];
+    const auto input_feature_map_height     = input_view->parent->lengths.t[NN_DATA_COORD_y];
+    const auto kernel_width                 = weights->parent->lengths.t[NN_DATA_COORD_x];
+    const auto kernel_height                = weights->parent->lengths.t[NN_DATA_COORD_y];
+    const auto kernel_stride_x              = stride_x;
+    const auto kernel_stride_y              = stride_y;
+    const auto kernel_input_fmap_view_start = weights->view_begin.t[NN_DATA_COORD_z];
+    const auto input_fmap_view_start        = input_view->view_begin.t[NN_DATA_COORD_z];
+    const auto input_fmap_view_length       = input_view->view_end.t[NN_DATA_COORD_z] - input_fmap_view_start + 1;
 
     const auto bias_view_start = bias->view_begin.t[NN_DATA_COORD_x];
 
@@ -263,7 +408,7 @@ void convolve_internal(
                 auto inp_offset_base    = inp_offset1 + input_column_view_start * num_input_feature_maps + input_image_offset;
                 
                 for (auto block = 0U; block < num_blocks_full; block++) {
-                    NN_CONVOLVE_OPTIMIZED_BLOCK(6);
+                    NN_CONVOLVE_BLOCK(6);
                     inp_offset_base += 6 * num_input_feature_maps * kernel_stride_x;
                     out_offset += 6 * num_output_feature_maps;
                 }
@@ -271,11 +416,11 @@ void convolve_internal(
                 switch (partial_block_size)
                 {
                 case 0: break;
-                case 1: NN_CONVOLVE_OPTIMIZED_BLOCK(1); break;
-                case 2: NN_CONVOLVE_OPTIMIZED_BLOCK(2); break;
-                case 3: NN_CONVOLVE_OPTIMIZED_BLOCK(3); break;
-                case 4: NN_CONVOLVE_OPTIMIZED_BLOCK(4); break;
-                case 5: NN_CONVOLVE_OPTIMIZED_BLOCK(5); break;
+                case 1: NN_CONVOLVE_BLOCK(1); break;
+                case 2: NN_CONVOLVE_BLOCK(2); break;
+                case 3: NN_CONVOLVE_BLOCK(3); break;
+                case 4: NN_CONVOLVE_BLOCK(4); break;
+                case 5: NN_CONVOLVE_BLOCK(5); break;
                 default:
                     /* Execution can never reach here (see 'partial_block_size') calculation.*/
                     /* Need to inform compiler that it should not generate code for 'default'.*/
@@ -287,73 +432,6 @@ void convolve_internal(
     }
 }
 
-using optimized_layer_map_t = std::map<
-    std::tuple<NN_ACTIVATION_FUNCTION, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>, 
-    decltype(convolve_internal<false, NN_ACTIVATION_FUNCTION_NONE>)*>;
-
-template<NN_ACTIVATION_FUNCTION T_activation,
-         uint32_t T_input_width, uint32_t T_input_height, uint32_t T_input_feature_maps, 
-         uint32_t T_input_fmap_view_start, uint32_t T_input_fmap_view_length, uint32_t T_kernel_in_fmap_view_start,
-         uint32_t T_kernel_width, uint32_t T_kernel_height, uint32_t T_kernel_stride_x, uint32_t T_kernel_stride_y,
-         uint32_t T_output_width, uint32_t T_output_height, uint32_t T_output_feature_maps>
-optimized_layer_map_t::value_type prepare_entry()
-{
-    return { 
-        optimized_layer_map_t::key_type{ 
-            T_activation,
-            T_input_width, T_input_height, T_input_feature_maps, 
-            T_input_fmap_view_start, T_input_fmap_view_length, T_kernel_in_fmap_view_start, 
-            T_kernel_width, T_kernel_height, T_kernel_stride_x, T_kernel_stride_y,
-            T_output_width, T_output_height, T_output_feature_maps }, 
-        convolve_internal<
-            true, 
-            T_activation, 
-            (T_input_fmap_view_length % 8 == 0) ? 8 : T_input_fmap_view_length,
-            T_input_width, T_input_height, T_input_feature_maps, 
-            T_input_fmap_view_start, T_input_fmap_view_length, T_kernel_in_fmap_view_start,
-            T_kernel_width, T_kernel_height, T_kernel_stride_x, T_kernel_stride_y, 
-            T_output_width, T_output_height, T_output_feature_maps> };
-}
-
-optimized_layer_map_t optimized_layer_map =
-{
-    // C3
-    { prepare_entry<NN_ACTIVATION_FUNCTION_NONE, 14, 14, 256, 0, 256, 0, 3, 3, 1, 1, 14, 14, 512>() },
-    { prepare_entry<NN_ACTIVATION_FUNCTION_RELU, 14, 14, 256, 0, 256, 0 ,3, 3, 1, 1, 14, 14, 512>() },
-
-    //  C4.
-    { prepare_entry<NN_ACTIVATION_FUNCTION_NONE, 14, 14, 512, 0, 512, 0, 3, 3, 1, 1, 14, 14, 1024>() },
-    { prepare_entry<NN_ACTIVATION_FUNCTION_RELU, 14, 14, 512, 0, 512, 0, 3, 3, 1, 1, 14, 14, 1024>() },
-
-    // CaffeNet C1.
-    { prepare_entry<NN_ACTIVATION_FUNCTION_NONE, 227, 227, 3, 0, 3, 0, 11, 11, 4, 4, 55, 55, 96>() },
-    { prepare_entry<NN_ACTIVATION_FUNCTION_RELU, 227, 227, 3, 0, 3, 0, 11, 11, 4, 4, 55, 55, 96>() },
-
-    // CaffeNet C2A.
-    { prepare_entry<NN_ACTIVATION_FUNCTION_NONE, 31, 31, 96, 0, 48, 0, 5, 5, 1, 1, 27, 27, 256>() },
-    { prepare_entry<NN_ACTIVATION_FUNCTION_RELU, 31, 31, 96, 0, 48, 0, 5, 5, 1, 1, 27, 27, 256>() },
-
-    // CaffeNet C2B.
-    { prepare_entry<NN_ACTIVATION_FUNCTION_NONE, 31, 31, 96, 48, 48, 0, 5, 5, 1, 1, 27, 27, 256>() },
-    { prepare_entry<NN_ACTIVATION_FUNCTION_RELU, 31, 31, 96, 48, 48, 0, 5, 5, 1, 1, 27, 27, 256>() },
-
-    // CaffeNet C3.
-    { prepare_entry<NN_ACTIVATION_FUNCTION_NONE, 15, 15, 256, 0, 256, 0, 3, 3, 1, 1, 15, 15, 384>() },
-    { prepare_entry<NN_ACTIVATION_FUNCTION_RELU, 15, 15, 256, 0, 256, 0, 3, 3, 1, 1, 15, 15, 384>() },
-
-    // CaffeNet C4A.
-    { prepare_entry<NN_ACTIVATION_FUNCTION_NONE, 15, 15, 384, 0, 192, 0, 3, 3, 1, 1, 15, 15, 192>() },
-    { prepare_entry<NN_ACTIVATION_FUNCTION_RELU, 15, 15, 384, 0, 192, 0, 3, 3, 1, 1, 15, 15, 192>() },
-
-    // CaffeNet C4B.
-    { prepare_entry<NN_ACTIVATION_FUNCTION_NONE, 15, 15, 384, 192, 192, 0, 3, 3, 1, 1, 15, 15, 192>() },
-    { prepare_entry<NN_ACTIVATION_FUNCTION_RELU, 15, 15, 384, 192, 192, 0, 3, 3, 1, 1, 15, 15, 192>() },
-
-    // CaffeNet C5AB.
-    { prepare_entry<NN_ACTIVATION_FUNCTION_NONE, 15, 15, 192, 0, 192, 0, 3, 3, 1, 1, 13, 13, 256>() },
-    { prepare_entry<NN_ACTIVATION_FUNCTION_RELU, 15, 15, 192, 0, 192, 0, 3, 3, 1, 1, 13, 13, 256>() },
-};
-
 template <NN_ACTIVATION_FUNCTION T_activation>
 void run_convolution(const nn::nn_workload_data_t<float> *input_view,
                      const NN_PADDING_MODE padding,
@@ -363,45 +441,30 @@ void run_convolution(const nn::nn_workload_data_t<float> *input_view,
                      const size_t stride_y,
                      const nn::nn_workload_data_t<float> *weights,
                      const nn::nn_workload_data_t<float> *bias,
-                     nn::nn_workload_data_t<float> *output_view) {
-
-    const size_t num_output_feature_maps = output_view->parent->lengths.t[NN_DATA_COORD_z];
-    const size_t num_input_feature_maps = input_view->parent->lengths.t[NN_DATA_COORD_z];
-    const size_t output_feature_map_width = output_view->parent->lengths.t[NN_DATA_COORD_x];
-    const size_t output_feature_map_height = output_view->parent->lengths.t[NN_DATA_COORD_y];
-    const size_t input_feature_map_width = input_view->parent->lengths.t[NN_DATA_COORD_x];
-    const size_t input_feature_map_height = input_view->parent->lengths.t[NN_DATA_COORD_y];
-    const size_t kernel_width = weights->parent->lengths.t[NN_DATA_COORD_x];
-    const size_t kernel_height = weights->parent->lengths.t[NN_DATA_COORD_y];
-    const size_t kernel_input_fmap_view_start = weights->view_begin.t[NN_DATA_COORD_z];
-    const size_t input_fmap_view_start = input_view->view_begin.t[NN_DATA_COORD_z];
-    const size_t input_fmap_view_length = input_view->view_end.t[NN_DATA_COORD_z] - input_fmap_view_start + 1;
-
-    auto map_element = optimized_layer_map.find(std::make_tuple(
-        T_activation,
-        input_feature_map_width,
-        input_feature_map_height,
-        num_input_feature_maps,
-        input_fmap_view_start,
-        input_fmap_view_length,
-        kernel_input_fmap_view_start,
-        kernel_width,
-        kernel_height,
-        stride_x,
-        stride_y,
-        output_feature_map_width,
-        output_feature_map_height,
-        num_output_feature_maps));
-
-    if (map_element != std::end(optimized_layer_map))
+                     nn::nn_workload_data_t<float> *output_view,
+                     bool use_optimized_kernel) {
+
+    if (use_optimized_kernel && nn_cpu_jit_code::is_supported())
     {
-        // Optimized.
-        map_element->second(input_view, center_offset_x, center_offset_y, stride_x, stride_y, weights, bias, output_view);
+        // Kernel generated for this layer shape.
+        const uint32_t num_input_feature_maps = input_view->parent->lengths.t[NN_DATA_COORD_z];
+        const uint32_t input_fmap_view_start = input_view->view_begin.t[NN_DATA_COORD_z];
+        const auto &jit_kernel = get_jit_kernel(std::make_tuple(
+            T_activation,
+            static_cast<uint32_t>(input_view->parent->lengths.t[NN_DATA_COORD_x] * num_input_feature_maps),
+            num_input_feature_maps,
+            static_cast<uint32_t>(input_view->view_end.t[NN_DATA_COORD_z] - input_fmap_view_start + 1),
+            static_cast<uint32_t>(weights->parent->lengths.t[NN_DATA_COORD_x]),
+            static_cast<uint32_t>(weights->parent->lengths.t[NN_DATA_COORD_y]),
+            static_cast<uint32_t>(stride_x),
+            static_cast<uint32_t>(output_view->parent->lengths.t[NN_DATA_COORD_z])));
+
+        convolve_internal<true, T_activation>(input_view, center_offset_x, center_offset_y, stride_x, stride_y, weights, bias, output_view, &jit_kernel);
     }
     else
     {
         // Generic.
-        convolve_internal<false, T_activation>(input_view, center_offset_x, center_offset_y, stride_x, stride_y, weights, bias, output_view);
+        convolve_internal<false, T_activation>(input_view, center_offset_x, center_offset_y, stride_x, stride_y, weights, bias, output_view, nullptr);
     }
 }
 
@@ -414,7 +477,8 @@ void choose_convolution_padding_mode_and_activation(const nn::nn_workload_data_t
                                                     const nn_argument_activation_t &activation,
                                                     const nn::nn_workload_data_t<float> *weights,
                                                     const nn::nn_workload_data_t<float> *bias,
-                                                    nn::nn_workload_data_t<float> *output) {
+                                                    nn::nn_workload_data_t<float> *output,
+                                                    bool use_optimized_kernel) {
 
     switch (padding)
     {
@@ -537,8 +601,8 @@ void choose_convolution_padding_mode_and_activation(const nn::nn_workload_data_t
                 output_subview = new nn::nn_workload_data_t<float>(*output, output_view_start, output_view_end);
 
                 switch (activation.function) {
-                case NN_ACTIVATION_FUNCTION_NONE: run_convolution<NN_ACTIVATION_FUNCTION_NONE>(input_subview, padding, center_offset_x, center_offset_y, stride_x, stride_y, weights, bias, output_subview); break;
-                case NN_ACTIVATION_FUNCTION_RELU: run_convolution<NN_ACTIVATION_FUNCTION_RELU>(input_subview, padding, center_offset_x, center_offset_y, stride_x, stride_y, weights, bias, output_subview); break;
+                case NN_ACTIVATION_FUNCTION_NONE: run_convolution<NN_ACTIVATION_FUNCTION_NONE>(input_subview, padding, center_offset_x, center_offset_y, stride_x, stride_y, weights, bias, output_subview, use_optimized_kernel); break;
+                case NN_ACTIVATION_FUNCTION_RELU: run_convolution<NN_ACTIVATION_FUNCTION_RELU>(input_subview, padding, center_offset_x, center_offset_y, stride_x, stride_y, weights, bias, output_subview, use_optimized_kernel); break;
                 }
             }
 
@@ -680,7 +744,8 @@ using parameters_convolution_f32_avx2 = std::tuple<nn::nn_workload_data_t<float>
                                                    const nn_argument_activation_t *,
                                                    nn::nn_workload_data_t<float> *,
                                                    nn::nn_workload_data_t<float> *,
-                                                   nn::nn_workload_data_t<float> *>;
+                                                   nn::nn_workload_data_t<float> *,
+                                                   bool>;
 
 void unpack_convolve_callback_handle(
     void* void_handle)
@@ -695,7 +760,8 @@ void unpack_convolve_callback_handle(
                                                    *std::get<6>(handle),
                                                    std::get<7>(handle),
                                                    std::get<8>(handle),
-                                                   std::get<9>(handle));
+                                                   std::get<9>(handle),
+                                                   std::get<10>(handle));
 }
 
 nn_opaque_data_t *NN_API_CALL_CONVENTION
@@ -767,18 +833,43 @@ void convolution_f32::forward(const nn::nn_workload_data_t<float> *input_buffer,
                               const nn::nn_workload_data_t<float> *weights_buffer,
                               const nn::nn_workload_data_t<float> *bias_buffer,
                               nn::nn_workload_data_t<float> *output_buffer) {
-    const auto num_output_fm_items =
+    const auto kernel = get_kernel();
+    if (kernel == kernel_type::implicit_gemm)
+    {
+        convolution_f32_impl::convolve_implicit_gemm(input_buffer, center_offset_x, center_offset_y, stride_x, stride_y, activation, weights_buffer, bias_buffer, output_buffer, tuning.partition, device);
+        return;
+    }
+
+    const auto num_output_fm_slices =
         (output_buffer->view_end.t[NN_DATA_COORD_z] - output_buffer->view_begin.t[NN_DATA_COORD_z] + 1) /
         convolution_f32_impl::C_slice_size;
+    const bool use_optimized_kernel = kernel == kernel_type::generated;
     const auto num_batch_items =
         (output_buffer->view_end.t[NN_DATA_COORD_n] - output_buffer->view_begin.t[NN_DATA_COORD_n] + 1);
-
-    const auto total_workers = num_output_fm_items * num_batch_items;
+    const auto num_rows = output_buffer->get_length(NN_DATA_COORD_y);
+
+    // Slices & rows of image computed by single job; tuned partition fixes slices.
+    const auto partition = nn_cpu_partition_choose(
+        nn_cpu_partition_work{static_cast<uint32_t>(num_batch_items),
+                              static_cast<uint32_t>(num_output_fm_slices),
+                              static_cast<uint32_t>(num_rows),
+                              1,
+                              static_cast<uint64_t>(kernel_w) * kernel_h * input_size_z * convolution_f32_impl::C_slice_size * sizeof(float),
+                              static_cast<uint64_t>(kernel_h) * input_buffer->get_length(NN_DATA_COORD_x) * input_size_z * sizeof(float)},
+        device->thread_pool.get_num_threads(),
+        tuning.partition);
+    const auto slices_per_item = partition.slices_per_job;
+    const auto num_output_fm_items = num_output_fm_slices / slices_per_item;
+    const auto output_fm_item_size = slices_per_item * convolution_f32_impl::C_slice_size;
+    const auto rows_per_item = partition.rows_per_job;
+    const auto num_row_items = (num_rows + rows_per_item - 1) / rows_per_item;
+
+    const auto total_workers = partition.num_jobs;
 
     if (device->thread_pool.get_num_threads() < 2 || total_workers < 2)
     {
         // Its tiny data or there is only one thread available - just do it singlethreaded way.
-        convolution_f32_impl::choose_convolution_padding_mode_and_activation(input_buffer, padding, center_offset_x, center_offset_y, stride_x, stride_y, activation, weights_buffer, bias_buffer, output_buffer);
+        convolution_f32_impl::choose_convolution_padding_mode_and_activation(input_buffer, padding, center_offset_x, center_offset_y, stride_x, stride_y, activation, weights_buffer, bias_buffer, output_buffer, use_optimized_kernel);
     }
     else
     {
@@ -795,16 +886,19 @@ void convolution_f32::forward(const nn::nn_workload_data_t<float> *input_buffer,
         // Fill slave work items.
         for (auto output_fm_item = 0u; output_fm_item < num_output_fm_items; ++output_fm_item)
         {
-            for (auto batch_item = 0u; batch_item < num_batch_items; ++batch_item)
+            for (auto item = 0u; item < num_batch_items * num_row_items; ++item)
             {
-                auto item_in_pool = batch_item + output_fm_item * num_batch_items;
+                const auto batch_item = item / num_row_items;
+                const auto first_row = item % num_row_items * rows_per_item;
+                const auto last_row = std::min(first_row + rows_per_item, num_rows) - 1;
+                auto item_in_pool = item + output_fm_item * num_batch_items * num_row_items;
 
-                // Replace nn_workload_datas pointers with views.
+                // Replace nn_workload_datas pointers with views; first input row of view is read by first output row.
                 nn_workload_data_coords_t input_view_begin =
                 {
                     0,
                     0,
-                    0,
+                    static_cast<uint32_t>(first_row * stride_y),
                     0,
                     0,
                     0
@@ -822,8 +916,8 @@ void convolution_f32::forward(const nn::nn_workload_data_t<float> *input_buffer,
                 {
                     batch_item,
                     0,
-                    0,
-                    output_fm_item * convolution_f32_impl::C_slice_size,
+                    first_row,
+                    output_fm_item * output_fm_item_size,
                     0,
                     0
                 };
@@ -831,8 +925,8 @@ void convolution_f32::forward(const nn::nn_workload_data_t<float> *input_buffer,
                 {
                     batch_item,
                     cpp_master_output->get_length(NN_DATA_COORD_x) - 1,
-                    cpp_master_output->get_length(NN_DATA_COORD_y) - 1,
-                    (output_fm_item+1) * convolution_f32_impl::C_slice_size - 1,
+                    last_row,
+                    (output_fm_item+1) * output_fm_item_size - 1,
                     cpp_master_output->get_length(NN_DATA_COORD_p) - 1,
                     cpp_master_output->get_length(NN_DATA_COORD_q) - 1
                 };
@@ -844,7 +938,7 @@ void convolution_f32::forward(const nn::nn_workload_data_t<float> *input_buffer,
                     0,
                     0,
                     0,
-                    output_fm_item
+                    output_fm_item * slices_per_item
                 };
                 nn_workload_data_coords_t weights_view_end =
                 {
@@ -853,7 +947,7 @@ void convolution_f32::forward(const nn::nn_workload_data_t<float> *input_buffer,
                     cpp_master_weights->get_length(NN_DATA_COORD_y) - 1,
                     cpp_master_weights->get_length(NN_DATA_COORD_z) - 1,
                     cpp_master_weights->get_length(NN_DATA_COORD_p) - 1,
-                    output_fm_item
+                    (output_fm_item+1) * slices_per_item - 1
                 };
 
                 input_views[item_in_pool] = 
@@ -873,7 +967,7 @@ void convolution_f32::forward(const nn::nn_workload_data_t<float> *input_buffer,
                     nn_workload_data_coords_t bias_view_begin =
                     {
                         0,
-                        output_fm_item * convolution_f32_impl::C_slice_size,
+                        output_fm_item * output_fm_item_size,
                         0,
                         0,
                         0,
@@ -882,7 +976,7 @@ void convolution_f32::forward(const nn::nn_workload_data_t<float> *input_buffer,
                     nn_workload_data_coords_t bias_view_end =
                     {
                         cpp_master_biases->get_length(NN_DATA_COORD_n) - 1,
-                        (output_fm_item+1) * convolution_f32_impl::C_slice_size - 1,
+                        (output_fm_item+1) * output_fm_item_size - 1,
                         cpp_master_biases->get_length(NN_DATA_COORD_y) - 1,
                         cpp_master_biases->get_length(NN_DATA_COORD_z) - 1,
                         cpp_master_biases->get_length(NN_DATA_COORD_p) - 1,
@@ -912,7 +1006,8 @@ void convolution_f32::forward(const nn::nn_workload_data_t<float> *input_buffer,
                                                             &activation,
                                                             weight_views[item_in_pool],
                                                             bias_views[item_in_pool],
-                                                            output_views[item_in_pool]);
+                                                            output_views[item_in_pool],
+                                                            use_optimized_kernel);
 
             job[item_in_pool].callback = convolution_f32_impl::unpack_convolve_callback_handle;
             job[item_in_pool].request_handle = &request_handles[item_in_pool];
@@ -954,19 +1049,24 @@ convolution_f32 *convolution_f32::create(size_t kernel_w,
                                          const nn_argument_activation_t &activation,
                                          size_t batch_size,
                                          nn_device_t *device) {
-    return new convolution_f32(kernel_w,
-                               kernel_h,
-                               num_input,
-                               num_output,
-                               output_w,
-                               output_h,
-                               center_offset_x,
-                               center_offset_y,
-                               stride_x,
-                               stride_y,
-                               activation,
-                               batch_size,
-                               reinterpret_cast<nn_device_internal *>(device));
+    auto primitive = new convolution_f32(kernel_w,
+                                         kernel_h,
+                                         num_input,
+                                         num_output,
+                                         output_w,
+                                         output_h,
+                                         center_offset_x,
+                                         center_offset_y,
+                                         stride_x,
+                                         stride_y,
+                                         activation,
+                                         batch_size,
+                                         reinterpret_cast<nn_device_internal *>(device));
+
+    // Implicit GEMM has AVX-512 micro-kernel, generated code is AVX2 only.
+    if (primitive->device->isa == NN_CPU_ISA_AVX512)
+        primitive->tuning = nn_cpu_tuning_t{2, 0};
+    return primitive;
 }
 
 nn::nn_workload_data_t<float> *convolution_f32::create_weights(const nn::data<float, 4> &weights) {
@@ -1130,6 +1230,50 @@ bool convolution_f32::validate_input(const nn::nn_workload_data_t<float> &input)
 size_t convolution_f32::get_required_input_w() { return (output_size_x - 1) * stride_x + kernel_w; }
 
 size_t convolution_f32::get_required_input_h() { return (output_size_y - 1) * stride_y + kernel_h; }
+
+std::vector<nn_cpu_tuning_t> convolution_f32::get_tuning_candidates() {
+    // Generated kernel is available for every layer where code generation is supported.
+    const uint32_t num_kernels = nn_cpu_jit_code::is_supported() ? 2 : 1;
+
+    // Split chosen by partitioner (default) is tried before fixed ones; with single thread only single slice is.
+    const uint32_t num_slices = output_size_z / convolution_f32_impl::C_slice_size;
+    std::vector<uint32_t> partitions = {0, 1};
+    if (device->thread_pool.get_num_threads() > 1)
+    {
+        for (uint32_t slices = 2; slices <= 8 && slices < num_slices; slices *= 2)
+            if (num_slices % slices == 0) partitions.push_back(slices);
+    }
+
+    std::vector<nn_cpu_tuning_t> candidates;
+    for (uint32_t kernel = 0; kernel < num_kernels; ++kernel)
+        for (auto partition : partitions)
+            candidates.push_back(nn_cpu_tuning_t{kernel, partition});
+
+    // Implicit GEMM with tiles of 48 (default), 24 & 96 pixels; first when it is the default.
+    std::vector<nn_cpu_tuning_t> gemm_candidates;
+    for (uint32_t tile_blocks : {0u, 4u, 16u})
+        gemm_candidates.push_back(nn_cpu_tuning_t{2, tile_blocks});
+    candidates.insert(device->isa == NN_CPU_ISA_AVX512 ? candidates.begin() : candidates.end(),
+                      gemm_candidates.begin(),
+                      gemm_candidates.end());
+    return candidates;
+}
+
+convolution_f32::kernel_type convolution_f32::get_kernel() const {
+    if (tuning.kernel == 2)
+        return kernel_type::implicit_gemm;
+    return tuning.kernel == 0 && nn_cpu_jit_code::is_supported() ? kernel_type::generated : kernel_type::generic;
+}
+
+std::string convolution_f32::get_tuning_signature() {
+    return "convolution_f32"
+        ";in=" + std::to_string(get_required_input_w()) + "x" + std::to_string(get_required_input_h()) + "x" + std::to_string(input_size_z) +
+        ";out=" + std::to_string(output_size_x) + "x" + std::to_string(output_size_y) + "x" + std::to_string(output_size_z) +
+        ";kernel=" + std::to_string(kernel_w) + "x" + std::to_string(kernel_h) +
+        ";stride=" + std::to_string(stride_x) + "x" + std::to_string(stride_y) +
+        ";activation=" + std::to_string(activation.function) +
+        ";batch=" + std::to_string(batch_size);
+}
 } // namespace layer
 
 nn_primitives_convolution_f32_0_t nn_primitives_convolution_f32_0 = {
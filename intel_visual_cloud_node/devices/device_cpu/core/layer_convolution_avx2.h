@@ -28,12 +28,19 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "../api_internal/nn_device_interface_0_internal.h"
+#include "../api_internal/cpu_autotuner.h"
 #include "../../api/nn_primitives_api_0.h"
 #include "helper_zxyn_f32.h"
 
 namespace layer {
 
-class convolution_f32 : public helper_zxyn_f32::primitive_zxyn_f32_base {
+// Tuning: kernel 0 - kernel generated at run time for layer shape, 1 - generic kernel, 2 - implicit GEMM;
+//         partition - kernels 0 & 1: number of output feature map slices computed by single job (0 - chosen by
+//                     nn_cpu_partition_choose), output rows are split between jobs when images & slices are too few,
+//                     kernel 2: number of 6-pixel blocks in tile of output pixels (0 - default).
+//         Default set by create: kernel 2, partition 0 on devices running AVX-512 kernels (NN_PARAMETER_CPU_ISA),
+//         kernel 0, partition 0 otherwise; it is the first tuning candidate.
+class convolution_f32 : public helper_zxyn_f32::primitive_zxyn_f32_base, public nn_cpu_tunable {
   public:
     static convolution_f32 *create(size_t kernel_w,
                                    size_t kernel_h,
@@ -63,6 +70,14 @@ class convolution_f32 : public helper_zxyn_f32::primitive_zxyn_f32_base {
     virtual nn::nn_workload_data_t<float> *create_input(const nn::data<float, 4> &input);
     virtual bool validate_input(const nn::nn_workload_data_t<float>& input);
 
+    virtual std::vector<nn_cpu_tuning_t> get_tuning_candidates() override;
+    virtual std::string get_tuning_signature() override;
+
+    // Kernel run by forward for current tuning; generated kernel falls back to generic one where code generation
+    // is not supported.
+    enum class kernel_type { generated, generic, implicit_gemm };
+    kernel_type get_kernel() const;
+
   protected:
     convolution_f32(const size_t kernel_w,
                     const size_t kernel_h,
@@ -94,6 +109,46 @@ class convolution_f32 : public helper_zxyn_f32::primitive_zxyn_f32_base {
 void run_multithreaded_convolve_work_item(nn_workload_item *const work_item, nn_device_internal *device);
 
 namespace convolution_f32_impl {
+// Computes convolution (with activation) of output view; input view begins at input of its first output.
+void choose_convolution_padding_mode_and_activation(const nn::nn_workload_data_t<float> *input,
+                                                    const NN_PADDING_MODE padding,
+                                                    const int32_t center_offset_x,
+                                                    const int32_t center_offset_y,
+                                                    const size_t stride_x,
+                                                    const size_t stride_y,
+                                                    const nn_argument_activation_t &activation,
+                                                    const nn::nn_workload_data_t<float> *weights,
+                                                    const nn::nn_workload_data_t<float> *bias,
+                                                    nn::nn_workload_data_t<float> *output,
+                                                    bool use_optimized_kernel);
+
+// Computes convolution (with activation) of output view as GEMM of packed tiles of output pixels & weights;
+// splits work into jobs of device thread pool. Kernel 2 of convolution_f32 (layer_convolution_gemm_avx2.cpp).
+void convolve_implicit_gemm(const nn::nn_workload_data_t<float> *input,
+                            int32_t center_offset_x,
+                            int32_t center_offset_y,
+                            size_t stride_x,
+                            size_t stride_y,
+                            const nn_argument_activation_t &activation,
+                            const nn::nn_workload_data_t<float> *weights,
+                            const nn::nn_workload_data_t<float> *bias,
+                            nn::nn_workload_data_t<float> *output,
+                            uint32_t tile_blocks,
+                            nn_device_internal *device);
+
+// Same computation on calling thread with default tile, for layers running it inside their own jobs (convolution +
+// pooling computes rows of its tiles with it on devices running AVX-512 kernels).
+void convolve_implicit_gemm_rows(const nn::nn_workload_data_t<float> *input,
+                                 int32_t center_offset_x,
+                                 int32_t center_offset_y,
+                                 size_t stride_x,
+                                 size_t stride_y,
+                                 const nn_argument_activation_t &activation,
+                                 const nn::nn_workload_data_t<float> *weights,
+                                 const nn::nn_workload_data_t<float> *bias,
+                                 nn::nn_workload_data_t<float> *output,
+                                 nn_device_internal *device);
+
 nn_opaque_data_t *NN_API_CALL_CONVENTION
 create_weights(nn_primitive_handle_t handle, const nn_data_t *weights, NN_API_STATUS *status);
 nn_opaque_data_t *NN_API_CALL_CONVENTION
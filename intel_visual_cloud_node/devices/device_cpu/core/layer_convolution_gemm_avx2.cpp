@@ -0,0 +1,429 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "../../common/nn_workload_data.h"
+#include "../api_internal/nn_device_interface_0_internal.h"
+#include "layer_convolution_avx2.h"
+#include "layers_avx512.h"
+
+#include <immintrin.h>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <vector>
+
+/* Implicit GEMM convolution.
+
+Output pixels of view are multiplied as rows of matrix: row of pixel holds input values read by kernel at its every
+position (im2col), columns of weights are output feature maps. Matrix is never built whole - tiles of consecutive
+output pixels are packed from input in blocks of at most C_depth_block values per pixel and multiplied by weights of
+block with register-blocked micro-kernel (6 pixels x 16 output feature maps; 12 pixels on devices running AVX-512
+kernels, see layer_convolution_gemm_avx512.cpp).
+Packed block stays in L2 cache & weights of block for single slice of output feature maps in L1 while all groups of
+tile are multiplied. Products are accumulated in per-thread buffer initialized with bias; activation is applied when
+tile is written to output.
+Input outside of its buffer is read as zero, so there is no separate path for borders of padded layers; kernel sizes,
+strides & views of input feature maps (groups) need no specialization.
+*/
+
+namespace layer {
+namespace convolution_f32_impl {
+namespace
+{
+const uint32_t C_simd_width = sizeof(__m256) / sizeof(float);
+const uint32_t C_slice_size = 2 * C_simd_width;
+
+// Micro-kernel computes 6 pixels for 16 output feature maps.
+const uint32_t C_block_pixels = 6;
+const uint32_t C_default_tile_blocks = 8;
+
+// Values of pixel packed at once: packed block of tile (96KB for default tile) fits L2 & weights of block (16KB) L1.
+const uint32_t C_depth_block = 256;
+
+float *gemm_buffer(size_t size)
+{
+    struct buffer_t
+    {
+        float *data = nullptr;
+        size_t size = 0;
+        ~buffer_t() { _mm_free(data); }
+    };
+    static thread_local buffer_t buffer;
+    if (buffer.size < size)
+    {
+        _mm_free(buffer.data);
+        buffer.size = 0;
+        buffer.data = static_cast<float *>(_mm_malloc(size * sizeof(float), 64));
+        if (buffer.data == nullptr) throw std::bad_alloc();
+        buffer.size = size;
+    }
+    return buffer.data;
+}
+
+// Buffers & dimensions shared by all jobs of one forward call.
+struct gemm_task
+{
+    const float *input;
+    uint32_t input_width, input_height, input_depth;
+    uint32_t input_fmap_start, num_input;   // view of input feature maps
+    int32_t input_start_x, input_start_y;   // input read by top-left kernel position for first output of view
+    uint32_t stride_x, stride_y;
+
+    const float *weights;                   // first slice of view
+    uint32_t kernel_width, kernel_height;
+    uint32_t weights_fmap_start;            // input feature map of weights matching first one of input view
+    size_t weights_position_stride;         // between kernel positions
+    size_t weights_slice_stride;
+    const float *bias;                      // first output feature map of view, may be null
+
+    float *output;
+    uint32_t output_width, output_height, output_depth, output_fmap_start;
+    uint32_t output_start_x, output_start_y, output_view_width;
+    uint32_t num_slices;
+
+    // Block of packed values: kernel positions [position_begin, position_begin + positions) x input feature maps
+    // [fmap_begin, fmap_begin + fmaps); blocks cover kernel positions first when all input feature maps fit block.
+    uint32_t block_positions, block_fmaps;
+    uint32_t tile_pixels;
+
+    bool avx512;                            // device runs AVX-512 micro-kernel
+};
+
+// Multiplies packed values of group of pixels by weights & adds to accumulators of the group (16 per pixel).
+template <uint32_t T_pixels>
+void multiply_block(const float *packed, size_t packed_stride, uint32_t positions, uint32_t fmaps, const float *weights, size_t position_stride, float *accumulators)
+{
+    // Named accumulators - compilers keep them in registers which is not the case for arrays.
+    __m256 acc0 = _mm256_load_ps(accumulators + 0 * C_slice_size), acc1 = _mm256_load_ps(accumulators + 0 * C_slice_size + C_simd_width);
+    __m256 acc2, acc3, acc4, acc5, acc6, acc7, acc8, acc9, acc10, acc11;
+    if (T_pixels > 1) { acc2 = _mm256_load_ps(accumulators + 1 * C_slice_size);  acc3 = _mm256_load_ps(accumulators + 1 * C_slice_size + C_simd_width); }
+    if (T_pixels > 2) { acc4 = _mm256_load_ps(accumulators + 2 * C_slice_size);  acc5 = _mm256_load_ps(accumulators + 2 * C_slice_size + C_simd_width); }
+    if (T_pixels > 3) { acc6 = _mm256_load_ps(accumulators + 3 * C_slice_size);  acc7 = _mm256_load_ps(accumulators + 3 * C_slice_size + C_simd_width); }
+    if (T_pixels > 4) { acc8 = _mm256_load_ps(accumulators + 4 * C_slice_size);  acc9 = _mm256_load_ps(accumulators + 4 * C_slice_size + C_simd_width); }
+    if (T_pixels > 5) { acc10 = _mm256_load_ps(accumulators + 5 * C_slice_size); acc11 = _mm256_load_ps(accumulators + 5 * C_slice_size + C_simd_width); }
+
+    for (uint32_t position = 0; position < positions; ++position, weights += position_stride)
+    {
+        const float *fmap_weights = weights;
+        for (uint32_t fmap = 0; fmap < fmaps; ++fmap, fmap_weights += C_slice_size, ++packed)
+        {
+            const __m256 weights0 = _mm256_load_ps(fmap_weights);
+            const __m256 weights1 = _mm256_load_ps(fmap_weights + C_simd_width);
+            __m256 value;
+
+            value = _mm256_broadcast_ss(packed + 0 * packed_stride);
+            acc0 = _mm256_fmadd_ps(weights0, value, acc0);
+            acc1 = _mm256_fmadd_ps(weights1, value, acc1);
+            if (T_pixels > 1)
+            {
+                value = _mm256_broadcast_ss(packed + 1 * packed_stride);
+                acc2 = _mm256_fmadd_ps(weights0, value, acc2);
+                acc3 = _mm256_fmadd_ps(weights1, value, acc3);
+            }
+            if (T_pixels > 2)
+            {
+                value = _mm256_broadcast_ss(packed + 2 * packed_stride);
+                acc4 = _mm256_fmadd_ps(weights0, value, acc4);
+                acc5 = _mm256_fmadd_ps(weights1, value, acc5);
+            }
+            if (T_pixels > 3)
+            {
+                value = _mm256_broadcast_ss(packed + 3 * packed_stride);
+                acc6 = _mm256_fmadd_ps(weights0, value, acc6);
+                acc7 = _mm256_fmadd_ps(weights1, value, acc7);
+            }
+            if (T_pixels > 4)
+            {
+                value = _mm256_broadcast_ss(packed + 4 * packed_stride);
+                acc8 = _mm256_fmadd_ps(weights0, value, acc8);
+                acc9 = _mm256_fmadd_ps(weights1, value, acc9);
+            }
+            if (T_pixels > 5)
+            {
+                value = _mm256_broadcast_ss(packed + 5 * packed_stride);
+                acc10 = _mm256_fmadd_ps(weights0, value, acc10);
+                acc11 = _mm256_fmadd_ps(weights1, value, acc11);
+            }
+        }
+    }
+
+    _mm256_store_ps(accumulators + 0 * C_slice_size, acc0);
+    _mm256_store_ps(accumulators + 0 * C_slice_size + C_simd_width, acc1);
+    if (T_pixels > 1) { _mm256_store_ps(accumulators + 1 * C_slice_size, acc2);  _mm256_store_ps(accumulators + 1 * C_slice_size + C_simd_width, acc3); }
+    if (T_pixels > 2) { _mm256_store_ps(accumulators + 2 * C_slice_size, acc4);  _mm256_store_ps(accumulators + 2 * C_slice_size + C_simd_width, acc5); }
+    if (T_pixels > 3) { _mm256_store_ps(accumulators + 3 * C_slice_size, acc6);  _mm256_store_ps(accumulators + 3 * C_slice_size + C_simd_width, acc7); }
+    if (T_pixels > 4) { _mm256_store_ps(accumulators + 4 * C_slice_size, acc8);  _mm256_store_ps(accumulators + 4 * C_slice_size + C_simd_width, acc9); }
+    if (T_pixels > 5) { _mm256_store_ps(accumulators + 5 * C_slice_size, acc10); _mm256_store_ps(accumulators + 5 * C_slice_size + C_simd_width, acc11); }
+}
+
+// Packs block of input values for pixels [pixel_begin, pixel_begin + pixels) of output view.
+// Value (position, fmap) of pixel t is at (t * block_positions + position) * block_fmaps + fmap - runs of input feature
+// maps are copied whole.
+void pack_block(const gemm_task &task,
+                uint32_t image,
+                uint32_t pixel_begin,
+                uint32_t pixels,
+                uint32_t position_begin,
+                uint32_t positions,
+                uint32_t fmap_begin,
+                uint32_t fmaps,
+                float *packed)
+{
+    const float *image_input = task.input + static_cast<size_t>(image) * task.input_width * task.input_height * task.input_depth +
+                               task.input_fmap_start + fmap_begin;
+    for (uint32_t pixel = 0; pixel < pixels; ++pixel)
+    {
+        const auto view_x = (pixel_begin + pixel) % task.output_view_width;
+        const auto view_y = (pixel_begin + pixel) / task.output_view_width;
+        const int32_t pixel_x = task.input_start_x + static_cast<int32_t>(view_x * task.stride_x);
+        const int32_t pixel_y = task.input_start_y + static_cast<int32_t>(view_y * task.stride_y);
+        auto kernel_x = position_begin % task.kernel_width, kernel_y = position_begin / task.kernel_width;
+        for (uint32_t position = 0; position < positions; ++position, packed += fmaps)
+        {
+            const int32_t x = pixel_x + static_cast<int32_t>(kernel_x), y = pixel_y + static_cast<int32_t>(kernel_y);
+            if (x < 0 || y < 0 || x >= static_cast<int32_t>(task.input_width) || y >= static_cast<int32_t>(task.input_height))
+                std::fill_n(packed, fmaps, 0.0f);
+            else
+                std::copy_n(image_input + (static_cast<size_t>(y) * task.input_width + x) * task.input_depth, fmaps, packed);
+
+            if (++kernel_x == task.kernel_width)
+            {
+                kernel_x = 0;
+                ++kernel_y;
+            }
+        }
+    }
+}
+
+// Computes pixels [pixel_begin, pixel_begin + pixels) of image for output feature map slices [slice_begin, slice_end).
+template <NN_ACTIVATION_FUNCTION T_activation>
+void compute_tile(const gemm_task &task, uint32_t image, uint32_t pixel_begin, uint32_t pixels, uint32_t slice_begin, uint32_t slice_end)
+{
+    // Accumulators first - they are read & written with aligned accesses.
+    const size_t accumulators_size = static_cast<size_t>(slice_end - slice_begin) * task.tile_pixels * C_slice_size;
+    float *accumulators = gemm_buffer(accumulators_size + static_cast<size_t>(task.tile_pixels) * task.block_positions * task.block_fmaps);
+    float *packed = accumulators + accumulators_size;
+
+    for (auto slice = slice_begin; slice < slice_end; ++slice)
+    {
+        float *slice_accumulators = accumulators + static_cast<size_t>(slice - slice_begin) * task.tile_pixels * C_slice_size;
+        for (uint32_t pixel = 0; pixel < pixels; ++pixel)
+            for (uint32_t half = 0; half < 2; ++half)
+                _mm256_store_ps(slice_accumulators + pixel * C_slice_size + half * C_simd_width,
+                                task.bias ? _mm256_loadu_ps(task.bias + slice * C_slice_size + half * C_simd_width) : _mm256_setzero_ps());
+    }
+
+    const auto num_positions = task.kernel_width * task.kernel_height;
+    for (uint32_t position_begin = 0; position_begin < num_positions; position_begin += task.block_positions)
+        for (uint32_t fmap_begin = 0; fmap_begin < task.num_input; fmap_begin += task.block_fmaps)
+        {
+            const auto positions = std::min(task.block_positions, num_positions - position_begin);
+            const auto fmaps = std::min(task.block_fmaps, task.num_input - fmap_begin);
+            const size_t pixel_size = static_cast<size_t>(positions) * fmaps;
+            pack_block(task, image, pixel_begin, pixels, position_begin, positions, fmap_begin, fmaps, packed);
+
+            for (auto slice = slice_begin; slice < slice_end; ++slice)
+            {
+                const float *weights = task.weights + slice * task.weights_slice_stride + position_begin * task.weights_position_stride +
+                                       (task.weights_fmap_start + fmap_begin) * C_slice_size;
+                float *slice_accumulators = accumulators + static_cast<size_t>(slice - slice_begin) * task.tile_pixels * C_slice_size;
+                if (task.avx512)
+                {
+                    avx512::multiply_rows(packed, pixel_size, pixels, positions, fmaps, weights, task.weights_position_stride, slice_accumulators, true);
+                    continue;
+                }
+
+                uint32_t pixel = 0;
+                for (; pixel + C_block_pixels <= pixels; pixel += C_block_pixels)
+                    multiply_block<C_block_pixels>(packed + pixel * pixel_size, pixel_size, positions, fmaps, weights,
+                                                   task.weights_position_stride, slice_accumulators + pixel * C_slice_size);
+
+                const float *group_packed = packed + pixel * pixel_size;
+                float *group_accumulators = slice_accumulators + pixel * C_slice_size;
+                switch (pixels - pixel)
+                {
+                case 0: break;
+                case 1: multiply_block<1>(group_packed, pixel_size, positions, fmaps, weights, task.weights_position_stride, group_accumulators); break;
+                case 2: multiply_block<2>(group_packed, pixel_size, positions, fmaps, weights, task.weights_position_stride, group_accumulators); break;
+                case 3: multiply_block<3>(group_packed, pixel_size, positions, fmaps, weights, task.weights_position_stride, group_accumulators); break;
+                case 4: multiply_block<4>(group_packed, pixel_size, positions, fmaps, weights, task.weights_position_stride, group_accumulators); break;
+                case 5: multiply_block<5>(group_packed, pixel_size, positions, fmaps, weights, task.weights_position_stride, group_accumulators); break;
+                }
+            }
+        }
+
+    float *output = task.output + static_cast<size_t>(image) * task.output_width * task.output_height * task.output_depth +
+                    task.output_fmap_start;
+    for (auto slice = slice_begin; slice < slice_end; ++slice)
+    {
+        const float *slice_accumulators = accumulators + static_cast<size_t>(slice - slice_begin) * task.tile_pixels * C_slice_size;
+        for (uint32_t pixel = 0; pixel < pixels; ++pixel)
+        {
+            const auto output_x = task.output_start_x + (pixel_begin + pixel) % task.output_view_width;
+            const auto output_y = task.output_start_y + (pixel_begin + pixel) / task.output_view_width;
+            for (uint32_t half = 0; half < 2; ++half)
+            {
+                __m256 result = _mm256_load_ps(slice_accumulators + pixel * C_slice_size + half * C_simd_width);
+                if (T_activation == NN_ACTIVATION_FUNCTION_RELU)
+                    result = _mm256_max_ps(result, _mm256_setzero_ps());
+                _mm256_storeu_ps(output + (static_cast<size_t>(output_y) * task.output_width + output_x) * task.output_depth +
+                                     slice * C_slice_size + half * C_simd_width,
+                                 result);
+            }
+        }
+    }
+}
+
+// Describes computation of output view; tiles of pixels default to C_default_tile_blocks groups.
+gemm_task create_task(const nn::nn_workload_data_t<float> *input,
+                      int32_t center_offset_x,
+                      int32_t center_offset_y,
+                      size_t stride_x,
+                      size_t stride_y,
+                      const nn::nn_workload_data_t<float> *weights,
+                      const nn::nn_workload_data_t<float> *bias,
+                      nn::nn_workload_data_t<float> *output,
+                      uint32_t tile_blocks,
+                      nn_device_internal *device)
+{
+    gemm_task task;
+    task.input = static_cast<const float *>(input->parent->data_buffer);
+    task.input_width = input->parent->lengths.t[NN_DATA_COORD_x];
+    task.input_height = input->parent->lengths.t[NN_DATA_COORD_y];
+    task.input_depth = input->parent->lengths.t[NN_DATA_COORD_z];
+    task.input_fmap_start = input->view_begin.t[NN_DATA_COORD_z];
+    task.num_input = input->view_end.t[NN_DATA_COORD_z] - task.input_fmap_start + 1;
+    task.input_start_x = static_cast<int32_t>(input->view_begin.t[NN_DATA_COORD_x]) - center_offset_x;
+    task.input_start_y = static_cast<int32_t>(input->view_begin.t[NN_DATA_COORD_y]) - center_offset_y;
+    task.stride_x = static_cast<uint32_t>(stride_x);
+    task.stride_y = static_cast<uint32_t>(stride_y);
+
+    task.kernel_width = weights->parent->lengths.t[NN_DATA_COORD_x];
+    task.kernel_height = weights->parent->lengths.t[NN_DATA_COORD_y];
+    task.weights_fmap_start = weights->view_begin.t[NN_DATA_COORD_z];
+    task.weights_position_stride = static_cast<size_t>(weights->parent->lengths.t[NN_DATA_COORD_z]) * C_slice_size;
+    task.weights_slice_stride = task.weights_position_stride * task.kernel_width * task.kernel_height;
+    task.weights = static_cast<const float *>(weights->parent->data_buffer) + weights->view_begin.t[NN_DATA_COORD_q] * task.weights_slice_stride;
+    task.bias = bias ? static_cast<const float *>(bias->parent->data_buffer) + bias->view_begin.t[NN_DATA_COORD_x] : nullptr;
+
+    task.output = static_cast<float *>(output->parent->data_buffer);
+    task.output_width = output->parent->lengths.t[NN_DATA_COORD_x];
+    task.output_height = output->parent->lengths.t[NN_DATA_COORD_y];
+    task.output_depth = output->parent->lengths.t[NN_DATA_COORD_z];
+    task.output_fmap_start = output->view_begin.t[NN_DATA_COORD_z];
+    task.output_start_x = output->view_begin.t[NN_DATA_COORD_x];
+    task.output_start_y = output->view_begin.t[NN_DATA_COORD_y];
+    task.output_view_width = output->view_end.t[NN_DATA_COORD_x] - task.output_start_x + 1;
+    task.num_slices = (output->view_end.t[NN_DATA_COORD_z] - task.output_fmap_start + 1) / C_slice_size;
+
+    task.block_fmaps = std::min(task.num_input, C_depth_block);
+    task.block_positions = std::max(1u, C_depth_block / task.num_input);
+    task.tile_pixels = C_block_pixels * (tile_blocks ? tile_blocks : C_default_tile_blocks);
+    task.avx512 = device->isa == NN_CPU_ISA_AVX512;
+    return task;
+}
+
+} // namespace
+
+void convolve_implicit_gemm(const nn::nn_workload_data_t<float> *input,
+                            int32_t center_offset_x,
+                            int32_t center_offset_y,
+                            size_t stride_x,
+                            size_t stride_y,
+                            const nn_argument_activation_t &activation,
+                            const nn::nn_workload_data_t<float> *weights,
+                            const nn::nn_workload_data_t<float> *bias,
+                            nn::nn_workload_data_t<float> *output,
+                            uint32_t tile_blocks,
+                            nn_device_internal *device)
+{
+    const auto task = create_task(input, center_offset_x, center_offset_y, stride_x, stride_y, weights, bias, output, tile_blocks, device);
+    const auto compute = activation.function == NN_ACTIVATION_FUNCTION_RELU ? compute_tile<NN_ACTIVATION_FUNCTION_RELU>
+                                                                            : compute_tile<NN_ACTIVATION_FUNCTION_NONE>;
+
+    // Work is split into units: tiles of pixels of single image; when there are less of them than threads,
+    // output feature map slices are split too.
+    const auto num_pixels = task.output_view_width * (output->view_end.t[NN_DATA_COORD_y] - task.output_start_y + 1);
+    const auto num_tiles = (num_pixels + task.tile_pixels - 1) / task.tile_pixels;
+    const auto image_begin = output->view_begin.t[NN_DATA_COORD_n];
+    const auto num_images = output->view_end.t[NN_DATA_COORD_n] - image_begin + 1;
+    const auto num_threads = device->thread_pool.get_num_threads();
+    const auto slice_parts = std::min(task.num_slices, std::max(1u, (num_threads + num_images * num_tiles - 1) / (num_images * num_tiles)));
+    const auto num_units = num_images * num_tiles * slice_parts;
+
+    auto run_units = [&task, compute, num_tiles, slice_parts, image_begin, num_pixels](uint32_t unit_begin, uint32_t unit_end) {
+        for (auto unit = unit_begin; unit < unit_end; ++unit)
+        {
+            const auto slice_part = unit % slice_parts;
+            const auto tile = unit / slice_parts % num_tiles;
+            const auto image = image_begin + unit / slice_parts / num_tiles;
+            const auto pixel_begin = tile * task.tile_pixels;
+            compute(task, image, pixel_begin, std::min(task.tile_pixels, num_pixels - pixel_begin),
+                    slice_part * task.num_slices / slice_parts, (slice_part + 1) * task.num_slices / slice_parts);
+        }
+    };
+
+    const auto num_jobs = std::min(num_threads, num_units);
+    if (num_jobs < 2)
+    {
+        run_units(0, num_units);
+        return;
+    }
+
+    std::vector<nn_multithreaded_request> jobs(num_jobs);
+    for (auto job = 0u; job < num_jobs; ++job)
+    {
+        const auto unit_begin = job * num_units / num_jobs, unit_end = (job + 1) * num_units / num_jobs;
+        jobs[job].callback = [&run_units, unit_begin, unit_end](void *) { run_units(unit_begin, unit_end); };
+        jobs[job].request_handle = nullptr;
+    }
+    device->thread_pool.push_job(jobs);
+}
+
+void convolve_implicit_gemm_rows(const nn::nn_workload_data_t<float> *input,
+                                 int32_t center_offset_x,
+                                 int32_t center_offset_y,
+                                 size_t stride_x,
+                                 size_t stride_y,
+                                 const nn_argument_activation_t &activation,
+                                 const nn::nn_workload_data_t<float> *weights,
+                                 const nn::nn_workload_data_t<float> *bias,
+                                 nn::nn_workload_data_t<float> *output,
+                                 nn_device_internal *device)
+{
+    const auto task = create_task(input, center_offset_x, center_offset_y, stride_x, stride_y, weights, bias, output, 0, device);
+    const auto compute = activation.function == NN_ACTIVATION_FUNCTION_RELU ? compute_tile<NN_ACTIVATION_FUNCTION_RELU>
+                                                                            : compute_tile<NN_ACTIVATION_FUNCTION_NONE>;
+
+    const auto num_pixels = task.output_view_width * (output->view_end.t[NN_DATA_COORD_y] - task.output_start_y + 1);
+    for (auto image = output->view_begin.t[NN_DATA_COORD_n]; image <= output->view_end.t[NN_DATA_COORD_n]; ++image)
+        for (uint32_t pixel_begin = 0; pixel_begin < num_pixels; pixel_begin += task.tile_pixels)
+            compute(task, image, pixel_begin, std::min(task.tile_pixels, num_pixels - pixel_begin), 0, task.num_slices);
+}
+
+} // namespace convolution_f32_impl
+} // namespace layer
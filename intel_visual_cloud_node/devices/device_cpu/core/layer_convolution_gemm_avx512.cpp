@@ -0,0 +1,141 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "layers_avx512.h"
+
+#include <immintrin.h>
+
+/* AVX-512 micro-kernel of implicit GEMM (layer_convolution_gemm_avx2.cpp) & Winograd (layer_convolution_winograd_avx2.cpp)
+convolutions. Slice of 16 output feature maps fills one register, so block of 12 rows keeps 12 accumulators & reuses
+each loaded vector of weights 12 times (6 times with two registers per row in AVX2 versions).
+*/
+
+namespace layer {
+namespace avx512 {
+namespace
+{
+const uint32_t C_slice_size = sizeof(__m512) / sizeof(float);
+const uint32_t C_block_rows = 12;
+
+template <uint32_t T_rows>
+void multiply_block(const float *values,
+                    size_t value_stride,
+                    uint32_t positions,
+                    uint32_t depth,
+                    const float *weights,
+                    size_t position_stride,
+                    float *accumulators,
+                    bool accumulate)
+{
+    // Named accumulators - compilers keep them in registers which is not the case for arrays.
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps(), acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    __m512 acc4 = _mm512_setzero_ps(), acc5 = _mm512_setzero_ps(), acc6 = _mm512_setzero_ps(), acc7 = _mm512_setzero_ps();
+    __m512 acc8 = _mm512_setzero_ps(), acc9 = _mm512_setzero_ps(), acc10 = _mm512_setzero_ps(), acc11 = _mm512_setzero_ps();
+    if (accumulate)
+    {
+        acc0 = _mm512_load_ps(accumulators + 0 * C_slice_size);
+        if (T_rows > 1) acc1 = _mm512_load_ps(accumulators + 1 * C_slice_size);
+        if (T_rows > 2) acc2 = _mm512_load_ps(accumulators + 2 * C_slice_size);
+        if (T_rows > 3) acc3 = _mm512_load_ps(accumulators + 3 * C_slice_size);
+        if (T_rows > 4) acc4 = _mm512_load_ps(accumulators + 4 * C_slice_size);
+        if (T_rows > 5) acc5 = _mm512_load_ps(accumulators + 5 * C_slice_size);
+        if (T_rows > 6) acc6 = _mm512_load_ps(accumulators + 6 * C_slice_size);
+        if (T_rows > 7) acc7 = _mm512_load_ps(accumulators + 7 * C_slice_size);
+        if (T_rows > 8) acc8 = _mm512_load_ps(accumulators + 8 * C_slice_size);
+        if (T_rows > 9) acc9 = _mm512_load_ps(accumulators + 9 * C_slice_size);
+        if (T_rows > 10) acc10 = _mm512_load_ps(accumulators + 10 * C_slice_size);
+        if (T_rows > 11) acc11 = _mm512_load_ps(accumulators + 11 * C_slice_size);
+    }
+
+    for (uint32_t position = 0; position < positions; ++position, weights += position_stride)
+    {
+        const float *fmap_weights = weights;
+        for (uint32_t fmap = 0; fmap < depth; ++fmap, fmap_weights += C_slice_size, ++values)
+        {
+            const __m512 slice_weights = _mm512_loadu_ps(fmap_weights);
+            const float *row_values = values;
+            acc0 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[0 * value_stride]), acc0);
+            if (T_rows > 1) acc1 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[1 * value_stride]), acc1);
+            if (T_rows > 2) acc2 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[2 * value_stride]), acc2);
+            if (T_rows > 3) acc3 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[3 * value_stride]), acc3);
+            if (T_rows > 4) acc4 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[4 * value_stride]), acc4);
+            if (T_rows > 5) acc5 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[5 * value_stride]), acc5);
+            if (T_rows > 6) acc6 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[6 * value_stride]), acc6);
+            if (T_rows > 7) acc7 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[7 * value_stride]), acc7);
+            if (T_rows > 8) acc8 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[8 * value_stride]), acc8);
+            if (T_rows > 9) acc9 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[9 * value_stride]), acc9);
+            if (T_rows > 10) acc10 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[10 * value_stride]), acc10);
+            if (T_rows > 11) acc11 = _mm512_fmadd_ps(slice_weights, _mm512_set1_ps(row_values[11 * value_stride]), acc11);
+        }
+    }
+
+    _mm512_store_ps(accumulators + 0 * C_slice_size, acc0);
+    if (T_rows > 1) _mm512_store_ps(accumulators + 1 * C_slice_size, acc1);
+    if (T_rows > 2) _mm512_store_ps(accumulators + 2 * C_slice_size, acc2);
+    if (T_rows > 3) _mm512_store_ps(accumulators + 3 * C_slice_size, acc3);
+    if (T_rows > 4) _mm512_store_ps(accumulators + 4 * C_slice_size, acc4);
+    if (T_rows > 5) _mm512_store_ps(accumulators + 5 * C_slice_size, acc5);
+    if (T_rows > 6) _mm512_store_ps(accumulators + 6 * C_slice_size, acc6);
+    if (T_rows > 7) _mm512_store_ps(accumulators + 7 * C_slice_size, acc7);
+    if (T_rows > 8) _mm512_store_ps(accumulators + 8 * C_slice_size, acc8);
+    if (T_rows > 9) _mm512_store_ps(accumulators + 9 * C_slice_size, acc9);
+    if (T_rows > 10) _mm512_store_ps(accumulators + 10 * C_slice_size, acc10);
+    if (T_rows > 11) _mm512_store_ps(accumulators + 11 * C_slice_size, acc11);
+}
+} // namespace
+
+void multiply_rows(const float *values,
+                   size_t value_stride,
+                   uint32_t rows,
+                   uint32_t positions,
+                   uint32_t depth,
+                   const float *weights,
+                   size_t position_stride,
+                   float *accumulators,
+                   bool accumulate)
+{
+    for (; rows >= C_block_rows; rows -= C_block_rows, values += C_block_rows * value_stride, accumulators += C_block_rows * C_slice_size)
+        multiply_block<C_block_rows>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate);
+
+    switch (rows)
+    {
+    case 0: break;
+    case 1: multiply_block<1>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    case 2: multiply_block<2>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    case 3: multiply_block<3>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    case 4: multiply_block<4>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    case 5: multiply_block<5>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    case 6: multiply_block<6>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    case 7: multiply_block<7>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    case 8: multiply_block<8>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    case 9: multiply_block<9>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    case 10: multiply_block<10>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    case 11: multiply_block<11>(values, value_stride, positions, depth, weights, position_stride, accumulators, accumulate); break;
+    }
+}
+
+} // namespace avx512
+} // namespace layer
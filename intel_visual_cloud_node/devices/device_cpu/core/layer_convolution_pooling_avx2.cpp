@@ -27,6 +27,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "../../common/nn_workload_data.h"
 #include "../api_internal/nn_device_interface_0_internal.h"
+#include "../api_internal/cpu_partition.h"
 #include "layer_convolution_pooling_avx2.h"
 
 #include <immintrin.h>
@@ -35,6 +36,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <thread>
 #include <vector>
 #include <map>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
 #include <tuple>
 
 // NN_CODE_UNREACHABLE signal to supporting compiler that specific location in code cannot be reached
@@ -859,12 +864,28 @@ void convolution_pooling_f32_2x2stride2::forward(const nn::nn_workload_data_t<fl
                                                  const nn::nn_workload_data_t<float> *weights,
                                                  const nn::nn_workload_data_t<float> *bias,
                                                  nn::nn_workload_data_t<float> *output) {
-    const auto num_output_fm_items =
+    const auto num_output_fm_slices =
         (output->view_end.t[NN_DATA_COORD_z] - output->view_begin.t[NN_DATA_COORD_z] + 1) / C_slice_size;
     const auto num_batch_items =
         (output->view_end.t[NN_DATA_COORD_n] - output->view_begin.t[NN_DATA_COORD_n] + 1);
-
-    const auto total_workers = num_output_fm_items * num_batch_items;
+    const auto num_rows = output->get_length(NN_DATA_COORD_y);
+
+    // Every pooled row is computed from two convolution rows, its window reads kernel & stride input rows.
+    const auto partition = nn_cpu_partition_choose(
+        nn_cpu_partition_work{static_cast<uint32_t>(num_batch_items),
+                              static_cast<uint32_t>(num_output_fm_slices),
+                              static_cast<uint32_t>(num_rows),
+                              1,
+                              static_cast<uint64_t>(kernel_w) * kernel_h * input_size_z * C_slice_size * sizeof(float),
+                              static_cast<uint64_t>(kernel_h + stride_y) * input->get_length(NN_DATA_COORD_x) * input_size_z * sizeof(float)},
+        device->thread_pool.get_num_threads());
+    const auto slices_per_item = partition.slices_per_job;
+    const auto num_output_fm_items = num_output_fm_slices / slices_per_item;
+    const auto output_fm_item_size = slices_per_item * C_slice_size;
+    const auto rows_per_item = partition.rows_per_job;
+    const auto num_row_items = (num_rows + rows_per_item - 1) / rows_per_item;
+
+    const auto total_workers = partition.num_jobs;
 
     if (device->thread_pool.get_num_threads() < 2 || total_workers < 2)
     {
@@ -882,16 +903,19 @@ void convolution_pooling_f32_2x2stride2::forward(const nn::nn_workload_data_t<fl
         // Fill slave work items.
         for (auto output_fm_item = 0u; output_fm_item < num_output_fm_items; ++output_fm_item)
         {
-            for (auto batch_item = 0u; batch_item < num_batch_items; ++batch_item)
+            for (auto item = 0u; item < num_batch_items * num_row_items; ++item)
             {
-                auto item_in_pool = batch_item + output_fm_item * num_batch_items;
+                const auto batch_item = item / num_row_items;
+                const auto first_row = item % num_row_items * rows_per_item;
+                const auto last_row = std::min(first_row + rows_per_item, num_rows) - 1;
+                auto item_in_pool = item + output_fm_item * num_batch_items * num_row_items;
 
-                // Replace nn_workload_datas pointers with views.
+                // Replace nn_workload_datas pointers with views; first input row of view is read by first output row.
                 nn_workload_data_coords_t input_view_begin =
                 {
                     0,
                     0,
-                    0,
+                    static_cast<uint32_t>(first_row * pooling_stride_y * stride_y),
                     0,
                     0,
                     0
@@ -909,8 +933,8 @@ void convolution_pooling_f32_2x2stride2::forward(const nn::nn_workload_data_t<fl
                 {
                     batch_item,
                     0,
-                    0,
-                    output_fm_item * C_slice_size,
+                    first_row,
+                    output_fm_item * output_fm_item_size,
                     0,
                     0
                 };
@@ -918,8 +942,8 @@ void convolution_pooling_f32_2x2stride2::forward(const nn::nn_workload_data_t<fl
                 {
                     batch_item,
                     output->get_length(NN_DATA_COORD_x) - 1,
-                    output->get_length(NN_DATA_COORD_y) - 1,
-                    (output_fm_item+1) * C_slice_size - 1,
+                    last_row,
+                    (output_fm_item+1) * output_fm_item_size - 1,
                     output->get_length(NN_DATA_COORD_p) - 1,
                     output->get_length(NN_DATA_COORD_q) - 1
                 };
@@ -931,7 +955,7 @@ void convolution_pooling_f32_2x2stride2::forward(const nn::nn_workload_data_t<fl
                     0,
                     0,
                     0,
-                    output_fm_item
+                    output_fm_item * slices_per_item
                 };
                 nn_workload_data_coords_t weights_view_end =
                 {
@@ -940,7 +964,7 @@ void convolution_pooling_f32_2x2stride2::forward(const nn::nn_workload_data_t<fl
                     weights->get_length(NN_DATA_COORD_y) - 1,
                     weights->get_length(NN_DATA_COORD_z) - 1,
                     weights->get_length(NN_DATA_COORD_p) - 1,
-                    output_fm_item
+                    (output_fm_item+1) * slices_per_item - 1
                 };
 
                 input_views[item_in_pool] = 
@@ -950,7 +974,7 @@ void convolution_pooling_f32_2x2stride2::forward(const nn::nn_workload_data_t<fl
                     new nn::nn_workload_data_t<float>(*output, output_view_begin, output_view_end);
 
                 weights_views[item_in_pool] =
-                    new nn::nn_workload_data_t<float>(*weights, weights_view_begin, weights_view_end);
+                    new nn::nn_workload_data_t<float>(const_cast<nn::nn_workload_data_t<float> &>(*weights), weights_view_begin, weights_view_end);
 
                 // Use biases.
                 if (bias != nullptr)
@@ -958,7 +982,7 @@ void convolution_pooling_f32_2x2stride2::forward(const nn::nn_workload_data_t<fl
                     nn_workload_data_coords_t bias_view_begin =
                     {
                         0,
-                        output_fm_item * C_slice_size,
+                        output_fm_item * output_fm_item_size,
                         0,
                         0,
                         0,
@@ -967,7 +991,7 @@ void convolution_pooling_f32_2x2stride2::forward(const nn::nn_workload_data_t<fl
                     nn_workload_data_coords_t bias_view_end =
                     {
                         bias->get_length(NN_DATA_COORD_n) - 1,
-                        (output_fm_item+1) * C_slice_size - 1,
+                        (output_fm_item+1) * output_fm_item_size - 1,
                         bias->get_length(NN_DATA_COORD_y) - 1,
                         bias->get_length(NN_DATA_COORD_z) - 1,
                         bias->get_length(NN_DATA_COORD_p) - 1,
@@ -975,7 +999,7 @@ void convolution_pooling_f32_2x2stride2::forward(const nn::nn_workload_data_t<fl
                     };
 
                     bias_views[item_in_pool] = 
-                        new nn::nn_workload_data_t<float>(*bias, bias_view_begin, bias_view_end);
+                        new nn::nn_workload_data_t<float>(const_cast<nn::nn_workload_data_t<float> &>(*bias), bias_view_begin, bias_view_end);
                 } else {
                     bias_views[item_in_pool] = nullptr;
                 }
@@ -1023,6 +1047,436 @@ void run_multithreaded_convolve_maxpooling2x2_stride2x2_work_item(nn_workload_it
                   reinterpret_cast<nn::nn_workload_data_t<float> *>(work_item->output));
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// convolution followed by pooling of any window & stride
+
+namespace
+{
+// Per-thread buffer for convolution rows of tile; grows to the largest tile seen by thread.
+float *tile_buffer(size_t size)
+{
+    struct buffer_t
+    {
+        float *data = nullptr;
+        size_t size = 0;
+        ~buffer_t() { _mm_free(data); }
+    };
+    static thread_local buffer_t buffer;
+    if (buffer.size < size)
+    {
+        _mm_free(buffer.data);
+        buffer.size = 0;
+        buffer.data = static_cast<float *>(_mm_malloc(size * sizeof(float), 64));
+        if (buffer.data == nullptr) throw std::bad_alloc();
+        buffer.size = size;
+    }
+    return buffer.data;
+}
+
+// Pools rows of tile of given image of output view; band holds convolution rows starting at band_first_row, all
+// feature maps of job. Output may be in any untiled layout: feature maps are stored with vector stores when they are
+// innermost (ZXYN), otherwise one by one (e.g. batch-first layout read by fully connected layer).
+template <NN_POOLING_MODE T_mode>
+void pool_tile(const float *band,
+               uint32_t band_first_row,
+               uint32_t band_width,
+               uint32_t num_feature_maps,
+               uint32_t pooling_size_x,
+               uint32_t pooling_size_y,
+               uint32_t pooling_stride_x,
+               uint32_t pooling_stride_y,
+               nn::nn_workload_data_t<float> *output,
+               uint32_t image,
+               uint32_t first_row,
+               uint32_t last_row)
+{
+    const auto &layout = output->parent->layout;
+    size_t stride[NN_DIMENSION_COUNT];
+    for (size_t index = 0, size = 1; index < NN_DIMENSION_COUNT; ++index)
+    {
+        stride[layout.ordering.t[index]] = size;
+        size *= output->parent->lengths.t[layout.ordering.t[index]];
+    }
+
+    const auto output_width = output->view_end.t[NN_DATA_COORD_x] - output->view_begin.t[NN_DATA_COORD_x] + 1;
+    const auto scale = _mm256_set1_ps(1.0f / (pooling_size_x * pooling_size_y));
+    auto output_buffer = static_cast<float *>(output->parent->data_buffer);
+
+    for (auto row = first_row; row <= last_row; ++row)
+    {
+        const auto window_row = row * pooling_stride_y - band_first_row;
+        auto output_ptr = output_buffer + output->view_begin.t[NN_DATA_COORD_z] * stride[NN_DATA_COORD_z] +
+                                          output->view_begin.t[NN_DATA_COORD_x] * stride[NN_DATA_COORD_x] +
+                                          (output->view_begin.t[NN_DATA_COORD_y] + row) * stride[NN_DATA_COORD_y] +
+                                          (output->view_begin.t[NN_DATA_COORD_n] + image) * stride[NN_DATA_COORD_n];
+
+        for (uint32_t column = 0; column < output_width; ++column, output_ptr += stride[NN_DATA_COORD_x])
+        {
+            const auto window_ptr = band + (window_row * band_width + column * pooling_stride_x) * num_feature_maps;
+            for (uint32_t map = 0; map < num_feature_maps; map += C_simd_width)
+            {
+                auto acc = _mm256_load_ps(window_ptr + map);
+                for (uint32_t y = 0; y < pooling_size_y; ++y)
+                    for (uint32_t x = (y == 0) ? 1 : 0; x < pooling_size_x; ++x)
+                    {
+                        const auto value = _mm256_load_ps(window_ptr + (y * band_width + x) * num_feature_maps + map);
+                        acc = (T_mode == NN_POOLING_MODE_MAX) ? _mm256_max_ps(acc, value) : _mm256_add_ps(acc, value);
+                    }
+                if (T_mode == NN_POOLING_MODE_AVERAGE) acc = _mm256_mul_ps(acc, scale);
+
+                if (stride[NN_DATA_COORD_z] == 1)
+                    _mm256_storeu_ps(output_ptr + map, acc);
+                else
+                {
+                    float values[C_simd_width];
+                    _mm256_storeu_ps(values, acc);
+                    for (uint32_t lane = 0; lane < C_simd_width; ++lane)
+                        output_ptr[(map + lane) * stride[NN_DATA_COORD_z]] = values[lane];
+                }
+            }
+        }
+    }
+}
+
+struct convolution_pooling_f32_request_handle {
+    convolution_pooling_f32 *primitive;
+    const nn::nn_workload_data_t<float> *input;
+    const nn::nn_workload_data_t<float> *weights;
+    const nn::nn_workload_data_t<float> *bias;
+    nn::nn_workload_data_t<float> *output;
+    uint32_t first_image;
+    uint32_t last_image;
+    uint32_t first_row;
+    uint32_t last_row;
+    size_t tile_rows;
+};
+} // namespace
+
+void unpack_convolve_pooling_callback_handle(void *void_handle) {
+    auto handle = reinterpret_cast<convolution_pooling_f32_request_handle *>(void_handle);
+    for (auto image = handle->first_image; image <= handle->last_image; ++image)
+        handle->primitive->run_rows(handle->input,
+                                    handle->weights,
+                                    handle->bias,
+                                    handle->output,
+                                    image,
+                                    handle->first_row,
+                                    handle->last_row,
+                                    handle->tile_rows);
+}
+
+convolution_pooling_f32 *convolution_pooling_f32::create(size_t kernel_w,
+                                                         size_t kernel_h,
+                                                         size_t num_input,
+                                                         size_t num_output,
+                                                         size_t output_w,
+                                                         size_t output_h,
+                                                         int32_t center_offset_x,
+                                                         int32_t center_offset_y,
+                                                         size_t stride_x,
+                                                         size_t stride_y,
+                                                         const nn_argument_activation_t &activation,
+                                                         NN_POOLING_MODE pooling_mode,
+                                                         size_t pooling_size_x,
+                                                         size_t pooling_size_y,
+                                                         size_t pooling_stride_x,
+                                                         size_t pooling_stride_y,
+                                                         size_t batch_size,
+                                                         nn_device_t *device) {
+    if (pooling_mode != NN_POOLING_MODE_MAX && pooling_mode != NN_POOLING_MODE_AVERAGE)
+        throw std::invalid_argument("pooling mode");
+
+    return new convolution_pooling_f32(kernel_w,
+                                       kernel_h,
+                                       num_input,
+                                       num_output,
+                                       output_w,
+                                       output_h,
+                                       center_offset_x,
+                                       center_offset_y,
+                                       stride_x,
+                                       stride_y,
+                                       activation,
+                                       pooling_mode,
+                                       pooling_size_x,
+                                       pooling_size_y,
+                                       pooling_stride_x,
+                                       pooling_stride_y,
+                                       batch_size,
+                                       reinterpret_cast<nn_device_internal *>(device));
+}
+
+convolution_pooling_f32::convolution_pooling_f32(size_t kernel_w,
+                                                 size_t kernel_h,
+                                                 size_t num_input,
+                                                 size_t num_output,
+                                                 size_t output_w,
+                                                 size_t output_h,
+                                                 int32_t center_offset_x,
+                                                 int32_t center_offset_y,
+                                                 size_t stride_x,
+                                                 size_t stride_y,
+                                                 const nn_argument_activation_t &activation,
+                                                 NN_POOLING_MODE pooling_mode,
+                                                 size_t pooling_size_x,
+                                                 size_t pooling_size_y,
+                                                 size_t pooling_stride_x,
+                                                 size_t pooling_stride_y,
+                                                 size_t batch_size,
+                                                 nn_device_internal *device)
+    : convolution_f32(kernel_w,
+                      kernel_h,
+                      num_input,
+                      num_output,
+                      output_w,
+                      output_h,
+                      center_offset_x,
+                      center_offset_y,
+                      stride_x,
+                      stride_y,
+                      activation,
+                      batch_size,
+                      device),
+      pooling_mode(pooling_mode),
+      pooling_size_x(pooling_size_x),
+      pooling_size_y(pooling_size_y),
+      pooling_stride_x(pooling_stride_x),
+      pooling_stride_y(pooling_stride_y),
+      convolution_w((output_w - 1) * pooling_stride_x + pooling_size_x),
+      convolution_h((output_h - 1) * pooling_stride_y + pooling_size_y) {}
+
+size_t convolution_pooling_f32::get_required_input_w() { return (convolution_w - 1) * stride_x + kernel_w; }
+
+size_t convolution_pooling_f32::get_required_input_h() { return (convolution_h - 1) * stride_y + kernel_h; }
+
+size_t convolution_pooling_f32::get_tile_rows(size_t slices_per_job) {
+    if (tuning.kernel != 0) return tuning.kernel;
+
+    const size_t row_bytes = convolution_w * slices_per_job * C_slice_size * sizeof(float);
+    size_t rows = 1;
+    while (rows < output_size_y && (rows * pooling_stride_y + pooling_size_y) * row_bytes <= C_tile_bytes)
+        ++rows;
+    return rows;
+}
+
+void convolution_pooling_f32::run_rows(const nn::nn_workload_data_t<float> *input,
+                                       const nn::nn_workload_data_t<float> *weights,
+                                       const nn::nn_workload_data_t<float> *bias,
+                                       nn::nn_workload_data_t<float> *output,
+                                       uint32_t image,
+                                       uint32_t first_row,
+                                       uint32_t last_row,
+                                       size_t tile_rows) {
+    const uint32_t num_feature_maps = output->view_end.t[NN_DATA_COORD_z] - output->view_begin.t[NN_DATA_COORD_z] + 1;
+    const uint32_t band_width = static_cast<uint32_t>(convolution_w);
+    const uint32_t band_rows = static_cast<uint32_t>((tile_rows - 1) * pooling_stride_y + pooling_size_y);
+    const size_t band_row_size = band_width * num_feature_maps;
+
+    // Convolution rows of tile are written to image 0 of band, so input image is wrapped as single-image buffer.
+    float *band = tile_buffer(band_row_size * band_rows);
+    nn::nn_workload_data_t<float> band_data(band, nn_workload_data_coords_t{1, band_width, band_rows, num_feature_maps, 1, 1}, in_out_layout);
+
+    const auto &input_lengths = input->parent->lengths.t;
+    const size_t input_image_size = input_lengths[NN_DATA_COORD_x] * input_lengths[NN_DATA_COORD_y] * input_lengths[NN_DATA_COORD_z];
+    nn::nn_workload_data_t<float> image_data(
+        static_cast<float *>(input->parent->data_buffer) + (input->view_begin.t[NN_DATA_COORD_n] + image) * input_image_size,
+        nn_workload_data_coords_t{1, input_lengths[NN_DATA_COORD_x], input_lengths[NN_DATA_COORD_y], input_lengths[NN_DATA_COORD_z], 1, 1},
+        input->parent->layout);
+
+    bool band_valid = false;
+    uint32_t band_first = 0, band_last = 0; // convolution rows held in band
+    for (auto tile_first = first_row; tile_first <= last_row; tile_first += static_cast<uint32_t>(tile_rows))
+    {
+        const auto tile_last = std::min(last_row, static_cast<uint32_t>(tile_first + tile_rows - 1));
+        const auto convolution_first = static_cast<uint32_t>(tile_first * pooling_stride_y);
+        const auto convolution_last = static_cast<uint32_t>(tile_last * pooling_stride_y + pooling_size_y - 1);
+
+        // Rows shared with windows of previous tile are moved to the top of band instead of being recomputed.
+        uint32_t kept = 0;
+        if (band_valid && band_last >= convolution_first)
+        {
+            kept = band_last - convolution_first + 1;
+            memmove(band, band + (convolution_first - band_first) * band_row_size, kept * band_row_size * sizeof(float));
+        }
+
+        if (convolution_first + kept <= convolution_last)
+        {
+            nn_workload_data_coords_t input_view_begin =
+            {
+                0,
+                input->view_begin.t[NN_DATA_COORD_x],
+                static_cast<uint32_t>(input->view_begin.t[NN_DATA_COORD_y] + (convolution_first + kept) * stride_y),
+                input->view_begin.t[NN_DATA_COORD_z],
+                0,
+                0
+            };
+            nn_workload_data_coords_t input_view_end =
+            {
+                0,
+                input->view_end.t[NN_DATA_COORD_x],
+                input->view_end.t[NN_DATA_COORD_y],
+                input->view_end.t[NN_DATA_COORD_z],
+                0,
+                0
+            };
+            nn_workload_data_coords_t band_view_begin = {0, 0, kept, 0, 0, 0};
+            nn_workload_data_coords_t band_view_end = {0, band_width - 1, convolution_last - convolution_first, num_feature_maps - 1, 0, 0};
+
+            nn::nn_workload_data_t<float> input_view(image_data, input_view_begin, input_view_end);
+            nn::nn_workload_data_t<float> band_view(band_data, band_view_begin, band_view_end);
+            // AVX-512 micro-kernel computes band rows as pixels of implicit GEMM, generated AVX2 kernel row by row
+            if (device->isa == NN_CPU_ISA_AVX512)
+                convolution_f32_impl::convolve_implicit_gemm_rows(
+                    &input_view, center_offset_x, center_offset_y, stride_x, stride_y, activation, weights, bias, &band_view, device);
+            else
+                convolution_f32_impl::choose_convolution_padding_mode_and_activation(
+                    &input_view, padding, center_offset_x, center_offset_y, stride_x, stride_y, activation, weights, bias, &band_view, true);
+        }
+        band_valid = true;
+        band_first = convolution_first;
+        band_last = convolution_last;
+
+        if (pooling_mode == NN_POOLING_MODE_MAX)
+            pool_tile<NN_POOLING_MODE_MAX>(band, band_first, band_width, num_feature_maps,
+                                           pooling_size_x, pooling_size_y, pooling_stride_x, pooling_stride_y, output, image, tile_first, tile_last);
+        else
+            pool_tile<NN_POOLING_MODE_AVERAGE>(band, band_first, band_width, num_feature_maps,
+                                               pooling_size_x, pooling_size_y, pooling_stride_x, pooling_stride_y, output, image, tile_first, tile_last);
+    }
+}
+
+void convolution_pooling_f32::forward(const nn::nn_workload_data_t<float> *input,
+                                      const nn::nn_workload_data_t<float> *weights,
+                                      const nn::nn_workload_data_t<float> *bias,
+                                      nn::nn_workload_data_t<float> *output) {
+    const auto num_output_fm_slices =
+        (output->view_end.t[NN_DATA_COORD_z] - output->view_begin.t[NN_DATA_COORD_z] + 1) / C_slice_size;
+    const uint32_t slices_per_item =
+        (tuning.partition > 1 && num_output_fm_slices % tuning.partition == 0) ? tuning.partition : 1;
+    const auto num_output_fm_items = num_output_fm_slices / slices_per_item;
+    const auto output_fm_item_size = slices_per_item * C_slice_size;
+    const auto num_batch_items = output->view_end.t[NN_DATA_COORD_n] - output->view_begin.t[NN_DATA_COORD_n] + 1;
+    const auto num_rows = output->view_end.t[NN_DATA_COORD_y] - output->view_begin.t[NN_DATA_COORD_y] + 1;
+    const auto tile_rows = get_tile_rows(slices_per_item);
+
+    // Batch-first output (read by fully connected layer) holds values of neighbouring images in the same cache lines,
+    // so all images are computed by the job of their feature maps - jobs of separate images would share lines.
+    const bool batch_first = output->parent->layout.ordering.t[0] == NN_DATA_COORD_n;
+    const uint32_t images_per_item = batch_first ? num_batch_items : 1;
+    const uint32_t num_image_items = num_batch_items / images_per_item;
+
+    // Images & feature map slices usually give enough jobs; rows are split between jobs only when they do not,
+    // as rows shared by windows of neighbouring jobs are computed by both of them.
+    const uint32_t num_threads = device->thread_pool.get_num_threads();
+    const uint32_t items = num_output_fm_items * num_image_items;
+    const uint32_t num_row_items = std::min<uint32_t>(num_rows, items >= num_threads ? 1 : (num_threads + items - 1) / items);
+    const uint32_t rows_per_item = (num_rows + num_row_items - 1) / num_row_items;
+
+    std::vector<std::unique_ptr<nn::nn_workload_data_t<float>>> views;
+    std::vector<convolution_pooling_f32_request_handle> request_handles;
+    for (auto output_fm_item = 0u; output_fm_item < num_output_fm_items; ++output_fm_item)
+    {
+        nn_workload_data_coords_t weights_view_begin = {0, 0, 0, 0, 0, output_fm_item * slices_per_item};
+        nn_workload_data_coords_t weights_view_end =
+        {
+            weights->get_length(NN_DATA_COORD_n) - 1,
+            weights->get_length(NN_DATA_COORD_x) - 1,
+            weights->get_length(NN_DATA_COORD_y) - 1,
+            weights->get_length(NN_DATA_COORD_z) - 1,
+            weights->get_length(NN_DATA_COORD_p) - 1,
+            (output_fm_item + 1) * slices_per_item - 1
+        };
+        views.emplace_back(new nn::nn_workload_data_t<float>(const_cast<nn::nn_workload_data_t<float> &>(*weights), weights_view_begin, weights_view_end));
+        auto weights_view = views.back().get();
+
+        nn::nn_workload_data_t<float> *bias_view = nullptr;
+        if (bias != nullptr)
+        {
+            nn_workload_data_coords_t bias_view_begin = {0, output_fm_item * output_fm_item_size, 0, 0, 0, 0};
+            nn_workload_data_coords_t bias_view_end =
+            {
+                bias->get_length(NN_DATA_COORD_n) - 1,
+                (output_fm_item + 1) * output_fm_item_size - 1,
+                bias->get_length(NN_DATA_COORD_y) - 1,
+                bias->get_length(NN_DATA_COORD_z) - 1,
+                bias->get_length(NN_DATA_COORD_p) - 1,
+                bias->get_length(NN_DATA_COORD_q) - 1
+            };
+            views.emplace_back(new nn::nn_workload_data_t<float>(const_cast<nn::nn_workload_data_t<float> &>(*bias), bias_view_begin, bias_view_end));
+            bias_view = views.back().get();
+        }
+
+        nn_workload_data_coords_t output_view_begin = {0, 0, 0, output_fm_item * output_fm_item_size, 0, 0};
+        nn_workload_data_coords_t output_view_end =
+        {
+            output->get_length(NN_DATA_COORD_n) - 1,
+            output->get_length(NN_DATA_COORD_x) - 1,
+            output->get_length(NN_DATA_COORD_y) - 1,
+            (output_fm_item + 1) * output_fm_item_size - 1,
+            output->get_length(NN_DATA_COORD_p) - 1,
+            output->get_length(NN_DATA_COORD_q) - 1
+        };
+        views.emplace_back(new nn::nn_workload_data_t<float>(*output, output_view_begin, output_view_end));
+
+        for (auto first_image = 0u; first_image < num_batch_items; first_image += images_per_item)
+            for (auto first_row = 0u; first_row < num_rows; first_row += rows_per_item)
+                request_handles.push_back(convolution_pooling_f32_request_handle{
+                    this, input, weights_view, bias_view, views.back().get(),
+                    first_image, first_image + images_per_item - 1,
+                    first_row, std::min(num_rows, first_row + rows_per_item) - 1, tile_rows});
+    }
+
+    if (num_threads < 2 || request_handles.size() < 2)
+    {
+        // Its tiny data or there is only one thread available - just do it singlethreaded way.
+        for (auto &handle : request_handles)
+            unpack_convolve_pooling_callback_handle(&handle);
+    }
+    else
+    {
+        std::vector<nn_multithreaded_request> job(request_handles.size());
+        for (size_t item_in_pool = 0; item_in_pool < job.size(); ++item_in_pool)
+        {
+            job[item_in_pool].callback = unpack_convolve_pooling_callback_handle;
+            job[item_in_pool].request_handle = &request_handles[item_in_pool];
+        }
+
+        // Wait for all sub threads.
+        device->thread_pool.push_job(job);
+    }
+}
+
+std::vector<nn_cpu_tuning_t> convolution_pooling_f32::get_tuning_candidates() {
+    // Tile height trades size of band (cache) for number of rows pooled per computed band; feature map slices
+    // per job change band size as well, so they are tried even with single thread.
+    std::vector<uint32_t> tiles(1, 0);
+    for (uint32_t rows = 1; rows <= 4 && rows <= output_size_y; rows *= 2)
+        tiles.push_back(rows);
+
+    const uint32_t num_slices = static_cast<uint32_t>(output_size_z / C_slice_size);
+    std::vector<uint32_t> partitions(1, 0);
+    for (uint32_t slices = 2; slices <= 8 && slices <= num_slices; slices *= 2)
+        if (num_slices % slices == 0) partitions.push_back(slices);
+
+    std::vector<nn_cpu_tuning_t> candidates;
+    for (auto partition : partitions)
+        for (auto tile : tiles)
+            candidates.push_back(nn_cpu_tuning_t{tile, partition});
+    return candidates;
+}
+
+std::string convolution_pooling_f32::get_tuning_signature() {
+    return "convolution_pooling_f32"
+        ";in=" + std::to_string(get_required_input_w()) + "x" + std::to_string(get_required_input_h()) + "x" + std::to_string(input_size_z) +
+        ";out=" + std::to_string(output_size_x) + "x" + std::to_string(output_size_y) + "x" + std::to_string(output_size_z) +
+        ";kernel=" + std::to_string(kernel_w) + "x" + std::to_string(kernel_h) +
+        ";stride=" + std::to_string(stride_x) + "x" + std::to_string(stride_y) +
+        ";activation=" + std::to_string(activation.function) +
+        ";pooling=" + std::to_string(pooling_mode) + ":" + std::to_string(pooling_size_x) + "x" + std::to_string(pooling_size_y) +
+        "/" + std::to_string(pooling_stride_x) + "x" + std::to_string(pooling_stride_y) +
+        ";batch=" + std::to_string(batch_size);
+}
+
 namespace convolution_pooling_f32_2x2stride2_impl {
 nn_primitive_handle_t NN_API_CALL_CONVENTION create(nn_device_t *device,
                                                     const size_t kernel_w,
@@ -95,4 +95,91 @@ protected:
 
 void run_multithreaded_convolve_maxpooling2x2_stride2x2_work_item(nn_workload_item *const work_item,
                                                                   nn_device_internal *device);
+
+// Convolution (with activation) followed by max or average pooling of any window & stride, overlapping windows
+// included. Created by workflow compilation for convolution whose only user is pooling; output_w & output_h are
+// sizes after pooling. Pooled rows are computed in tiles: convolution rows needed by a tile go to small per-thread
+// buffer and are pooled while still in cache, rows shared by windows of consecutive tiles are kept, not recomputed.
+// Output may be in batch-first layout of fully connected layer, so compilation adds no conversion between them.
+// Jobs compute range of output feature maps of single image, or of all images when output is batch-first.
+// Tuning: kernel - pooled rows per tile (0: as many as fit in C_tile_bytes);
+//         partition - number of output feature map slices computed by single job.
+class convolution_pooling_f32 : public convolution_f32 {
+  public:
+    static convolution_pooling_f32 *create(size_t kernel_w,
+                                           size_t kernel_h,
+                                           size_t num_input,
+                                           size_t num_output,
+                                           size_t output_w,
+                                           size_t output_h,
+                                           int32_t center_offset_x,
+                                           int32_t center_offset_y,
+                                           size_t stride_x,
+                                           size_t stride_y,
+                                           const nn_argument_activation_t &activation,
+                                           NN_POOLING_MODE pooling_mode,
+                                           size_t pooling_size_x,
+                                           size_t pooling_size_y,
+                                           size_t pooling_stride_x,
+                                           size_t pooling_stride_y,
+                                           size_t batch_size,
+                                           nn_device_t *device);
+    virtual ~convolution_pooling_f32() {}
+
+    virtual void forward(const nn::nn_workload_data_t<float> *input,
+                         const nn::nn_workload_data_t<float> *weights,
+                         const nn::nn_workload_data_t<float> *bias,
+                         nn::nn_workload_data_t<float> *output) override;
+
+    virtual std::vector<nn_cpu_tuning_t> get_tuning_candidates() override;
+    virtual std::string get_tuning_signature() override;
+
+    static const size_t C_tile_bytes = 128 * 1024;
+
+  protected:
+    convolution_pooling_f32(size_t kernel_w,
+                            size_t kernel_h,
+                            size_t num_input,
+                            size_t num_output,
+                            size_t output_w,
+                            size_t output_h,
+                            int32_t center_offset_x,
+                            int32_t center_offset_y,
+                            size_t stride_x,
+                            size_t stride_y,
+                            const nn_argument_activation_t &activation,
+                            NN_POOLING_MODE pooling_mode,
+                            size_t pooling_size_x,
+                            size_t pooling_size_y,
+                            size_t pooling_stride_x,
+                            size_t pooling_stride_y,
+                            size_t batch_size,
+                            nn_device_internal *device);
+
+    virtual size_t get_required_input_w() override;
+    virtual size_t get_required_input_h() override;
+
+  private:
+    size_t get_tile_rows(size_t slices_per_job);
+
+    // Computes pooled rows [first_row, last_row] of single image & range of output feature maps.
+    void run_rows(const nn::nn_workload_data_t<float> *input,
+                  const nn::nn_workload_data_t<float> *weights,
+                  const nn::nn_workload_data_t<float> *bias,
+                  nn::nn_workload_data_t<float> *output,
+                  uint32_t image,
+                  uint32_t first_row,
+                  uint32_t last_row,
+                  size_t tile_rows);
+
+    friend void unpack_convolve_pooling_callback_handle(void *void_handle);
+
+    const NN_POOLING_MODE pooling_mode;
+    const size_t pooling_size_x;
+    const size_t pooling_size_y;
+    const size_t pooling_stride_x;
+    const size_t pooling_stride_y;
+    const size_t convolution_w;     // convolution output used by pooling windows
+    const size_t convolution_h;
+};
 }
@@ -0,0 +1,653 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "../../common/nn_workload_data.h"
+#include "../api_internal/nn_device_interface_0_internal.h"
+#include "layer_convolution_winograd_avx2.h"
+#include "layers_avx512.h"
+
+#include <immintrin.h>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace layer {
+namespace convolution_winograd_f32_impl {
+
+const uint32_t C_simd_width = sizeof(__m256) / sizeof(float);
+const uint32_t C_slice_size = 2 * C_simd_width;
+
+// Micro-kernel computes products of 6 tiles for 16 output feature maps.
+const uint32_t C_micro_tiles = 6;
+const uint32_t C_default_micro_blocks = 2;
+
+// Winograd is used only when transforms are small compared to products.
+const size_t C_min_feature_maps = 32;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// transforms
+// F(m x m, 3x3): U = G g G^T (weights), V = B^T d B (input patch), Y = A^T M A (output tile),
+// where M is element-wise product of U & V summed over input feature maps. 2D transforms are
+// 1D transform of columns followed by 1D transform of rows.
+template <uint32_t T_tile> struct winograd;
+
+template <> struct winograd<2>
+{
+    static const uint32_t alpha = 4;
+
+    static void weights(const double *g, size_t g_stride, double *u, size_t u_stride)
+    {
+        u[0 * u_stride] = g[0];
+        u[1 * u_stride] = (g[0] + g[g_stride] + g[2 * g_stride]) / 2;
+        u[2 * u_stride] = (g[0] - g[g_stride] + g[2 * g_stride]) / 2;
+        u[3 * u_stride] = g[2 * g_stride];
+    }
+
+    static void input(const __m256 *d, size_t stride, __m256 *v)
+    {
+        v[0 * stride] = _mm256_sub_ps(d[0], d[2 * stride]);
+        v[1 * stride] = _mm256_add_ps(d[stride], d[2 * stride]);
+        v[2 * stride] = _mm256_sub_ps(d[2 * stride], d[stride]);
+        v[3 * stride] = _mm256_sub_ps(d[stride], d[3 * stride]);
+    }
+
+    static void output(const __m256 *m, size_t stride, __m256 *y, size_t y_stride)
+    {
+        y[0 * y_stride] = _mm256_add_ps(_mm256_add_ps(m[0], m[stride]), m[2 * stride]);
+        y[1 * y_stride] = _mm256_sub_ps(_mm256_sub_ps(m[stride], m[2 * stride]), m[3 * stride]);
+    }
+};
+
+template <> struct winograd<4>
+{
+    static const uint32_t alpha = 6;
+
+    static void weights(const double *g, size_t g_stride, double *u, size_t u_stride)
+    {
+        const double g0 = g[0], g1 = g[g_stride], g2 = g[2 * g_stride];
+        u[0 * u_stride] = g0 / 4;
+        u[1 * u_stride] = -(g0 + g1 + g2) / 6;
+        u[2 * u_stride] = -(g0 - g1 + g2) / 6;
+        u[3 * u_stride] = g0 / 24 + g1 / 12 + g2 / 6;
+        u[4 * u_stride] = g0 / 24 - g1 / 12 + g2 / 6;
+        u[5 * u_stride] = g2;
+    }
+
+    static void input(const __m256 *d, size_t stride, __m256 *v)
+    {
+        const __m256 two = _mm256_set1_ps(2.0f), four = _mm256_set1_ps(4.0f), five = _mm256_set1_ps(5.0f);
+        const __m256 d0 = d[0], d1 = d[stride], d2 = d[2 * stride], d3 = d[3 * stride], d4 = d[4 * stride], d5 = d[5 * stride];
+
+        // 4*d0 - 5*d2 + d4
+        v[0 * stride] = _mm256_fmadd_ps(four, d0, _mm256_fnmadd_ps(five, d2, d4));
+        // (d3 + d4) -/+ 4*(d1 + d2) with d1 sign
+        const __m256 t1 = _mm256_fnmadd_ps(four, d2, d4), t2 = _mm256_mul_ps(four, d1);
+        v[1 * stride] = _mm256_sub_ps(_mm256_add_ps(t1, d3), t2);
+        v[2 * stride] = _mm256_add_ps(_mm256_sub_ps(t1, d3), t2);
+        // (d4 - d2) -/+ 2*(d1 - d3)
+        const __m256 t3 = _mm256_sub_ps(d4, d2), t4 = _mm256_mul_ps(two, _mm256_sub_ps(d1, d3));
+        v[3 * stride] = _mm256_sub_ps(t3, t4);
+        v[4 * stride] = _mm256_add_ps(t3, t4);
+        // 4*d1 - 5*d3 + d5
+        v[5 * stride] = _mm256_fmadd_ps(four, d1, _mm256_fnmadd_ps(five, d3, d5));
+    }
+
+    static void output(const __m256 *m, size_t stride, __m256 *y, size_t y_stride)
+    {
+        const __m256 two = _mm256_set1_ps(2.0f), four = _mm256_set1_ps(4.0f), eight = _mm256_set1_ps(8.0f);
+        const __m256 sum12 = _mm256_add_ps(m[stride], m[2 * stride]), diff12 = _mm256_sub_ps(m[stride], m[2 * stride]);
+        const __m256 sum34 = _mm256_add_ps(m[3 * stride], m[4 * stride]), diff34 = _mm256_sub_ps(m[3 * stride], m[4 * stride]);
+
+        y[0 * y_stride] = _mm256_add_ps(_mm256_add_ps(m[0], sum12), sum34);
+        y[1 * y_stride] = _mm256_fmadd_ps(two, diff34, diff12);
+        y[2 * y_stride] = _mm256_fmadd_ps(four, sum34, sum12);
+        y[3 * y_stride] = _mm256_add_ps(_mm256_fmadd_ps(eight, diff34, diff12), m[5 * stride]);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// execution
+
+// Per-thread buffer for transformed tiles & their products; grows to the largest size seen by thread.
+float *tile_buffer(size_t size)
+{
+    struct buffer_t
+    {
+        float *data = nullptr;
+        size_t size = 0;
+        ~buffer_t() { _mm_free(data); }
+    };
+    static thread_local buffer_t buffer;
+    if (buffer.size < size)
+    {
+        _mm_free(buffer.data);
+        buffer.size = 0;
+        buffer.data = static_cast<float *>(_mm_malloc(size * sizeof(float), 64));
+        if (buffer.data == nullptr) throw std::bad_alloc();
+        buffer.size = size;
+    }
+    return buffer.data;
+}
+
+// Buffers & dimensions shared by all jobs of one forward call.
+struct winograd_task
+{
+    const float *input;             // parent buffer, ZXYN
+    uint32_t input_width;
+    uint32_t input_height;
+    uint32_t input_depth;
+    uint32_t input_fmap_start;      // first feature map of input view
+    int32_t input_start_x;          // position of input patch of first output of view (may be negative)
+    int32_t input_start_y;
+
+    float *output;                  // parent buffer, ZXYN
+    uint32_t output_width;
+    uint32_t output_height;
+    uint32_t output_depth;
+    uint32_t output_fmap_start;
+    uint32_t output_start_x;        // output view
+    uint32_t output_start_y;
+    uint32_t output_view_width;
+    uint32_t output_view_height;
+
+    const float *weights;           // transformed: alpha x alpha x slices x input feature maps x 16
+    const float *bias;              // nullptr if there are no biases
+    uint32_t num_input;
+    uint32_t num_slices;
+
+    uint32_t tiles_x;
+    uint32_t tiles_y;
+    uint32_t tile_block;            // tiles computed at once
+    bool avx512;                    // device runs AVX-512 micro-kernel
+};
+
+// Products of transformed weights of one slice & up to 6 transformed tiles, summed over input feature maps.
+// Tiles are num_input apart in transformed buffer, products of tile take 16 floats.
+template <uint32_t T_tiles>
+void multiply_block(const float *transformed, uint32_t num_input, const float *weights, float *products)
+{
+    // Named accumulators - compilers keep them in registers which is not the case for arrays.
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    __m256 acc4 = _mm256_setzero_ps(), acc5 = _mm256_setzero_ps(), acc6 = _mm256_setzero_ps(), acc7 = _mm256_setzero_ps();
+    __m256 acc8 = _mm256_setzero_ps(), acc9 = _mm256_setzero_ps(), acc10 = _mm256_setzero_ps(), acc11 = _mm256_setzero_ps();
+
+    for (uint32_t ifm = 0; ifm < num_input; ++ifm, weights += C_slice_size)
+    {
+        const __m256 weights0 = _mm256_load_ps(weights);
+        const __m256 weights1 = _mm256_load_ps(weights + C_simd_width);
+        const float *value_ptr = transformed + ifm;
+        __m256 value;
+
+        value = _mm256_broadcast_ss(value_ptr);
+        acc0 = _mm256_fmadd_ps(weights0, value, acc0);
+        acc1 = _mm256_fmadd_ps(weights1, value, acc1);
+        if (T_tiles > 1)
+        {
+            value = _mm256_broadcast_ss(value_ptr + 1 * num_input);
+            acc2 = _mm256_fmadd_ps(weights0, value, acc2);
+            acc3 = _mm256_fmadd_ps(weights1, value, acc3);
+        }
+        if (T_tiles > 2)
+        {
+            value = _mm256_broadcast_ss(value_ptr + 2 * num_input);
+            acc4 = _mm256_fmadd_ps(weights0, value, acc4);
+            acc5 = _mm256_fmadd_ps(weights1, value, acc5);
+        }
+        if (T_tiles > 3)
+        {
+            value = _mm256_broadcast_ss(value_ptr + 3 * num_input);
+            acc6 = _mm256_fmadd_ps(weights0, value, acc6);
+            acc7 = _mm256_fmadd_ps(weights1, value, acc7);
+        }
+        if (T_tiles > 4)
+        {
+            value = _mm256_broadcast_ss(value_ptr + 4 * num_input);
+            acc8 = _mm256_fmadd_ps(weights0, value, acc8);
+            acc9 = _mm256_fmadd_ps(weights1, value, acc9);
+        }
+        if (T_tiles > 5)
+        {
+            value = _mm256_broadcast_ss(value_ptr + 5 * num_input);
+            acc10 = _mm256_fmadd_ps(weights0, value, acc10);
+            acc11 = _mm256_fmadd_ps(weights1, value, acc11);
+        }
+    }
+
+    _mm256_store_ps(products + 0 * C_slice_size, acc0);
+    _mm256_store_ps(products + 0 * C_slice_size + C_simd_width, acc1);
+    if (T_tiles > 1) { _mm256_store_ps(products + 1 * C_slice_size, acc2);  _mm256_store_ps(products + 1 * C_slice_size + C_simd_width, acc3); }
+    if (T_tiles > 2) { _mm256_store_ps(products + 2 * C_slice_size, acc4);  _mm256_store_ps(products + 2 * C_slice_size + C_simd_width, acc5); }
+    if (T_tiles > 3) { _mm256_store_ps(products + 3 * C_slice_size, acc6);  _mm256_store_ps(products + 3 * C_slice_size + C_simd_width, acc7); }
+    if (T_tiles > 4) { _mm256_store_ps(products + 4 * C_slice_size, acc8);  _mm256_store_ps(products + 4 * C_slice_size + C_simd_width, acc9); }
+    if (T_tiles > 5) { _mm256_store_ps(products + 5 * C_slice_size, acc10); _mm256_store_ps(products + 5 * C_slice_size + C_simd_width, acc11); }
+}
+
+// Transforms input patches of tiles [tile_begin, tile_begin + tiles) of image.
+// Transformed value (i, j) of tile t, feature map f is at ((i * alpha + j) * tile_block + t) * num_input + f.
+template <uint32_t T_tile>
+void transform_input(const winograd_task &task, uint32_t image, uint32_t tile_begin, uint32_t tiles, float *transformed)
+{
+    const uint32_t alpha = winograd<T_tile>::alpha;
+    const auto element_stride = task.tile_block * task.num_input;
+
+    const auto remainder = task.num_input % C_simd_width;
+    const __m256i remainder_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(remainder), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    const auto image_offset = static_cast<size_t>(image) * task.input_height * task.input_width * task.input_depth;
+
+    for (uint32_t tile = 0; tile < tiles; ++tile)
+    {
+        const auto tile_y = (tile_begin + tile) / task.tiles_x;
+        const auto tile_x = (tile_begin + tile) % task.tiles_x;
+        const int32_t patch_x = task.input_start_x + static_cast<int32_t>(tile_x * T_tile);
+        const int32_t patch_y = task.input_start_y + static_cast<int32_t>(tile_y * T_tile);
+
+        // Elements of patch out of input buffer are zeros.
+        const float *patch[alpha][alpha];
+        for (uint32_t i = 0; i < alpha; ++i)
+            for (uint32_t j = 0; j < alpha; ++j)
+            {
+                const int32_t x = patch_x + static_cast<int32_t>(j), y = patch_y + static_cast<int32_t>(i);
+                patch[i][j] = (x >= 0 && y >= 0 && x < static_cast<int32_t>(task.input_width) && y < static_cast<int32_t>(task.input_height))
+                    ? task.input + image_offset + (static_cast<size_t>(y) * task.input_width + x) * task.input_depth + task.input_fmap_start
+                    : nullptr;
+            }
+
+        float *tile_transformed = transformed + tile * task.num_input;
+        for (uint32_t ifm = 0; ifm < task.num_input; ifm += C_simd_width)
+        {
+            const bool masked = ifm + C_simd_width > task.num_input;
+
+            __m256 d[alpha][alpha];
+            for (uint32_t i = 0; i < alpha; ++i)
+                for (uint32_t j = 0; j < alpha; ++j)
+                    d[i][j] = patch[i][j] == nullptr ? _mm256_setzero_ps()
+                            : masked ? _mm256_maskload_ps(patch[i][j] + ifm, remainder_mask)
+                            : _mm256_loadu_ps(patch[i][j] + ifm);
+
+            __m256 columns[alpha][alpha], v[alpha][alpha];
+            for (uint32_t j = 0; j < alpha; ++j)
+                winograd<T_tile>::input(&d[0][j], alpha, &columns[0][j]);
+            for (uint32_t i = 0; i < alpha; ++i)
+                winograd<T_tile>::input(&columns[i][0], 1, &v[i][0]);
+
+            for (uint32_t i = 0; i < alpha; ++i)
+                for (uint32_t j = 0; j < alpha; ++j)
+                {
+                    float *destination = tile_transformed + (i * alpha + j) * element_stride + ifm;
+                    if (masked)
+                        _mm256_maskstore_ps(destination, remainder_mask, v[i][j]);
+                    else
+                        _mm256_storeu_ps(destination, v[i][j]);
+                }
+        }
+    }
+}
+
+// Transforms products of tiles back to outputs of slice, adds biases & applies activation.
+// Product (i, j) of tile t is at ((i * alpha + j) * tile_block + t) * 16.
+template <uint32_t T_tile, NN_ACTIVATION_FUNCTION T_activation>
+void transform_output(const winograd_task &task, uint32_t image, uint32_t tile_begin, uint32_t tiles, uint32_t slice, const float *products)
+{
+    const uint32_t alpha = winograd<T_tile>::alpha;
+    const auto element_stride = task.tile_block * C_slice_size;
+    const auto image_offset = static_cast<size_t>(image) * task.output_height * task.output_width * task.output_depth;
+
+    for (uint32_t tile = 0; tile < tiles; ++tile)
+    {
+        const auto tile_y = (tile_begin + tile) / task.tiles_x;
+        const auto tile_x = (tile_begin + tile) % task.tiles_x;
+        const auto rows = std::min(T_tile, task.output_view_height - tile_y * T_tile);
+        const auto columns = std::min(T_tile, task.output_view_width - tile_x * T_tile);
+
+        for (uint32_t half = 0; half < 2; ++half)
+        {
+            const auto feature_map = slice * C_slice_size + half * C_simd_width;
+
+            __m256 m[alpha][alpha];
+            for (uint32_t i = 0; i < alpha; ++i)
+                for (uint32_t j = 0; j < alpha; ++j)
+                    m[i][j] = _mm256_load_ps(products + (i * alpha + j) * element_stride + tile * C_slice_size + half * C_simd_width);
+
+            __m256 reduced[T_tile][alpha], y[T_tile][T_tile];
+            for (uint32_t j = 0; j < alpha; ++j)
+                winograd<T_tile>::output(&m[0][j], alpha, &reduced[0][j], alpha);
+            for (uint32_t i = 0; i < T_tile; ++i)
+                winograd<T_tile>::output(&reduced[i][0], 1, &y[i][0], 1);
+
+            const __m256 bias = task.bias ? _mm256_loadu_ps(task.bias + feature_map) : _mm256_setzero_ps();
+            for (uint32_t i = 0; i < rows; ++i)
+            {
+                const auto output_y = task.output_start_y + tile_y * T_tile + i;
+                for (uint32_t j = 0; j < columns; ++j)
+                {
+                    const auto output_x = task.output_start_x + tile_x * T_tile + j;
+                    __m256 result = _mm256_add_ps(y[i][j], bias);
+                    if (T_activation == NN_ACTIVATION_FUNCTION_RELU)
+                        result = _mm256_max_ps(result, _mm256_setzero_ps());
+                    _mm256_storeu_ps(task.output + image_offset + (static_cast<size_t>(output_y) * task.output_width + output_x) * task.output_depth +
+                                         task.output_fmap_start + feature_map,
+                                     result);
+                }
+            }
+        }
+    }
+}
+
+// Computes tiles [tile_begin, tile_begin + tiles) of image for output feature map slices [slice_begin, slice_end).
+template <uint32_t T_tile, NN_ACTIVATION_FUNCTION T_activation>
+void compute_tiles(const winograd_task &task, uint32_t image, uint32_t tile_begin, uint32_t tiles, uint32_t slice_begin, uint32_t slice_end)
+{
+    const uint32_t alpha = winograd<T_tile>::alpha;
+    const uint32_t elements = alpha * alpha;
+
+    // Products first - they are stored with aligned stores.
+    float *products = tile_buffer(elements * task.tile_block * (C_slice_size + task.num_input));
+    float *transformed = products + elements * task.tile_block * C_slice_size;
+
+    transform_input<T_tile>(task, image, tile_begin, tiles, transformed);
+
+    for (auto slice = slice_begin; slice < slice_end; ++slice)
+    {
+        for (uint32_t element = 0; element < elements; ++element)
+        {
+            const float *weights = task.weights + (static_cast<size_t>(element) * task.num_slices + slice) * task.num_input * C_slice_size;
+            const float *element_transformed = transformed + element * task.tile_block * task.num_input;
+            float *element_products = products + element * task.tile_block * C_slice_size;
+            if (task.avx512)
+            {
+                avx512::multiply_rows(element_transformed, task.num_input, tiles, 1, task.num_input, weights, 0, element_products, false);
+                continue;
+            }
+
+            uint32_t tile = 0;
+            for (; tile + C_micro_tiles <= tiles; tile += C_micro_tiles)
+                multiply_block<C_micro_tiles>(element_transformed + tile * task.num_input, task.num_input, weights, element_products + tile * C_slice_size);
+
+            switch (tiles - tile)
+            {
+            case 0: break;
+            case 1: multiply_block<1>(element_transformed + tile * task.num_input, task.num_input, weights, element_products + tile * C_slice_size); break;
+            case 2: multiply_block<2>(element_transformed + tile * task.num_input, task.num_input, weights, element_products + tile * C_slice_size); break;
+            case 3: multiply_block<3>(element_transformed + tile * task.num_input, task.num_input, weights, element_products + tile * C_slice_size); break;
+            case 4: multiply_block<4>(element_transformed + tile * task.num_input, task.num_input, weights, element_products + tile * C_slice_size); break;
+            case 5: multiply_block<5>(element_transformed + tile * task.num_input, task.num_input, weights, element_products + tile * C_slice_size); break;
+            }
+        }
+
+        transform_output<T_tile, T_activation>(task, image, tile_begin, tiles, slice, products);
+    }
+}
+
+using compute_tiles_function = decltype(compute_tiles<2, NN_ACTIVATION_FUNCTION_NONE>)*;
+
+compute_tiles_function choose_compute_tiles(size_t tile_size, NN_ACTIVATION_FUNCTION activation)
+{
+    const bool relu = activation == NN_ACTIVATION_FUNCTION_RELU;
+    switch (tile_size)
+    {
+    case 2: return relu ? compute_tiles<2, NN_ACTIVATION_FUNCTION_RELU> : compute_tiles<2, NN_ACTIVATION_FUNCTION_NONE>;
+    case 4: return relu ? compute_tiles<4, NN_ACTIVATION_FUNCTION_RELU> : compute_tiles<4, NN_ACTIVATION_FUNCTION_NONE>;
+    default: throw std::invalid_argument("tile size");
+    }
+}
+
+} // namespace convolution_winograd_f32_impl
+
+using namespace convolution_winograd_f32_impl;
+
+convolution_winograd_f32 *convolution_winograd_f32::create(size_t tile_size,
+                                                           size_t num_input,
+                                                           size_t num_output,
+                                                           size_t output_w,
+                                                           size_t output_h,
+                                                           int32_t center_offset_x,
+                                                           int32_t center_offset_y,
+                                                           const nn_argument_activation_t &activation,
+                                                           size_t batch_size,
+                                                           nn_device_t *device) {
+    return new convolution_winograd_f32(tile_size,
+                                        num_input,
+                                        num_output,
+                                        output_w,
+                                        output_h,
+                                        center_offset_x,
+                                        center_offset_y,
+                                        activation,
+                                        batch_size,
+                                        reinterpret_cast<nn_device_internal *>(device));
+}
+
+convolution_winograd_f32::convolution_winograd_f32(size_t tile_size,
+                                                   size_t num_input,
+                                                   size_t num_output,
+                                                   size_t output_w,
+                                                   size_t output_h,
+                                                   int32_t center_offset_x,
+                                                   int32_t center_offset_y,
+                                                   const nn_argument_activation_t &activation,
+                                                   size_t batch_size,
+                                                   nn_device_internal *device)
+    : convolution_f32(3, 3, num_input, num_output, output_w, output_h, center_offset_x, center_offset_y, 1, 1, activation, batch_size, device),
+      tile_size(tile_size) {
+    if (tile_size != 2 && tile_size != 4)
+        throw std::invalid_argument("tile size");
+    if (activation.function != NN_ACTIVATION_FUNCTION_NONE && activation.function != NN_ACTIVATION_FUNCTION_RELU)
+        throw std::invalid_argument("activation");
+    if (num_output % C_slice_size != 0)
+        throw std::invalid_argument("number of outputs");
+}
+
+float convolution_winograd_f32::get_error(size_t tile_size) {
+    // Measured on layers with up to 1024 input feature maps of uniformly distributed data, rounded up;
+    // error grows slowly with number of input feature maps.
+    switch (tile_size) {
+    case 2: return 5e-6f;
+    case 4: return 1e-4f;
+    default: return 1.0f;
+    }
+}
+
+size_t convolution_winograd_f32::choose_tile_size(size_t kernel_w,
+                                                  size_t kernel_h,
+                                                  size_t stride_x,
+                                                  size_t stride_y,
+                                                  size_t num_input,
+                                                  size_t num_output,
+                                                  size_t output_w,
+                                                  size_t output_h,
+                                                  const nn_argument_activation_t &activation,
+                                                  float tolerance) {
+    if (kernel_w != 3 || kernel_h != 3 || stride_x != 1 || stride_y != 1)
+        return 0;
+    if (activation.function != NN_ACTIVATION_FUNCTION_NONE && activation.function != NN_ACTIVATION_FUNCTION_RELU)
+        return 0;
+    if (num_input < C_min_feature_maps || num_output < C_min_feature_maps || num_output % C_slice_size != 0)
+        return 0;
+
+    // 4x4 tiles need the heavier transforms, so they pay off only when output is not much smaller than area it covers.
+    const auto tiled_area = [&](size_t tile_size) {
+        return ((output_w + tile_size - 1) / tile_size) * ((output_h + tile_size - 1) / tile_size) * tile_size * tile_size;
+    };
+    if (get_error(4) <= tolerance && 8 * tiled_area(4) <= 9 * output_w * output_h)
+        return 4;
+    if (get_error(2) <= tolerance)
+        return 2;
+    return 0;
+}
+
+nn::nn_workload_data_t<float> *convolution_winograd_f32::create_weights(const nn::data<float, 4> &weights) {
+    if (weights.size[0] != 3 || weights.size[1] != 3 || weights.size[2] != input_size_z || weights.size[3] != output_size_z)
+        throw std::invalid_argument("weights");
+
+    const uint32_t alpha = static_cast<uint32_t>(tile_size + 2);
+    const uint32_t num_input = static_cast<uint32_t>(weights.size[2]);
+    const uint32_t num_slices = static_cast<uint32_t>(weights.size[3]) / C_slice_size;
+
+    // Transformed weights: for every element of transformed tile, slices of 16 output feature maps,
+    // each with all input feature maps - contiguous data read by single micro-kernel call.
+    nn_workload_data_layout_t layout = {
+        { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
+        { 0, 0, 0, 0, 0, 0 }, // alignment
+        { NN_DATA_COORD_p, NN_DATA_COORD_z, NN_DATA_COORD_q, NN_DATA_COORD_x, NN_DATA_COORD_y, NN_DATA_COORD_n }, // ordering
+        NN_DATATYPE_FLOAT
+    };
+
+    nn_workload_data_coords_t size = {
+        1,
+        alpha,          // transformed tile width
+        alpha,          // transformed tile height
+        num_input,      // number of input feature maps
+        C_slice_size,   // output feature maps slice size
+        num_slices      // number of slices of output feature maps
+    };
+
+    auto load_weights = new nn::nn_workload_data_t<float>(size, layout);
+    auto dst = static_cast<float *>(load_weights->parent->data_buffer);
+
+    // Transform is computed in double precision, so weights add no error of their own.
+    double g[3][3], columns[6][3], u[6][6];
+    for (uint32_t output = 0; output < num_slices * C_slice_size; ++output)
+        for (uint32_t input = 0; input < num_input; ++input)
+        {
+            for (uint32_t y = 0; y < 3; ++y)
+                for (uint32_t x = 0; x < 3; ++x)
+                    g[y][x] = weights.at(x, y, input, output);
+
+            for (uint32_t x = 0; x < 3; ++x)
+                if (tile_size == 2) winograd<2>::weights(&g[0][x], 3, &columns[0][x], 3);
+                else                winograd<4>::weights(&g[0][x], 3, &columns[0][x], 3);
+            for (uint32_t i = 0; i < alpha; ++i)
+                if (tile_size == 2) winograd<2>::weights(&columns[i][0], 1, &u[i][0], 1);
+                else                winograd<4>::weights(&columns[i][0], 1, &u[i][0], 1);
+
+            const auto slice = output / C_slice_size, slice_element = output % C_slice_size;
+            for (uint32_t i = 0; i < alpha; ++i)
+                for (uint32_t j = 0; j < alpha; ++j)
+                    dst[((static_cast<size_t>(i * alpha + j) * num_slices + slice) * num_input + input) * C_slice_size + slice_element] =
+                        static_cast<float>(u[i][j]);
+        }
+
+    return load_weights;
+}
+
+void convolution_winograd_f32::forward(const nn::nn_workload_data_t<float> *input_buffer,
+                                       const nn::nn_workload_data_t<float> *weights_buffer,
+                                       const nn::nn_workload_data_t<float> *bias_buffer,
+                                       nn::nn_workload_data_t<float> *output_buffer) {
+    winograd_task task;
+    task.input = static_cast<const float *>(input_buffer->parent->data_buffer);
+    task.input_width = input_buffer->parent->lengths.t[NN_DATA_COORD_x];
+    task.input_height = input_buffer->parent->lengths.t[NN_DATA_COORD_y];
+    task.input_depth = input_buffer->parent->lengths.t[NN_DATA_COORD_z];
+    task.input_fmap_start = input_buffer->view_begin.t[NN_DATA_COORD_z];
+    task.input_start_x = static_cast<int32_t>(input_buffer->view_begin.t[NN_DATA_COORD_x]) - center_offset_x;
+    task.input_start_y = static_cast<int32_t>(input_buffer->view_begin.t[NN_DATA_COORD_y]) - center_offset_y;
+
+    task.output = static_cast<float *>(output_buffer->parent->data_buffer);
+    task.output_width = output_buffer->parent->lengths.t[NN_DATA_COORD_x];
+    task.output_height = output_buffer->parent->lengths.t[NN_DATA_COORD_y];
+    task.output_depth = output_buffer->parent->lengths.t[NN_DATA_COORD_z];
+    task.output_fmap_start = output_buffer->view_begin.t[NN_DATA_COORD_z];
+    task.output_start_x = output_buffer->view_begin.t[NN_DATA_COORD_x];
+    task.output_start_y = output_buffer->view_begin.t[NN_DATA_COORD_y];
+    task.output_view_width = output_buffer->view_end.t[NN_DATA_COORD_x] - task.output_start_x + 1;
+    task.output_view_height = output_buffer->view_end.t[NN_DATA_COORD_y] - task.output_start_y + 1;
+
+    task.weights = static_cast<const float *>(weights_buffer->parent->data_buffer);
+    task.bias = bias_buffer ? static_cast<const float *>(bias_buffer->parent->data_buffer) + bias_buffer->view_begin.t[NN_DATA_COORD_x] : nullptr;
+    task.num_input = weights_buffer->parent->lengths.t[NN_DATA_COORD_z];
+    task.num_slices = weights_buffer->parent->lengths.t[NN_DATA_COORD_q];
+
+    const auto tile = static_cast<uint32_t>(tile_size);
+    task.tiles_x = (task.output_view_width + tile - 1) / tile;
+    task.tiles_y = (task.output_view_height + tile - 1) / tile;
+    task.tile_block = C_micro_tiles * (tuning.partition ? tuning.partition : C_default_micro_blocks);
+    task.avx512 = device->isa == NN_CPU_ISA_AVX512;
+
+    const auto compute = choose_compute_tiles(tile_size, activation.function);
+
+    // Work is split into units: blocks of tiles of single image; when there are less of them than threads,
+    // output feature map slices are split too.
+    const auto num_tiles = task.tiles_x * task.tiles_y;
+    const auto tile_blocks = (num_tiles + task.tile_block - 1) / task.tile_block;
+    const auto image_begin = output_buffer->view_begin.t[NN_DATA_COORD_n];
+    const auto num_images = output_buffer->view_end.t[NN_DATA_COORD_n] - image_begin + 1;
+    const auto num_threads = device->thread_pool.get_num_threads();
+    const auto slice_parts = std::min(task.num_slices, std::max(1u, (num_threads + num_images * tile_blocks - 1) / (num_images * tile_blocks)));
+    const auto num_units = num_images * tile_blocks * slice_parts;
+
+    auto run_units = [&task, compute, tile_blocks, slice_parts, image_begin, num_tiles](uint32_t unit_begin, uint32_t unit_end) {
+        for (auto unit = unit_begin; unit < unit_end; ++unit)
+        {
+            const auto slice_part = unit % slice_parts;
+            const auto tile_block = unit / slice_parts % tile_blocks;
+            const auto image = image_begin + unit / slice_parts / tile_blocks;
+            const auto tile_begin = tile_block * task.tile_block;
+            compute(task, image, tile_begin, std::min(task.tile_block, num_tiles - tile_begin),
+                    slice_part * task.num_slices / slice_parts, (slice_part + 1) * task.num_slices / slice_parts);
+        }
+    };
+
+    const auto num_jobs = std::min(num_threads, num_units);
+    if (num_jobs < 2)
+    {
+        run_units(0, num_units);
+        return;
+    }
+
+    std::vector<nn_multithreaded_request> jobs(num_jobs);
+    for (auto job = 0u; job < num_jobs; ++job)
+    {
+        const auto unit_begin = job * num_units / num_jobs, unit_end = (job + 1) * num_units / num_jobs;
+        jobs[job].callback = [&run_units, unit_begin, unit_end](void *) { run_units(unit_begin, unit_end); };
+        jobs[job].request_handle = nullptr;
+    }
+    device->thread_pool.push_job(jobs);
+}
+
+std::vector<nn_cpu_tuning_t> convolution_winograd_f32::get_tuning_candidates() {
+    // Blocks of 12 (default), 6 & 24 tiles - larger ones reuse weights more, smaller ones split better
+    // between threads. Blocks larger than needed for all tiles of image are skipped.
+    const auto tiles = ((output_size_x + tile_size - 1) / tile_size) * ((output_size_y + tile_size - 1) / tile_size);
+    std::vector<nn_cpu_tuning_t> candidates(1, nn_cpu_tuning_t{0, C_default_micro_blocks});
+    for (uint32_t micro_blocks : {1u, 4u})
+        if (micro_blocks < C_default_micro_blocks || C_micro_tiles * micro_blocks / 2 < tiles)
+            candidates.push_back(nn_cpu_tuning_t{0, micro_blocks});
+    return candidates;
+}
+
+std::string convolution_winograd_f32::get_tuning_signature() {
+    return "convolution_winograd_f32"
+        ";tile=" + std::to_string(tile_size) +
+        ";in=" + std::to_string(get_required_input_w()) + "x" + std::to_string(get_required_input_h()) + "x" + std::to_string(input_size_z) +
+        ";out=" + std::to_string(output_size_x) + "x" + std::to_string(output_size_y) + "x" + std::to_string(output_size_z) +
+        ";activation=" + std::to_string(activation.function) +
+        ";batch=" + std::to_string(batch_size);
+}
+
+} // namespace layer
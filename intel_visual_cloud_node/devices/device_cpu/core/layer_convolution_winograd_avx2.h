@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "layer_convolution_avx2.h"
+
+namespace layer {
+
+// Convolution with 3x3 kernel & stride 1 computed with Winograd minimal filtering F(m x m, 3x3), m = 2 or 4.
+// Weights are transformed once when they are created. Input is split into m x m output tiles; their
+// (m+2) x (m+2) input patches are transformed, multiplied with transformed weights in (m+2)^2 independent
+// products over input feature maps and transformed back. Results differ from direct convolution by rounding
+// errors that grow with m (see get_error), so compiler uses it only when device tolerance allows.
+// Tuning: partition - number of 6-tile blocks of micro-kernel in block of tiles computed at once (0 - default).
+class convolution_winograd_f32 : public convolution_f32 {
+  public:
+    static convolution_winograd_f32 *create(size_t tile_size,
+                                            size_t num_input,
+                                            size_t num_output,
+                                            size_t output_w,
+                                            size_t output_h,
+                                            int32_t center_offset_x,
+                                            int32_t center_offset_y,
+                                            const nn_argument_activation_t &activation,
+                                            size_t batch_size,
+                                            nn_device_t *device);
+    virtual ~convolution_winograd_f32() {}
+
+    // size m of output tile computed from single transformed input tile
+    const size_t tile_size;
+
+    // Largest error of outputs relative to largest output magnitude for given tile size.
+    static float get_error(size_t tile_size);
+
+    // Largest tile size for layer with given tolerated relative error; 0 if layer should use direct convolution.
+    static size_t choose_tile_size(size_t kernel_w,
+                                   size_t kernel_h,
+                                   size_t stride_x,
+                                   size_t stride_y,
+                                   size_t num_input,
+                                   size_t num_output,
+                                   size_t output_w,
+                                   size_t output_h,
+                                   const nn_argument_activation_t &activation,
+                                   float tolerance);
+
+    virtual void forward(const nn::nn_workload_data_t<float> *input_buffer,
+                         const nn::nn_workload_data_t<float> *weights_buffer,
+                         const nn::nn_workload_data_t<float> *bias_buffer,
+                         nn::nn_workload_data_t<float> *output_buffer) override;
+
+    // order of weights coordinates is kernel_width, kernel_height, number of input channels, number of filters
+    virtual nn::nn_workload_data_t<float> *create_weights(const nn::data<float, 4> &weights) override;
+
+    virtual std::vector<nn_cpu_tuning_t> get_tuning_candidates() override;
+    virtual std::string get_tuning_signature() override;
+
+  protected:
+    convolution_winograd_f32(size_t tile_size,
+                             size_t num_input,
+                             size_t num_output,
+                             size_t output_w,
+                             size_t output_h,
+                             int32_t center_offset_x,
+                             int32_t center_offset_y,
+                             const nn_argument_activation_t &activation,
+                             size_t batch_size,
+                             nn_device_internal *device);
+};
+
+} // namespace layer
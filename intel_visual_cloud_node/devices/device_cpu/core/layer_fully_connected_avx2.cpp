@@ -28,576 +28,321 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../common/nn_workload_data.h"
 #include "../api_internal/nn_device_interface_0_internal.h"
 #include "layer_fully_connected_avx2.h"
+#include "layers_avx512.h"
 
 #include <immintrin.h>
 #include <string.h>
 #include <algorithm>
 #include <thread>
 #include <vector>
+#include <string>
 
 // SIMD width for this implementation
 const auto C_simd_width = sizeof(__m256) / sizeof(float);
 
 static const auto C_max_acc_batch1 = 13u;
-static const auto C_max_acc_batch8 = 13u;
-static const auto C_max_acc_batch48 = 2u;
-
-static const auto C_batch8_size = C_simd_width;
-static const auto C_batch48_size = 6 * C_simd_width;
 
 static const auto C_data_stride_batch1 = C_simd_width * C_max_acc_batch1;
-static const auto C_data_stride_batch8 = C_batch8_size * C_max_acc_batch8;
-static const auto C_data_stride_batch48 = C_batch48_size * C_max_acc_batch48;
 
 namespace layer {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // forward implementation
 
-template<uint32_t T_SIZE, NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY>
-void fully_connected_compute_block_batch8(
-    float* input_buffer,
-    float* output_ptr,
-    float* bias_ptr,
-    float* weights_buffer,
-    uint32_t input_width)
+// Batched modes run as packed GEMM: weights are packed at create_weights() time in panels of
+// C_gemm_panel outputs, inputs are split in blocks of C_gemm_depth that stay in cache for all
+// panels and outputs of panel are computed by register-blocked micro-kernels:
+// 6 outputs x 16 batch items or 12 outputs x 8 batch items (12 outputs x 16 batch items on devices
+// running AVX-512 kernels, see layer_fully_connected_avx512.cpp).
+// Packed weights are stored in workload caches - changing packing needs new nn_cpu_workload_cache::version.
+static const auto C_gemm_panel = 12u;
+static const auto C_gemm_half_panel = C_gemm_panel / 2;
+static const auto C_gemm_depth = 256u;
+static const auto C_gemm_batch_block = 16u;
+
+// Loads & stores of 8 batch items; last block of batch that is not multiple of 8 is masked.
+template<bool T_MASKED>
+inline __m256 load_batch_block(const float* ptr, __m256i mask)
 {
-    // We are not using table of registers and unroll pragmas
-    // due to compiler which have issues with register allocation
-    // and needs special, obvious treatment. Template immediate
-    // arguments matching will remove all conditions in this code.
-    __m256  acc0, acc1, acc2, acc3, acc4, 
-            acc5, acc6, acc7, acc8, acc9, 
-            acc10, acc11, acc12, acc13, acc14;
+    return T_MASKED ? _mm256_maskload_ps(ptr, mask) : _mm256_loadu_ps(ptr);
+}
 
-    if (T_NEED_BIAS_COPY)
-    {
-        if (T_SIZE >=  1)  acc0 = _mm256_setzero_ps();
-        if (T_SIZE >=  2)  acc1 = _mm256_setzero_ps();
-        if (T_SIZE >=  3)  acc2 = _mm256_setzero_ps();
-        if (T_SIZE >=  4)  acc3 = _mm256_setzero_ps();
-        if (T_SIZE >=  5)  acc4 = _mm256_setzero_ps();
-        if (T_SIZE >=  6)  acc5 = _mm256_setzero_ps();
-        if (T_SIZE >=  7)  acc6 = _mm256_setzero_ps();
-        if (T_SIZE >=  8)  acc7 = _mm256_setzero_ps();
-        if (T_SIZE >=  9)  acc8 = _mm256_setzero_ps();
-        if (T_SIZE >= 10)  acc9 = _mm256_setzero_ps();
-        if (T_SIZE >= 11) acc10 = _mm256_setzero_ps();
-        if (T_SIZE >= 12) acc11 = _mm256_setzero_ps();
-        if (T_SIZE >= 13) acc12 = _mm256_setzero_ps();
-        if (T_SIZE >= 14) acc13 = _mm256_setzero_ps();
-        if (T_SIZE >= 15) acc14 = _mm256_setzero_ps();
-    }
-    else
-    {
-        if (T_SIZE >=  1)  acc0 = _mm256_load_ps(output_ptr +  0 * C_batch8_size);
-        if (T_SIZE >=  2)  acc1 = _mm256_load_ps(output_ptr +  1 * C_batch8_size);
-        if (T_SIZE >=  3)  acc2 = _mm256_load_ps(output_ptr +  2 * C_batch8_size);
-        if (T_SIZE >=  4)  acc3 = _mm256_load_ps(output_ptr +  3 * C_batch8_size);
-        if (T_SIZE >=  5)  acc4 = _mm256_load_ps(output_ptr +  4 * C_batch8_size);
-        if (T_SIZE >=  6)  acc5 = _mm256_load_ps(output_ptr +  5 * C_batch8_size);
-        if (T_SIZE >=  7)  acc6 = _mm256_load_ps(output_ptr +  6 * C_batch8_size);
-        if (T_SIZE >=  8)  acc7 = _mm256_load_ps(output_ptr +  7 * C_batch8_size);
-        if (T_SIZE >=  9)  acc8 = _mm256_load_ps(output_ptr +  8 * C_batch8_size);
-        if (T_SIZE >= 10)  acc9 = _mm256_load_ps(output_ptr +  9 * C_batch8_size);
-        if (T_SIZE >= 11) acc10 = _mm256_load_ps(output_ptr + 10 * C_batch8_size);
-        if (T_SIZE >= 12) acc11 = _mm256_load_ps(output_ptr + 11 * C_batch8_size);
-        if (T_SIZE >= 13) acc12 = _mm256_load_ps(output_ptr + 12 * C_batch8_size);
-        if (T_SIZE >= 14) acc13 = _mm256_load_ps(output_ptr + 13 * C_batch8_size);
-        if (T_SIZE >= 15) acc14 = _mm256_load_ps(output_ptr + 14 * C_batch8_size);
-    }
+template<bool T_MASKED>
+inline void store_batch_block(float* ptr, __m256i mask, __m256 value)
+{
+    if (T_MASKED) _mm256_maskstore_ps(ptr, mask, value);
+    else          _mm256_storeu_ps(ptr, value);
+}
 
-    auto input_ptr = &input_buffer[0];
+// Accumulator of output row starts from zero when biases are added at the end of first pass,
+// otherwise from output (partial result of previous input block or bias stored in output).
+template<bool T_NEED_BIAS_COPY, bool T_MASKED>
+inline __m256 gemm_load_accumulator(const float* output_ptr, __m256i mask, uint32_t row, uint32_t rows, bool first_run)
+{
+    return (row >= rows || (T_NEED_BIAS_COPY && first_run)) ? _mm256_setzero_ps() : load_batch_block<T_MASKED>(output_ptr, mask);
+}
 
-    const auto input_ptr_end = &input_buffer[input_width*C_batch8_size];
+// After last input block bias and activation are applied; rows of panel past output count are not stored.
+template<NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY, bool T_MASKED>
+inline void gemm_store_accumulator(float* output_ptr, const float* bias_ptr, __m256i mask, uint32_t row, uint32_t rows, bool last_run, __m256 acc)
+{
+    if (row >= rows)
+        return;
 
-    while (input_ptr < input_ptr_end)
+    if (last_run)
     {
-        // Do MADs.
-        __m256 input = _mm256_load_ps(input_ptr);
-        if (T_SIZE >=  1)  acc0 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  0),  acc0);
-        if (T_SIZE >=  2)  acc1 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  1),  acc1);
-        if (T_SIZE >=  3)  acc2 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  2),  acc2);
-        if (T_SIZE >=  4)  acc3 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  3),  acc3);
-        if (T_SIZE >=  5)  acc4 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  4),  acc4);
-        if (T_SIZE >=  6)  acc5 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  5),  acc5);
-        if (T_SIZE >=  7)  acc6 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  6),  acc6);
-        if (T_SIZE >=  8)  acc7 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  7),  acc7);
-        if (T_SIZE >=  9)  acc8 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  8),  acc8);
-        if (T_SIZE >= 10)  acc9 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  9),  acc9);
-        if (T_SIZE >= 11) acc10 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer + 10), acc10);
-        if (T_SIZE >= 12) acc11 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer + 11), acc11);
-        if (T_SIZE >= 13) acc12 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer + 12), acc12);
-        if (T_SIZE >= 14) acc13 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer + 13), acc13);
-        if (T_SIZE >= 15) acc14 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer + 14), acc14);
+        if (T_NEED_BIAS_COPY)
+            acc = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + row), acc);
 
-        // Increment pointers.
-        input_ptr += C_batch8_size;
-        weights_buffer += C_max_acc_batch8;
+        if (T_FUNCTION == NN_ACTIVATION_FUNCTION_RELU)
+            acc = _mm256_max_ps(_mm256_setzero_ps(), acc);
     }
 
-    if (T_NEED_BIAS_COPY)
-    {
-        // Add biases.
-        if (T_SIZE >=  1)  acc0 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr +  0),  acc0);
-        if (T_SIZE >=  2)  acc1 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr +  1),  acc1);
-        if (T_SIZE >=  3)  acc2 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr +  2),  acc2);
-        if (T_SIZE >=  4)  acc3 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr +  3),  acc3);
-        if (T_SIZE >=  5)  acc4 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr +  4),  acc4);
-        if (T_SIZE >=  6)  acc5 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr +  5),  acc5);
-        if (T_SIZE >=  7)  acc6 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr +  6),  acc6);
-        if (T_SIZE >=  8)  acc7 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr +  7),  acc7);
-        if (T_SIZE >=  9)  acc8 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr +  8),  acc8);
-        if (T_SIZE >= 10)  acc9 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr +  9),  acc9);
-        if (T_SIZE >= 11) acc10 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 10), acc10);
-        if (T_SIZE >= 12) acc11 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 11), acc11);
-        if (T_SIZE >= 13) acc12 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 12), acc12);
-        if (T_SIZE >= 14) acc13 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 13), acc13);
-        if (T_SIZE >= 15) acc14 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 14), acc14);
-    }
+    store_batch_block<T_MASKED>(output_ptr, mask, acc);
+}
 
-    if (T_FUNCTION == NN_ACTIVATION_FUNCTION_RELU)
+// 6 outputs x 16 batch items, second vector of batch items masked for batch remainder.
+template<NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY, bool T_MASKED>
+void fully_connected_compute_block_gemm6x16(
+    const float* input_buffer,
+    float* output_ptr,
+    const float* bias_ptr,
+    const float* weights_buffer,
+    uint32_t input_depth,
+    uint32_t batch_size,
+    uint32_t rows,
+    bool first_run,
+    bool last_run,
+    __m256i mask)
+{
+    // Named accumulators, same as in other kernels of this file - compilers
+    // keep them in registers which is not the case for arrays.
+    __m256 acc0  = gemm_load_accumulator<T_NEED_BIAS_COPY, false   >(output_ptr + 0 * batch_size,                mask,  0, rows, first_run);
+    __m256 acc1  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 0 * batch_size + C_simd_width, mask,  0, rows, first_run);
+    __m256 acc2  = gemm_load_accumulator<T_NEED_BIAS_COPY, false   >(output_ptr + 1 * batch_size,                mask,  1, rows, first_run);
+    __m256 acc3  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 1 * batch_size + C_simd_width, mask,  1, rows, first_run);
+    __m256 acc4  = gemm_load_accumulator<T_NEED_BIAS_COPY, false   >(output_ptr + 2 * batch_size,                mask,  2, rows, first_run);
+    __m256 acc5  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 2 * batch_size + C_simd_width, mask,  2, rows, first_run);
+    __m256 acc6  = gemm_load_accumulator<T_NEED_BIAS_COPY, false   >(output_ptr + 3 * batch_size,                mask,  3, rows, first_run);
+    __m256 acc7  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 3 * batch_size + C_simd_width, mask,  3, rows, first_run);
+    __m256 acc8  = gemm_load_accumulator<T_NEED_BIAS_COPY, false   >(output_ptr + 4 * batch_size,                mask,  4, rows, first_run);
+    __m256 acc9  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 4 * batch_size + C_simd_width, mask,  4, rows, first_run);
+    __m256 acc10 = gemm_load_accumulator<T_NEED_BIAS_COPY, false   >(output_ptr + 5 * batch_size,                mask,  5, rows, first_run);
+    __m256 acc11 = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 5 * batch_size + C_simd_width, mask,  5, rows, first_run);
+
+    const auto input_end = input_buffer + input_depth * batch_size;
+    for (auto input_ptr = input_buffer; input_ptr < input_end; input_ptr += batch_size, weights_buffer += C_gemm_panel)
     {
-        // Perform ReLU.
-        if (T_SIZE >=  1)  acc0 = _mm256_max_ps(_mm256_setzero_ps(),  acc0);
-        if (T_SIZE >=  2)  acc1 = _mm256_max_ps(_mm256_setzero_ps(),  acc1);
-        if (T_SIZE >=  3)  acc2 = _mm256_max_ps(_mm256_setzero_ps(),  acc2);
-        if (T_SIZE >=  4)  acc3 = _mm256_max_ps(_mm256_setzero_ps(),  acc3);
-        if (T_SIZE >=  5)  acc4 = _mm256_max_ps(_mm256_setzero_ps(),  acc4);
-        if (T_SIZE >=  6)  acc5 = _mm256_max_ps(_mm256_setzero_ps(),  acc5);
-        if (T_SIZE >=  7)  acc6 = _mm256_max_ps(_mm256_setzero_ps(),  acc6);
-        if (T_SIZE >=  8)  acc7 = _mm256_max_ps(_mm256_setzero_ps(),  acc7);
-        if (T_SIZE >=  9)  acc8 = _mm256_max_ps(_mm256_setzero_ps(),  acc8);
-        if (T_SIZE >= 10)  acc9 = _mm256_max_ps(_mm256_setzero_ps(),  acc9);
-        if (T_SIZE >= 11) acc10 = _mm256_max_ps(_mm256_setzero_ps(), acc10);
-        if (T_SIZE >= 12) acc11 = _mm256_max_ps(_mm256_setzero_ps(), acc11);
-        if (T_SIZE >= 13) acc12 = _mm256_max_ps(_mm256_setzero_ps(), acc12);
-        if (T_SIZE >= 14) acc13 = _mm256_max_ps(_mm256_setzero_ps(), acc13);
-        if (T_SIZE >= 15) acc14 = _mm256_max_ps(_mm256_setzero_ps(), acc14);
+        const __m256 input0 = load_batch_block<false>(input_ptr, mask);
+        const __m256 input1 = load_batch_block<T_MASKED>(input_ptr + C_simd_width, mask);
+
+        __m256 weight = _mm256_broadcast_ss(weights_buffer + 0);
+        acc0  = _mm256_fmadd_ps(input0, weight, acc0);
+        acc1  = _mm256_fmadd_ps(input1, weight, acc1);
+        weight = _mm256_broadcast_ss(weights_buffer + 1);
+        acc2  = _mm256_fmadd_ps(input0, weight, acc2);
+        acc3  = _mm256_fmadd_ps(input1, weight, acc3);
+        weight = _mm256_broadcast_ss(weights_buffer + 2);
+        acc4  = _mm256_fmadd_ps(input0, weight, acc4);
+        acc5  = _mm256_fmadd_ps(input1, weight, acc5);
+        weight = _mm256_broadcast_ss(weights_buffer + 3);
+        acc6  = _mm256_fmadd_ps(input0, weight, acc6);
+        acc7  = _mm256_fmadd_ps(input1, weight, acc7);
+        weight = _mm256_broadcast_ss(weights_buffer + 4);
+        acc8  = _mm256_fmadd_ps(input0, weight, acc8);
+        acc9  = _mm256_fmadd_ps(input1, weight, acc9);
+        weight = _mm256_broadcast_ss(weights_buffer + 5);
+        acc10 = _mm256_fmadd_ps(input0, weight, acc10);
+        acc11 = _mm256_fmadd_ps(input1, weight, acc11);
     }
 
-    // Store results.
-    if (T_SIZE >=  1) _mm256_store_ps(output_ptr +  0 * C_batch8_size,  acc0);
-    if (T_SIZE >=  2) _mm256_store_ps(output_ptr +  1 * C_batch8_size,  acc1);
-    if (T_SIZE >=  3) _mm256_store_ps(output_ptr +  2 * C_batch8_size,  acc2);
-    if (T_SIZE >=  4) _mm256_store_ps(output_ptr +  3 * C_batch8_size,  acc3);
-    if (T_SIZE >=  5) _mm256_store_ps(output_ptr +  4 * C_batch8_size,  acc4);
-    if (T_SIZE >=  6) _mm256_store_ps(output_ptr +  5 * C_batch8_size,  acc5);
-    if (T_SIZE >=  7) _mm256_store_ps(output_ptr +  6 * C_batch8_size,  acc6);
-    if (T_SIZE >=  8) _mm256_store_ps(output_ptr +  7 * C_batch8_size,  acc7);
-    if (T_SIZE >=  9) _mm256_store_ps(output_ptr +  8 * C_batch8_size,  acc8);
-    if (T_SIZE >= 10) _mm256_store_ps(output_ptr +  9 * C_batch8_size,  acc9);
-    if (T_SIZE >= 11) _mm256_store_ps(output_ptr + 10 * C_batch8_size, acc10);
-    if (T_SIZE >= 12) _mm256_store_ps(output_ptr + 11 * C_batch8_size, acc11);
-    if (T_SIZE >= 13) _mm256_store_ps(output_ptr + 12 * C_batch8_size, acc12);
-    if (T_SIZE >= 14) _mm256_store_ps(output_ptr + 13 * C_batch8_size, acc13);
-    if (T_SIZE >= 15) _mm256_store_ps(output_ptr + 14 * C_batch8_size, acc14);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, false   >(output_ptr + 0 * batch_size,                bias_ptr, mask,  0, rows, last_run, acc0);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 0 * batch_size + C_simd_width, bias_ptr, mask,  0, rows, last_run, acc1);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, false   >(output_ptr + 1 * batch_size,                bias_ptr, mask,  1, rows, last_run, acc2);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 1 * batch_size + C_simd_width, bias_ptr, mask,  1, rows, last_run, acc3);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, false   >(output_ptr + 2 * batch_size,                bias_ptr, mask,  2, rows, last_run, acc4);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 2 * batch_size + C_simd_width, bias_ptr, mask,  2, rows, last_run, acc5);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, false   >(output_ptr + 3 * batch_size,                bias_ptr, mask,  3, rows, last_run, acc6);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 3 * batch_size + C_simd_width, bias_ptr, mask,  3, rows, last_run, acc7);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, false   >(output_ptr + 4 * batch_size,                bias_ptr, mask,  4, rows, last_run, acc8);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 4 * batch_size + C_simd_width, bias_ptr, mask,  4, rows, last_run, acc9);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, false   >(output_ptr + 5 * batch_size,                bias_ptr, mask,  5, rows, last_run, acc10);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 5 * batch_size + C_simd_width, bias_ptr, mask,  5, rows, last_run, acc11);
 }
 
-template <NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY>
-void fully_connected_f32::run_fully_connected_work_item_internal_batch8(const nn::nn_workload_data_t<float> *input,
-                                                                        const nn::nn_workload_data_t<float> *weights,
-                                                                        const nn::nn_workload_data_t<float> *bias,
-                                                                        nn::nn_workload_data_t<float> *output) {
-    const auto input_width = input->parent->lengths.t[NN_DATA_COORD_x];
-    const auto output_width = output->view_end.t[NN_DATA_COORD_x] - output->view_begin.t[NN_DATA_COORD_x] + 1;
-
-    const auto num_full_blocks = output_width / C_max_acc_batch8;
-    const auto partial_block_size = output_width % C_max_acc_batch8;
-
-    auto input_buffer = static_cast<float*>(input->parent->data_buffer);
-    auto output_buffer = static_cast<float*>(output->parent->data_buffer);
-    auto weights_buffer = static_cast<float*>(weights->parent->data_buffer);
-
-    // Output views.
-    const auto output_view_start = output->view_begin.t[NN_DATA_COORD_x];
-    const auto output_view_batch_offset = output_view_start * C_batch8_size;
-
-    // Weight views (for output-related weights).
-    auto weight_view_start =
-        output_view_start / C_max_acc_batch8 * input_width * C_max_acc_batch8;
-
-    auto weights_ptr = &weights_buffer[weight_view_start];
-    auto output_ptr = &output_buffer[output_view_batch_offset];
-
-    float* bias_ptr = nullptr;
-    if (T_NEED_BIAS_COPY)
-    {
-        auto biases_buffer = static_cast<float*>(bias->parent->data_buffer);
-        bias_ptr = &biases_buffer[output_view_start];
-    }
-
-    for (auto block = 0u; block < num_full_blocks; ++block)
+// 12 outputs x 8 batch items, used for last 8 or less batch items.
+template<NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY, bool T_MASKED>
+void fully_connected_compute_block_gemm12x8(
+    const float* input_buffer,
+    float* output_ptr,
+    const float* bias_ptr,
+    const float* weights_buffer,
+    uint32_t input_depth,
+    uint32_t batch_size,
+    uint32_t rows,
+    bool first_run,
+    bool last_run,
+    __m256i mask)
+{
+    __m256 acc0  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  0 * batch_size, mask,  0, rows, first_run);
+    __m256 acc1  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  1 * batch_size, mask,  1, rows, first_run);
+    __m256 acc2  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  2 * batch_size, mask,  2, rows, first_run);
+    __m256 acc3  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  3 * batch_size, mask,  3, rows, first_run);
+    __m256 acc4  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  4 * batch_size, mask,  4, rows, first_run);
+    __m256 acc5  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  5 * batch_size, mask,  5, rows, first_run);
+    __m256 acc6  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  6 * batch_size, mask,  6, rows, first_run);
+    __m256 acc7  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  7 * batch_size, mask,  7, rows, first_run);
+    __m256 acc8  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  8 * batch_size, mask,  8, rows, first_run);
+    __m256 acc9  = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  9 * batch_size, mask,  9, rows, first_run);
+    __m256 acc10 = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 10 * batch_size, mask, 10, rows, first_run);
+    __m256 acc11 = gemm_load_accumulator<T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 11 * batch_size, mask, 11, rows, first_run);
+
+    const auto input_end = input_buffer + input_depth * batch_size;
+    for (auto input_ptr = input_buffer; input_ptr < input_end; input_ptr += batch_size, weights_buffer += C_gemm_panel)
     {
-        // Run computation.
-        fully_connected_compute_block_batch8<C_max_acc_batch8, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width);
-
-        // Increment pointers.
-        output_ptr += C_data_stride_batch8;
-        weights_ptr += input_width*C_max_acc_batch8;
-
-        if (T_NEED_BIAS_COPY)
-        {
-            bias_ptr += C_max_acc_batch8;
-        }
+        const __m256 input = load_batch_block<T_MASKED>(input_ptr, mask);
+        acc0  = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  0),  acc0);
+        acc1  = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  1),  acc1);
+        acc2  = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  2),  acc2);
+        acc3  = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  3),  acc3);
+        acc4  = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  4),  acc4);
+        acc5  = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  5),  acc5);
+        acc6  = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  6),  acc6);
+        acc7  = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  7),  acc7);
+        acc8  = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  8),  acc8);
+        acc9  = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer +  9),  acc9);
+        acc10 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer + 10), acc10);
+        acc11 = _mm256_fmadd_ps(input, _mm256_broadcast_ss(weights_buffer + 11), acc11);
     }
 
-    switch (partial_block_size)
-    {
-    case  0: break;
-    case  1: fully_connected_compute_block_batch8< 1, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case  2: fully_connected_compute_block_batch8< 2, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case  3: fully_connected_compute_block_batch8< 3, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case  4: fully_connected_compute_block_batch8< 4, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case  5: fully_connected_compute_block_batch8< 5, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case  6: fully_connected_compute_block_batch8< 6, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case  7: fully_connected_compute_block_batch8< 7, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case  8: fully_connected_compute_block_batch8< 8, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case  9: fully_connected_compute_block_batch8< 9, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case 10: fully_connected_compute_block_batch8<10, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case 11: fully_connected_compute_block_batch8<11, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    case 12: fully_connected_compute_block_batch8<12, T_FUNCTION, T_NEED_BIAS_COPY>(input_buffer, output_ptr, bias_ptr, weights_ptr, input_width); break;
-    default:
-        NN_UNREACHABLE_CODE;
-    }
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  0 * batch_size, bias_ptr, mask,  0, rows, last_run,  acc0);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  1 * batch_size, bias_ptr, mask,  1, rows, last_run,  acc1);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  2 * batch_size, bias_ptr, mask,  2, rows, last_run,  acc2);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  3 * batch_size, bias_ptr, mask,  3, rows, last_run,  acc3);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  4 * batch_size, bias_ptr, mask,  4, rows, last_run,  acc4);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  5 * batch_size, bias_ptr, mask,  5, rows, last_run,  acc5);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  6 * batch_size, bias_ptr, mask,  6, rows, last_run,  acc6);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  7 * batch_size, bias_ptr, mask,  7, rows, last_run,  acc7);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  8 * batch_size, bias_ptr, mask,  8, rows, last_run,  acc8);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr +  9 * batch_size, bias_ptr, mask,  9, rows, last_run,  acc9);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 10 * batch_size, bias_ptr, mask, 10, rows, last_run, acc10);
+    gemm_store_accumulator<T_FUNCTION, T_NEED_BIAS_COPY, T_MASKED>(output_ptr + 11 * batch_size, bias_ptr, mask, 11, rows, last_run, acc11);
 }
 
-template<uint32_t T_SIZE, NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY>
-inline void fully_connected_compute_block_batch48(
-    float* input_buffer,
+// One panel of outputs for batch items [batch_begin, batch_end) over one block of inputs.
+template<NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY>
+void fully_connected_compute_panel_gemm(
+    const float* input_buffer,
     float* output_ptr,
-    float* bias_ptr,
-    float* weights_buffer,
-    uint32_t input_width,
+    const float* bias_ptr,
+    const float* weights_buffer,
+    uint32_t input_depth,
+    uint32_t batch_size,
+    uint32_t batch_begin,
+    uint32_t batch_end,
+    uint32_t rows,
     bool first_run,
     bool last_run)
 {
-    // We are not using table of registers and unroll pragmas
-    // due to compiler which have issues with register allocation
-    // and needs special, obvious treatment. Template immediate
-    // arguments matching will remove all conditions in this code.
-    __m256  acc0, acc1, acc2, acc3, acc4, 
-            acc5, acc6, acc7, acc8, acc9, 
-            acc10, acc11;
-
-    if (first_run)
-    {
-        if (T_NEED_BIAS_COPY)
-        {
-            if (T_SIZE >= 1)
-            {
-                acc0 = _mm256_setzero_ps();
-                acc1 = _mm256_setzero_ps();
-                acc2 = _mm256_setzero_ps();
-                acc3 = _mm256_setzero_ps();
-                acc4 = _mm256_setzero_ps();
-                acc5 = _mm256_setzero_ps();
-            }
-
-            if (T_SIZE >= 2)
-            {
-                acc6 = _mm256_setzero_ps();
-                acc7 = _mm256_setzero_ps();
-                acc8 = _mm256_setzero_ps();
-                acc9 = _mm256_setzero_ps();
-                acc10 = _mm256_setzero_ps();
-                acc11 = _mm256_setzero_ps();
-            }
-        }
-        else
-        {
-            if (T_SIZE >= 1)
-            {
-                acc0 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 0 * C_simd_width);
-                acc1 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 1 * C_simd_width);
-                acc2 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 2 * C_simd_width);
-                acc3 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 3 * C_simd_width);
-                acc4 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 4 * C_simd_width);
-                acc5 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 5 * C_simd_width);
-            }
-
-            if (T_SIZE >= 2)
-            {
-                acc6 = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 0 * C_simd_width);
-                acc7 = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 1 * C_simd_width);
-                acc8 = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 2 * C_simd_width);
-                acc9 = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 3 * C_simd_width);
-                acc10 = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 4 * C_simd_width);
-                acc11 = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 5 * C_simd_width);
-            }
-        }
-    }
-    else
-    {
-        if (T_SIZE >= 1)
-        {
-            acc0 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 0 * C_simd_width);
-            acc1 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 1 * C_simd_width);
-            acc2 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 2 * C_simd_width);
-            acc3 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 3 * C_simd_width);
-            acc4 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 4 * C_simd_width);
-            acc5 = _mm256_load_ps(output_ptr + 0 * C_batch48_size + 5 * C_simd_width);
-        }
-
-        if (T_SIZE >= 2)
-        {
-            acc6  = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 0 * C_simd_width);
-            acc7  = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 1 * C_simd_width);
-            acc8  = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 2 * C_simd_width);
-            acc9  = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 3 * C_simd_width);
-            acc10 = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 4 * C_simd_width);
-            acc11 = _mm256_load_ps(output_ptr + 1 * C_batch48_size + 5 * C_simd_width);
-        }
-    }
-
-    auto input_ptr = &input_buffer[0];
-
-    const auto input_ptr_end = &input_buffer[input_width*C_batch48_size];
-
-    while (input_ptr < input_ptr_end)
-    {
-        // Do MADs.
-        __m256 weights0 = _mm256_broadcast_ss(weights_buffer + 0);
-        __m256 weights1 = _mm256_broadcast_ss(weights_buffer + 1);
-
-        __m256 input = _mm256_load_ps(input_ptr + 0 * C_simd_width);
-        if (T_SIZE >= 1)  acc0 = _mm256_fmadd_ps(input, weights0,  acc0);
-        if (T_SIZE >= 2)  acc6 = _mm256_fmadd_ps(input, weights1,  acc6);
-                                                                   
-        input = _mm256_load_ps(input_ptr + 1 * C_simd_width);     
-        if (T_SIZE >= 1)  acc1 = _mm256_fmadd_ps(input, weights0,  acc1);
-        if (T_SIZE >= 2)  acc7 = _mm256_fmadd_ps(input, weights1,  acc7);
-                                                                   
-        input = _mm256_load_ps(input_ptr + 2 * C_simd_width);     
-        if (T_SIZE >= 1)  acc2 = _mm256_fmadd_ps(input, weights0,  acc2);
-        if (T_SIZE >= 2)  acc8 = _mm256_fmadd_ps(input, weights1,  acc8);
-
-        input = _mm256_load_ps(input_ptr + 3 * C_simd_width);
-        if (T_SIZE >= 1)  acc3 = _mm256_fmadd_ps(input, weights0,  acc3);
-        if (T_SIZE >= 2)  acc9 = _mm256_fmadd_ps(input, weights1,  acc9);
-
-        input = _mm256_load_ps(input_ptr + 4 * C_simd_width);
-        if (T_SIZE >= 1)  acc4 = _mm256_fmadd_ps(input, weights0,  acc4);
-        if (T_SIZE >= 2) acc10 = _mm256_fmadd_ps(input, weights1, acc10);
-
-        input = _mm256_load_ps(input_ptr + 5 * C_simd_width);
-        if (T_SIZE >= 1)  acc5 = _mm256_fmadd_ps(input, weights0,  acc5);
-        if (T_SIZE >= 2) acc11 = _mm256_fmadd_ps(input, weights1, acc11);
-        
-        // Increment pointers.
-        input_ptr += C_batch48_size;
-        weights_buffer += C_max_acc_batch48;
-    }
+    const auto half_rows = std::min(rows, C_gemm_half_panel);
+    const auto upper_bias_ptr = T_NEED_BIAS_COPY ? bias_ptr + C_gemm_half_panel : nullptr;
 
-    if (first_run)
+    for (auto batch = batch_begin; batch < batch_end; batch += C_gemm_batch_block)
     {
-        if (T_NEED_BIAS_COPY)
-        {
-            // Add biases.
-            if (T_SIZE >= 1)
-            {
-                acc0 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 0), acc0);
-                acc1 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 0), acc1);
-                acc2 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 0), acc2);
-                acc3 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 0), acc3);
-                acc4 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 0), acc4);
-                acc5 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 0), acc5);
-            }
-
-            if (T_SIZE >= 2)
-            {
-                acc6 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 1), acc6);
-                acc7 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 1), acc7);
-                acc8 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 1), acc8);
-                acc9 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 1), acc9);
-                acc10 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 1), acc10);
-                acc11 = _mm256_add_ps(_mm256_broadcast_ss(bias_ptr + 1), acc11);
-            }
-        }
-    }
+        const auto items = std::min(C_gemm_batch_block, batch_end - batch);
+        const auto mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(items % C_simd_width), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
 
-    if (last_run)
-    {
-        if (T_FUNCTION == NN_ACTIVATION_FUNCTION_RELU)
+        if (items > C_simd_width)
         {
-            // Perform ReLU.
-            if (T_SIZE >= 1)
+            // Both halves of panel.
+            if (items == C_gemm_batch_block)
             {
-                acc0 = _mm256_max_ps(_mm256_setzero_ps(), acc0);
-                acc1 = _mm256_max_ps(_mm256_setzero_ps(), acc1);
-                acc2 = _mm256_max_ps(_mm256_setzero_ps(), acc2);
-                acc3 = _mm256_max_ps(_mm256_setzero_ps(), acc3);
-                acc4 = _mm256_max_ps(_mm256_setzero_ps(), acc4);
-                acc5 = _mm256_max_ps(_mm256_setzero_ps(), acc5);
+                fully_connected_compute_block_gemm6x16<T_FUNCTION, T_NEED_BIAS_COPY, false>(
+                    input_buffer + batch, output_ptr + batch, bias_ptr, weights_buffer, input_depth, batch_size, half_rows, first_run, last_run, mask);
+                if (rows > C_gemm_half_panel)
+                    fully_connected_compute_block_gemm6x16<T_FUNCTION, T_NEED_BIAS_COPY, false>(
+                        input_buffer + batch, output_ptr + C_gemm_half_panel * batch_size + batch, upper_bias_ptr,
+                        weights_buffer + C_gemm_half_panel, input_depth, batch_size, rows - C_gemm_half_panel, first_run, last_run, mask);
             }
-
-            if (T_SIZE >= 2)
+            else
             {
-                acc6 = _mm256_max_ps(_mm256_setzero_ps(), acc6);
-                acc7 = _mm256_max_ps(_mm256_setzero_ps(), acc7);
-                acc8 = _mm256_max_ps(_mm256_setzero_ps(), acc8);
-                acc9 = _mm256_max_ps(_mm256_setzero_ps(), acc9);
-                acc10 = _mm256_max_ps(_mm256_setzero_ps(), acc10);
-                acc11 = _mm256_max_ps(_mm256_setzero_ps(), acc11);
+                fully_connected_compute_block_gemm6x16<T_FUNCTION, T_NEED_BIAS_COPY, true>(
+                    input_buffer + batch, output_ptr + batch, bias_ptr, weights_buffer, input_depth, batch_size, half_rows, first_run, last_run, mask);
+                if (rows > C_gemm_half_panel)
+                    fully_connected_compute_block_gemm6x16<T_FUNCTION, T_NEED_BIAS_COPY, true>(
+                        input_buffer + batch, output_ptr + C_gemm_half_panel * batch_size + batch, upper_bias_ptr,
+                        weights_buffer + C_gemm_half_panel, input_depth, batch_size, rows - C_gemm_half_panel, first_run, last_run, mask);
             }
         }
-    }
-
-    // Store results.
-    if (T_SIZE >= 1)
-    {
-        _mm256_store_ps(output_ptr + 0 * C_batch48_size + 0 * C_simd_width, acc0);
-        _mm256_store_ps(output_ptr + 0 * C_batch48_size + 1 * C_simd_width, acc1);
-        _mm256_store_ps(output_ptr + 0 * C_batch48_size + 2 * C_simd_width, acc2);
-        _mm256_store_ps(output_ptr + 0 * C_batch48_size + 3 * C_simd_width, acc3);
-        _mm256_store_ps(output_ptr + 0 * C_batch48_size + 4 * C_simd_width, acc4);
-        _mm256_store_ps(output_ptr + 0 * C_batch48_size + 5 * C_simd_width, acc5);
-    }
-
-    if (T_SIZE >= 2)
-    {
-        _mm256_store_ps(output_ptr + 1 * C_batch48_size + 0 * C_simd_width,  acc6);
-        _mm256_store_ps(output_ptr + 1 * C_batch48_size + 1 * C_simd_width,  acc7);
-        _mm256_store_ps(output_ptr + 1 * C_batch48_size + 2 * C_simd_width,  acc8);
-        _mm256_store_ps(output_ptr + 1 * C_batch48_size + 3 * C_simd_width,  acc9);
-        _mm256_store_ps(output_ptr + 1 * C_batch48_size + 4 * C_simd_width, acc10);
-        _mm256_store_ps(output_ptr + 1 * C_batch48_size + 5 * C_simd_width, acc11);
+        else if (items == C_simd_width)
+            fully_connected_compute_block_gemm12x8<T_FUNCTION, T_NEED_BIAS_COPY, false>(
+                input_buffer + batch, output_ptr + batch, bias_ptr, weights_buffer, input_depth, batch_size, rows, first_run, last_run, mask);
+        else
+            fully_connected_compute_block_gemm12x8<T_FUNCTION, T_NEED_BIAS_COPY, true>(
+                input_buffer + batch, output_ptr + batch, bias_ptr, weights_buffer, input_depth, batch_size, rows, first_run, last_run, mask);
     }
 }
 
+// Output view selects panels (view starts at panel boundary) and batch items computed by this job.
 template <NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY>
-void fully_connected_f32::run_fully_connected_work_item_internal_batch48(const nn::nn_workload_data_t<float> *input,
-                                                                         const nn::nn_workload_data_t<float> *weights,
-                                                                         const nn::nn_workload_data_t<float> *bias,
-                                                                         nn::nn_workload_data_t<float> *output) {
+void fully_connected_f32::run_fully_connected_work_item_internal_batch(const nn::nn_workload_data_t<float> *input,
+                                                                       const nn::nn_workload_data_t<float> *weights,
+                                                                       const nn::nn_workload_data_t<float> *bias,
+                                                                       nn::nn_workload_data_t<float> *output) {
     const auto input_width = input->parent->lengths.t[NN_DATA_COORD_x];
-    const auto output_width = output->view_end.t[NN_DATA_COORD_x] - output->view_begin.t[NN_DATA_COORD_x] + 1;
-
-    const auto num_full_blocks = output_width / C_max_acc_batch48;
-    const auto partial_block_size = output_width % C_max_acc_batch48;
-
-    auto input_buffer = static_cast<float*>(input->parent->data_buffer);
-    auto output_buffer = static_cast<float*>(output->parent->data_buffer);
-    auto weights_buffer = static_cast<float*>(weights->parent->data_buffer);
-
-    // Output views.
-    const auto output_view_start = output->view_begin.t[NN_DATA_COORD_x];
-    const auto output_view_batch_offset = output_view_start * C_batch48_size;
+    const auto batch = output->parent->lengths.t[NN_DATA_COORD_n];
 
-    // Weight views (for output-related weights).
-    auto weight_view_start =
-        output_view_start / C_max_acc_batch48 * input_width * C_max_acc_batch48;
+    const auto output_begin = output->view_begin.t[NN_DATA_COORD_x];
+    const auto output_end = output->view_end.t[NN_DATA_COORD_x] + 1;
+    const auto batch_begin = output->view_begin.t[NN_DATA_COORD_n];
+    const auto batch_end = output->view_end.t[NN_DATA_COORD_n] + 1;
 
-    const auto weights_ptr = &weights_buffer[weight_view_start];
-    const auto output_ptr = &output_buffer[output_view_batch_offset];
+    assert(output_begin % C_gemm_panel == 0);
 
-    const auto C_package_size = 128;
-
-    const auto num_input_packages = input_width / C_package_size;
-    const auto package_remainder = input_width % C_package_size;
-    
-    bool first_run = true;
+    auto input_buffer = static_cast<const float*>(input->parent->data_buffer);
+    auto output_buffer = static_cast<float*>(output->parent->data_buffer);
+    auto weights_buffer = static_cast<const float*>(weights->parent->data_buffer);
+    auto biases_buffer = T_NEED_BIAS_COPY ? static_cast<const float*>(bias->parent->data_buffer) : nullptr;
 
-    float* bias_ptr = nullptr;
-    if (T_NEED_BIAS_COPY)
+    for (auto input_begin = 0u; input_begin < input_width; input_begin += C_gemm_depth)
     {
-        auto biases_buffer = static_cast<float*>(bias->parent->data_buffer);
-        bias_ptr = &biases_buffer[output_view_start];
-    }
-    
-    // Full packages.
-    for (auto input_package = 0u; input_package < num_input_packages; ++input_package)
-    {
-        const bool last_run = 
-            (package_remainder > 0 || input_package + 1 < num_input_packages) ? false : true;
-        auto package_weights_ptr = weights_ptr;
-        auto package_output_ptr = output_ptr;
-        auto package_bias_ptr = bias_ptr;
-        for (auto block = 0u; block < num_full_blocks; ++block)
-        {
-            // Run computation.
-            fully_connected_compute_block_batch48<C_max_acc_batch48, T_FUNCTION, T_NEED_BIAS_COPY>(
-                        input_buffer + C_package_size * C_batch48_size * input_package,
-                        package_output_ptr, 
-                        package_bias_ptr,
-                        package_weights_ptr + C_package_size * C_max_acc_batch48 * input_package,
-                        C_package_size,
-                        first_run,
-                        last_run);
+        const auto input_depth = std::min(C_gemm_depth, input_width - input_begin);
+        const bool first_run = (input_begin == 0);
+        const bool last_run = (input_begin + input_depth == input_width);
 
-            // Increment pointers.
-            package_output_ptr += C_data_stride_batch48;
-            package_weights_ptr += input_width*C_max_acc_batch48;
-
-            if (T_NEED_BIAS_COPY)
-            {
-                package_bias_ptr += C_max_acc_batch48;
-            }
-        }
-
-        switch (partial_block_size)
-        {
-        case  0: break;
-        case  1: fully_connected_compute_block_batch48< 1, T_FUNCTION, T_NEED_BIAS_COPY>(
-                            input_buffer + C_package_size * C_batch48_size * input_package,
-                            package_output_ptr,
-                            package_bias_ptr,
-                            package_weights_ptr + C_package_size * C_max_acc_batch48 * input_package,
-                            C_package_size,
-                            first_run,
-                            last_run);
-            break;
-        default:
-            NN_UNREACHABLE_CODE;
-        }
-
-        first_run = false;
-    }
-
-    // Remaining input items.
-    if (package_remainder > 0 )
-    {
-        auto package_weights_ptr = weights_ptr;
-        auto package_output_ptr = output_ptr;
-        auto package_bias_ptr = bias_ptr;
-        for (auto block = 0u; block < num_full_blocks; ++block)
+        for (auto panel_begin = output_begin; panel_begin < output_end; panel_begin += C_gemm_panel)
         {
-            // Run computation.
-            fully_connected_compute_block_batch48<C_max_acc_batch48, T_FUNCTION, T_NEED_BIAS_COPY>(
-                        input_buffer + C_package_size * C_batch48_size * num_input_packages,
-                        package_output_ptr,
-                        package_bias_ptr,
-                        package_weights_ptr + C_package_size * C_max_acc_batch48 * num_input_packages,
-                        package_remainder,
-                        first_run,
-                        true);
-
-            // Increment pointers.
-            package_output_ptr += C_data_stride_batch48;
-            package_weights_ptr += input_width*C_max_acc_batch48;
-
-            if (T_NEED_BIAS_COPY)
+            if (device->isa == NN_CPU_ISA_AVX512)
             {
-                package_bias_ptr += C_max_acc_batch48;
+                avx512::fully_connected_panel_gemm(
+                    input_buffer + input_begin * batch,
+                    output_buffer + panel_begin * batch,
+                    T_NEED_BIAS_COPY ? biases_buffer + panel_begin : nullptr,
+                    weights_buffer + (panel_begin * input_width + input_begin * C_gemm_panel),
+                    input_depth,
+                    batch,
+                    batch_begin,
+                    batch_end,
+                    std::min(C_gemm_panel, output_end - panel_begin),
+                    first_run,
+                    last_run,
+                    T_FUNCTION == NN_ACTIVATION_FUNCTION_RELU);
+                continue;
             }
-        }
 
-        switch (partial_block_size)
-        {
-        case  0: break;
-        case  1: fully_connected_compute_block_batch48< 1, T_FUNCTION, T_NEED_BIAS_COPY>(
-                        input_buffer + C_package_size * C_batch48_size * num_input_packages,
-                        package_output_ptr,
-                        package_bias_ptr,
-                        package_weights_ptr + C_package_size * C_max_acc_batch48 * num_input_packages,
-                        package_remainder,
-                        first_run,
-                        true);
-            break;
-        default:
-            NN_UNREACHABLE_CODE;
+            fully_connected_compute_panel_gemm<T_FUNCTION, T_NEED_BIAS_COPY>(
+                input_buffer + input_begin * batch,
+                output_buffer + panel_begin * batch,
+                T_NEED_BIAS_COPY ? biases_buffer + panel_begin : nullptr,
+                weights_buffer + (panel_begin * input_width + input_begin * C_gemm_panel),
+                input_depth,
+                batch,
+                batch_begin,
+                batch_end,
+                std::min(C_gemm_panel, output_end - panel_begin),
+                first_run,
+                last_run);
         }
     }
-
 }
 
 template<uint32_t T_SIZE, NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY>
@@ -886,20 +631,10 @@ void fully_connected_f32::choose_fully_connected_work_item_batching_mode(const n
                                                                          const nn::nn_workload_data_t<float> *weights,
                                                                          const nn::nn_workload_data_t<float> *bias,
                                                                          nn::nn_workload_data_t<float> *output) {
-    switch (batch_size)
-    {
-    case 1:
+    if (batch_size == 1)
         run_fully_connected_work_item_internal_latency<T_FUNCTION, T_NEED_BIAS_COPY>(input, weights, bias, output);
-        break;
-    case 8:
-        run_fully_connected_work_item_internal_batch8<T_FUNCTION, T_NEED_BIAS_COPY>(input, weights, bias, output);
-        break;
-    case 48:
-        run_fully_connected_work_item_internal_batch48<T_FUNCTION, T_NEED_BIAS_COPY>(input, weights, bias, output);
-        break;
-    default:
-        break;
-    }
+    else
+        run_fully_connected_work_item_internal_batch<T_FUNCTION, T_NEED_BIAS_COPY>(input, weights, bias, output);
 }
 
 template <bool T_NEED_BIAS_COPY>
@@ -959,134 +694,69 @@ void fully_connected_f32::forward(const nn::nn_workload_data_t<float> *input,
                                   const nn::nn_workload_data_t<float> *weights,
                                   const nn::nn_workload_data_t<float> *bias,
                                   nn::nn_workload_data_t<float> *output) {
-    auto num_hardware_threads = std::min(device->thread_pool.get_num_threads(), max_threads);
+    const auto num_hardware_threads = tuning.partition ? std::min(device->thread_pool.get_num_threads(), tuning.partition)
+                                                       : std::min(device->thread_pool.get_num_threads(), max_threads);
 
-    auto item_view_length = output->view_end.t[NN_DATA_COORD_x] - output->view_begin.t[NN_DATA_COORD_x] + 1;
+    // Outputs are split between jobs in blocks (weight panels in batched modes); batch is split in
+    // blocks of micro-kernel width only when there are less output blocks than threads.
+    const auto output_length = output->view_end.t[NN_DATA_COORD_x] - output->view_begin.t[NN_DATA_COORD_x] + 1;
+    const auto batch_length = output->view_end.t[NN_DATA_COORD_n] - output->view_begin.t[NN_DATA_COORD_n] + 1;
 
-    auto rest_of_items_in_batch = 0u;
-    if (batch_size == 8)
-    {
-        rest_of_items_in_batch = item_view_length % C_max_acc_batch8;
-        item_view_length /= C_max_acc_batch8;
-    }
-    else if (batch_size == 48)
-    {
-        rest_of_items_in_batch = item_view_length % C_max_acc_batch48;
-        item_view_length /= C_max_acc_batch48;
-    }
+    const auto output_block = batch_size == 1 ? 1u : C_gemm_panel;
+    const auto output_blocks = (output_length + output_block - 1) / output_block;
+    const auto batch_blocks = (batch_length + C_gemm_batch_block - 1) / C_gemm_batch_block;
 
-    const auto items_per_thread = item_view_length / num_hardware_threads;
-    const auto items_modulo = item_view_length % num_hardware_threads;
+    const auto output_jobs = std::min<uint32_t>(output_blocks, num_hardware_threads);
+    const auto batch_jobs = std::min<uint32_t>(batch_blocks, std::max<uint32_t>(1u, num_hardware_threads / output_jobs));
 
     // Check if we have enough data to cover all threads.
-    if (items_per_thread == 0 && items_modulo < 2)
+    if (output_jobs * batch_jobs < 2)
     {
         // Its tiny data - just do it singlethreaded way.
         run_fully_connected_work_item(input, weights, bias, output);
+        return;
     }
-    else
-    {
-        // Not all threads will be used.
-        if (items_per_thread == 0)
-            num_hardware_threads = items_modulo;
 
-        uint32_t* thread_items_sums = static_cast<uint32_t*>(alloca(num_hardware_threads * sizeof(uint32_t)));
+    std::vector<fully_connected_f32_request_handle> request_handles(output_jobs * batch_jobs);
+
+    // Replace nn_workload_datas pointers with views.
+    nn_workload_data_coords_t input_view_begin = {0, 0, 0, 0, 0, 0};
+    nn_workload_data_coords_t input_view_end = {
+        input->get_length(NN_DATA_COORD_n) - 1,
+        input->get_length(NN_DATA_COORD_x) - 1,
+        input->get_length(NN_DATA_COORD_y) - 1,
+        input->get_length(NN_DATA_COORD_z) - 1,
+        input->get_length(NN_DATA_COORD_p) - 1,
+        input->get_length(NN_DATA_COORD_q) - 1
+    };
 
-        if (thread_items_sums == nullptr) throw std::bad_alloc();
+    nn_workload_data_coords_t weights_view_begin = {0, 0, 0, 0, 0, 0};
+    nn_workload_data_coords_t weights_view_end = {
+        weights->get_length(NN_DATA_COORD_n) - 1,
+        weights->get_length(NN_DATA_COORD_x) - 1,
+        weights->get_length(NN_DATA_COORD_y) - 1,
+        weights->get_length(NN_DATA_COORD_z) - 1,
+        weights->get_length(NN_DATA_COORD_p) - 1,
+        weights->get_length(NN_DATA_COORD_q) - 1
+    };
 
-        // Distribute elements more evenly.
-        auto elements_left = items_modulo;
-        for (auto thread_id = 0u; thread_id < num_hardware_threads; ++thread_id)
-        {
-            thread_items_sums[thread_id] = items_per_thread;
-            if (elements_left)
-            {
-                ++thread_items_sums[thread_id];
-                --elements_left;
-            }
-        }
+    // Fill slave work items.
+    for (auto output_job = 0u; output_job < output_jobs; ++output_job)
+    {
+        const auto work_begin = output_job * output_blocks / output_jobs * output_block;
+        const auto work_end = std::min((output_job + 1) * output_blocks / output_jobs * output_block, output_length) - 1;
 
-        // Now create table of thread sums.
-        auto thread_sum = 0u;
-        for (auto thread_id = 0u; thread_id < num_hardware_threads; ++thread_id)
+        for (auto batch_job = 0u; batch_job < batch_jobs; ++batch_job)
         {
-            thread_sum += thread_items_sums[thread_id];
-            thread_items_sums[thread_id] = thread_sum;
-
-            if (batch_size == 8)
-            {
-                thread_items_sums[thread_id] *= C_max_acc_batch8;
-
-                if (thread_id+1 == num_hardware_threads)
-                {
-                    thread_items_sums[thread_id] += rest_of_items_in_batch;
-                }
-            }
-            else if (batch_size == 48)
-            {
-                thread_items_sums[thread_id] *= C_max_acc_batch48;
+            const auto batch_begin = batch_job * batch_blocks / batch_jobs * C_gemm_batch_block;
+            const auto batch_end = std::min((batch_job + 1) * batch_blocks / batch_jobs * C_gemm_batch_block, batch_length) - 1;
 
-                if (thread_id+1 == num_hardware_threads)
-                {
-                    thread_items_sums[thread_id] += rest_of_items_in_batch;
-                }
-            }
-        }
-
-        std::vector<fully_connected_f32_request_handle> request_handles(num_hardware_threads);
-
-        // Fill slave work items.
-        for (auto thread_id = 0u; thread_id < num_hardware_threads; ++thread_id)
-        {
-            auto& request_handle = request_handles[thread_id];
+            auto& request_handle = request_handles[output_job * batch_jobs + batch_job];
             request_handle.primitive = this;
 
-            auto work_begin = 0u;
-            if (thread_id > 0u)
-                work_begin = thread_items_sums[thread_id - 1];
-
-            auto work_end = thread_items_sums[thread_id] - 1;
-
-            // Replace nn_workload_datas pointers with views.
-            nn_workload_data_coords_t input_view_begin =
-            {
-                0,
-                0,
-                0,
-                0,
-                0,
-                0
-            };
-            nn_workload_data_coords_t input_view_end = {
-                input->get_length(NN_DATA_COORD_n) - 1,
-                input->get_length(NN_DATA_COORD_x) - 1,
-                input->get_length(NN_DATA_COORD_y) - 1,
-                input->get_length(NN_DATA_COORD_z) - 1,
-                input->get_length(NN_DATA_COORD_p) - 1,
-                input->get_length(NN_DATA_COORD_q) - 1
-            };
-
-            nn_workload_data_coords_t weights_view_begin =
-            {
-                0,
-                0,
-                0,
-                0,
-                0,
-                0
-            };
-            nn_workload_data_coords_t weights_view_end = {
-                weights->get_length(NN_DATA_COORD_n) - 1,
-                weights->get_length(NN_DATA_COORD_x) - 1,
-                weights->get_length(NN_DATA_COORD_y) - 1,
-                weights->get_length(NN_DATA_COORD_z) - 1,
-                weights->get_length(NN_DATA_COORD_p) - 1,
-                weights->get_length(NN_DATA_COORD_q) - 1
-            };
-
             nn_workload_data_coords_t output_view_begin =
             {
-                0,
+                batch_begin,
                 work_begin,
                 0,
                 0,
@@ -1095,7 +765,7 @@ void fully_connected_f32::forward(const nn::nn_workload_data_t<float> *input,
             };
             nn_workload_data_coords_t output_view_end =
             {
-                output->get_length(NN_DATA_COORD_n) - 1,
+                batch_end,
                 work_end,
                 output->get_length(NN_DATA_COORD_y) - 1,
                 output->get_length(NN_DATA_COORD_z) - 1,
@@ -1139,28 +809,28 @@ void fully_connected_f32::forward(const nn::nn_workload_data_t<float> *input,
                 request_handle.bias = nullptr;
             }
         }
+    }
 
-        // Run threads.
-        std::vector<nn_multithreaded_request> job(num_hardware_threads);
+    // Run threads.
+    std::vector<nn_multithreaded_request> job(request_handles.size());
 
-        for (auto thread_id = 0u; thread_id < num_hardware_threads; ++thread_id)
-        {
-            job[thread_id].callback = unpack_fully_connected_callback_handle;
-            job[thread_id].request_handle = &request_handles[thread_id];
-        }
+    for (auto job_id = 0u; job_id < job.size(); ++job_id)
+    {
+        job[job_id].callback = unpack_fully_connected_callback_handle;
+        job[job_id].request_handle = &request_handles[job_id];
+    }
 
-        // Wait for all sub threads.
-        device->thread_pool.push_job(job);
+    // Wait for all sub threads.
+    device->thread_pool.push_job(job);
 
-        // Cleanup dynamic memory.
-        for (auto thread_id = 0u; thread_id < num_hardware_threads; ++thread_id)
-        {
-            delete request_handles[thread_id].input;
-            delete request_handles[thread_id].weights;
-            if (request_handles[thread_id].bias != nullptr)
-                delete request_handles[thread_id].bias;
-            delete request_handles[thread_id].output;
-        }
+    // Cleanup dynamic memory.
+    for (auto& request_handle : request_handles)
+    {
+        delete request_handle.input;
+        delete request_handle.weights;
+        if (request_handle.bias != nullptr)
+            delete request_handle.bias;
+        delete request_handle.output;
     }
 }
 
@@ -1196,6 +866,10 @@ void wrapper_fully_connected_work_item(nn_workload_item *const work_item)
 
     nn::nn_workload_data_t<float>* input_view = new nn::nn_workload_data_t<float>(work_item->input[0]->output->parent->data_buffer, input_view_coords, in_out_view_layout);
     nn::nn_workload_data_t<float>* output_view = new nn::nn_workload_data_t<float>(work_item->output->parent->data_buffer, output_view_coords, in_out_view_layout);
+    input_view->view_begin.t[NN_DATA_COORD_n] = work_item->input[0]->output->view_begin.t[NN_DATA_COORD_n];
+    input_view->view_end.t[NN_DATA_COORD_n] = work_item->input[0]->output->view_end.t[NN_DATA_COORD_n];
+    output_view->view_begin.t[NN_DATA_COORD_n] = work_item->output->view_begin.t[NN_DATA_COORD_n];
+    output_view->view_end.t[NN_DATA_COORD_n] = work_item->output->view_end.t[NN_DATA_COORD_n];
 
     if (static_cast<fully_connected_f32 *>(work_item->primitive)->device->thread_pool.get_num_threads() > 1)
     {
@@ -1240,6 +914,19 @@ fully_connected_f32::fully_connected_f32(size_t num_input,
       batch_size(batch_size),
       device(device) {}
 
+std::vector<nn_cpu_tuning_t> fully_connected_f32::get_tuning_candidates() {
+    const auto num_threads = device->thread_pool.get_num_threads();
+    return nn_cpu_job_count_candidates(num_threads, std::min(num_threads, max_threads));
+}
+
+std::string fully_connected_f32::get_tuning_signature() {
+    return "fully_connected_f32"
+        ";in=" + std::to_string(num_input) +
+        ";out=" + std::to_string(num_output) +
+        ";activation=" + std::to_string(activation.function) +
+        ";batch=" + std::to_string(batch_size);
+}
+
 nn::nn_workload_data_t<float> *fully_connected_f32::create_weights(const nn::data<float, 2> &weights) {
     nn::nn_workload_data_t<float> *result = nullptr;
 
@@ -1276,10 +963,9 @@ nn::nn_workload_data_t<float> *fully_connected_f32::create_weights(const nn::dat
                 dst[y + x*num_output] = src[x + y*num_input];
         break;
     }
-    case 8: 
-    case 48:
+    default: // batched modes
     {
-        const uint32_t C_max_accumulators = (batch_size == 8) ? 13 : 2;
+        const uint32_t C_max_accumulators = C_gemm_panel;
 
         //TODO: validate weight format
         nn_workload_data_layout_t layout = {
@@ -1298,6 +984,7 @@ nn::nn_workload_data_t<float> *fully_connected_f32::create_weights(const nn::dat
             static_cast<uint32_t>((weights.size[1] + C_max_accumulators - 1) / C_max_accumulators)   // q (number of slices)
         };
         result = new nn::nn_workload_data_t<float>(size, layout);
+        memset(result->parent->data_buffer, 0, result->parent->buffer_size); // padding of last panel
         /*
         Code below this comment is a performance optimized version of:
         auto width = weights.size[0];
@@ -1318,8 +1005,6 @@ nn::nn_workload_data_t<float> *fully_connected_f32::create_weights(const nn::dat
         }
         break;
     }
-    default:
-        assert(0); // batch size unsupported
     }
 
     return result;
@@ -1358,9 +1043,8 @@ nn::nn_workload_data_t<float> *fully_connected_f32::create_weights(const nn::dat
                         (*result)(0, z + z_size * (x + x_size * y), p, 0, 0, 0) = weights.at(x, y, z, p);
         break;
     }
-    case 8:
-    case 48:{
-        const uint32_t C_max_accumulators = (batch_size == 8) ? 13 : 2;
+    default:{ // batched modes
+        const uint32_t C_max_accumulators = C_gemm_panel;
 
         //THIS code requires verification
         //TODO: validate weight format
@@ -1380,6 +1064,7 @@ nn::nn_workload_data_t<float> *fully_connected_f32::create_weights(const nn::dat
             static_cast<uint32_t>(num_output + C_max_accumulators - 1) / C_max_accumulators // q (number of slices)
         };
         result = new nn::nn_workload_data_t<float>(size, layout);
+        memset(result->parent->data_buffer, 0, result->parent->buffer_size); // padding of last panel
 
         uint32_t last_non_full_slice = weights.size[3] % C_max_accumulators;
         /*
@@ -1410,8 +1095,6 @@ nn::nn_workload_data_t<float> *fully_connected_f32::create_weights(const nn::dat
                 }
         break;
     }
-    default:
-        assert(0); // batch size unsupported
     }
 
     return result;
@@ -28,13 +28,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "../api_internal/nn_device_interface_0_internal.h"
+#include "../api_internal/cpu_autotuner.h"
 #include "../../api/nn_primitives_api_0.h"
 
 struct nn_workload_item;
 struct nn_device_internal;
 
 namespace layer {
-class fully_connected_f32 : public nn_primitive_t {
+// Tuning: partition - number of jobs outputs and batch are split into (0 - all device threads up to max_threads).
+class fully_connected_f32 : public nn_primitive_t, public nn_cpu_tunable {
   public:
     static fully_connected_f32 *create(size_t num_input,
                                        size_t num_output,
@@ -70,17 +72,15 @@ class fully_connected_f32 : public nn_primitive_t {
 
     virtual void copy_output(nn::data<float, 2> &destination, const nn::nn_workload_data_t<float> &source);
 
+    virtual std::vector<nn_cpu_tuning_t> get_tuning_candidates() override;
+    virtual std::string get_tuning_signature() override;
+
   private:
     template <NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY>
-    void run_fully_connected_work_item_internal_batch8(const nn::nn_workload_data_t<float> *input,
-                                                       const nn::nn_workload_data_t<float> *weights,
-                                                       const nn::nn_workload_data_t<float> *bias,
-                                                       nn::nn_workload_data_t<float> *output);
-    template <NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY>
-    void run_fully_connected_work_item_internal_batch48(const nn::nn_workload_data_t<float> *input,
-                                                        const nn::nn_workload_data_t<float> *weights,
-                                                        const nn::nn_workload_data_t<float> *bias,
-                                                        nn::nn_workload_data_t<float> *output);
+    void run_fully_connected_work_item_internal_batch(const nn::nn_workload_data_t<float> *input,
+                                                      const nn::nn_workload_data_t<float> *weights,
+                                                      const nn::nn_workload_data_t<float> *bias,
+                                                      nn::nn_workload_data_t<float> *output);
     template <NN_ACTIVATION_FUNCTION T_FUNCTION, bool T_NEED_BIAS_COPY>
     void run_fully_connected_work_item_internal_latency(const nn::nn_workload_data_t<float> *input,
                                                         const nn::nn_workload_data_t<float> *weights,
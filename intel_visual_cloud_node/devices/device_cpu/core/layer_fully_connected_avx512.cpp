@@ -0,0 +1,166 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "layers_avx512.h"
+
+#include <immintrin.h>
+
+/* AVX-512 micro-kernel of batched fully connected layer (layer_fully_connected_avx2.cpp): 12 outputs x 16 batch
+items in 12 registers, batch remainder handled with masked loads & stores instead of separate 8-item kernel.
+*/
+
+namespace layer {
+namespace avx512 {
+namespace
+{
+const uint32_t C_panel = 12;
+const uint32_t C_batch_block = sizeof(__m512) / sizeof(float);
+
+// Accumulator of output row starts from zero when biases are added at the end of first pass,
+// otherwise from output (partial result of previous input block or bias stored in output).
+template <bool T_BIAS>
+inline __m512 load_accumulator(const float *output, __mmask16 mask, uint32_t row, uint32_t rows, bool first_run)
+{
+    return (row >= rows || (T_BIAS && first_run)) ? _mm512_setzero_ps() : _mm512_maskz_loadu_ps(mask, output);
+}
+
+template <bool T_RELU, bool T_BIAS>
+inline void store_accumulator(float *output, const float *bias, __mmask16 mask, uint32_t row, uint32_t rows, bool last_run, __m512 acc)
+{
+    if (row >= rows)
+        return;
+
+    if (last_run)
+    {
+        if (T_BIAS)
+            acc = _mm512_add_ps(_mm512_set1_ps(bias[row]), acc);
+        if (T_RELU)
+            acc = _mm512_max_ps(_mm512_setzero_ps(), acc);
+    }
+
+    _mm512_mask_storeu_ps(output, mask, acc);
+}
+
+template <bool T_RELU, bool T_BIAS>
+void compute_block(const float *input,
+                   float *output,
+                   const float *bias,
+                   const float *weights,
+                   uint32_t input_depth,
+                   uint32_t batch_size,
+                   uint32_t rows,
+                   bool first_run,
+                   bool last_run,
+                   __mmask16 mask)
+{
+    // Named accumulators - compilers keep them in registers which is not the case for arrays.
+    __m512 acc0  = load_accumulator<T_BIAS>(output +  0 * batch_size, mask,  0, rows, first_run);
+    __m512 acc1  = load_accumulator<T_BIAS>(output +  1 * batch_size, mask,  1, rows, first_run);
+    __m512 acc2  = load_accumulator<T_BIAS>(output +  2 * batch_size, mask,  2, rows, first_run);
+    __m512 acc3  = load_accumulator<T_BIAS>(output +  3 * batch_size, mask,  3, rows, first_run);
+    __m512 acc4  = load_accumulator<T_BIAS>(output +  4 * batch_size, mask,  4, rows, first_run);
+    __m512 acc5  = load_accumulator<T_BIAS>(output +  5 * batch_size, mask,  5, rows, first_run);
+    __m512 acc6  = load_accumulator<T_BIAS>(output +  6 * batch_size, mask,  6, rows, first_run);
+    __m512 acc7  = load_accumulator<T_BIAS>(output +  7 * batch_size, mask,  7, rows, first_run);
+    __m512 acc8  = load_accumulator<T_BIAS>(output +  8 * batch_size, mask,  8, rows, first_run);
+    __m512 acc9  = load_accumulator<T_BIAS>(output +  9 * batch_size, mask,  9, rows, first_run);
+    __m512 acc10 = load_accumulator<T_BIAS>(output + 10 * batch_size, mask, 10, rows, first_run);
+    __m512 acc11 = load_accumulator<T_BIAS>(output + 11 * batch_size, mask, 11, rows, first_run);
+
+    const auto input_end = input + static_cast<size_t>(input_depth) * batch_size;
+    for (; input < input_end; input += batch_size, weights += C_panel)
+    {
+        const __m512 input_block = _mm512_maskz_loadu_ps(mask, input);
+        acc0  = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[ 0]), acc0 );
+        acc1  = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[ 1]), acc1 );
+        acc2  = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[ 2]), acc2 );
+        acc3  = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[ 3]), acc3 );
+        acc4  = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[ 4]), acc4 );
+        acc5  = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[ 5]), acc5 );
+        acc6  = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[ 6]), acc6 );
+        acc7  = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[ 7]), acc7 );
+        acc8  = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[ 8]), acc8 );
+        acc9  = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[ 9]), acc9 );
+        acc10 = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[10]), acc10);
+        acc11 = _mm512_fmadd_ps(input_block, _mm512_set1_ps(weights[11]), acc11);
+    }
+
+    store_accumulator<T_RELU, T_BIAS>(output +  0 * batch_size, bias, mask,  0, rows, last_run, acc0);
+    store_accumulator<T_RELU, T_BIAS>(output +  1 * batch_size, bias, mask,  1, rows, last_run, acc1);
+    store_accumulator<T_RELU, T_BIAS>(output +  2 * batch_size, bias, mask,  2, rows, last_run, acc2);
+    store_accumulator<T_RELU, T_BIAS>(output +  3 * batch_size, bias, mask,  3, rows, last_run, acc3);
+    store_accumulator<T_RELU, T_BIAS>(output +  4 * batch_size, bias, mask,  4, rows, last_run, acc4);
+    store_accumulator<T_RELU, T_BIAS>(output +  5 * batch_size, bias, mask,  5, rows, last_run, acc5);
+    store_accumulator<T_RELU, T_BIAS>(output +  6 * batch_size, bias, mask,  6, rows, last_run, acc6);
+    store_accumulator<T_RELU, T_BIAS>(output +  7 * batch_size, bias, mask,  7, rows, last_run, acc7);
+    store_accumulator<T_RELU, T_BIAS>(output +  8 * batch_size, bias, mask,  8, rows, last_run, acc8);
+    store_accumulator<T_RELU, T_BIAS>(output +  9 * batch_size, bias, mask,  9, rows, last_run, acc9);
+    store_accumulator<T_RELU, T_BIAS>(output + 10 * batch_size, bias, mask, 10, rows, last_run, acc10);
+    store_accumulator<T_RELU, T_BIAS>(output + 11 * batch_size, bias, mask, 11, rows, last_run, acc11);
+}
+
+template <bool T_RELU, bool T_BIAS>
+void compute_panel(const float *input,
+                   float *output,
+                   const float *bias,
+                   const float *weights,
+                   uint32_t input_depth,
+                   uint32_t batch_size,
+                   uint32_t batch_begin,
+                   uint32_t batch_end,
+                   uint32_t rows,
+                   bool first_run,
+                   bool last_run)
+{
+    for (auto batch = batch_begin; batch < batch_end; batch += C_batch_block)
+    {
+        const auto items = batch_end - batch;
+        const __mmask16 mask = items >= C_batch_block ? static_cast<__mmask16>(0xffff) : static_cast<__mmask16>((1u << items) - 1);
+        compute_block<T_RELU, T_BIAS>(input + batch, output + batch, bias, weights, input_depth, batch_size, rows, first_run, last_run, mask);
+    }
+}
+} // namespace
+
+void fully_connected_panel_gemm(const float *input,
+                                float *output,
+                                const float *bias,
+                                const float *weights,
+                                uint32_t input_depth,
+                                uint32_t batch_size,
+                                uint32_t batch_begin,
+                                uint32_t batch_end,
+                                uint32_t rows,
+                                bool first_run,
+                                bool last_run,
+                                bool relu)
+{
+    const auto compute = relu ? (bias ? compute_panel<true, true> : compute_panel<true, false>)
+                              : (bias ? compute_panel<false, true> : compute_panel<false, false>);
+    compute(input, output, bias, weights, input_depth, batch_size, batch_begin, batch_end, rows, first_run, last_run);
+}
+
+} // namespace avx512
+} // namespace layer
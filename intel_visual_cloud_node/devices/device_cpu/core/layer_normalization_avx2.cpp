@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>
 #include <thread>
 #include <vector>
+#include <string>
 
 // NN_CODE_UNREACHABLE signal to supporting compiler that specific location in code cannot be reached
 #if defined _MSC_VER 
@@ -458,10 +459,15 @@ void normalization_elementwise_linear_f32::run_multithreaded_1d_normalization_wo
 
 void normalization_elementwise_linear_f32::forward(const nn::nn_workload_data_t<float> *input,
                                                    nn::nn_workload_data_t<float> *output) {
+    const auto batch = input->parent->lengths.t[NN_DATA_COORD_n];
+    const auto image_size = input->parent->buffer_size / static_cast<uint32_t>(sizeof(float)) / batch;
+    const auto view_batch = input->get_length(NN_DATA_COORD_n);
+
+    // Images of smaller batch are prefix of buffer (batch is outermost), they are processed as one flat image.
     nn_workload_data_coords_t in_out_view_coords =
     {
-        input->parent->lengths.t[NN_DATA_COORD_n],
-        input->parent->buffer_size / static_cast<uint32_t>(sizeof(float)) / input->parent->lengths.t[NN_DATA_COORD_n],
+        view_batch == batch ? batch : 1,
+        view_batch == batch ? image_size : image_size * view_batch,
         1,
         1,
         1,
@@ -670,7 +676,8 @@ void unpack_3d_normalization_callback_handle(
 
 void normalization_response_across_maps_f32::run_multithreaded_3d_normalization_work_item(
     const nn::nn_workload_data_t<float> *input, nn::nn_workload_data_t<float> *output) {
-    auto num_hardware_threads = std::min(device->thread_pool.get_num_threads(), max_threads);
+    auto num_hardware_threads = tuning.partition ? std::min(device->thread_pool.get_num_threads(), tuning.partition)
+                                                 : std::min(device->thread_pool.get_num_threads(), max_threads);
 
     const auto item_view_length =
         output->view_end.t[NN_DATA_COORD_y] - output->view_begin.t[NN_DATA_COORD_y] + 1;
@@ -878,6 +885,18 @@ size_t normalization_response_across_maps_f32::get_required_input_w() { return o
 
 size_t normalization_response_across_maps_f32::get_required_input_h() { return output_size_y; }
 
+std::vector<nn_cpu_tuning_t> normalization_response_across_maps_f32::get_tuning_candidates() {
+    const auto num_threads = device->thread_pool.get_num_threads();
+    return nn_cpu_job_count_candidates(num_threads, std::min(num_threads, max_threads));
+}
+
+std::string normalization_response_across_maps_f32::get_tuning_signature() {
+    return "normalization_response_across_maps_f32"
+        ";size=" + std::to_string(output_size_x) + "x" + std::to_string(output_size_y) + "x" + std::to_string(output_size_z) +
+        ";n=" + std::to_string(n) +
+        ";batch=" + std::to_string(batch_size);
+}
+
 namespace normalization_elementwise_linear_f32_impl {
 nn_event_t NN_API_CALL_CONVENTION forward_async(nn_primitive_handle_t handle,
                                                 nn_opaque_data_t *input,
@@ -28,6 +28,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "../api_internal/nn_device_interface_0_internal.h"
+#include "../api_internal/cpu_autotuner.h"
 #include "../../api/nn_primitives_api_0.h"
 #include "helper_zxyn_f32.h"
 
@@ -75,7 +76,8 @@ class normalization_elementwise_linear_f32 : public helper_zxyn_f32::primitive_z
     friend void unpack_1d_normalization_callback_handle(void *void_handle);
 };
 
-class normalization_response_across_maps_f32 : public helper_zxyn_f32::primitive_zxyn_f32_base {
+// Tuning: partition - number of jobs rows are split into (0 - all device threads up to max_threads).
+class normalization_response_across_maps_f32 : public helper_zxyn_f32::primitive_zxyn_f32_base, public nn_cpu_tunable {
   public:
     static normalization_response_across_maps_f32 *create(float alpha,
                                                           float beta,
@@ -89,6 +91,9 @@ class normalization_response_across_maps_f32 : public helper_zxyn_f32::primitive
 
     virtual void forward(const nn::nn_workload_data_t<float> *input, nn::nn_workload_data_t<float> *output);
 
+    virtual std::vector<nn_cpu_tuning_t> get_tuning_candidates() override;
+    virtual std::string get_tuning_signature() override;
+
   protected:
     normalization_response_across_maps_f32(float alpha,
                                            float beta,
@@ -422,7 +422,7 @@ void unpack_pooling_callback_handle(void *void_handle) {
 
 void pooling_f32::forward(const nn::nn_workload_data_t<float> *input, nn::nn_workload_data_t<float> *output)
 {
-    const auto batch = output->parent->lengths.t[NN_DATA_COORD_n];
+    const auto batch = output->get_length(NN_DATA_COORD_n);
 
     const auto num_output_row_items =
         (output->view_end.t[NN_DATA_COORD_y] - output->view_begin.t[NN_DATA_COORD_y] + 1);
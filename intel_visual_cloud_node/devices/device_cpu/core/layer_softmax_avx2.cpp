@@ -520,8 +520,66 @@ void softmax_f32::run_softmax_work_item_batch48(const nn::nn_workload_data_t<flo
     }
 }
 
+// Softmax of 8 batch items, n is the fastest dimension of both buffers.
+// Masked lanes load zeros, so their sums stay finite and are never stored.
+template<bool T_MASKED>
+void softmax_compute_batch_block(
+    const float* input_ptr,
+    float* output_ptr,
+    uint32_t width,
+    uint32_t batch_size,
+    __m256i mask)
+{
+    __m256 acc_sum = _mm256_setzero_ps();
+    for (auto x = 0u; x < width; ++x)
+    {
+        auto input = T_MASKED ? _mm256_maskload_ps(input_ptr + x * batch_size, mask) : _mm256_loadu_ps(input_ptr + x * batch_size);
+        auto result = _inner_mm256_exp_ps(input);
+        if (T_MASKED) _mm256_maskstore_ps(output_ptr + x * batch_size, mask, result);
+        else          _mm256_storeu_ps(output_ptr + x * batch_size, result);
+        acc_sum = _mm256_add_ps(result, acc_sum);
+    }
+
+    acc_sum = _mm256_div_ps(_mm256_set1_ps(1.0f), acc_sum);
+
+    for (auto x = 0u; x < width; ++x)
+    {
+        auto output = T_MASKED ? _mm256_maskload_ps(output_ptr + x * batch_size, mask) : _mm256_loadu_ps(output_ptr + x * batch_size);
+        output = _mm256_mul_ps(output, acc_sum);
+        if (T_MASKED) _mm256_maskstore_ps(output_ptr + x * batch_size, mask, output);
+        else          _mm256_storeu_ps(output_ptr + x * batch_size, output);
+    }
+}
+
+void softmax_f32::run_softmax_work_item_batch(const nn::nn_workload_data_t<float> *input_view,
+                                              nn::nn_workload_data_t<float> *output_view) {
+    const auto batch = output_view->parent->lengths.t[NN_DATA_COORD_n];
+    const auto view_batch = output_view->get_length(NN_DATA_COORD_n);
+    const auto output_width = output_view->view_end.t[NN_DATA_COORD_x] - output_view->view_begin.t[NN_DATA_COORD_x] + 1;
+
+    const auto input_buffer = &static_cast<float*>(input_view->parent->data_buffer)[input_view->view_begin.t[NN_DATA_COORD_x] * batch + input_view->view_begin.t[NN_DATA_COORD_n]];
+    auto output_buffer = &static_cast<float*>(output_view->parent->data_buffer)[output_view->view_begin.t[NN_DATA_COORD_x] * batch + output_view->view_begin.t[NN_DATA_COORD_n]];
+
+    const auto full_batch = view_batch - view_batch % C_batch8_size;
+    for (auto batch_block = 0u; batch_block < full_batch; batch_block += C_batch8_size)
+        softmax_compute_batch_block<false>(input_buffer + batch_block, output_buffer + batch_block, output_width, batch, _mm256_setzero_si256());
+
+    if (full_batch < view_batch)
+    {
+        const auto mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(view_batch - full_batch), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        softmax_compute_batch_block<true>(input_buffer + full_batch, output_buffer + full_batch, output_width, batch, mask);
+    }
+}
+
 void softmax_f32::forward(const nn::nn_workload_data_t<float> *input, nn::nn_workload_data_t<float> *output) {
+    // specialized versions process whole batch of buffer
     auto batch_size = input->parent->lengths.t[NN_DATA_COORD_n];
+    if (output->get_length(NN_DATA_COORD_n) != batch_size)
+    {
+        run_softmax_work_item_batch(input, output);
+        return;
+    }
+
     switch (batch_size)
     {
     case 1:
@@ -534,6 +592,7 @@ void softmax_f32::forward(const nn::nn_workload_data_t<float> *input, nn::nn_wor
         run_softmax_work_item_batch48(input, output);
         break;
     default:
+        run_softmax_work_item_batch(input, output);
         break;
     }
 }
@@ -570,6 +629,10 @@ void wrapper_softmax_work_item(nn_workload_item *const work_item, nn_device_inte
 
     nn::nn_workload_data_t<float>* input_view = new nn::nn_workload_data_t<float>(work_item->input[0]->output->parent->data_buffer, in_out_view_coords, in_out_view_layout);
     nn::nn_workload_data_t<float>* output_view = new nn::nn_workload_data_t<float>(work_item->output->parent->data_buffer, in_out_view_coords, in_out_view_layout);
+    input_view->view_begin.t[NN_DATA_COORD_n] = work_item->input[0]->output->view_begin.t[NN_DATA_COORD_n];
+    input_view->view_end.t[NN_DATA_COORD_n] = work_item->input[0]->output->view_end.t[NN_DATA_COORD_n];
+    output_view->view_begin.t[NN_DATA_COORD_n] = work_item->output->view_begin.t[NN_DATA_COORD_n];
+    output_view->view_end.t[NN_DATA_COORD_n] = work_item->output->view_end.t[NN_DATA_COORD_n];
 
     run_singlethreaded_softmax_work_item(work_item, input_view, output_view);
 
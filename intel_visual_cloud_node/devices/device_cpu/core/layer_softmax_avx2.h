@@ -54,6 +54,8 @@ class softmax_f32 : public nn_primitive_t {
                                        nn::nn_workload_data_t<float> *output_view);
     void run_softmax_work_item_batch48(const nn::nn_workload_data_t<float> *input_view,
                                        nn::nn_workload_data_t<float> *output_view);
+    void run_softmax_work_item_batch(const nn::nn_workload_data_t<float> *input_view,
+                                     nn::nn_workload_data_t<float> *output_view);
 
 protected:
     const size_t num_features, batch_size;
@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* AVX-512 versions of micro-kernels of layers.
+
+Files implementing them (*_avx512.cpp) are the only ones compiled with AVX-512 enabled. Callers run them
+only when device instruction set (nn_device_internal::isa) is NN_CPU_ISA_AVX512, so declarations here use
+plain types and the files include nothing that could be instantiated with AVX-512 code outside of them.
+
+Convolution + pooling computes rows of its tiles with multiply_rows as well, through implicit GEMM run inside
+its own jobs; generated convolution kernel (nn_cpu_jit_code) emits VEX encoding only, so it stays AVX2.
+
+Layers without AVX-512 kernels run their AVX2 code on every device:
+  - softmax & local response normalization (float & int16) make one pass over data with few operations per value,
+    their time is memory bandwidth, not width of registers,
+  - int16 convolution & convolution + pooling keep 8 output feature maps per block of their data layout, which is
+    shared by all int16 layers; 16-lane madd needs blocks of 16,
+  - int16 fully connected layer with batch of 8 - its pairs of inputs fill one AVX2 register.
+*/
+
+namespace layer {
+namespace avx512 {
+
+// Multiplies values of rows by weights of one slice of 16 output feature maps & adds products to accumulators
+// of rows (16 per row, 64-byte aligned); with accumulate false accumulators are overwritten.
+// Values of row r are at values + r * value_stride: positions x depth, consecutive. Weights of position p are at
+// weights + p * position_stride: depth x 16. Computes blocks of 12 rows x 16 outputs in registers.
+void multiply_rows(const float *values,
+                   size_t value_stride,
+                   uint32_t rows,
+                   uint32_t positions,
+                   uint32_t depth,
+                   const float *weights,
+                   size_t position_stride,
+                   float *accumulators,
+                   bool accumulate);
+
+// Fully connected layer, one panel of 12 outputs for batch items [batch_begin, batch_end) over one block of
+// input_depth inputs; same semantics as AVX2 panel in layer_fully_connected_avx2.cpp. Input is input_depth x
+// batch_size, output panel is 12 x batch_size, weights are packed input_depth x 12. Biases (nullptr if they are
+// stored in output before the first block) & relu are applied after the last block.
+void fully_connected_panel_gemm(const float *input,
+                                float *output,
+                                const float *bias,
+                                const float *weights,
+                                uint32_t input_depth,
+                                uint32_t batch_size,
+                                uint32_t batch_begin,
+                                uint32_t batch_end,
+                                uint32_t rows,
+                                bool first_run,
+                                bool last_run,
+                                bool relu);
+
+// Int16 fixed-point fully connected layer for batch of 1: int32 sums of `blocks` blocks of 8 outputs, before
+// activation. Input is num_inputs (even) values; weights of block b are at weights + b * 8 * num_inputs: num_inputs / 2
+// pairs x 8 outputs x 2 inputs, as packed for AVX2 kernel in layer_fully_connected_int16_fixedpoint_avx2.cpp.
+// Sums start from biases (nullptr - zero) & are stored 8 per block.
+void fully_connected_int16_accumulate(const int16_t *input,
+                                      const int16_t *weights,
+                                      uint32_t num_inputs,
+                                      uint32_t blocks,
+                                      const int32_t *bias,
+                                      int32_t *sums);
+
+// Int16 fixed-point fully connected layer for batches of 16, 24 & 32 items: int32 sums of 8 outputs x batch_size items,
+// before activation. Input is num_inputs / 2 pairs x batch_size items x 2 inputs; weights are num_inputs / 2 pairs x
+// 8 outputs x 2 inputs. Sums start from biases (nullptr - zero) & are stored batch_size per output.
+void fully_connected_int16_batch_accumulate(const int16_t *input,
+                                            const int16_t *weights,
+                                            uint32_t num_inputs,
+                                            uint32_t batch_size,
+                                            const int32_t *bias,
+                                            int32_t *sums);
+
+} // namespace avx512
+} // namespace layer
@@ -1318,6 +1318,8 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workflow_compile_0x0_function(
         *( const_cast< NN_WORKLOAD_DATA_TYPE ** >( &( dummy_workload->output_format ) ) ) = new NN_WORKLOAD_DATA_TYPE;
         const_cast< NN_WORKLOAD_DATA_TYPE * >( dummy_workload->output_format )[0]         = output_format[0];
         *const_cast<uint32_t *>(&dummy_workload->batch) = batch;
+        *const_cast<uint64_t *>(&dummy_workload->activation_memory) = 0;
+        *const_cast<uint64_t *>(&dummy_workload->parameter_memory) = 0;
 
         memcpy( gpu_workload->nn_workload_placeholder, dummy_workload, sizeof( nn_workload ) );
         delete[] reinterpret_cast< char * >( dummy_workload );
@@ -2495,6 +2497,25 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_execute_0x0_function(
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+/* waits for execution of workload */
+NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_wait_0x0_function(
+    nn_workload_t      *workload,       /* workload to wait for */
+    NN_API_STATUS      *status          /* status of single execution or NULL for all executions */
+    )
+{
+    if(workload == nullptr)
+    {
+        return NN_API_STATUS_ERROR_INVALID_POINTER;
+    }
+    // Execution is blocking for now, so there is nothing to wait for - just report the result.
+    if( ( status != nullptr ) && ( *status != NN_API_WORK_FINISHED ) )
+    {
+        return *status;
+    }
+    return NN_API_STATUS_OK;
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 /* delete workload */
 NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_delete_0x0_function(
     nn_workload_t       *workload       /* workload to be deleted */
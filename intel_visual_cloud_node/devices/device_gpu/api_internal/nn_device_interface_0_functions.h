@@ -68,6 +68,12 @@ NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_execute_0x0_function(
     NN_API_STATUS      *status          /* asynchronous status */
     );
 
+/* waits for execution of workload */
+NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_wait_0x0_function(
+    nn_workload_t      *workload,       /* workload to wait for */
+    NN_API_STATUS      *status          /* status of single execution or NULL for all executions */
+    );
+
 /* delete workload */
 NN_API_STATUS NN_API_CALL_CONVENTION nn_workload_delete_0x0_function(
     nn_workload_t       *workload       /* workload to be deleted */
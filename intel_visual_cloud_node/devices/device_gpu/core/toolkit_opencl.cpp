@@ -34,6 +34,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <iostream>
 #include <fstream>
 #include <malloc.h>
+#include <cstdlib>
 #include "../../../common/common.h"
 #include "../../api/nn_device_interface_0.h"
 #include "layers_opencl.h"
@@ -100,10 +101,17 @@ ocl_toolkit::ocl_toolkit( void ) : m_constant_mem_size(0), m_local_mem_size(0),
         return true;
     };
 
-    // Get first found GPU Device
+    // NN_OPENCL_DEVICE_TYPE=cpu selects CPU OpenCL implementation instead of GPU (for testing on machines without GPU)
+    cl_device_type device_type = CL_DEVICE_TYPE_GPU;
+    if( const char *requested_type = std::getenv( "NN_OPENCL_DEVICE_TYPE" ) )
+    {
+        if( std::string( requested_type ) == "cpu" ) device_type = CL_DEVICE_TYPE_CPU;
+    }
+
+    // Get first found device of requested type
     for( std::vector< cl::Platform >::iterator plat_it = platforms.begin(); plat_it != platforms.end(); ++plat_it )
     {
-        if( (plat_it->getDevices( CL_DEVICE_TYPE_GPU, &devices ) == CL_SUCCESS) && has_requested_extensions(devices[0]) )
+        if( (plat_it->getDevices( device_type, &devices ) == CL_SUCCESS) && has_requested_extensions(devices[0]) )
         {
             // Store chosen device for further usage
             m_device = devices[0];
@@ -114,7 +122,7 @@ ocl_toolkit::ocl_toolkit( void ) : m_constant_mem_size(0), m_local_mem_size(0),
 
     if( m_device() == nullptr )
     {
-        THROW_ERROR( CL_DEVICE_NOT_FOUND, "Error: No suitable GPU OpenCL devices found!\n" );
+        THROW_ERROR( CL_DEVICE_NOT_FOUND, "Error: No suitable OpenCL devices found!\n" );
     }
 
     // create CL context
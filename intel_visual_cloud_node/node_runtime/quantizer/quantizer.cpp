@@ -0,0 +1,677 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "quantizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace
+{
+const int32_t C_max_fraction = 15;
+const float C_int16_limit = 32767.0f;
+const float C_lrn_input_limit = 16383.0f;           // sum of 5 squares of input has to fit int32
+const float C_accumulator_limit = 1073741824.0f;    // 2^30, one bit of headroom for partial sums
+
+// Largest magnitude & largest positive value of result.
+struct range_t
+{
+    float magnitude;
+    float positive;
+};
+
+// Number of bits range can be shifted left by and stay within limit.
+int32_t headroom(float range, float limit)
+{
+    if (!(range > 0.0f)) return std::numeric_limits<int16_t>::max();
+    return static_cast<int32_t>(std::floor(std::log2(limit / range)));
+}
+
+// Largest fraction (not larger than C_max_fraction) that keeps range within limit.
+int32_t fraction_for(float range, float limit)
+{
+    return std::min(C_max_fraction, headroom(range, limit));
+}
+
+template <typename T_type> T_type saturate(double value)
+{
+    value = std::round(value);
+    value = std::max<double>(value, std::numeric_limits<T_type>::min());
+    value = std::min<double>(value, std::numeric_limits<T_type>::max());
+    return static_cast<T_type>(value);
+}
+
+size_t count_of(const nn_data_t *data)
+{
+    return nn_data_buffer_size_ptr(1, data->dimension, data->size);
+}
+
+float max_magnitude(const nn_data_t *data)
+{
+    auto buffer = static_cast<const float *>(data->buffer);
+    float result = 0.0f;
+    for (size_t index = 0, count = count_of(data); index < count; ++index)
+        result = std::max(result, std::fabs(buffer[index]));
+    return result;
+}
+
+void update_range(range_t &range, const nn_data_t *data)
+{
+    auto buffer = static_cast<const float *>(data->buffer);
+    for (size_t index = 0, count = count_of(data); index < count; ++index)
+    {
+        range.magnitude = std::max(range.magnitude, std::fabs(buffer[index]));
+        range.positive = std::max(range.positive, buffer[index]);
+    }
+}
+
+std::string name_of(const nn_workflow_item_t *item)
+{
+    return item->name ? item->name : "unnamed";
+}
+
+bool has_relu(const nn_workflow_item_t *item)
+{
+    switch (item->type)
+    {
+    case NN_WORK_ITEM_TYPE_CONVOLUTION:
+        return item->arguments.forward_convolution.activation.function == NN_ACTIVATION_FUNCTION_RELU;
+    case NN_WORK_ITEM_TYPE_FULLY_CONNECTED:
+        return item->arguments.forward_fully_connected.activation.function == NN_ACTIVATION_FUNCTION_RELU;
+    default:
+        return false;
+    }
+}
+
+NN_ACTIVATION_FUNCTION &activation_of(nn_workflow_item_t *item)
+{
+    return item->type == NN_WORK_ITEM_TYPE_CONVOLUTION ? item->arguments.forward_convolution.activation.function
+                                                       : item->arguments.forward_fully_connected.activation.function;
+}
+
+// Fills arguments shared by fixed point convolution & fully connected layers.
+template <typename T_arguments>
+void set_layer_arguments(T_arguments &arguments,
+                         nn_data_t *weights,
+                         nn_data_t *biases,
+                         const nn_argument_activation_t &activation,
+                         int32_t accumulator_fraction,
+                         int32_t output_fraction)
+{
+    arguments.weights = weights;
+    arguments.biases = biases;
+    arguments.activation.basic_arguments = activation;
+    arguments.activation.fractions.accumulator = static_cast<uint16_t>(accumulator_fraction);
+    arguments.activation.fractions.output = static_cast<uint16_t>(output_fraction);
+}
+
+// Items reachable from input of workflow, each one after all of its inputs.
+std::vector<nn_workflow_item_t *> sort_items(nn_workflow_t *workflow)
+{
+    std::vector<nn_workflow_item_t *> result;
+    std::map<nn_workflow_item_t *, uint32_t> inputs_left;
+    std::vector<nn_workflow_item_t *> ready(1, workflow->input[0]);
+    while (!ready.empty())
+    {
+        auto item = ready.back();
+        ready.pop_back();
+        result.push_back(item);
+        for (auto index = 0u; index < item->use_count; ++index)
+        {
+            auto use = item->use[index];
+            auto found = inputs_left.find(use);
+            if (found == inputs_left.end()) found = inputs_left.emplace(use, use->input_count).first;
+            if (--found->second == 0) ready.push_back(use);
+        }
+    }
+    return result;
+}
+
+// Format of workload output that returns result of item as is.
+NN_WORKLOAD_DATA_TYPE output_format_of(const nn_workflow_item_t *item)
+{
+    return item->output_format.format >= NN_DATA_FORMAT_3D ? NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH
+                                                           : NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH;
+}
+
+// Buffer for batch of results of item in given format of workload output.
+std::unique_ptr<nn::data<float>> create_output_buffer(NN_WORKLOAD_DATA_TYPE output_format,
+                                                      const nn_output_format_t &format,
+                                                      uint32_t batch)
+{
+    const size_t x = format.format_1d.size[0];
+    const size_t y = format.format >= NN_DATA_FORMAT_2D ? format.format_2d.size[1] : 1;
+    const size_t z = format.format >= NN_DATA_FORMAT_3D ? format.format_3d.size[2] : 1;
+    switch (output_format)
+    {
+    case NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH:
+        return std::unique_ptr<nn::data<float>>(new nn::data<float>(x * y * z, batch));
+    case NN_WORKLOAD_DATA_TYPE_F32_3D_BATCH:
+        return std::unique_ptr<nn::data<float>>(new nn::data<float>(x, y, z, batch));
+    case NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH:
+        return std::unique_ptr<nn::data<float>>(new nn::data<float>(z, x, y, batch));
+    default:
+        throw std::invalid_argument("quantizer supports batched float workflow outputs only");
+    }
+}
+
+// Workload compiled from workflow, deleted with this object.
+class scoped_workload
+{
+public:
+    scoped_workload(nn_device_interface_0_t &device_interface,
+                    nn_workflow_t *workflow,
+                    NN_WORKLOAD_DATA_TYPE input_format,
+                    NN_WORKLOAD_DATA_TYPE output_format,
+                    uint32_t batch)
+        : device_interface(device_interface)
+        , workload(nullptr)
+    {
+        if (device_interface.workflow_compile_function(
+                &workload, device_interface.device, workflow, &input_format, &output_format, batch) != NN_API_STATUS_OK ||
+            !workload)
+            throw std::runtime_error("workflow compilation failed");
+    }
+
+    ~scoped_workload()
+    {
+        device_interface.workload_delete_function(workload);
+    }
+
+    // Executes workload on calibration set batch after batch; consume(output) is called after each one.
+    template <typename T_consume> void run(nn_data_t *calibration, nn::data<float> &output, T_consume consume)
+    {
+        const auto dimension = calibration->dimension;
+        std::vector<size_t> size(calibration->size, calibration->size + dimension);
+        const auto samples = size.back();
+        const auto sample_size = count_of(calibration) / samples;
+        size.back() = workload->batch;
+        for (size_t first = 0; first < samples; first += workload->batch)
+        {
+            nn::data<float> input(static_cast<float *>(calibration->buffer) + first * sample_size, size.data(), dimension);
+            void *inputs[] = {&input}, *outputs[] = {&output};
+            NN_API_STATUS status;
+            if (device_interface.workload_execute_function(workload, inputs, outputs, &status) != NN_API_STATUS_OK ||
+                device_interface.workload_wait_function(workload, &status) != NN_API_STATUS_OK)
+                throw std::runtime_error("workload execution failed");
+            consume(output);
+        }
+    }
+
+    nn_device_interface_0_t &device_interface;
+    nn_workload_t *workload;
+
+private:
+    scoped_workload(const scoped_workload &) = delete;
+    scoped_workload &operator=(const scoped_workload &) = delete;
+};
+} // namespace
+
+// Workflow together with items created for it. Items are deleted in reverse order of creation, so each one is
+// deleted after all of its uses.
+class nn_owned_workflow
+{
+public:
+    nn_owned_workflow(nn_device_interface_0_t &device_interface)
+        : device_interface(device_interface)
+        , workflow(nullptr)
+    {
+    }
+
+    ~nn_owned_workflow()
+    {
+        for (auto item = items.rbegin(); item != items.rend(); ++item) device_interface.workflow_item_delete_function(*item);
+        if (workflow) device_interface.workflow_delete_function(workflow);
+    }
+
+    nn_workflow_item_t *create(NN_WORK_ITEM_TYPE type,
+                               const nn_output_format_t &format,
+                               std::vector<nn_workflow_item_t *> inputs,
+                               const char *name)
+    {
+        nn_workflow_item_t *item = nullptr;
+        if (device_interface.workflow_item_create_function(
+                &item, static_cast<uint32_t>(inputs.size()), inputs.empty() ? nullptr : inputs.data()) != NN_API_STATUS_OK)
+            throw std::bad_alloc();
+        items.push_back(item);
+        item->type = type;
+        item->output_format = format;
+        item->name = name;
+        return item;
+    }
+
+    // Copies item together with all items it depends on; items copied before are reused.
+    nn_workflow_item_t *copy(nn_workflow_item_t *item, std::map<nn_workflow_item_t *, nn_workflow_item_t *> &copies)
+    {
+        auto found = copies.find(item);
+        if (found != copies.end()) return found->second;
+        std::vector<nn_workflow_item_t *> inputs;
+        for (auto index = 0u; index < item->input_count; ++index) inputs.push_back(copy(item->input[index], copies));
+        auto result = create(item->type, item->output_format, inputs, item->name);
+        result->arguments = item->arguments;
+        copies[item] = result;
+        return result;
+    }
+
+    nn_workflow_t *finish(nn_workflow_item_t *input, nn_workflow_item_t *output)
+    {
+        if (device_interface.workflow_create_function(&workflow, 1, 1) != NN_API_STATUS_OK) throw std::bad_alloc();
+        workflow->input[0] = input;
+        workflow->output[0] = output;
+        return workflow;
+    }
+
+private:
+    nn_owned_workflow(const nn_owned_workflow &) = delete;
+    nn_owned_workflow &operator=(const nn_owned_workflow &) = delete;
+
+    nn_device_interface_0_t &device_interface;
+    nn_workflow_t *workflow;
+    std::vector<nn_workflow_item_t *> items;
+};
+
+namespace
+{
+// Range of result of item over calibration set. Convolutions & fully connected layers are observed without
+// activation, so that magnitude is the range of their accumulators.
+range_t observe(nn_device_interface_0_t &device_interface,
+                nn_workflow_t *workflow,
+                nn_workflow_item_t *item,
+                NN_WORKLOAD_DATA_TYPE input_format,
+                nn_data_t *calibration,
+                uint32_t batch)
+{
+    range_t result = {0.0f, 0.0f};
+    if (item->type == NN_WORK_ITEM_TYPE_INPUT)
+    {
+        update_range(result, calibration);
+        return result;
+    }
+
+    // workflow that ends at observed item
+    nn_owned_workflow prefix(device_interface);
+    std::map<nn_workflow_item_t *, nn_workflow_item_t *> copies;
+    auto last = prefix.copy(item, copies);
+    if (last->type == NN_WORK_ITEM_TYPE_CONVOLUTION || last->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED)
+        activation_of(last) = NN_ACTIVATION_FUNCTION_NONE;
+    auto output = prefix.create(NN_WORK_ITEM_TYPE_OUTPUT, item->output_format, {last}, "quantizer_output");
+    output->arguments.output.index = 0;
+    auto prefix_workflow = prefix.finish(copies.at(workflow->input[0]), output);
+
+    const auto output_format = output_format_of(item);
+    scoped_workload workload(device_interface, prefix_workflow, input_format, output_format, batch);
+    auto buffer = create_output_buffer(output_format, item->output_format, batch);
+    workload.run(calibration, *buffer, [&result](nn::data<float> &output) { update_range(result, &output); });
+    return result;
+}
+} // namespace
+
+nn_quantizer::nn_quantizer(nn_device_interface_0_t &device_interface,
+                           nn_workflow_t *float_workflow,
+                           NN_WORKLOAD_DATA_TYPE input_format,
+                           NN_WORKLOAD_DATA_TYPE output_format,
+                           nn_data_t *calibration,
+                           uint32_t batch)
+    : owned(new nn_owned_workflow(device_interface))
+    , workflow(nullptr)
+    , report()
+{
+    if (!float_workflow || float_workflow->input_count != 1 || float_workflow->output_count != 1)
+        throw std::invalid_argument("quantizer requires workflow with single input & output");
+    if (!calibration || !calibration->buffer || calibration->dimension < 2 || calibration->sizeof_value != sizeof(float))
+        throw std::invalid_argument("quantizer requires calibration samples in float");
+    const auto samples = calibration->size[calibration->dimension - 1];
+    if (batch == 0 || samples == 0 || samples % batch != 0)
+        throw std::invalid_argument("number of calibration samples has to be multiple of batch");
+
+    const auto items = sort_items(float_workflow);
+
+    // decide which results are kept in fixed point; fully connected layers without activation produce int32 that
+    // only softmax can consume
+    std::map<nn_workflow_item_t *, bool> fixed;
+    auto is_int32 = [](nn_workflow_item_t *item) {
+        return item->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED &&
+               item->arguments.forward_fully_connected.activation.function == NN_ACTIVATION_FUNCTION_NONE;
+    };
+    for (auto item : items)
+    {
+        auto unsupported = [item](const char *reason) {
+            return std::invalid_argument("cannot quantize '" + name_of(item) + "': " + reason);
+        };
+        bool fixed_input = false, float_input = false;
+        for (auto index = 0u; index < item->input_count; ++index)
+        {
+            (fixed[item->input[index]] ? fixed_input : float_input) = true;
+            if (is_int32(item->input[index]) && item->type != NN_WORK_ITEM_TYPE_SOFTMAX)
+                throw unsupported("only softmax can follow fully connected layer without activation");
+        }
+
+        switch (item->type)
+        {
+        case NN_WORK_ITEM_TYPE_INPUT:
+        case NN_WORK_ITEM_TYPE_ARITHMETIC:
+        case NN_WORK_ITEM_TYPE_OUTPUT:
+            if (fixed_input) throw unsupported("it has no fixed point counterpart");
+            fixed[item] = false;
+            break;
+        case NN_WORK_ITEM_TYPE_VIEW:
+        case NN_WORK_ITEM_TYPE_MERGE:
+            if (fixed_input && float_input) throw unsupported("inputs are partly in fixed point");
+            fixed[item] = fixed_input;
+            break;
+        case NN_WORK_ITEM_TYPE_CONVOLUTION:
+        case NN_WORK_ITEM_TYPE_FULLY_CONNECTED: {
+            const auto activation = activation_of(item);
+            if (activation != NN_ACTIVATION_FUNCTION_NONE && activation != NN_ACTIVATION_FUNCTION_RELU)
+                throw unsupported("only ReLU activation is supported");
+            const auto outputs = item->type == NN_WORK_ITEM_TYPE_CONVOLUTION
+                                     ? item->arguments.forward_convolution.weights->size[3]
+                                     : item->arguments.forward_fully_connected.weights->size[
+                                           item->arguments.forward_fully_connected.weights->dimension - 1];
+            if (outputs % (item->type == NN_WORK_ITEM_TYPE_CONVOLUTION ? 32 : 8) != 0)
+                throw unsupported("fixed point kernels need 32 output maps or 8 outputs at a time");
+            fixed[item] = true;
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_POOLING:
+            if (item->arguments.forward_pooling.mode != NN_POOLING_MODE_MAX)
+                throw unsupported("only max pooling is supported");
+            fixed[item] = true;
+            break;
+        case NN_WORK_ITEM_TYPE_NORMALIZATION: {
+            const auto &normalization = item->arguments.forward_normalization.normalization;
+            if (normalization.mode != NN_NORMALIZATION_MODE_RESPONSE_ACROSS_MAPS || normalization.n != 5 ||
+                normalization.beta != 0.75f)
+                throw unsupported("only response normalization across 5 maps with beta 0.75 is supported");
+            fixed[item] = true;
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_SOFTMAX:
+            if (item->input_count != 1 || !is_int32(item->input[0]))
+                throw unsupported("softmax has to follow fully connected layer without activation");
+            fixed[item] = false;
+            break;
+        default:
+            throw unsupported("it has no fixed point counterpart");
+        }
+    }
+
+    // float results consumed by fixed point items are converted; layers are observed to get range of their
+    // results (& accumulators)
+    std::map<nn_workflow_item_t *, range_t> ranges;
+    std::map<nn_workflow_item_t *, bool> converted;
+    for (auto item : items)
+    {
+        for (auto index = 0u; index < item->input_count; ++index)
+            if (fixed[item] && !fixed[item->input[index]]) converted[item->input[index]] = true;
+    }
+    for (auto item : items)
+    {
+        if (converted[item] || item->type == NN_WORK_ITEM_TYPE_CONVOLUTION ||
+            item->type == NN_WORK_ITEM_TYPE_FULLY_CONNECTED || item->type == NN_WORK_ITEM_TYPE_NORMALIZATION)
+            ranges[item] = observe(device_interface, float_workflow, item, input_format, calibration, batch);
+    }
+
+    // int16 results that share fraction are grouped: converted float results, results of layers & items passing
+    // their input through (views, max pooling, merges)
+    std::map<nn_workflow_item_t *, size_t> node;
+    std::vector<size_t> parent;
+    std::vector<float> group_range, group_limit;
+    auto find = [&parent](size_t index) {
+        while (parent[index] != index) index = parent[index] = parent[parent[index]];
+        return index;
+    };
+    auto unite = [&](size_t first, size_t second) {
+        first = find(first);
+        second = find(second);
+        if (first == second) return;
+        parent[second] = first;
+        group_range[first] = std::max(group_range[first], group_range[second]);
+        group_limit[first] = std::min(group_limit[first], group_limit[second]);
+    };
+    auto add_node = [&](nn_workflow_item_t *item, float range) {
+        node[item] = parent.size();
+        parent.push_back(parent.size());
+        group_range.push_back(range);
+        group_limit.push_back(C_int16_limit);
+    };
+    for (auto item : items)
+    {
+        if (converted[item])
+            add_node(item, ranges[item].magnitude);
+        else if (fixed[item] && !is_int32(item))
+        {
+            const auto &range = ranges[item];
+            add_node(item, has_relu(item) ? range.positive : range.magnitude);
+            if (item->type == NN_WORK_ITEM_TYPE_POOLING || item->type == NN_WORK_ITEM_TYPE_VIEW ||
+                item->type == NN_WORK_ITEM_TYPE_MERGE)
+                for (auto index = 0u; index < item->input_count; ++index) unite(node[item->input[index]], node[item]);
+            if (item->type == NN_WORK_ITEM_TYPE_NORMALIZATION)
+            {
+                auto input = find(node[item->input[0]]);
+                group_limit[input] = std::min(group_limit[input], C_lrn_input_limit);
+            }
+        }
+    }
+    auto fraction_of = [&](nn_workflow_item_t *item) {
+        // fixed point layers take non-negative output fractions only; larger results saturate
+        const auto group = find(node.at(item));
+        return std::max(0, fraction_for(group_range[group], group_limit[group]));
+    };
+
+    // fixed point workflow
+    std::map<nn_workflow_item_t *, nn_workflow_item_t *> copies, conversions;
+    std::map<nn_workflow_item_t *, int32_t> int32_fraction;
+    auto add_layer = [this](nn_workflow_item_t *item, NN_WORK_ITEM_TYPE type, float range, int32_t input_fraction,
+                            int32_t weights_fraction, int32_t output_fraction) {
+        report.layers.push_back(
+            nn_quantized_layer_t{name_of(item), type, range, input_fraction, weights_fraction, output_fraction});
+    };
+    // weights get largest fraction that fits int16 and keeps accumulator within its limit
+    auto quantize_weights = [&](nn_workflow_item_t *item, nn_data_t *float_weights, nn_data_t *float_biases,
+                                int32_t input_fraction, int32_t &accumulator_fraction) {
+        const auto weights_fraction =
+            std::max(-input_fraction,
+                     std::min(fraction_for(max_magnitude(float_weights), C_int16_limit),
+                              headroom(ranges[item].magnitude, C_accumulator_limit) - input_fraction));
+        accumulator_fraction = input_fraction + weights_fraction;
+
+        weights.emplace_back(new nn::data<int16_t>(float_weights->size, float_weights->dimension));
+        auto source = static_cast<const float *>(float_weights->buffer);
+        auto target = static_cast<int16_t *>(weights.back()->buffer);
+        for (size_t index = 0, count = count_of(float_weights); index < count; ++index)
+            target[index] = saturate<int16_t>(std::ldexp(static_cast<double>(source[index]), weights_fraction));
+
+        const auto outputs = float_weights->size[float_weights->dimension - 1];
+        biases.emplace_back(new nn::data<int32_t>(outputs));
+        for (size_t index = 0; index < outputs; ++index)
+            biases.back()->at(index) =
+                float_biases ? saturate<int32_t>(std::ldexp(static_cast<double>(static_cast<const float *>(
+                                                                float_biases->buffer)[index]),
+                                                            accumulator_fraction))
+                             : 0;
+        return weights_fraction;
+    };
+    auto input_of = [&](nn_workflow_item_t *item, uint32_t index) {
+        auto input = item->input[index];
+        if (fixed[input] || !fixed[item]) return copies.at(input);
+        auto &conversion = conversions[input];
+        if (!conversion)
+        {
+            conversion = owned->create(NN_WORK_ITEM_TYPE_CONVERT_FLOAT_TO_INT16_FIXEDPOINT, input->output_format,
+                                       {copies.at(input)}, input->name);
+            conversion->arguments.forward_convert_float_to_int16_fixedpoint.output_fraction =
+                static_cast<int8_t>(fraction_of(input));
+            add_layer(input, NN_WORK_ITEM_TYPE_CONVERT_FLOAT_TO_INT16_FIXEDPOINT, ranges[input].magnitude, 0, 0,
+                      fraction_of(input));
+        }
+        return conversion;
+    };
+    for (auto item : items)
+    {
+        std::vector<nn_workflow_item_t *> inputs;
+        for (auto index = 0u; index < item->input_count; ++index) inputs.push_back(input_of(item, index));
+        const auto input_fraction = item->input_count && fixed[item] ? fraction_of(item->input[0]) : 0;
+
+        if (!fixed[item] && item->type != NN_WORK_ITEM_TYPE_SOFTMAX)
+        {
+            copies[item] = owned->create(item->type, item->output_format, inputs, item->name);
+            copies[item]->arguments = item->arguments;
+            continue;
+        }
+
+        switch (item->type)
+        {
+        case NN_WORK_ITEM_TYPE_CONVOLUTION: {
+            const auto &source = item->arguments.forward_convolution;
+            auto copy = owned->create(NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT, item->output_format, inputs, item->name);
+            auto &arguments = copy->arguments.forward_convolution_int16_fixedpoint;
+            int32_t accumulator_fraction;
+            const auto weights_fraction =
+                quantize_weights(item, source.weights, source.biases, input_fraction, accumulator_fraction);
+            set_layer_arguments(arguments, weights.back().get(), biases.back().get(), source.activation,
+                                accumulator_fraction, fraction_of(item));
+            arguments.padding = source.padding;
+            std::copy(source.stride, source.stride + 2, arguments.stride);
+            std::copy(source.center_offset, source.center_offset + 2, arguments.center_offset);
+            copies[item] = copy;
+            add_layer(item, copy->type, group_range[find(node[item])], input_fraction, weights_fraction, fraction_of(item));
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_FULLY_CONNECTED: {
+            const auto &source = item->arguments.forward_fully_connected;
+            const auto int32 = is_int32(item);
+            auto copy = owned->create(int32 ? NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN
+                                            : NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN,
+                                      item->output_format, inputs, item->name);
+            int32_t accumulator_fraction;
+            const auto weights_fraction =
+                quantize_weights(item, source.weights, source.biases, input_fraction, accumulator_fraction);
+            // int32 results keep fraction of accumulator
+            const auto output_fraction = int32 ? accumulator_fraction : fraction_of(item);
+            if (int32)
+                set_layer_arguments(copy->arguments.fully_connected_forward_i16qn_i32qn, weights.back().get(),
+                                    biases.back().get(), source.activation, accumulator_fraction, output_fraction);
+            else
+                set_layer_arguments(copy->arguments.fully_connected_forward_i16qn_i16qn, weights.back().get(),
+                                    biases.back().get(), source.activation, accumulator_fraction, output_fraction);
+            if (int32) int32_fraction[item] = output_fraction;
+            copies[item] = copy;
+            add_layer(item, copy->type, int32 ? ranges[item].magnitude : group_range[find(node[item])], input_fraction,
+                      weights_fraction, output_fraction);
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_POOLING: {
+            const auto &source = item->arguments.forward_pooling;
+            auto copy = owned->create(NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT, item->output_format, inputs, item->name);
+            std::copy(source.size, source.size + 2, copy->arguments.forward_pooling_fixedpoint.pool_size);
+            std::copy(source.stride, source.stride + 2, copy->arguments.forward_pooling_fixedpoint.pool_stride);
+            copies[item] = copy;
+            add_layer(item, copy->type, group_range[find(node[item])], input_fraction, 0, fraction_of(item));
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_NORMALIZATION: {
+            const auto &source = item->arguments.forward_normalization.normalization;
+            auto copy = owned->create(
+                NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN, item->output_format, inputs, item->name);
+            auto &arguments = copy->arguments.normalization_response_across_maps_forward_i16qn;
+            arguments.alpha = source.alpha;
+            arguments.beta = source.beta;
+            arguments.k = source.k;
+            arguments.n = source.n;
+            arguments.fractions.input = static_cast<uint16_t>(input_fraction);
+            arguments.fractions.output = static_cast<uint16_t>(fraction_of(item));
+            copies[item] = copy;
+            add_layer(item, copy->type, group_range[find(node[item])], input_fraction, 0, fraction_of(item));
+            break;
+        }
+        case NN_WORK_ITEM_TYPE_SOFTMAX: {
+            auto copy = owned->create(NN_WORK_ITEM_TYPE_SOFTMAX_FIXEDPOINT, item->output_format, inputs, item->name);
+            const auto fraction = int32_fraction.at(item->input[0]);
+            copy->arguments.forward_softmax_fixedpoint.input_fraction = static_cast<int8_t>(fraction);
+            copies[item] = copy;
+            add_layer(item, copy->type, 1.0f, fraction, 0, 0);
+            break;
+        }
+        default: // views & merges
+            copies[item] = owned->create(item->type, item->output_format, inputs, item->name);
+            copies[item]->arguments = item->arguments;
+            add_layer(item, item->type, group_range[find(node[item])], input_fraction, 0, fraction_of(item));
+        }
+    }
+    workflow = owned->finish(copies.at(float_workflow->input[0]), copies.at(float_workflow->output[0]));
+
+    // accuracy of fixed point workflow against float one
+    scoped_workload float_workload(device_interface, float_workflow, input_format, output_format, batch);
+    scoped_workload fixed_workload(device_interface, workflow, input_format, output_format, batch);
+    report.float_parameter_memory = float_workload.workload->parameter_memory;
+    report.float_activation_memory = float_workload.workload->activation_memory;
+    report.fixed_parameter_memory = fixed_workload.workload->parameter_memory;
+    report.fixed_activation_memory = fixed_workload.workload->activation_memory;
+
+    const auto &result_format = float_workflow->output[0]->output_format;
+    auto float_output = create_output_buffer(output_format, result_format, batch);
+    auto fixed_output = create_output_buffer(output_format, result_format, batch);
+    std::vector<float> float_results;
+    float_workload.run(calibration, *float_output, [&float_results](nn::data<float> &output) {
+        auto buffer = static_cast<const float *>(output.buffer);
+        float_results.insert(float_results.end(), buffer, buffer + output.count());
+    });
+
+    const auto sample_size = float_output->count() / batch;
+    double error_sum = 0.0;
+    uint32_t agreements = 0;
+    auto expected = float_results.cbegin();
+    fixed_workload.run(calibration, *fixed_output, [&](nn::data<float> &output) {
+        auto buffer = static_cast<const float *>(output.buffer);
+        for (size_t sample = 0; sample < batch; ++sample, expected += sample_size)
+        {
+            auto actual = buffer + sample * sample_size;
+            for (size_t index = 0; index < sample_size; ++index)
+            {
+                const auto error = std::fabs(actual[index] - expected[index]);
+                report.max_error = std::max(report.max_error, error);
+                error_sum += error;
+            }
+            if (std::max_element(actual, actual + sample_size) - actual ==
+                std::max_element(expected, expected + sample_size) - expected)
+                ++agreements;
+        }
+    });
+    report.samples = static_cast<uint32_t>(samples);
+    report.mean_error = static_cast<float>(error_sum / (samples * sample_size));
+    report.top1_agreement = static_cast<float>(agreements) / samples;
+}
+
+nn_quantizer::~nn_quantizer()
+{
+    // items referring to weights go first
+    owned.reset();
+}
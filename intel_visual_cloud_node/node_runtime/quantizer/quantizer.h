@@ -0,0 +1,115 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "../../devices/api/nn_device_interface_0.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* This file contains post-training quantization of float workflows to int16 fixed point.
+
+Fixed point work items (*_INT16_FIXEDPOINT, *_I16QN_*) halve size of weights & intermediate results, but each needs
+number of fractional bits of its inputs, weights & outputs. Quantizer derives them from calibration set instead of
+having them chosen by hand:
+
+  - float workflow is executed on calibration samples, once per layer with output attached to that layer (and its
+    activation removed), which gives largest magnitude of every intermediate result & accumulator,
+  - every result gets largest fraction its range fits int16 in; results that must share representation (inputs of
+    merge, outputs of views & max pooling) share fraction, inputs of response normalization keep headroom for sums
+    of squares,
+  - weights get largest fraction that fits both int16 and keeps accumulator (input fraction + weight fraction)
+    within int32; biases are stored in accumulator fraction,
+  - graph is rebuilt with fixed point items: convolution, max pooling, response normalization across maps, fully
+    connected (with ReLU, or without activation when followed by softmax) & softmax, while views & merges are kept;
+    float items in front of the first fixed point one (input, arithmetic) stay float & their result is converted
+    to int16 by CONVERT_FLOAT_TO_INT16_FIXEDPOINT,
+  - both workflows are executed on calibration set and their outputs compared.
+
+Items without fixed point counterpart past the converted part of the graph make quantization throw
+std::invalid_argument.
+*/
+
+struct nn_quantized_layer_t
+{
+    std::string name;                   // name of float item
+    NN_WORK_ITEM_TYPE type;             // fixed point item it was replaced with
+    float range;                        // largest magnitude of result over calibration set
+    int32_t input_fraction;             // fractional bits of input
+    int32_t weights_fraction;           // fractional bits of weights (0 for layers without weights)
+    int32_t output_fraction;            // fractional bits of result
+};
+
+struct nn_quantization_report_t
+{
+    std::vector<nn_quantized_layer_t> layers;   // in order of execution
+    uint32_t samples;                   // calibration samples both workflows were compared on
+    float max_error;                    // largest absolute difference of outputs
+    float mean_error;                   // mean absolute difference of outputs
+    float top1_agreement;               // part of samples for which largest output is at the same position
+    uint64_t float_parameter_memory;    // memory of weights & intermediate results of workloads compiled from both
+    uint64_t fixed_parameter_memory;    // workflows (0 if device does not report them)
+    uint64_t float_activation_memory;
+    uint64_t fixed_activation_memory;
+};
+
+class nn_owned_workflow;
+
+class nn_quantizer
+{
+public:
+    // Quantizes workflow with single input & output. Calibration holds float samples in input_format with samples
+    // as the outermost dimension; their count must be multiple of batch workloads are compiled for.
+    nn_quantizer(nn_device_interface_0_t &device_interface,
+                 nn_workflow_t *workflow,
+                 NN_WORKLOAD_DATA_TYPE input_format,
+                 NN_WORKLOAD_DATA_TYPE output_format,
+                 nn_data_t *calibration,
+                 uint32_t batch);
+
+    // Deletes fixed point workflow together with its weights.
+    ~nn_quantizer();
+
+    // Fixed point workflow; it takes & returns data in the same formats as float one.
+    nn_workflow_t *get_workflow() { return workflow; }
+
+    const nn_quantization_report_t &get_report() { return report; }
+
+private:
+    nn_quantizer(const nn_quantizer &) = delete;
+    nn_quantizer &operator=(const nn_quantizer &) = delete;
+
+    std::unique_ptr<nn_owned_workflow> owned;
+    nn_workflow_t *workflow;
+    std::vector<std::unique_ptr<nn::data<int16_t>>> weights;
+    std::vector<std::unique_ptr<nn::data<int32_t>>> biases;
+    nn_quantization_report_t report;
+};
@@ -24,3 +24,176 @@ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
 OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
+#include "resource_manager.h"
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+uint64_t workload_memory(const nn_workload_t *workload)
+{
+    return workload->parameter_memory + workload->activation_memory;
+}
+} // namespace
+
+nn_resource_manager::nn_resource_manager(uint32_t cores, uint64_t host_memory)
+    : cores(cores ? cores : std::max(1u, std::thread::hardware_concurrency()))
+{
+    memories.push_back(memory_t{host_memory, 0});
+}
+
+nn_resource_manager::~nn_resource_manager()
+{
+}
+
+void nn_resource_manager::add_device(nn_device_interface_0_t &device_interface, uint64_t device_memory)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &device : devices)
+        if (device.device_interface->device == device_interface.device)
+            throw std::invalid_argument("nn_resource_manager: device already registered");
+
+    size_t memory = 0;
+    if (device_memory != 0)
+    {
+        memory = memories.size();
+        memories.push_back(memory_t{device_memory, 0});
+    }
+
+    const bool cpu = device_memory == 0;
+    devices.push_back(device_t{&device_interface, memory, cpu, 0, 0});
+    if (cpu)
+        split_cores();
+}
+
+void nn_resource_manager::remove_device(nn_device_interface_0_t &device_interface)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &device = find_device(device_interface.device);
+    if (device.workloads != 0)
+        throw std::invalid_argument("nn_resource_manager: device still has admitted workloads");
+    for (auto &request : queue)
+        if (request.workload->device == device_interface.device)
+            throw std::invalid_argument("nn_resource_manager: device still has queued workloads");
+
+    // budget of device memory stays in place (unused), so indices of other devices remain valid
+    devices.erase(devices.begin() + (&device - devices.data()));
+}
+
+std::future<void> nn_resource_manager::admit(nn_workload_t *workload)
+{
+    if (!workload)
+        throw std::invalid_argument("nn_resource_manager: null workload");
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &device = find_device(workload->device);
+    if (admitted.count(workload) ||
+        std::any_of(queue.begin(), queue.end(), [workload](const request_t &request) { return request.workload == workload; }))
+        throw std::invalid_argument("nn_resource_manager: workload already admitted");
+    if (workload_memory(workload) > memories[device.memory].budget)
+        throw std::invalid_argument("nn_resource_manager: workload does not fit in memory budget");
+
+    queue.push_back(request_t{workload, std::promise<void>()});
+    auto result = queue.back().admitted.get_future();
+    admit_queued();
+    return result;
+}
+
+void nn_resource_manager::release(nn_workload_t *workload)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = admitted.find(workload);
+    if (found == admitted.end())
+        throw std::invalid_argument("nn_resource_manager: workload is not admitted");
+
+    auto &device = find_device(workload->device);
+    memories[device.memory].committed -= found->second;
+    admitted.erase(found);
+    if (--device.workloads == 0 && device.cpu)
+        split_cores();
+
+    admit_queued();
+}
+
+nn_resource_usage_t nn_resource_manager::get_usage(nn_device_interface_0_t &device_interface)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &device = find_device(device_interface.device);
+    auto &memory = memories[device.memory];
+    const auto queued = std::count_if(queue.begin(), queue.end(), [&device_interface](const request_t &request) {
+        return request.workload->device == device_interface.device;
+    });
+    return nn_resource_usage_t{device.threads, memory.budget, memory.committed, device.workloads, static_cast<uint32_t>(queued)};
+}
+
+nn_resource_manager::device_t &nn_resource_manager::find_device(nn_device_t *device)
+{
+    for (auto &entry : devices)
+        if (entry.device_interface->device == device)
+            return entry;
+    throw std::invalid_argument("nn_resource_manager: device is not registered");
+}
+
+void nn_resource_manager::commit(nn_workload_t *workload)
+{
+    auto &device = find_device(workload->device);
+    const auto size = workload_memory(workload);
+    memories[device.memory].committed += size;
+    admitted[workload] = size;
+    if (device.workloads++ == 0 && device.cpu)
+        split_cores();
+}
+
+// Admits queued workloads in order of arrival. Once workload does not fit, later workloads using the same memory
+// wait behind it even if they would fit themselves.
+void nn_resource_manager::admit_queued()
+{
+    std::set<size_t> blocked;
+    for (auto request = queue.begin(); request != queue.end();)
+    {
+        const auto memory_index = find_device(request->workload->device).memory;
+        auto &memory = memories[memory_index];
+        if (blocked.count(memory_index) == 0 && memory.committed + workload_memory(request->workload) <= memory.budget)
+        {
+            commit(request->workload);
+            request->admitted.set_value();
+            request = queue.erase(request);
+        }
+        else
+        {
+            blocked.insert(memory_index);
+            ++request;
+        }
+    }
+}
+
+void nn_resource_manager::split_cores()
+{
+    const auto busy = static_cast<uint32_t>(std::count_if(devices.begin(), devices.end(), [](const device_t &device) {
+        return device.cpu && device.workloads != 0;
+    }));
+
+    uint32_t busy_index = 0;
+    for (auto &device : devices)
+    {
+        if (!device.cpu) continue;
+
+        uint32_t threads = 1;
+        if (device.workloads != 0)
+        {
+            threads = std::max(1u, cores / busy + (busy_index < cores % busy ? 1u : 0u));
+            ++busy_index;
+        }
+
+        if (threads == device.threads) continue;
+        if (device.device_interface->parameter_set_function(device.device_interface->device,
+                                                            NN_PARAMETER_CPU_THREAD_COUNT,
+                                                            &threads,
+                                                            sizeof(threads)) != NN_API_STATUS_OK)
+            throw std::runtime_error("nn_resource_manager: cannot set number of threads of device");
+        device.threads = threads;
+    }
+}
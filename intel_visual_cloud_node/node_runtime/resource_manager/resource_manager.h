@@ -24,3 +24,105 @@ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
 OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
+#pragma once
+
+#include "../../devices/api/nn_device_interface_0.h"
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/* This file contains resource manager of node.
+
+Every workload compiled on node commits memory for its parameters & activations for as long as it is loaded, and
+every CPU device owns thread pool that spreads executions over its threads. Resource manager keeps both within
+budgets when several workloads (models) are resident on the node at once:
+
+  - memory: workload is admitted only if its parameter_memory + activation_memory fit in the free part of budget
+    of the memory it lives in. Workloads of devices registered without own memory (CPU) share the host budget,
+    other devices (GPU) get budgets of their own. Workloads that do not fit wait in queue until enough memory is
+    released; queue is served in order of arrival, so large workloads are not starved by small ones.
+  - cores: cores of node are split evenly between CPU devices that have admitted workloads (first devices get
+    what remains from division), each idle CPU device is shrunk to single thread. Shares are applied with
+    NN_PARAMETER_CPU_THREAD_COUNT every time set of busy devices changes, so thread pools of co-resident
+    models never oversubscribe the machine.
+
+Each model is expected to be compiled on device (interface) of its own - that is what lets cores be split.
+*/
+
+struct nn_resource_usage_t
+{
+    uint32_t threads;           // threads of device (0 for devices without managed thread pool)
+    uint64_t memory_budget;     // budget of memory device uses (shared host budget for CPU devices)
+    uint64_t memory_committed;  // memory committed by admitted workloads from the same budget
+    uint32_t workloads;         // workloads of device admitted at the moment
+    uint32_t queued;            // workloads of device waiting for admission
+};
+
+class nn_resource_manager
+{
+public:
+    // Cores & host memory (bytes) that can be used by workloads; cores == 0 uses all hardware threads.
+    nn_resource_manager(uint32_t cores, uint64_t host_memory);
+
+    // Devices must be removed before they are closed; workloads still queued at destruction are abandoned.
+    ~nn_resource_manager();
+
+    // Registers device. Device with device_memory == 0 is CPU device - it keeps workloads in host memory & its
+    // thread pool gets share of cores. Otherwise device_memory is budget of memory of the device itself.
+    void add_device(nn_device_interface_0_t &device_interface, uint64_t device_memory = 0);
+
+    // Unregisters device, its workloads must be released (and none may be queued) before.
+    void remove_device(nn_device_interface_0_t &device_interface);
+
+    // Requests admission of compiled workload - returned future is ready when memory is committed for it and
+    // workload can be used. Throws std::invalid_argument if device of workload is not registered, workload is
+    // already admitted or queued, or it is larger than whole budget (and so could never be admitted).
+    std::future<void> admit(nn_workload_t *workload);
+
+    // Releases memory committed by admitted workload; workload must not execute anymore.
+    void release(nn_workload_t *workload);
+
+    nn_resource_usage_t get_usage(nn_device_interface_0_t &device_interface);
+
+private:
+    struct device_t
+    {
+        nn_device_interface_0_t *device_interface;
+        size_t memory;          // index of memory budget
+        bool cpu;
+        uint32_t threads;
+        uint32_t workloads;
+    };
+
+    struct memory_t
+    {
+        uint64_t budget;
+        uint64_t committed;
+    };
+
+    struct request_t
+    {
+        nn_workload_t *workload;
+        std::promise<void> admitted;
+    };
+
+    nn_resource_manager(const nn_resource_manager &) = delete;
+    nn_resource_manager &operator=(const nn_resource_manager &) = delete;
+
+    device_t &find_device(nn_device_t *device);
+    void commit(nn_workload_t *workload);
+    void admit_queued();
+    void split_cores();
+
+    const uint32_t cores;
+
+    std::mutex mutex;
+    std::vector<device_t> devices;          // in order of registration
+    std::vector<memory_t> memories;         // [0] is host memory
+    std::map<nn_workload_t *, uint64_t> admitted;
+    std::deque<request_t> queue;
+};
@@ -24,3 +24,217 @@ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
 OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
+
+#include "scheduler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+// Creates buffer for batch of samples shaped like given one; batch is the outermost dimension.
+nn_data_t *create_batch_buffer(const nn_data_t *sample, uint32_t batch)
+{
+    std::vector<size_t> size(sample->size, sample->size + sample->dimension);
+    size.push_back(batch);
+    auto result = nn_data_create_ptr(sample->sizeof_value, static_cast<uint8_t>(size.size()), size.data());
+    if (!result) throw std::bad_alloc();
+    return result;
+}
+
+// Returns true if sample has the same shape as single sample of batch buffer.
+bool fits_batch_buffer(const nn_data_t *sample, const nn_data_t *batch_buffer)
+{
+    if (sample->dimension + 1 != batch_buffer->dimension || sample->sizeof_value != batch_buffer->sizeof_value) return false;
+    return std::equal(sample->size, sample->size + sample->dimension, batch_buffer->size);
+}
+
+size_t buffer_bytes(const nn_data_t *data)
+{
+    return nn_data_buffer_size_ptr(data->sizeof_value, data->dimension, data->size);
+}
+} // namespace
+
+nn_scheduler::nn_scheduler(nn_device_interface_0_t &device_interface,
+                           const std::vector<nn_workload_t *> &workloads,
+                           std::chrono::microseconds deadline,
+                           float min_fill)
+    : device_interface(device_interface)
+    , deadline(std::chrono::duration_cast<clock::duration>(deadline))
+    , min_fill(min_fill)
+    , stopping(false)
+    , statistics()
+{
+    if (workloads.empty()) throw std::invalid_argument("scheduler requires at least one workload");
+    for (auto workload : workloads)
+    {
+        if (!workload || workload->input_count != 1 || workload->output_count != 1 || workload->batch == 0)
+            throw std::invalid_argument("scheduler requires workloads with single input & output");
+        variants.push_back(variant_t{workload, nullptr, nullptr});
+    }
+    std::sort(variants.begin(), variants.end(),
+              [](const variant_t &lhs, const variant_t &rhs) { return lhs.workload->batch < rhs.workload->batch; });
+    for (size_t index = 1; index < variants.size(); ++index)
+        if (variants[index - 1].workload->batch == variants[index].workload->batch)
+            throw std::invalid_argument("scheduler requires workloads with different batch sizes");
+
+    statistics.fill_histogram.resize(variants.back().workload->batch + 1);
+    dispatcher = std::thread(&nn_scheduler::dispatch_loop, this);
+}
+
+nn_scheduler::~nn_scheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    dispatcher.join();
+
+    for (auto &variant : variants)
+    {
+        nn_data_delete(variant.input);
+        nn_data_delete(variant.output);
+    }
+}
+
+std::future<NN_API_STATUS> nn_scheduler::submit(nn_data_t *input, nn_data_t *output)
+{
+    request_t request;
+    request.input = input;
+    request.output = output;
+    request.queued = clock::now();
+    auto result = request.status.get_future();
+
+    if (!input || !output || !input->buffer || !output->buffer)
+    {
+        request.status.set_value(NN_API_STATUS_ERROR_INVALID_POINTER);
+        return result;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(request));
+    }
+    wake.notify_one();
+    return result;
+}
+
+nn_scheduler_statistics_t nn_scheduler::get_statistics()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics;
+}
+
+nn_scheduler::variant_t &nn_scheduler::choose_variant(size_t queued)
+{
+    // smallest variant requests fit in, largest variant requests fill completely
+    auto fitting = std::find_if(variants.begin(), variants.end(),
+                                [queued](const variant_t &variant) { return variant.workload->batch >= queued; });
+    if (fitting == variants.end()) return variants.back();
+    if (fitting->workload->batch == queued || fitting == variants.begin()) return *fitting;
+    if (static_cast<float>(queued) >= min_fill * fitting->workload->batch) return *fitting;
+    return *(fitting - 1);
+}
+
+void nn_scheduler::dispatch_loop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        if (queue.empty())
+        {
+            if (stopping) break;
+            wake.wait(lock);
+            continue;
+        }
+
+        // wait for full batch of the largest variant, but not longer than deadline of the oldest request
+        const auto dispatch_time = queue.front().queued + deadline;
+        if (!stopping && queue.size() < variants.back().workload->batch && clock::now() < dispatch_time)
+        {
+            wake.wait_until(lock, dispatch_time);
+            continue;
+        }
+
+        auto &variant = choose_variant(queue.size());
+        const auto batch = variant.workload->batch;
+        auto count = std::min<size_t>(queue.size(), batch);
+        std::vector<request_t> requests;
+        requests.reserve(count);
+        const auto now = clock::now();
+        for (size_t index = 0; index < count; ++index)
+        {
+            auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(now - queue.front().queued);
+            statistics.total_queue_wait += wait;
+            statistics.max_queue_wait = std::max(statistics.max_queue_wait, wait);
+            requests.push_back(std::move(queue.front()));
+            queue.pop_front();
+        }
+
+        lock.unlock();
+        auto status = execute(variant, requests);
+        count = requests.size(); // without rejected ones
+        lock.lock();
+
+        if (count != 0)
+        {
+            statistics.requests += count;
+            statistics.batches += 1;
+            statistics.padded_slots += batch - count;
+            statistics.batches_of_size[batch] += 1;
+            statistics.fill_histogram[count] += 1;
+        }
+        // statistics already count requests when their clients get status
+        for (auto &request : requests)
+            request.status.set_value(status);
+    }
+}
+
+NN_API_STATUS nn_scheduler::execute(variant_t &variant, std::vector<request_t> &requests)
+{
+    const auto batch = variant.workload->batch;
+    try
+    {
+        if (!variant.input)
+        {
+            variant.input = create_batch_buffer(requests.front().input, batch);
+            variant.output = create_batch_buffer(requests.front().output, batch);
+        }
+    }
+    catch (...)
+    {
+        return NN_API_STATUS_ERROR_OUT_OF_MEMORY;
+    }
+
+    // requests shaped differently than the first one executed on this variant are rejected
+    auto rejected = std::stable_partition(requests.begin(), requests.end(), [&variant](const request_t &request) {
+        return fits_batch_buffer(request.input, variant.input) && fits_batch_buffer(request.output, variant.output);
+    });
+    for (auto request = rejected; request != requests.end(); ++request)
+        request->status.set_value(NN_API_STATUS_ERROR_INVALID_MEMORY_LAYOUT);
+    requests.erase(rejected, requests.end());
+    if (requests.empty()) return NN_API_STATUS_OK;
+
+    // gather samples, padding slots are zeroed
+    const auto input_bytes = buffer_bytes(variant.input) / batch;
+    const auto output_bytes = buffer_bytes(variant.output) / batch;
+    auto input_buffer = static_cast<uint8_t *>(variant.input->buffer);
+    for (size_t index = 0; index < requests.size(); ++index)
+        std::memcpy(input_buffer + index * input_bytes, requests[index].input->buffer, input_bytes);
+    std::memset(input_buffer + requests.size() * input_bytes, 0, (batch - requests.size()) * input_bytes);
+
+    void *input = variant.input, *output = variant.output;
+    NN_API_STATUS status;
+    auto result = device_interface.workload_execute_function(variant.workload, &input, &output, &status);
+    if (result == NN_API_STATUS_OK && device_interface.workload_wait_function)
+        result = device_interface.workload_wait_function(variant.workload, &status);
+    if (result != NN_API_STATUS_OK) return result;
+
+    // scatter results
+    auto output_buffer = static_cast<const uint8_t *>(variant.output->buffer);
+    for (size_t index = 0; index < requests.size(); ++index)
+        std::memcpy(requests[index].output->buffer, output_buffer + index * output_bytes, output_bytes);
+    return NN_API_STATUS_OK;
+}
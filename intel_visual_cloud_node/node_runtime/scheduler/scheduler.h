@@ -24,3 +24,100 @@ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
 OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
+
+#pragma once
+
+#include "../../devices/api/nn_device_interface_0.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* This file contains dynamic batching scheduler.
+
+Clients send one sample at a time, while workloads run most efficiently on batches (CPU kernels are tuned for
+batch 8 & 48). Scheduler queues single-sample requests and executes them in batches on workloads compiled from
+the same workflow for different batch sizes.
+
+As soon as enough requests to fill the largest batch are queued, they are executed. Otherwise requests wait until
+the oldest one waited for deadline; then queued requests are executed on:
+  - the smallest variant they fit in, with remaining slots padded with zeros - if at least min_fill of the batch
+    is used by requests (or there is no smaller variant),
+  - the largest variant they fill completely otherwise; requests left over are dispatched right after it.
+
+Batches are executed one after another - each one is spread over all threads of the device by itself.
+*/
+
+struct nn_scheduler_statistics_t
+{
+    uint64_t requests;                          // requests executed
+    uint64_t batches;                           // batches executed
+    uint64_t padded_slots;                      // batch slots filled with padding instead of requests
+    std::map<uint32_t, uint64_t> batches_of_size; // executed batches per batch size of variant
+    std::vector<uint64_t> fill_histogram;       // [n]: number of batches carrying n requests
+    std::chrono::nanoseconds total_queue_wait;  // sum of times requests spent in queue
+    std::chrono::nanoseconds max_queue_wait;    // longest time request spent in queue
+};
+
+class nn_scheduler
+{
+public:
+    // Workloads are variants of single workflow with one input & one output, each compiled for different batch
+    // size; they must stay valid as long as scheduler exists.
+    nn_scheduler(nn_device_interface_0_t &device_interface,
+                 const std::vector<nn_workload_t *> &workloads,
+                 std::chrono::microseconds deadline,
+                 float min_fill = 0.5f);
+
+    // Executes requests still in queue and stops.
+    ~nn_scheduler();
+
+    // Queues single sample. Input & output describe one sample (without batch dimension) and must stay valid until
+    // returned future is ready; it holds status of execution of batch the request was part of.
+    std::future<NN_API_STATUS> submit(nn_data_t *input, nn_data_t *output);
+
+    nn_scheduler_statistics_t get_statistics();
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    struct request_t
+    {
+        nn_data_t *input;
+        nn_data_t *output;
+        std::promise<NN_API_STATUS> status;
+        clock::time_point queued;
+    };
+
+    struct variant_t
+    {
+        nn_workload_t *workload;
+        nn_data_t *input;           // batch buffers, created with first execution
+        nn_data_t *output;
+    };
+
+    nn_scheduler(const nn_scheduler &) = delete;
+    nn_scheduler &operator=(const nn_scheduler &) = delete;
+
+    void dispatch_loop();
+    variant_t &choose_variant(size_t queued);
+    NN_API_STATUS execute(variant_t &variant, std::vector<request_t> &requests);
+
+    nn_device_interface_0_t &device_interface;
+    std::vector<variant_t> variants;  // sorted by batch size
+    const clock::duration deadline;
+    const float min_fill;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<request_t> queue;
+    bool stopping;
+    nn_scheduler_statistics_t statistics;
+    std::thread dispatcher;
+};
@@ -30,10 +30,45 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../devices/api/nn_device_api.h"
 #include "../../devices/common/nn_workload_data.h"
 #include "../../devices/api/nn_device_interface_0.h"
+#include "../../devices/device_cpu/api_internal/nn_device_interface_0_internal.h"
+#include "../../devices/device_cpu/api_internal/cpu_isa.h"
+#include "../../devices/device_cpu/core/layer_convolution_avx2.h"
+#include "../../devices/device_cpu/core/layer_convolution_pooling_avx2.h"
+#include "../../devices/device_cpu/core/layer_convolution_winograd_avx2.h"
 
 #include <random>
+#include <limits>
+#include <cmath>
+#include <algorithm>
 #include <cstdint>
 #include <vector>
+#include <memory>
+#include <thread>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <new>
+#include <cstdlib>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Allocations of test thread can be made to fail, so that out-of-memory paths of API calls are reachable.
+// Counter is number of allocations that still succeed; negative value disables failures.
+namespace {
+    thread_local int32_t allocations_until_failure = -1;
+}
+
+void *operator new(size_t size) {
+    if(allocations_until_failure==0) throw std::bad_alloc();
+    if(allocations_until_failure>0) --allocations_until_failure;
+    if(auto memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -52,6 +87,70 @@ namespace {
         // unload device
         EXPECT_EQ(0, nn_device_unload());
     }
+
+    // input [32x32x8] -> max pooling 2x2 stride 2x2 -> output [16x16x8], compiled for ZXY data
+    nn_workload_t *create_pooling_workload(nn_device_interface_0_t &di, nn_workflow_t *&workflow) {
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+        nn_workflow_item_t  *input = nullptr
+            , *pooling = nullptr
+            , *output = nullptr;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+        input->type = NN_WORK_ITEM_TYPE_INPUT;
+        input->arguments.input.index = 0;
+        input->output_format.format = NN_DATA_FORMAT_3D;
+        input->output_format.format_3d = nn_output_format_3d{ { 32, 32, 8 } };
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&pooling, 1, &input));
+        pooling->type = NN_WORK_ITEM_TYPE_POOLING;
+        pooling->arguments.forward_pooling = nn_arguments_forward_pooling_t{
+            {2, 2},             /* stride during filtering operation */
+            {2, 2},             /* pooling area size */
+            NN_POOLING_MODE_MAX /* pooling mode */
+        };
+        pooling->output_format.format = NN_DATA_FORMAT_3D;
+        pooling->output_format.format_3d = nn_output_format_3d{ { 16, 16, 8 } };
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &pooling));
+        output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+        output->arguments.output.index = 0;
+        output->output_format.format = NN_DATA_FORMAT_3D;
+        output->output_format.format_3d = nn_output_format_3d{ { 16, 16, 8 } };
+
+        workflow->input[0] = input;
+        workflow->output[0] = output;
+
+        nn_workload_t *workload = nullptr;
+        NN_WORKLOAD_DATA_TYPE io_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &io_format, &io_format, 1));
+        return workload;
+    }
+
+    void delete_pooling_workload(nn_device_interface_0_t &di, nn_workflow_t *workflow, nn_workload_t *workload) {
+        auto output = workflow->output[0];
+        auto pooling = output->input[0];
+        auto input = workflow->input[0];
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(pooling));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+    }
+
+    // values grow with every coordinate, so maximum is at bottom-right of each pooling window
+    void fill_pooling_input(nn::data<float, 3> &input_data, float offset) {
+        for (auto y = 0u; y < 32; ++y)
+            for (auto x = 0u; x < 32; ++x)
+                for (auto z = 0u; z < 8; ++z)
+                    input_data(z, x, y) = offset + static_cast<float>((y * 32 + x) * 8 + z);
+    }
+
+    void check_pooling_output(nn::data<float, 3> &input_data, nn::data<float, 3> &output_data) {
+        for (auto y = 0u; y < 16; ++y)
+            for (auto x = 0u; x < 16; ++x)
+                for (auto z = 0u; z < 8; ++z)
+                    EXPECT_EQ(input_data(z, x * 2 + 1, y * 2 + 1), output_data(z, x, y));
+    }
 } //namespace
 
 
@@ -363,6 +462,1869 @@ TEST(api_workloads, workflow_in_pooling_out_compilation)
     test_teardown(device_description, device_interface_0);
 }
 
+TEST(api_workloads, device_parameter_thread_placement)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    uint32_t placement = NN_CPU_THREAD_PLACEMENT_LAST;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_THREAD_PLACEMENT, &placement, sizeof(placement)));
+    EXPECT_EQ(NN_CPU_THREAD_PLACEMENT_NONE, placement);
+
+    // invalid arguments
+    placement = NN_CPU_THREAD_PLACEMENT_LAST + 1;
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_THREAD_PLACEMENT, &placement, sizeof(placement)));
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_THREAD_PLACEMENT, &placement, 1));
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_THREAD_PLACEMENT, nullptr, sizeof(placement)));
+
+    for (uint32_t mode = NN_CPU_THREAD_PLACEMENT_COMPACT; mode <= NN_CPU_THREAD_PLACEMENT_LAST + 1; ++mode) {
+        // last iteration goes back to unpinned threads
+        placement = mode > NN_CPU_THREAD_PLACEMENT_LAST ? NN_CPU_THREAD_PLACEMENT_NONE : mode;
+        EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_THREAD_PLACEMENT, &placement, sizeof(placement)));
+
+        uint32_t result = NN_CPU_THREAD_PLACEMENT_LAST + 1;
+        EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_THREAD_PLACEMENT, &result, sizeof(result)));
+        EXPECT_EQ(placement, result);
+
+        // compile & run workflow with placement applied
+        nn_workflow_t *workflow = nullptr;
+        nn_workload_t *workload = create_pooling_workload(di, workflow);
+
+        // nn::data allocates page-aligned buffers as required by AVX kernels
+        nn::data<float, 3> input_data(8, 32, 32), output_data(8, 16, 16);
+        fill_pooling_input(input_data, 0.0f);
+
+        void *input_buffer = &input_data, *output_buffer = &output_data;
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        check_pooling_output(input_data, output_data);
+
+        delete_pooling_workload(di, workflow, workload);
+    }
+
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, device_parameter_thread_count)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    uint32_t threads = 0;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_THREAD_COUNT, &threads, sizeof(threads)));
+    EXPECT_LE(1u, threads);
+
+    // invalid arguments
+    threads = 0;
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_THREAD_COUNT, &threads, sizeof(threads)));
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_THREAD_COUNT, &threads, 1));
+
+    nn_workflow_t *workflow = nullptr;
+    nn_workload_t *workload = create_pooling_workload(di, workflow);
+    nn::data<float, 3> input_data(8, 32, 32), output_data(8, 16, 16);
+    fill_pooling_input(input_data, 0.0f);
+    void *input_buffer = &input_data, *output_buffer = &output_data;
+
+    for (uint32_t count : {1u, 3u, 2u}) {
+        // pool is resized while asynchronous execution may still be running - resize waits for it
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_THREAD_COUNT, &count, sizeof(count)));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        check_pooling_output(input_data, output_data);
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_THREAD_COUNT, &threads, sizeof(threads)));
+        EXPECT_EQ(count, threads);
+
+        std::memset(output_data.buffer, 0, output_data.count() * sizeof(float));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        check_pooling_output(input_data, output_data);
+    }
+
+    delete_pooling_workload(di, workflow, workload);
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, device_parameter_profiling)
+{
+    const char *trace_path = "api_workloads_trace.json";
+
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    uint32_t enabled = 1;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_PROFILING, &enabled, sizeof(enabled)));
+    EXPECT_EQ(0u, enabled);
+    enabled = 2;
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_PROFILING, &enabled, sizeof(enabled)));
+
+    nn_workflow_t *workflow = nullptr;
+    nn_workload_t *workload = create_pooling_workload(di, workflow);
+    nn::data<float, 3> input_data(8, 32, 32), output_data(8, 16, 16);
+    fill_pooling_input(input_data, 0.0f);
+    void *input_buffer = &input_data, *output_buffer = &output_data;
+    auto execute = [&]() {
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        check_pooling_output(input_data, output_data);
+    };
+    auto read_trace = [&]() {
+        std::string path(trace_path);
+        EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_PROFILING_TRACE, &path[0], static_cast<uint32_t>(path.size() + 1)));
+        std::ifstream file(trace_path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    };
+    auto count = [](const std::string &text, const std::string &pattern) {
+        size_t result = 0;
+        for (auto at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) ++result;
+        return result;
+    };
+
+    // profiling switched on for existing workload
+    execute();
+    enabled = 1;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_PROFILING, &enabled, sizeof(enabled)));
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_PROFILING, &enabled, sizeof(enabled)));
+    EXPECT_EQ(1u, enabled);
+    execute();
+    execute();
+    enabled = 0;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_PROFILING, &enabled, sizeof(enabled)));
+    execute();
+
+    // two executions of input, pooling & output items; pooling pushes its requests to thread pool
+    auto trace = read_trace();
+    EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ns\""));
+    EXPECT_NE(std::string::npos, trace.find("\"traceEvents\":["));
+    EXPECT_EQ(6u, count(trace, "\"ph\":\"X\""));
+    EXPECT_EQ(2u, count(trace, "\"cat\":\"pooling_f32\""));
+    EXPECT_EQ(6u, count(trace, "\"caller\":"));
+    EXPECT_EQ(1u, count(trace, "\"name\":\"process_name\""));
+
+    // records are cleared by export
+    trace = read_trace();
+    EXPECT_EQ(0u, count(trace, "\"ph\":\"X\""));
+
+    // invalid path
+    std::string invalid_path("nonexistent_directory/trace.json");
+    EXPECT_EQ(NN_API_STATUS_ERROR_OTHER, di.parameter_set_function(di.device, NN_PARAMETER_CPU_PROFILING_TRACE, &invalid_path[0], static_cast<uint32_t>(invalid_path.size() + 1)));
+
+    std::remove(trace_path);
+    delete_pooling_workload(di, workflow, workload);
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, device_parameter_profiling_counters)
+{
+    const char *trace_path = "api_workloads_counters.json";
+
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    uint32_t enabled = 1;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_PROFILING_COUNTERS, &enabled, sizeof(enabled)));
+    EXPECT_EQ(0u, enabled);
+    enabled = 2;
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_PROFILING_COUNTERS, &enabled, sizeof(enabled)));
+
+    // counters may be unavailable (no PMU in virtual machine, perf_event_paranoid) - then setting fails & they stay off
+    enabled = 1;
+    const auto status = di.parameter_set_function(di.device, NN_PARAMETER_CPU_PROFILING_COUNTERS, &enabled, sizeof(enabled));
+    EXPECT_TRUE(status == NN_API_STATUS_OK || status == NN_API_STATUS_ERROR_OTHER);
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_PROFILING_COUNTERS, &enabled, sizeof(enabled)));
+    EXPECT_EQ(status == NN_API_STATUS_OK ? 1u : 0u, enabled);
+    enabled = 1;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_PROFILING, &enabled, sizeof(enabled)));
+
+    nn_workflow_t *workflow = nullptr;
+    nn_workload_t *workload = create_pooling_workload(di, workflow);
+    nn::data<float, 3> input_data(8, 32, 32), output_data(8, 16, 16);
+    fill_pooling_input(input_data, 0.0f);
+    void *input_buffer = &input_data, *output_buffer = &output_data;
+    for (int execution = 0; execution < 2; ++execution)
+    {
+        NN_API_STATUS execute_status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &execute_status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &execute_status));
+        check_pooling_output(input_data, output_data);
+    }
+
+    std::string path(trace_path);
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_PROFILING_TRACE, &path[0], static_cast<uint32_t>(path.size() + 1)));
+    std::ifstream file(trace_path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    const auto trace = contents.str();
+    auto count = [&](const std::string &pattern) {
+        size_t result = 0;
+        for (auto at = trace.find(pattern); at != std::string::npos; at = trace.find(pattern, at + 1)) ++result;
+        return result;
+    };
+
+    // counters of six records & summary of three work items
+    if (status == NN_API_STATUS_OK)
+    {
+        EXPECT_EQ(6u, count("\"ph\":\"X\""));
+        EXPECT_EQ(1u, count("\"counters\":["));
+        EXPECT_EQ(3u, count(",\"executions\":2,"));
+        EXPECT_EQ(9u, count("\"ipc\":"));
+        EXPECT_EQ(9u, count("\"llc_misses\":"));
+    }
+    else
+    {
+        EXPECT_EQ(6u, count("\"ph\":\"X\""));
+        EXPECT_EQ(0u, count("\"ipc\":"));
+    }
+
+    file.close();
+    std::remove(trace_path);
+    delete_pooling_workload(di, workflow, workload);
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workload_execute_async)
+{
+    const uint32_t request_count = 8;
+
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    nn_workflow_t *workflow = nullptr;
+    nn_workload_t *workload = create_pooling_workload(di, workflow);
+
+    std::vector<std::unique_ptr<nn::data<float, 3>>> input_datas, output_datas;
+    std::vector<NN_API_STATUS> statuses(request_count, NN_API_STATUS_ERROR_OTHER);
+    for (auto request = 0u; request < request_count; ++request) {
+        input_datas.emplace_back(new nn::data<float, 3>(8, 32, 32));
+        output_datas.emplace_back(new nn::data<float, 3>(8, 16, 16));
+        fill_pooling_input(*input_datas.back(), static_cast<float>(request * 10000));
+    }
+
+    // queue all requests at once - calls do not block, status is set to "in progress" or already finished
+    for (auto request = 0u; request < request_count; ++request) {
+        void *input_buffer = input_datas[request].get(), *output_buffer = output_datas[request].get();
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &statuses[request]));
+        EXPECT_TRUE(statuses[request] == NN_API_WORK_IN_PROGRESS || statuses[request] == NN_API_WORK_FINISHED);
+    }
+
+    // first request waited for explicitly, remaining ones as a whole
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &statuses[0]));
+    EXPECT_EQ(NN_API_WORK_FINISHED, statuses[0]);
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, nullptr));
+
+    for (auto request = 0u; request < request_count; ++request) {
+        EXPECT_EQ(NN_API_WORK_FINISHED, statuses[request]);
+        check_pooling_output(*input_datas[request], *output_datas[request]);
+    }
+
+    // workload deleted with request still queued - deletion waits for it
+    {
+        void *input_buffer = input_datas[0].get(), *output_buffer = output_datas[0].get();
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &statuses[0]));
+    }
+    delete_pooling_workload(di, workflow, workload);
+    EXPECT_EQ(NN_API_WORK_FINISHED, statuses[0]);
+
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workload_execute_out_of_memory)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    nn_workflow_t *workflow = nullptr;
+    nn_workload_t *workload = create_pooling_workload(di, workflow);
+
+    nn::data<float, 3> input_data(8, 32, 32), output_data(8, 16, 16);
+    fill_pooling_input(input_data, 0.0f);
+
+    // failing every allocation from n-th one on reaches each point where queuing of execution can fail;
+    // failed call must leave neither status nor pending execution behind, so waiting returns
+    for(int32_t allocations = 0; ; ++allocations) {
+        NN_API_STATUS status = NN_API_STATUS_ERROR_OTHER;
+        void *input_buffer = &input_data, *output_buffer = &output_data;
+        allocations_until_failure = allocations;
+        auto result = di.workload_execute_function(workload, &input_buffer, &output_buffer, &status);
+        allocations_until_failure = -1;
+
+        if(result==NN_API_STATUS_OK) {
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+            EXPECT_EQ(NN_API_WORK_FINISHED, status);
+            check_pooling_output(input_data, output_data);
+            break;
+        }
+        EXPECT_EQ(NN_API_STATUS_ERROR_OUT_OF_MEMORY, result);
+        ASSERT_EQ(NN_API_STATUS_ERROR_OTHER, status);
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, nullptr));
+    }
+
+    delete_pooling_workload(di, workflow, workload);
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workload_output_written_directly)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    nn_workflow_t *workflow = nullptr;
+    nn_workload_t *workload = create_pooling_workload(di, workflow);
+
+    // pooling produces ZXY data - the same layout as requested output, so it writes straight into user buffer
+    auto workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload + 1);
+    ASSERT_EQ(1u, workload_opaque->direct_output.size());
+    EXPECT_EQ(workload_opaque->output[0]->input[0], workload_opaque->direct_output[0]);
+
+    nn::data<float, 3> input_data(8, 32, 32), output_data(8, 16, 16);
+    void *input_buffer = &input_data, *output_buffer = &output_data;
+    for (auto execution = 0u; execution < 2; ++execution) {
+        fill_pooling_input(input_data, static_cast<float>(execution * 10000));
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        check_pooling_output(input_data, output_data);
+    }
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+
+    // XYZ output needs layout conversion - result is copied
+    NN_WORKLOAD_DATA_TYPE input_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY, output_format = NN_WORKLOAD_DATA_TYPE_F32_3D;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &input_format, &output_format, 1));
+    workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload + 1);
+    EXPECT_EQ(nullptr, workload_opaque->direct_output[0]);
+
+    nn::data<float, 3> output_data_xyz(16, 16, 8);
+    output_buffer = &output_data_xyz;
+    NN_API_STATUS status;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+    for (auto y = 0u; y < 16; ++y)
+        for (auto x = 0u; x < 16; ++x)
+            for (auto z = 0u; z < 8; ++z)
+                EXPECT_EQ(input_data(z, x * 2 + 1, y * 2 + 1), output_data_xyz(x, y, z));
+
+    delete_pooling_workload(di, workflow, workload);
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workload_output_misaligned)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    nn_workflow_t *workflow = nullptr;
+    nn_workload_t *workload = create_pooling_workload(di, workflow);
+
+    // user buffer aligned only to float - kernels store whole vectors to aligned addresses, so result is copied
+    nn::data<float, 3> input_data(8, 32, 32);
+    fill_pooling_input(input_data, 0.0f);
+    std::vector<float> storage(8 * 16 * 16 + 64 / sizeof(float));
+    auto aligned = reinterpret_cast<float *>((reinterpret_cast<uintptr_t>(storage.data()) + 63) & ~uintptr_t(63));
+    for (auto offset : {1u, 4u, 8u, 0u}) {
+        auto output_data = nn_data_create_shared(aligned + offset, sizeof(float), 3, 8, 16, 16);
+        ASSERT_NE(nullptr, output_data);
+        void *input_buffer = &input_data, *output_buffer = output_data;
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        EXPECT_EQ(NN_API_WORK_FINISHED, status);
+        for (auto y = 0u; y < 16; ++y)
+            for (auto x = 0u; x < 16; ++x)
+                for (auto z = 0u; z < 8; ++z)
+                    EXPECT_EQ(input_data(z, x * 2 + 1, y * 2 + 1), aligned[offset + (y * 16 + x) * 8 + z]);
+        nn_data_delete(output_data);
+    }
+
+    delete_pooling_workload(di, workflow, workload);
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workload_activations_share_memory)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    // input [32x32x8] -> 3x max pooling 2x2 stride 2x2 -> output [4x4x8]
+    nn_workflow_t *workflow = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+    nn_workflow_item_t  *input = nullptr
+        , *output = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+    input->type = NN_WORK_ITEM_TYPE_INPUT;
+    input->arguments.input.index = 0;
+    input->output_format.format = NN_DATA_FORMAT_3D;
+    input->output_format.format_3d = nn_output_format_3d{ { 32, 32, 8 } };
+
+    std::vector<nn_workflow_item_t *> poolings;
+    for (auto size = 16u; size >= 4; size /= 2) {
+        nn_workflow_item_t *pooling = nullptr;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&pooling, 1, poolings.empty() ? &input : &poolings.back()));
+        pooling->type = NN_WORK_ITEM_TYPE_POOLING;
+        pooling->arguments.forward_pooling = nn_arguments_forward_pooling_t{ {2, 2}, {2, 2}, NN_POOLING_MODE_MAX };
+        pooling->output_format.format = NN_DATA_FORMAT_3D;
+        pooling->output_format.format_3d = nn_output_format_3d{ { size, size, 8 } };
+        poolings.push_back(pooling);
+    }
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &poolings.back()));
+    output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+    output->arguments.output.index = 0;
+    output->output_format.format = NN_DATA_FORMAT_3D;
+    output->output_format.format_3d = nn_output_format_3d{ { 4, 4, 8 } };
+
+    workflow->input[0] = input;
+    workflow->output[0] = output;
+
+    nn_workload_t *workload = nullptr;
+    NN_WORKLOAD_DATA_TYPE io_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &io_format, &io_format, 1));
+
+    // activations take 8kB, 4kB & 4kB (page granularity) - last one is placed over first one, which is dead by then
+    EXPECT_EQ(12288u, workload->activation_memory);
+
+    nn::data<float, 3> input_data(8, 32, 32), output_data(8, 4, 4);
+    void *input_buffer = &input_data, *output_buffer = &output_data;
+    for (auto execution = 0u; execution < 2; ++execution) {
+        fill_pooling_input(input_data, static_cast<float>(execution * 10000));
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        for (auto y = 0u; y < 4; ++y)
+            for (auto x = 0u; x < 4; ++x)
+                for (auto z = 0u; z < 8; ++z)
+                    EXPECT_EQ(input_data(z, x * 8 + 7, y * 8 + 7), output_data(z, x, y));
+    }
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+    for (auto pooling = poolings.rbegin(); pooling != poolings.rend(); ++pooling)
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(*pooling));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workload_execute_reentrant)
+{
+    const uint32_t thread_count = 4;
+    const uint32_t execution_count = 16;
+
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    nn_workflow_t *workflow = nullptr;
+    nn_workload_t *workload = create_pooling_workload(di, workflow);
+
+    // every thread executes the same workload with its own data - executions overlap & must not interfere
+    std::vector<std::thread> threads;
+    std::vector<uint32_t> valid_results(thread_count, 0);
+    for (auto thread = 0u; thread < thread_count; ++thread)
+        threads.emplace_back([&, thread]() {
+            nn::data<float, 3> input_data(8, 32, 32), output_data(8, 16, 16);
+            for (auto execution = 0u; execution < execution_count; ++execution) {
+                const float offset = static_cast<float>((thread * execution_count + execution) * 10000);
+                fill_pooling_input(input_data, offset);
+                void *input_buffer = &input_data, *output_buffer = &output_data;
+                NN_API_STATUS status;
+                if (NN_API_STATUS_OK != di.workload_execute_function(workload, &input_buffer, &output_buffer, &status)) continue;
+                if (NN_API_STATUS_OK != di.workload_wait_function(workload, &status)) continue;
+
+                bool valid = true;
+                for (auto y = 0u; y < 16; ++y)
+                    for (auto x = 0u; x < 16; ++x)
+                        for (auto z = 0u; z < 8; ++z)
+                            valid &= input_data(z, x * 2 + 1, y * 2 + 1) == output_data(z, x, y);
+                valid_results[thread] += valid;
+            }
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    for (auto thread = 0u; thread < thread_count; ++thread)
+        EXPECT_EQ(execution_count, valid_results[thread]);
+
+    delete_pooling_workload(di, workflow, workload);
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workflow_metrics_query)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    nn_workflow_t *workflow = nullptr;
+    nn_workload_t *workload = create_pooling_workload(di, workflow);
+
+    nn_workflow_metrics_array_t *metrics = nullptr;
+    EXPECT_EQ(NN_API_STATUS_ERROR_INVALID_POINTER, di.workflow_metrics_query_function(&metrics, di.device, nullptr));
+    ASSERT_EQ(NN_API_STATUS_OK, di.workflow_metrics_query_function(&metrics, di.device, workflow));
+    ASSERT_NE(nullptr, metrics);
+    EXPECT_EQ(1u, metrics->input_count);
+    EXPECT_EQ(1u, metrics->output_count);
+
+    // default variants: single image, image per thread & 8 images per thread
+    uint32_t num_threads = 0;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_THREAD_COUNT, &num_threads, sizeof(num_threads)));
+    std::vector<uint32_t> default_batches = {1, num_threads, num_threads * 8};
+    default_batches.erase(std::unique(default_batches.begin(), default_batches.end()), default_batches.end());
+    ASSERT_EQ(default_batches.size(), metrics->variant_count);
+    for (auto variant = 0u; variant < metrics->variant_count; ++variant)
+        EXPECT_EQ(default_batches[variant], metrics->array[variant]->batch);
+
+    for (auto variant = 0u; variant < metrics->variant_count; ++variant) {
+        auto entry = metrics->array[variant];
+        EXPECT_EQ(NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH, entry->input_format[0]);
+        EXPECT_EQ(NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH, entry->output_format[0]);
+        EXPECT_LT(0u, entry->metric[0]);
+        EXPECT_LT(0u, entry->metric[1]);
+        // larger batch takes longer as a whole
+        if (variant) {
+            EXPECT_LT(metrics->array[variant - 1]->batch, entry->batch);
+            EXPECT_LE(metrics->array[variant - 1]->metric[0], entry->metric[0]);
+        }
+    }
+
+    // every variant can be compiled
+    for (auto variant = 0u; variant < metrics->variant_count; ++variant) {
+        auto entry = metrics->array[variant];
+        nn_workload_t *variant_workload = nullptr;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&variant_workload, di.device, workflow, entry->input_format, entry->output_format, entry->batch));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(variant_workload));
+    }
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_metrics_delete_function(metrics));
+
+    // batches of variants are configurable; list is sorted, ends at 0 & empty one restores defaults
+    uint32_t batches[] = {20, 3, 20, 0, 7};
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_METRICS_BATCHES, batches, sizeof(batches)));
+    uint32_t configured[3] = {};
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_METRICS_BATCHES, configured, 2*sizeof(uint32_t)));
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_METRICS_BATCHES, configured, sizeof(configured)));
+    EXPECT_EQ(3u, configured[0]);
+    EXPECT_EQ(20u, configured[1]);
+    EXPECT_EQ(0u, configured[2]);
+    ASSERT_EQ(NN_API_STATUS_OK, di.workflow_metrics_query_function(&metrics, di.device, workflow));
+    ASSERT_EQ(2u, metrics->variant_count);
+    EXPECT_EQ(3u, metrics->array[0]->batch);
+    EXPECT_EQ(20u, metrics->array[1]->batch);
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_metrics_delete_function(metrics));
+
+    uint32_t empty_list = 0;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_METRICS_BATCHES, &empty_list, sizeof(empty_list)));
+    ASSERT_EQ(NN_API_STATUS_OK, di.workflow_metrics_query_function(&metrics, di.device, workflow));
+    EXPECT_EQ(default_batches.size(), metrics->variant_count);
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_metrics_delete_function(metrics));
+
+    delete_pooling_workload(di, workflow, workload);
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workflow_compile_autotune)
+{
+    const char *database_path = "api_workloads_tuning.txt";
+    std::remove(database_path);
+
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_TUNING_DATABASE, const_cast<char *>(database_path), static_cast<uint32_t>(std::strlen(database_path) + 1)));
+    char path[64] = {};
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_TUNING_DATABASE, path, sizeof(path)));
+    EXPECT_STREQ(database_path, path);
+
+    // input [15x15x192] -> convolution 3x3 + ReLU -> output [13x13x256]; layer has specialized kernel
+    nn::data<float, 4> weights(3, 3, 192, 256);
+    nn::data<float, 1> biases(256);
+    for (auto o = 0u; o < 256; ++o) {
+        biases(o) = static_cast<float>(o % 5) / 10.0f - 0.2f;
+        for (auto i = 0u; i < 192; ++i)
+            for (auto ky = 0u; ky < 3; ++ky)
+                for (auto kx = 0u; kx < 3; ++kx)
+                    weights(kx, ky, i, o) = (static_cast<float>((kx + ky * 3 + i * 5 + o * 7) % 11) / 11.0f - 0.5f) / 100.0f;
+    }
+
+    nn_workflow_t *workflow = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+    nn_workflow_item_t  *input = nullptr
+        , *convolution = nullptr
+        , *output = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+    input->type = NN_WORK_ITEM_TYPE_INPUT;
+    input->arguments.input.index = 0;
+    input->output_format.format = NN_DATA_FORMAT_3D;
+    input->output_format.format_3d = nn_output_format_3d{ { 15, 15, 192 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&convolution, 1, &input));
+    convolution->type = NN_WORK_ITEM_TYPE_CONVOLUTION;
+    auto &arguments = convolution->arguments.forward_convolution;
+    arguments.padding = NN_PADDING_MODE_DATA_OR_ZERO;
+    arguments.center_offset[0] = arguments.center_offset[1] = 0;
+    arguments.stride[0] = arguments.stride[1] = 1;
+    arguments.weights = &weights;
+    arguments.biases = &biases;
+    arguments.activation.function = NN_ACTIVATION_FUNCTION_RELU;
+    convolution->output_format.format = NN_DATA_FORMAT_3D;
+    convolution->output_format.format_3d = nn_output_format_3d{ { 13, 13, 256 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &convolution));
+    output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+    output->arguments.output.index = 0;
+    output->output_format.format = NN_DATA_FORMAT_3D;
+    output->output_format.format_3d = nn_output_format_3d{ { 13, 13, 256 } };
+
+    workflow->input[0] = input;
+    workflow->output[0] = output;
+
+    nn::data<float, 3> input_data(192, 15, 15), output_data(256, 13, 13), reference(256, 13, 13);
+    for (auto y = 0u; y < 15; ++y)
+        for (auto x = 0u; x < 15; ++x)
+            for (auto z = 0u; z < 192; ++z)
+                input_data(z, x, y) = static_cast<float>((x + 2 * y + 3 * z) % 7) / 7.0f - 0.5f;
+    for (auto y = 0u; y < 13; ++y)
+        for (auto x = 0u; x < 13; ++x)
+            for (auto o = 0u; o < 256; ++o) {
+                float sum = biases(o);
+                for (auto ky = 0u; ky < 3; ++ky)
+                    for (auto kx = 0u; kx < 3; ++kx)
+                        for (auto i = 0u; i < 192; ++i)
+                            sum += input_data(i, x + kx, y + ky) * weights(kx, ky, i, o);
+                reference(o, x, y) = std::max(sum, 0.0f);
+            }
+
+    auto compile = [&]() {
+        nn_workload_t *workload = nullptr;
+        NN_WORKLOAD_DATA_TYPE io_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &io_format, &io_format, 1));
+        return workload;
+    };
+    auto primitive_of = [](nn_workload_t *workload) {
+        auto workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload + 1);
+        return static_cast<layer::convolution_f32 *>(workload_opaque->output[0]->input[0]->primitive);
+    };
+    auto execute_and_check = [&](nn_workload_t *workload) {
+        void *input_buffer = &input_data, *output_buffer = &output_data;
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        for (auto y = 0u; y < 13; ++y)
+            for (auto x = 0u; x < 13; ++x)
+                for (auto o = 0u; o < 256; ++o)
+                    ASSERT_NEAR(reference(o, x, y), output_data(o, x, y), 1e-3f);
+    };
+
+    // first compilation times candidates & stores the choice
+    nn_workload_t *workload = compile();
+    auto tuned = primitive_of(workload)->tuning;
+    EXPECT_GT(3u, tuned.kernel);
+    execute_and_check(workload);
+
+    // every candidate computes the same result
+    for (auto &candidate : primitive_of(workload)->get_tuning_candidates()) {
+        primitive_of(workload)->tuning = candidate;
+        execute_and_check(workload);
+    }
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+
+    std::string key, line;
+    {
+        std::ifstream database(database_path);
+        ASSERT_TRUE(static_cast<bool>(std::getline(database, line)));
+        key = line.substr(0, line.find(' '));
+        EXPECT_NE(std::string::npos, key.find("convolution_f32;in=15x15x192;out=13x13x256;kernel=3x3"));
+    }
+
+    // stored choice is reused by later compilations - database edited to generic kernel to see it is read
+    {
+        std::ofstream database(database_path, std::ios::trunc);
+        database << key << " 1 1\n";
+    }
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_TUNING_DATABASE, const_cast<char *>(database_path), static_cast<uint32_t>(std::strlen(database_path) + 1)));
+    workload = compile();
+    EXPECT_EQ(1u, primitive_of(workload)->tuning.kernel);
+    EXPECT_EQ(1u, primitive_of(workload)->tuning.partition);
+    execute_and_check(workload);
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+
+    // empty path disables autotuning - primitive runs with defaults
+    char empty[] = "";
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_TUNING_DATABASE, empty, sizeof(empty)));
+    workload = compile();
+    const bool avx512 = reinterpret_cast<nn_device_internal *>(di.device)->isa == NN_CPU_ISA_AVX512;
+    EXPECT_EQ(avx512 ? 2u : 0u, primitive_of(workload)->tuning.kernel);
+    EXPECT_EQ(0u, primitive_of(workload)->tuning.partition);
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(convolution));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+    test_teardown(device_description, device_interface_0);
+    std::remove(database_path);
+}
+
+TEST(api_workloads, workflow_compile_winograd_convolution)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    float tolerance = -1.0f;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE, &tolerance, sizeof(tolerance)));
+    EXPECT_EQ(0.0f, tolerance);
+
+    // invalid arguments
+    tolerance = -0.5f;
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE, &tolerance, sizeof(tolerance)));
+    tolerance = 2.0f;
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE, &tolerance, sizeof(tolerance)));
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE, &tolerance, 1));
+
+    // input [30x30x64] -> convolution 3x3 + ReLU -> output [28x28x64]
+    nn::data<float, 4> weights(3, 3, 64, 64);
+    nn::data<float, 1> biases(64);
+    for (auto o = 0u; o < 64; ++o) {
+        biases(o) = static_cast<float>(o % 5) / 10.0f - 0.2f;
+        for (auto i = 0u; i < 64; ++i)
+            for (auto ky = 0u; ky < 3; ++ky)
+                for (auto kx = 0u; kx < 3; ++kx)
+                    weights(kx, ky, i, o) = (static_cast<float>((kx + ky * 3 + i * 5 + o * 7) % 11) / 11.0f - 0.5f) / 10.0f;
+    }
+
+    nn_workflow_t *workflow = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+    nn_workflow_item_t  *input = nullptr
+        , *convolution = nullptr
+        , *output = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+    input->type = NN_WORK_ITEM_TYPE_INPUT;
+    input->arguments.input.index = 0;
+    input->output_format.format = NN_DATA_FORMAT_3D;
+    input->output_format.format_3d = nn_output_format_3d{ { 30, 30, 64 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&convolution, 1, &input));
+    convolution->type = NN_WORK_ITEM_TYPE_CONVOLUTION;
+    auto &arguments = convolution->arguments.forward_convolution;
+    arguments.padding = NN_PADDING_MODE_DATA_OR_ZERO;
+    arguments.center_offset[0] = arguments.center_offset[1] = 0;
+    arguments.stride[0] = arguments.stride[1] = 1;
+    arguments.weights = &weights;
+    arguments.biases = &biases;
+    arguments.activation.function = NN_ACTIVATION_FUNCTION_RELU;
+    convolution->output_format.format = NN_DATA_FORMAT_3D;
+    convolution->output_format.format_3d = nn_output_format_3d{ { 28, 28, 64 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &convolution));
+    output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+    output->arguments.output.index = 0;
+    output->output_format.format = NN_DATA_FORMAT_3D;
+    output->output_format.format_3d = nn_output_format_3d{ { 28, 28, 64 } };
+
+    workflow->input[0] = input;
+    workflow->output[0] = output;
+
+    nn::data<float, 3> input_data(64, 30, 30), output_data(64, 28, 28), reference(64, 28, 28);
+    for (auto y = 0u; y < 30; ++y)
+        for (auto x = 0u; x < 30; ++x)
+            for (auto z = 0u; z < 64; ++z)
+                input_data(z, x, y) = static_cast<float>((x + 2 * y + 3 * z) % 7) / 7.0f - 0.5f;
+    float largest = 0.0f;
+    for (auto y = 0u; y < 28; ++y)
+        for (auto x = 0u; x < 28; ++x)
+            for (auto o = 0u; o < 64; ++o) {
+                double sum = biases(o);
+                for (auto ky = 0u; ky < 3; ++ky)
+                    for (auto kx = 0u; kx < 3; ++kx)
+                        for (auto i = 0u; i < 64; ++i)
+                            sum += static_cast<double>(input_data(i, x + kx, y + ky)) * weights(kx, ky, i, o);
+                reference(o, x, y) = std::max(static_cast<float>(sum), 0.0f);
+                largest = std::max(largest, std::abs(static_cast<float>(sum)));
+            }
+
+    // compiles workflow with given tolerance, checks the algorithm chosen and the result
+    auto compile_and_check = [&](float tolerance, size_t expected_tile_size) {
+        EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE, &tolerance, sizeof(tolerance)));
+        nn_workload_t *workload = nullptr;
+        NN_WORKLOAD_DATA_TYPE io_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &io_format, &io_format, 1));
+
+        auto workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload + 1);
+        auto winograd = dynamic_cast<layer::convolution_winograd_f32 *>(
+            static_cast<layer::convolution_f32 *>(workload_opaque->output[0]->input[0]->primitive));
+        EXPECT_EQ(expected_tile_size, winograd ? winograd->tile_size : 0u);
+
+        void *input_buffer = &input_data, *output_buffer = &output_data;
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        const float accepted = std::max(tolerance, 1e-6f) * largest;
+        for (auto y = 0u; y < 28; ++y)
+            for (auto x = 0u; x < 28; ++x)
+                for (auto o = 0u; o < 64; ++o)
+                    ASSERT_NEAR(reference(o, x, y), output_data(o, x, y), accepted);
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+    };
+    compile_and_check(0.0f, 0);
+    compile_and_check(layer::convolution_winograd_f32::get_error(2), 2);
+    compile_and_check(layer::convolution_winograd_f32::get_error(4), 4);
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE, &tolerance, sizeof(tolerance)));
+    EXPECT_EQ(layer::convolution_winograd_f32::get_error(4), tolerance);
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(convolution));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workflow_fuse_convolution_pooling)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    // input [15x15x16] -> convolution 3x3 + ReLU [13x13x32] -> pooling 3x3 stride 2x2 -> output [6x6x32]
+    nn::data<float, 4> weights(3, 3, 16, 32);
+    nn::data<float, 1> biases(32);
+    for (auto o = 0u; o < 32; ++o) {
+        biases(o) = static_cast<float>(o % 5) / 10.0f - 0.2f;
+        for (auto i = 0u; i < 16; ++i)
+            for (auto ky = 0u; ky < 3; ++ky)
+                for (auto kx = 0u; kx < 3; ++kx)
+                    weights(kx, ky, i, o) = static_cast<float>((kx + ky * 3 + i * 5 + o * 7) % 11) / 11.0f - 0.5f;
+    }
+
+    nn::data<float, 3> input_data(16, 15, 15), convolved(32, 13, 13), output_data(32, 6, 6), reference(32, 6, 6);
+    for (auto y = 0u; y < 15; ++y)
+        for (auto x = 0u; x < 15; ++x)
+            for (auto z = 0u; z < 16; ++z)
+                input_data(z, x, y) = static_cast<float>((x + 2 * y + 3 * z) % 7) / 7.0f - 0.5f;
+    for (auto y = 0u; y < 13; ++y)
+        for (auto x = 0u; x < 13; ++x)
+            for (auto o = 0u; o < 32; ++o) {
+                float sum = biases(o);
+                for (auto ky = 0u; ky < 3; ++ky)
+                    for (auto kx = 0u; kx < 3; ++kx)
+                        for (auto i = 0u; i < 16; ++i)
+                            sum += input_data(i, x + kx, y + ky) * weights(kx, ky, i, o);
+                convolved(o, x, y) = std::max(sum, 0.0f);
+            }
+
+    // single thread computes everything in one job, more threads split rows of pooled output between jobs;
+    // rows of tiles are computed by kernels of every instruction set host supports
+    for (uint32_t isa = 0; isa <= nn_cpu_isa_detect(); ++isa)
+    for (uint32_t threads : {1u, 4u})
+    for (auto mode : {NN_POOLING_MODE_MAX, NN_POOLING_MODE_AVERAGE}) {
+        EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa)));
+        EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_THREAD_COUNT, &threads, sizeof(threads)));
+        for (auto y = 0u; y < 6; ++y)
+            for (auto x = 0u; x < 6; ++x)
+                for (auto o = 0u; o < 32; ++o) {
+                    float max = convolved(o, x * 2, y * 2), sum = 0.0f;
+                    for (auto py = 0u; py < 3; ++py)
+                        for (auto px = 0u; px < 3; ++px) {
+                            max = std::max(max, convolved(o, x * 2 + px, y * 2 + py));
+                            sum += convolved(o, x * 2 + px, y * 2 + py);
+                        }
+                    reference(o, x, y) = mode == NN_POOLING_MODE_MAX ? max : sum / 9.0f;
+                }
+
+        nn_workflow_t *workflow = nullptr;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+        nn_workflow_item_t  *input = nullptr
+            , *convolution = nullptr
+            , *pooling = nullptr
+            , *output = nullptr;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+        input->type = NN_WORK_ITEM_TYPE_INPUT;
+        input->arguments.input.index = 0;
+        input->output_format.format = NN_DATA_FORMAT_3D;
+        input->output_format.format_3d = nn_output_format_3d{ { 15, 15, 16 } };
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&convolution, 1, &input));
+        convolution->type = NN_WORK_ITEM_TYPE_CONVOLUTION;
+        auto &arguments = convolution->arguments.forward_convolution;
+        arguments.padding = NN_PADDING_MODE_DATA_OR_ZERO;
+        arguments.center_offset[0] = arguments.center_offset[1] = 0;
+        arguments.stride[0] = arguments.stride[1] = 1;
+        arguments.weights = &weights;
+        arguments.biases = &biases;
+        arguments.activation.function = NN_ACTIVATION_FUNCTION_RELU;
+        convolution->output_format.format = NN_DATA_FORMAT_3D;
+        convolution->output_format.format_3d = nn_output_format_3d{ { 13, 13, 32 } };
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&pooling, 1, &convolution));
+        pooling->type = NN_WORK_ITEM_TYPE_POOLING;
+        pooling->arguments.forward_pooling = nn_arguments_forward_pooling_t{
+            {2, 2},             /* stride during filtering operation */
+            {3, 3},             /* pooling area size */
+            mode                /* pooling mode */
+        };
+        pooling->output_format.format = NN_DATA_FORMAT_3D;
+        pooling->output_format.format_3d = nn_output_format_3d{ { 6, 6, 32 } };
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &pooling));
+        output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+        output->arguments.output.index = 0;
+        output->output_format.format = NN_DATA_FORMAT_3D;
+        output->output_format.format_3d = nn_output_format_3d{ { 6, 6, 32 } };
+
+        workflow->input[0] = input;
+        workflow->output[0] = output;
+
+        nn_workload_t *workload = nullptr;
+        NN_WORKLOAD_DATA_TYPE io_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &io_format, &io_format, 1));
+
+        // pooling is computed by convolution item
+        auto workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload + 1);
+        auto fused = workload_opaque->output[0]->input[0];
+        EXPECT_EQ(NN_WORK_ITEM_TYPE_CONVOLUTION, fused->type);
+        EXPECT_EQ(workload_opaque->input[0], fused->input[0]);
+        auto primitive = dynamic_cast<layer::convolution_pooling_f32 *>(static_cast<layer::convolution_f32 *>(fused->primitive));
+        ASSERT_NE(nullptr, primitive);
+
+        // every tile height & split of feature maps computes the same result
+        for (auto &candidate : primitive->get_tuning_candidates()) {
+            primitive->tuning = candidate;
+            void *input_buffer = &input_data, *output_buffer = &output_data;
+            NN_API_STATUS status;
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+            for (auto y = 0u; y < 6; ++y)
+                for (auto x = 0u; x < 6; ++x)
+                    for (auto o = 0u; o < 32; ++o)
+                        ASSERT_NEAR(reference(o, x, y), output_data(o, x, y), 1e-4f);
+        }
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(pooling));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(convolution));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+    }
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workflow_fuse_convolution_pooling_with_tolerance)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    // input [15x15x32] -> convolution 3x3 + ReLU [13x13x32] -> max pooling 2x2 stride 2x2 -> output [6x6x32]
+    // alone, the convolution would use Winograd algorithm with this tolerance
+    float tolerance = layer::convolution_winograd_f32::get_error(4);
+    nn_argument_activation_t activation = {};
+    activation.function = NN_ACTIVATION_FUNCTION_RELU;
+    ASSERT_NE(0u, layer::convolution_winograd_f32::choose_tile_size(3, 3, 1, 1, 32, 32, 13, 13, activation, tolerance));
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_CONVOLUTION_TOLERANCE, &tolerance, sizeof(tolerance)));
+
+    nn::data<float, 4> weights(3, 3, 32, 32);
+    nn::data<float, 1> biases(32);
+    for (auto o = 0u; o < 32; ++o) {
+        biases(o) = static_cast<float>(o % 5) / 10.0f - 0.2f;
+        for (auto i = 0u; i < 32; ++i)
+            for (auto ky = 0u; ky < 3; ++ky)
+                for (auto kx = 0u; kx < 3; ++kx)
+                    weights(kx, ky, i, o) = (static_cast<float>((kx + ky * 3 + i * 5 + o * 7) % 11) / 11.0f - 0.5f) / 10.0f;
+    }
+
+    nn::data<float, 3> input_data(32, 15, 15), convolved(32, 13, 13), output_data(32, 6, 6), reference(32, 6, 6);
+    for (auto y = 0u; y < 15; ++y)
+        for (auto x = 0u; x < 15; ++x)
+            for (auto z = 0u; z < 32; ++z)
+                input_data(z, x, y) = static_cast<float>((x + 2 * y + 3 * z) % 7) / 7.0f - 0.5f;
+    for (auto y = 0u; y < 13; ++y)
+        for (auto x = 0u; x < 13; ++x)
+            for (auto o = 0u; o < 32; ++o) {
+                float sum = biases(o);
+                for (auto ky = 0u; ky < 3; ++ky)
+                    for (auto kx = 0u; kx < 3; ++kx)
+                        for (auto i = 0u; i < 32; ++i)
+                            sum += input_data(i, x + kx, y + ky) * weights(kx, ky, i, o);
+                convolved(o, x, y) = std::max(sum, 0.0f);
+            }
+    for (auto y = 0u; y < 6; ++y)
+        for (auto x = 0u; x < 6; ++x)
+            for (auto o = 0u; o < 32; ++o)
+                reference(o, x, y) = std::max(std::max(convolved(o, x * 2, y * 2), convolved(o, x * 2 + 1, y * 2)),
+                                              std::max(convolved(o, x * 2, y * 2 + 1), convolved(o, x * 2 + 1, y * 2 + 1)));
+
+    nn_workflow_t *workflow = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+    nn_workflow_item_t  *input = nullptr
+        , *convolution = nullptr
+        , *pooling = nullptr
+        , *output = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+    input->type = NN_WORK_ITEM_TYPE_INPUT;
+    input->arguments.input.index = 0;
+    input->output_format.format = NN_DATA_FORMAT_3D;
+    input->output_format.format_3d = nn_output_format_3d{ { 15, 15, 32 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&convolution, 1, &input));
+    convolution->type = NN_WORK_ITEM_TYPE_CONVOLUTION;
+    auto &arguments = convolution->arguments.forward_convolution;
+    arguments.padding = NN_PADDING_MODE_DATA_OR_ZERO;
+    arguments.center_offset[0] = arguments.center_offset[1] = 0;
+    arguments.stride[0] = arguments.stride[1] = 1;
+    arguments.weights = &weights;
+    arguments.biases = &biases;
+    arguments.activation = activation;
+    convolution->output_format.format = NN_DATA_FORMAT_3D;
+    convolution->output_format.format_3d = nn_output_format_3d{ { 13, 13, 32 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&pooling, 1, &convolution));
+    pooling->type = NN_WORK_ITEM_TYPE_POOLING;
+    pooling->arguments.forward_pooling = nn_arguments_forward_pooling_t{
+        {2, 2},             /* stride during filtering operation */
+        {2, 2},             /* pooling area size */
+        NN_POOLING_MODE_MAX /* pooling mode */
+    };
+    pooling->output_format.format = NN_DATA_FORMAT_3D;
+    pooling->output_format.format_3d = nn_output_format_3d{ { 6, 6, 32 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &pooling));
+    output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+    output->arguments.output.index = 0;
+    output->output_format.format = NN_DATA_FORMAT_3D;
+    output->output_format.format_3d = nn_output_format_3d{ { 6, 6, 32 } };
+
+    workflow->input[0] = input;
+    workflow->output[0] = output;
+
+    nn_workload_t *workload = nullptr;
+    NN_WORKLOAD_DATA_TYPE io_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &io_format, &io_format, 1));
+
+    // fused item computes direct convolution, with weights in its layout
+    auto workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload + 1);
+    auto fused = workload_opaque->output[0]->input[0];
+    EXPECT_EQ(NN_WORK_ITEM_TYPE_CONVOLUTION, fused->type);
+    EXPECT_NE(nullptr, dynamic_cast<layer::convolution_pooling_f32 *>(static_cast<layer::convolution_f32 *>(fused->primitive)));
+
+    void *input_buffer = &input_data, *output_buffer = &output_data;
+    NN_API_STATUS status;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+    for (auto y = 0u; y < 6; ++y)
+        for (auto x = 0u; x < 6; ++x)
+            for (auto o = 0u; o < 32; ++o)
+                ASSERT_NEAR(reference(o, x, y), output_data(o, x, y), 1e-4f);
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(pooling));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(convolution));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workflow_compile_layout_assignment)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    // jobs of fused convolution & pooling storing batch-first layout run concurrently
+    uint32_t num_threads = 4;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_THREAD_COUNT, &num_threads, sizeof(num_threads)));
+
+    // batch of 8: input [8x8x16] -> convolution 3x3 + ReLU [6x6x32] (-> max pooling 2x2 stride 2x2 [3x3x32]) -> fully connected [16]
+    const uint32_t batch = 8;
+    nn::data<float, 4> input_data(16, 8, 8, batch);
+    for (auto n = 0u; n < batch; ++n)
+        for (auto y = 0u; y < 8; ++y)
+            for (auto x = 0u; x < 8; ++x)
+                for (auto z = 0u; z < 16; ++z)
+                    input_data(z, x, y, n) = static_cast<float>((x + 2 * y + 3 * z + 5 * n) % 7) / 7.0f - 0.5f;
+
+    nn::data<float, 4> conv_weights(3, 3, 16, 32);
+    nn::data<float, 1> conv_biases(32), fc_biases(16);
+    for (auto o = 0u; o < 32; ++o) {
+        conv_biases(o) = static_cast<float>(o % 5) / 10.0f - 0.2f;
+        for (auto i = 0u; i < 16; ++i)
+            for (auto ky = 0u; ky < 3; ++ky)
+                for (auto kx = 0u; kx < 3; ++kx)
+                    conv_weights(kx, ky, i, o) = (static_cast<float>((kx + ky * 3 + i * 5 + o * 7) % 11) / 11.0f - 0.5f) / 10.0f;
+    }
+    for (auto o = 0u; o < 16; ++o)
+        fc_biases(o) = static_cast<float>(o % 3) / 10.0f;
+
+    nn::data<float, 4> convolved(32, 6, 6, batch);
+    for (auto n = 0u; n < batch; ++n)
+        for (auto y = 0u; y < 6; ++y)
+            for (auto x = 0u; x < 6; ++x)
+                for (auto o = 0u; o < 32; ++o) {
+                    float sum = conv_biases(o);
+                    for (auto ky = 0u; ky < 3; ++ky)
+                        for (auto kx = 0u; kx < 3; ++kx)
+                            for (auto i = 0u; i < 16; ++i)
+                                sum += input_data(i, x + kx, y + ky, n) * conv_weights(kx, ky, i, o);
+                    convolved(o, x, y, n) = std::max(sum, 0.0f);
+                }
+
+    for (auto with_pooling : {false, true}) {
+        const uint32_t size = with_pooling ? 3 : 6;
+        nn::data<float, 4> fc_input(32, size, size, batch), fc_weights(size, size, 32, 16);
+        for (auto n = 0u; n < batch; ++n)
+            for (auto y = 0u; y < size; ++y)
+                for (auto x = 0u; x < size; ++x)
+                    for (auto z = 0u; z < 32; ++z)
+                        fc_input(z, x, y, n) = with_pooling
+                            ? std::max(std::max(convolved(z, 2 * x, 2 * y, n), convolved(z, 2 * x + 1, 2 * y, n)),
+                                       std::max(convolved(z, 2 * x, 2 * y + 1, n), convolved(z, 2 * x + 1, 2 * y + 1, n)))
+                            : convolved(z, x, y, n);
+        for (auto o = 0u; o < 16; ++o)
+            for (auto z = 0u; z < 32; ++z)
+                for (auto y = 0u; y < size; ++y)
+                    for (auto x = 0u; x < size; ++x)
+                        fc_weights(x, y, z, o) = (static_cast<float>((x + y * 3 + z * 5 + o * 7) % 13) / 13.0f - 0.5f) / 10.0f;
+
+        nn::data<float, 2> output_data(16, batch), reference(16, batch);
+        for (auto n = 0u; n < batch; ++n)
+            for (auto o = 0u; o < 16; ++o) {
+                float sum = fc_biases(o);
+                for (auto z = 0u; z < 32; ++z)
+                    for (auto y = 0u; y < size; ++y)
+                        for (auto x = 0u; x < size; ++x)
+                            sum += fc_input(z, x, y, n) * fc_weights(x, y, z, o);
+                reference(o, n) = sum;
+            }
+
+        nn_workflow_t *workflow = nullptr;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+        nn_workflow_item_t  *input = nullptr
+            , *convolution = nullptr
+            , *pooling = nullptr
+            , *fully_connected = nullptr
+            , *output = nullptr;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+        input->type = NN_WORK_ITEM_TYPE_INPUT;
+        input->arguments.input.index = 0;
+        input->output_format.format = NN_DATA_FORMAT_3D;
+        input->output_format.format_3d = nn_output_format_3d{ { 8, 8, 16 } };
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&convolution, 1, &input));
+        convolution->type = NN_WORK_ITEM_TYPE_CONVOLUTION;
+        auto &arguments = convolution->arguments.forward_convolution;
+        arguments.padding = NN_PADDING_MODE_DATA_OR_ZERO;
+        arguments.center_offset[0] = arguments.center_offset[1] = 0;
+        arguments.stride[0] = arguments.stride[1] = 1;
+        arguments.weights = &conv_weights;
+        arguments.biases = &conv_biases;
+        arguments.activation.function = NN_ACTIVATION_FUNCTION_RELU;
+        convolution->output_format.format = NN_DATA_FORMAT_3D;
+        convolution->output_format.format_3d = nn_output_format_3d{ { 6, 6, 32 } };
+
+        auto last = convolution;
+        if (with_pooling) {
+            EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&pooling, 1, &convolution));
+            pooling->type = NN_WORK_ITEM_TYPE_POOLING;
+            pooling->arguments.forward_pooling = nn_arguments_forward_pooling_t{
+                {2, 2},             /* stride during filtering operation */
+                {2, 2},             /* pooling area size */
+                NN_POOLING_MODE_MAX /* pooling mode */
+            };
+            pooling->output_format.format = NN_DATA_FORMAT_3D;
+            pooling->output_format.format_3d = nn_output_format_3d{ { 3, 3, 32 } };
+            last = pooling;
+        }
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&fully_connected, 1, &last));
+        fully_connected->type = NN_WORK_ITEM_TYPE_FULLY_CONNECTED;
+        fully_connected->arguments.forward_fully_connected.weights = &fc_weights;
+        fully_connected->arguments.forward_fully_connected.biases = &fc_biases;
+        fully_connected->arguments.forward_fully_connected.activation.function = NN_ACTIVATION_FUNCTION_NONE;
+        fully_connected->output_format.format = NN_DATA_FORMAT_1D;
+        fully_connected->output_format.format_1d = nn_output_format_1d{ { 16 } };
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &fully_connected));
+        output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+        output->arguments.output.index = 0;
+        output->output_format.format = NN_DATA_FORMAT_1D;
+        output->output_format.format_1d = nn_output_format_1d{ { 16 } };
+
+        workflow->input[0] = input;
+        workflow->output[0] = output;
+
+        nn_workload_t *workload = nullptr;
+        NN_WORKLOAD_DATA_TYPE input_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH, output_format = NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &input_format, &output_format, batch));
+
+        // fused convolution & pooling stores batch-first layout of fully connected layer itself
+        auto workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload + 1);
+        auto conversions = 0u;
+        for (auto load_item : workload_opaque->order_of_execution)
+            if (load_item->type == NN_WORK_ITEM_TYPE_CONVERT_DATA_LAYOUT) ++conversions;
+        EXPECT_EQ(with_pooling ? 0u : 1u, conversions);
+
+        void *input_buffer = &input_data, *output_buffer = &output_data;
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        for (auto n = 0u; n < batch; ++n)
+            for (auto o = 0u; o < 16; ++o)
+                ASSERT_NEAR(reference(o, n), output_data(o, n), 1e-3f);
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(fully_connected));
+        if (pooling) EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(pooling));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(convolution));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+    }
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workload_execute_independent_branches)
+{
+    const uint32_t branch_count = 4;
+
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    // input [32x32x8] -> 4 independent max poolings 2x2 stride 2x2 -> merge along x -> output [64x16x8]
+    nn_workflow_t *workflow = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+    nn_workflow_item_t  *input = nullptr
+        , *merge = nullptr
+        , *output = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+    input->type = NN_WORK_ITEM_TYPE_INPUT;
+    input->arguments.input.index = 0;
+    input->output_format.format = NN_DATA_FORMAT_3D;
+    input->output_format.format_3d = nn_output_format_3d{ { 32, 32, 8 } };
+
+    std::vector<nn_workflow_item_t *> poolings(branch_count, nullptr);
+    for (auto &pooling : poolings) {
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&pooling, 1, &input));
+        pooling->type = NN_WORK_ITEM_TYPE_POOLING;
+        pooling->arguments.forward_pooling = nn_arguments_forward_pooling_t{ {2, 2}, {2, 2}, NN_POOLING_MODE_MAX };
+        pooling->output_format.format = NN_DATA_FORMAT_3D;
+        pooling->output_format.format_3d = nn_output_format_3d{ { 16, 16, 8 } };
+    }
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&merge, branch_count, poolings.data()));
+    merge->type = NN_WORK_ITEM_TYPE_MERGE;
+    merge->arguments.forward_merge.axis = 0; // x
+    merge->output_format.format = NN_DATA_FORMAT_3D;
+    merge->output_format.format_3d = nn_output_format_3d{ { 16 * branch_count, 16, 8 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &merge));
+    output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+    output->arguments.output.index = 0;
+    output->output_format.format = NN_DATA_FORMAT_3D;
+    output->output_format.format_3d = nn_output_format_3d{ { 16 * branch_count, 16, 8 } };
+
+    workflow->input[0] = input;
+    workflow->output[0] = output;
+
+    nn_workload_t *workload = nullptr;
+    NN_WORKLOAD_DATA_TYPE io_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &io_format, &io_format, 1));
+
+    // poolings land in one wave and run concurrently - each of them has to fill its own part of merged output
+    nn::data<float, 3> input_data(8, 32, 32), output_data(8, 16 * branch_count, 16);
+    fill_pooling_input(input_data, 0.0f);
+    void *input_buffer = &input_data, *output_buffer = &output_data;
+    NN_API_STATUS status;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+
+    for (auto branch = 0u; branch < branch_count; ++branch)
+        for (auto y = 0u; y < 16; ++y)
+            for (auto x = 0u; x < 16; ++x)
+                for (auto z = 0u; z < 8; ++z)
+                    EXPECT_EQ(input_data(z, x * 2 + 1, y * 2 + 1), output_data(z, branch * 16 + x, y));
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(merge));
+    for (auto pooling : poolings)
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(pooling));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workload_save_load_cache)
+{
+    const char *cache_path = "api_workloads_cache.bin";
+    std::remove(cache_path);
+
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    // input [10x10x16] -> convolution 3x3 + ReLU -> output [8x8x32]
+    nn::data<float, 4> weights(3, 3, 16, 32);
+    nn::data<float, 1> biases(32);
+    for (auto o = 0u; o < 32; ++o) {
+        biases(o) = static_cast<float>(o % 3) / 10.0f - 0.1f;
+        for (auto i = 0u; i < 16; ++i)
+            for (auto ky = 0u; ky < 3; ++ky)
+                for (auto kx = 0u; kx < 3; ++kx)
+                    weights(kx, ky, i, o) = static_cast<float>((kx + ky * 3 + i * 5 + o * 7) % 11) / 11.0f - 0.5f;
+    }
+
+    nn_workflow_t *workflow = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+    nn_workflow_item_t  *input = nullptr
+        , *convolution = nullptr
+        , *output = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+    input->type = NN_WORK_ITEM_TYPE_INPUT;
+    input->arguments.input.index = 0;
+    input->output_format.format = NN_DATA_FORMAT_3D;
+    input->output_format.format_3d = nn_output_format_3d{ { 10, 10, 16 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&convolution, 1, &input));
+    convolution->type = NN_WORK_ITEM_TYPE_CONVOLUTION;
+    auto &arguments = convolution->arguments.forward_convolution;
+    arguments.padding = NN_PADDING_MODE_DATA_OR_ZERO;
+    arguments.center_offset[0] = arguments.center_offset[1] = 0;
+    arguments.stride[0] = arguments.stride[1] = 1;
+    arguments.weights = &weights;
+    arguments.biases = &biases;
+    arguments.activation.function = NN_ACTIVATION_FUNCTION_RELU;
+    convolution->output_format.format = NN_DATA_FORMAT_3D;
+    convolution->output_format.format_3d = nn_output_format_3d{ { 8, 8, 32 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &convolution));
+    output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+    output->arguments.output.index = 0;
+    output->output_format.format = NN_DATA_FORMAT_3D;
+    output->output_format.format_3d = nn_output_format_3d{ { 8, 8, 32 } };
+
+    workflow->input[0] = input;
+    workflow->output[0] = output;
+
+    nn::data<float, 3> input_data(16, 10, 10), output_data(32, 8, 8), reference(32, 8, 8);
+    for (auto y = 0u; y < 10; ++y)
+        for (auto x = 0u; x < 10; ++x)
+            for (auto z = 0u; z < 16; ++z)
+                input_data(z, x, y) = static_cast<float>((x + 2 * y + 3 * z) % 7) / 7.0f - 0.5f;
+    for (auto y = 0u; y < 8; ++y)
+        for (auto x = 0u; x < 8; ++x)
+            for (auto o = 0u; o < 32; ++o) {
+                float sum = biases(o);
+                for (auto ky = 0u; ky < 3; ++ky)
+                    for (auto kx = 0u; kx < 3; ++kx)
+                        for (auto i = 0u; i < 16; ++i)
+                            sum += input_data(i, x + kx, y + ky) * weights(kx, ky, i, o);
+                reference(o, x, y) = std::max(sum, 0.0f);
+            }
+
+    auto primitive_of = [](nn_workload_t *workload) {
+        auto workload_opaque = reinterpret_cast<nn_workload_opaque_t *>(workload + 1);
+        return static_cast<layer::convolution_f32 *>(workload_opaque->output[0]->input[0]->primitive);
+    };
+    auto execute_and_check = [&](nn_workload_t *workload) {
+        void *input_buffer = &input_data, *output_buffer = &output_data;
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        for (auto y = 0u; y < 8; ++y)
+            for (auto x = 0u; x < 8; ++x)
+                for (auto o = 0u; o < 32; ++o)
+                    ASSERT_NEAR(reference(o, x, y), output_data(o, x, y), 1e-4f);
+    };
+
+    // compiled workload is saved with packed weights & tuning choice (changed from default to see it is restored)
+    nn_workload_t *workload = nullptr;
+    NN_WORKLOAD_DATA_TYPE io_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &io_format, &io_format, 1));
+    primitive_of(workload)->tuning = nn_cpu_tuning_t{1, 2};
+    execute_and_check(workload);
+    const auto parameter_memory = workload->parameter_memory;
+    EXPECT_LE((3u * 3 * 16 * 32 + 32) * sizeof(float), parameter_memory);
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_save_function(workload, cache_path));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+
+    // weights of workflow are not read when loading - zeroed ones give the same result
+    nn::data<float, 4> zero_weights(3, 3, 16, 32);
+    nn::data<float, 1> zero_biases(32);
+    std::memset(zero_weights.buffer, 0, zero_weights.count() * sizeof(float));
+    std::memset(zero_biases.buffer, 0, zero_biases.count() * sizeof(float));
+    arguments.weights = &zero_weights;
+    arguments.biases = &zero_biases;
+
+    workload = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_load_function(&workload, di.device, workflow, cache_path));
+    ASSERT_NE(nullptr, workload);
+    EXPECT_EQ(1u, workload->batch);
+    EXPECT_EQ(NN_WORKLOAD_DATA_TYPE_F32_ZXY, workload->input_format[0]);
+    EXPECT_EQ(NN_WORKLOAD_DATA_TYPE_F32_ZXY, workload->output_format[0]);
+    EXPECT_EQ(1u, primitive_of(workload)->tuning.kernel);
+    EXPECT_EQ(2u, primitive_of(workload)->tuning.partition);
+    EXPECT_EQ(parameter_memory, workload->parameter_memory);
+    execute_and_check(workload);
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+
+    // workflow with different structure is rejected
+    arguments.activation.function = NN_ACTIVATION_FUNCTION_NONE;
+    workload = nullptr;
+    EXPECT_EQ(NN_API_STATUS_ERROR_INVALID_WORKFLOW, di.workload_load_function(&workload, di.device, workflow, cache_path));
+    EXPECT_EQ(nullptr, workload);
+    arguments.activation.function = NN_ACTIVATION_FUNCTION_RELU;
+
+    // so is cache of other version - its weights may be packed differently
+    {
+        std::fstream file(cache_path, std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t version = nn_cpu_workload_cache::version - 1;
+        file.seekp(8 /* after magic */);
+        file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    }
+    EXPECT_EQ(NN_API_STATUS_ERROR_OTHER, di.workload_load_function(&workload, di.device, workflow, cache_path));
+    EXPECT_EQ(nullptr, workload);
+
+    // and file that is not a workload cache
+    {
+        std::ofstream file(cache_path, std::ios::trunc);
+        file << "not a workload cache\n";
+    }
+    EXPECT_EQ(NN_API_STATUS_ERROR_OTHER, di.workload_load_function(&workload, di.device, workflow, cache_path));
+    std::remove(cache_path);
+    EXPECT_EQ(NN_API_STATUS_ERROR_OTHER, di.workload_load_function(&workload, di.device, workflow, cache_path));
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(convolution));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workload_execute_any_batch)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    // input [40] -> fully connected + ReLU [27] -> fully connected [12] -> softmax [12]
+    const uint32_t input_size = 40, hidden_size = 27, output_size = 12, max_batch = 20;
+    nn::data<float, 2> fc1_weights(input_size, hidden_size), fc2_weights(hidden_size, output_size);
+    nn::data<float, 1> fc1_biases(hidden_size), fc2_biases(output_size);
+    for (auto o = 0u; o < hidden_size; ++o) {
+        fc1_biases(o) = static_cast<float>(o % 5) / 10.0f - 0.2f;
+        for (auto i = 0u; i < input_size; ++i)
+            fc1_weights(i, o) = (static_cast<float>((i * 5 + o * 7) % 11) / 11.0f - 0.5f) / 4.0f;
+    }
+    for (auto o = 0u; o < output_size; ++o) {
+        fc2_biases(o) = static_cast<float>(o % 3) / 10.0f;
+        for (auto i = 0u; i < hidden_size; ++i)
+            fc2_weights(i, o) = static_cast<float>((i * 3 + o * 5) % 13) / 13.0f - 0.5f;
+    }
+
+    nn::data<float, 2> input_data(input_size, max_batch), reference(output_size, max_batch);
+    for (auto n = 0u; n < max_batch; ++n) {
+        for (auto i = 0u; i < input_size; ++i)
+            input_data(i, n) = static_cast<float>((i + 3 * n) % 7) / 7.0f - 0.5f;
+
+        float hidden[hidden_size], sum = 0.0f;
+        for (auto o = 0u; o < hidden_size; ++o) {
+            hidden[o] = fc1_biases(o);
+            for (auto i = 0u; i < input_size; ++i)
+                hidden[o] += input_data(i, n) * fc1_weights(i, o);
+            hidden[o] = std::max(hidden[o], 0.0f);
+        }
+        for (auto o = 0u; o < output_size; ++o) {
+            float value = fc2_biases(o);
+            for (auto i = 0u; i < hidden_size; ++i)
+                value += hidden[i] * fc2_weights(i, o);
+            reference(o, n) = std::exp(value);
+            sum += reference(o, n);
+        }
+        for (auto o = 0u; o < output_size; ++o)
+            reference(o, n) /= sum;
+    }
+
+    nn_workflow_t *workflow = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+    nn_workflow_item_t  *input = nullptr
+        , *fc1 = nullptr
+        , *fc2 = nullptr
+        , *softmax = nullptr
+        , *output = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+    input->type = NN_WORK_ITEM_TYPE_INPUT;
+    input->arguments.input.index = 0;
+    input->output_format.format = NN_DATA_FORMAT_1D;
+    input->output_format.format_1d = nn_output_format_1d{ { input_size } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&fc1, 1, &input));
+    fc1->type = NN_WORK_ITEM_TYPE_FULLY_CONNECTED;
+    fc1->arguments.forward_fully_connected.weights = &fc1_weights;
+    fc1->arguments.forward_fully_connected.biases = &fc1_biases;
+    fc1->arguments.forward_fully_connected.activation.function = NN_ACTIVATION_FUNCTION_RELU;
+    fc1->output_format.format = NN_DATA_FORMAT_1D;
+    fc1->output_format.format_1d = nn_output_format_1d{ { hidden_size } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&fc2, 1, &fc1));
+    fc2->type = NN_WORK_ITEM_TYPE_FULLY_CONNECTED;
+    fc2->arguments.forward_fully_connected.weights = &fc2_weights;
+    fc2->arguments.forward_fully_connected.biases = &fc2_biases;
+    fc2->arguments.forward_fully_connected.activation.function = NN_ACTIVATION_FUNCTION_NONE;
+    fc2->output_format.format = NN_DATA_FORMAT_1D;
+    fc2->output_format.format_1d = nn_output_format_1d{ { output_size } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&softmax, 1, &fc2));
+    softmax->type = NN_WORK_ITEM_TYPE_SOFTMAX;
+    softmax->output_format.format = NN_DATA_FORMAT_1D;
+    softmax->output_format.format_1d = nn_output_format_1d{ { output_size } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &softmax));
+    output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+    output->arguments.output.index = 0;
+    output->output_format.format = NN_DATA_FORMAT_1D;
+    output->output_format.format_1d = nn_output_format_1d{ { output_size } };
+
+    workflow->input[0] = input;
+    workflow->output[0] = output;
+
+    // batches that are not multiple of 8 run masked remainders; every workload also serves smaller batches
+    for (auto compiled_batch : {3u, 8u, 13u, 16u, max_batch}) {
+        nn_workload_t *workload = nullptr;
+        NN_WORKLOAD_DATA_TYPE io_format = NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &io_format, &io_format, compiled_batch));
+
+        for (auto batch : {compiled_batch, compiled_batch - 1, 1u}) {
+            // images behind submitted ones are poisoned on input and have to stay untouched on output
+            nn::data<float, 2> guarded_input(input_size, compiled_batch), guarded_output(output_size, compiled_batch);
+            for (auto n = 0u; n < compiled_batch; ++n) {
+                for (auto i = 0u; i < input_size; ++i)
+                    guarded_input(i, n) = n < batch ? input_data(i, n) : std::numeric_limits<float>::quiet_NaN();
+                for (auto o = 0u; o < output_size; ++o)
+                    guarded_output(o, n) = -1.0f;
+            }
+            nn::data<float, 2> batch_input(static_cast<float *>(guarded_input.buffer), input_size, batch), batch_output(static_cast<float *>(guarded_output.buffer), output_size, batch);
+            void *input_buffer = &batch_input, *output_buffer = &batch_output;
+            NN_API_STATUS status;
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+            for (auto n = 0u; n < compiled_batch; ++n)
+                for (auto o = 0u; o < output_size; ++o)
+                    ASSERT_NEAR(n < batch ? reference(o, n) : -1.0f, guarded_output(o, n), 1e-4f) << "compiled batch " << compiled_batch << ", batch " << batch;
+        }
+
+        // batch over the one workload was compiled for is rejected
+        nn::data<float, 2> large_input(static_cast<float *>(input_data.buffer), input_size, compiled_batch + 1), large_output(output_size, compiled_batch + 1);
+        void *input_buffer = &large_input, *output_buffer = &large_output;
+        NN_API_STATUS status;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+        EXPECT_EQ(NN_API_STATUS_ERROR_INVALID_MEMORY_LAYOUT, di.workload_wait_function(workload, &status));
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+    }
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(softmax));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(fc2));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(fc1));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+
+    // input [4x5x6] -> conversion to int16 fixed point [4x5x6], as in front of quantized workflows
+    const uint32_t size_z = 4, size_x = 5, size_y = 6;
+    const int8_t output_fraction = 8;
+    nn::data<float, 4> image_data(size_z, size_x, size_y, max_batch);
+    for (auto index = 0u; index < image_data.count(); ++index)
+        static_cast<float *>(image_data.buffer)[index] = static_cast<float>(index % 29) / 29.0f - 0.5f;
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+    nn_workflow_item_t *convert = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+    input->type = NN_WORK_ITEM_TYPE_INPUT;
+    input->arguments.input.index = 0;
+    input->output_format.format = NN_DATA_FORMAT_3D;
+    input->output_format.format_3d = nn_output_format_3d{ { size_x, size_y, size_z } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&convert, 1, &input));
+    convert->type = NN_WORK_ITEM_TYPE_CONVERT_FLOAT_TO_INT16_FIXEDPOINT;
+    convert->arguments.forward_convert_float_to_int16_fixedpoint.output_fraction = output_fraction;
+    convert->output_format.format = NN_DATA_FORMAT_3D;
+    convert->output_format.format_3d = nn_output_format_3d{ { size_x, size_y, size_z } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &convert));
+    output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+    output->arguments.output.index = 0;
+    output->output_format.format = NN_DATA_FORMAT_3D;
+    output->output_format.format_3d = nn_output_format_3d{ { size_x, size_y, size_z } };
+
+    workflow->input[0] = input;
+    workflow->output[0] = output;
+
+    for (auto compiled_batch : {1u, 8u, 13u}) {
+        nn_workload_t *workload = nullptr;
+        NN_WORKLOAD_DATA_TYPE input_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH, output_format = NN_WORKLOAD_DATA_TYPE_I16_ZXY_BATCH;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &input_format, &output_format, compiled_batch));
+
+        for (auto batch : {compiled_batch, compiled_batch - 1, 1u}) {
+            if (batch == 0) continue;
+            nn::data<int16_t, 4> guarded_output(size_z, size_x, size_y, compiled_batch);
+            for (auto index = 0u; index < guarded_output.count(); ++index)
+                static_cast<int16_t *>(guarded_output.buffer)[index] = -1;
+            nn::data<float, 4> batch_input(static_cast<float *>(image_data.buffer), size_z, size_x, size_y, batch);
+            nn::data<int16_t, 4> batch_output(static_cast<int16_t *>(guarded_output.buffer), size_z, size_x, size_y, batch);
+            void *input_buffer = &batch_input, *output_buffer = &batch_output;
+            NN_API_STATUS status;
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+            for (auto index = 0u; index < guarded_output.count(); ++index) {
+                const auto expected = index < batch * size_z * size_x * size_y
+                    ? static_cast<int16_t>(std::nearbyint(std::ldexp(static_cast<float *>(image_data.buffer)[index], output_fraction)))
+                    : int16_t(-1);
+                ASSERT_EQ(expected, static_cast<int16_t *>(guarded_output.buffer)[index]) << "compiled batch " << compiled_batch << ", batch " << batch;
+            }
+        }
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+    }
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(convert));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+
+    test_teardown(device_description, device_interface_0);
+}
+
+TEST(api_workloads, workload_execute_any_batch_convolution)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t device_interface_0;
+    test_setup(device_description, device_interface_0);
+
+    // shorter name for function calls
+    nn_device_interface_0_t &di = device_interface_0;
+
+    // input [9x9x8] -> convolution 3x3 + ReLU [7x7x16] -> pooling 3x3 stride 2x2 [3x3x16] -> fully connected [10] -> softmax [10]
+    const uint32_t max_batch = 13, output_size = 10;
+    nn::data<float, 4> conv_weights(3, 3, 8, 16);
+    nn::data<float, 1> conv_biases(16), fc_biases(output_size);
+    nn::data<float, 4> fc_weights(3, 3, 16, output_size);
+    for (auto o = 0u; o < 16; ++o) {
+        conv_biases(o) = static_cast<float>(o % 5) / 10.0f - 0.2f;
+        for (auto i = 0u; i < 8; ++i)
+            for (auto ky = 0u; ky < 3; ++ky)
+                for (auto kx = 0u; kx < 3; ++kx)
+                    conv_weights(kx, ky, i, o) = static_cast<float>((kx + ky * 3 + i * 5 + o * 7) % 11) / 11.0f - 0.5f;
+    }
+    for (auto o = 0u; o < output_size; ++o) {
+        fc_biases(o) = static_cast<float>(o % 3) / 10.0f;
+        for (auto i = 0u; i < 16; ++i)
+            for (auto y = 0u; y < 3; ++y)
+                for (auto x = 0u; x < 3; ++x)
+                    fc_weights(x, y, i, o) = (static_cast<float>((x + y * 3 + i * 3 + o * 5) % 13) / 13.0f - 0.5f) / 8.0f;
+    }
+
+    nn::data<float, 4> input_data(8, 9, 9, max_batch);
+    for (auto n = 0u; n < max_batch; ++n)
+        for (auto y = 0u; y < 9; ++y)
+            for (auto x = 0u; x < 9; ++x)
+                for (auto z = 0u; z < 8; ++z)
+                    input_data(z, x, y, n) = static_cast<float>((x + 2 * y + 3 * z + 5 * n) % 7) / 7.0f - 0.5f;
+
+    nn_workflow_t *workflow = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+    nn_workflow_item_t  *input = nullptr
+        , *convolution = nullptr
+        , *pooling = nullptr
+        , *fc = nullptr
+        , *softmax = nullptr
+        , *output = nullptr;
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&input, 0, nullptr));
+    input->type = NN_WORK_ITEM_TYPE_INPUT;
+    input->arguments.input.index = 0;
+    input->output_format.format = NN_DATA_FORMAT_3D;
+    input->output_format.format_3d = nn_output_format_3d{ { 9, 9, 8 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&convolution, 1, &input));
+    convolution->type = NN_WORK_ITEM_TYPE_CONVOLUTION;
+    auto &arguments = convolution->arguments.forward_convolution;
+    arguments.padding = NN_PADDING_MODE_DATA_OR_ZERO;
+    arguments.center_offset[0] = arguments.center_offset[1] = 0;
+    arguments.stride[0] = arguments.stride[1] = 1;
+    arguments.weights = &conv_weights;
+    arguments.biases = &conv_biases;
+    arguments.activation.function = NN_ACTIVATION_FUNCTION_RELU;
+    convolution->output_format.format = NN_DATA_FORMAT_3D;
+    convolution->output_format.format_3d = nn_output_format_3d{ { 7, 7, 16 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&pooling, 1, &convolution));
+    pooling->type = NN_WORK_ITEM_TYPE_POOLING;
+    pooling->arguments.forward_pooling = nn_arguments_forward_pooling_t{
+        {2, 2},             /* stride during filtering operation */
+        {3, 3},             /* pooling area size */
+        NN_POOLING_MODE_MAX /* pooling mode */
+    };
+    pooling->output_format.format = NN_DATA_FORMAT_3D;
+    pooling->output_format.format_3d = nn_output_format_3d{ { 3, 3, 16 } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&fc, 1, &pooling));
+    fc->type = NN_WORK_ITEM_TYPE_FULLY_CONNECTED;
+    fc->arguments.forward_fully_connected.weights = &fc_weights;
+    fc->arguments.forward_fully_connected.biases = &fc_biases;
+    fc->arguments.forward_fully_connected.activation.function = NN_ACTIVATION_FUNCTION_NONE;
+    fc->output_format.format = NN_DATA_FORMAT_1D;
+    fc->output_format.format_1d = nn_output_format_1d{ { output_size } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&softmax, 1, &fc));
+    softmax->type = NN_WORK_ITEM_TYPE_SOFTMAX;
+    softmax->output_format.format = NN_DATA_FORMAT_1D;
+    softmax->output_format.format_1d = nn_output_format_1d{ { output_size } };
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&output, 1, &softmax));
+    output->type = NN_WORK_ITEM_TYPE_OUTPUT;
+    output->arguments.output.index = 0;
+    output->output_format.format = NN_DATA_FORMAT_1D;
+    output->output_format.format_1d = nn_output_format_1d{ { output_size } };
+
+    workflow->input[0] = input;
+    workflow->output[0] = output;
+
+    // images of smaller batch give the same results as in full one, images behind them are neither read nor written
+    for (auto compiled_batch : {8u, max_batch}) {
+        nn_workload_t *workload = nullptr;
+        NN_WORKLOAD_DATA_TYPE input_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH, output_format = NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH;
+        EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &input_format, &output_format, compiled_batch));
+
+        nn::data<float, 4> full_input(static_cast<float *>(input_data.buffer), 8, 9, 9, compiled_batch);
+        nn::data<float, 2> reference(output_size, compiled_batch);
+        {
+            void *input_buffer = &full_input, *output_buffer = &reference;
+            NN_API_STATUS status;
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+        }
+
+        for (auto batch : {compiled_batch - 3, 1u}) {
+            nn::data<float, 4> guarded_input(8, 9, 9, compiled_batch);
+            nn::data<float, 2> guarded_output(output_size, compiled_batch);
+            for (auto n = 0u; n < compiled_batch; ++n) {
+                for (auto y = 0u; y < 9; ++y)
+                    for (auto x = 0u; x < 9; ++x)
+                        for (auto z = 0u; z < 8; ++z)
+                            guarded_input(z, x, y, n) = n < batch ? input_data(z, x, y, n) : std::numeric_limits<float>::quiet_NaN();
+                for (auto o = 0u; o < output_size; ++o)
+                    guarded_output(o, n) = -1.0f;
+            }
+            nn::data<float, 4> batch_input(static_cast<float *>(guarded_input.buffer), 8, 9, 9, batch);
+            nn::data<float, 2> batch_output(static_cast<float *>(guarded_output.buffer), output_size, batch);
+            void *input_buffer = &batch_input, *output_buffer = &batch_output;
+            NN_API_STATUS status;
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, &input_buffer, &output_buffer, &status));
+            EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
+            for (auto n = 0u; n < compiled_batch; ++n)
+                for (auto o = 0u; o < output_size; ++o)
+                    ASSERT_NEAR(n < batch ? reference(o, n) : -1.0f, guarded_output(o, n), 1e-5f) << "compiled batch " << compiled_batch << ", batch " << batch;
+        }
+
+        EXPECT_EQ(NN_API_STATUS_OK, di.workload_delete_function(workload));
+    }
+
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(output));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(softmax));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(fc));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(pooling));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(convolution));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(input));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+
+    test_teardown(device_description, device_interface_0);
+}
+
 //TEST(api_workloads, workflow_in_convolve_int16_out_compilation)
 //{
 //    // test configuration
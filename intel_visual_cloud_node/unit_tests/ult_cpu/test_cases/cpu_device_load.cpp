@@ -29,6 +29,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "../../devices/api/nn_device_api.h"
 #include "../../devices/api/nn_device_interface_0.h"
+#include "../../devices/device_cpu/api_internal/cpu_isa.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -80,6 +81,7 @@ TEST( cpu_device_load_and_unload, callbacks_test )
             EXPECT_NE(nullptr, di.parameter_get_function);              // non-null function pointer returned
             EXPECT_NE(nullptr, di.parameter_set_function);              // non-null function pointer returned
             EXPECT_NE(nullptr, di.translate_api_status_function);       // non-null function pointer returned
+            EXPECT_NE(nullptr, di.workload_wait_function);              // non-null function pointer returned
             EXPECT_EQ(0, nn_device_interface_close(&di));               // successful close of interface
         }
     }
@@ -87,3 +89,36 @@ TEST( cpu_device_load_and_unload, callbacks_test )
     // nn_device_unload
     EXPECT_EQ(0, nn_device_unload()); // successful unload
 }
+
+TEST( cpu_device_load_and_unload, instruction_set_parameter )
+{
+    nn_device_description_t dd;
+    nn_device_interface_0_t di;
+    EXPECT_EQ(0, nn_device_load(&dd));
+    EXPECT_EQ(0, nn_device_interface_open(0, &di));
+
+    // best instruction set of host is selected at load
+    uint32_t isa = NN_CPU_ISA_LAST + 1;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa)));
+    EXPECT_EQ(static_cast<uint32_t>(nn_cpu_isa_detect()), isa);
+
+    // AVX2 is always supported
+    isa = NN_CPU_ISA_AVX2;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa)));
+    isa = NN_CPU_ISA_LAST + 1;
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_get_function(di.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa)));
+    EXPECT_EQ(static_cast<uint32_t>(NN_CPU_ISA_AVX2), isa);
+
+    // AVX-512 only where host has it
+    isa = NN_CPU_ISA_AVX512;
+    const auto expected = nn_cpu_isa_supported(NN_CPU_ISA_AVX512) ? NN_API_STATUS_OK : NN_API_STATUS_ERROR_OTHER;
+    EXPECT_EQ(expected, di.parameter_set_function(di.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa)));
+
+    // invalid arguments
+    isa = NN_CPU_ISA_LAST + 1;
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa)));
+    EXPECT_NE(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_ISA, &isa, 1));
+
+    EXPECT_EQ(0, nn_device_interface_close(&di));
+    EXPECT_EQ(0, nn_device_unload());
+}
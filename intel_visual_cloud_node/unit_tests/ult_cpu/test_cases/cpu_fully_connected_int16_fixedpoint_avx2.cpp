@@ -199,7 +199,7 @@ static void ult_nn_fc_deinitialize_work_items(nn_workload_item* work_items[])
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
-static bool ult_nn_fc_interface_run(nn_workload_item* work_item)
+static bool ult_nn_fc_interface_run(nn_workload_item* work_item, uint32_t isa)
 {
     bool retvalue = true;
 
@@ -209,6 +209,7 @@ static bool ult_nn_fc_interface_run(nn_workload_item* work_item)
 
     nn_device_load(&device_description);
     nn_device_interface_open(0, &device_interface_0);
+    device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa));
 
     int16_fixedpoint::run_multithreaded_fully_connected_fixedpoint_work_item(work_item, reinterpret_cast<nn_device_internal*>(device_interface_0.device));
 
@@ -509,7 +510,8 @@ bool ult_fc_int16_fp_perform_test(
     bool check_out_views,
     uint8_t accumulator_fraction,
     uint8_t output_fraction,
-    NN_ACTIVATION_FUNCTION activation )
+    NN_ACTIVATION_FUNCTION activation,
+    uint32_t isa = NN_CPU_ISA_AVX2)
 {
     nn_workload_item* work_item = nullptr;
     nn_workload_item* work_items[8];
@@ -611,7 +613,7 @@ bool ult_fc_int16_fp_perform_test(
             activation);
 
         //Optimized convolution.
-        passed = ult_nn_fc_interface_run(work_item);
+        passed = ult_nn_fc_interface_run(work_item, isa);
     }
 
     if (passed)
@@ -658,14 +660,18 @@ TEST(cpu_fully_connected_int16_fp, cpu16_fully_connected_test)
 
     //EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int32_t>(512, 1000, 1, false, 16, 0, NN_ACTIVATION_FUNCTION_NONE));
 
+    for (uint32_t isa = 0; isa <= nn_cpu_isa_detect(); ++isa)
     for (uint32_t &batchsize : batches)
     {
-        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int32_t>(64, 64, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_NONE));
-        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int32_t>(256, 256, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_NONE));
-        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int32_t>(512, 1000, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_NONE));
+        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int32_t>(64, 64, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_NONE, isa));
+        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int32_t>(256, 256, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_NONE, isa));
+        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int32_t>(512, 1000, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_NONE, isa));
 
-        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int16_t>(64, 64, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_RELU));
-        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int16_t>(256, 256, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_RELU));
-        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int16_t>(512, 1000, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_RELU));
+        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int16_t>(64, 64, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_RELU, isa));
+        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int16_t>(256, 256, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_RELU, isa));
+        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int16_t>(512, 1000, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_RELU, isa));
+
+        // odd number of input pairs - last pair computed by AVX2 instructions of AVX-512 kernel
+        EXPECT_EQ(true, ult_fc_int16_fp_perform_test<int32_t>(66, 64, batchsize, false, 16, 0, NN_ACTIVATION_FUNCTION_NONE, isa));
     }
 }
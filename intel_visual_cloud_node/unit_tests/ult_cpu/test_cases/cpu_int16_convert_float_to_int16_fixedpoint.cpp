@@ -31,6 +31,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../devices/device_cpu/api_internal/nn_device_interface_0_internal.h"
 #include "../../devices/device_cpu/core/fixedpoint/layer_convert_float_to_int16_fixedpoint_avx2.h"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -121,3 +123,61 @@ TEST(cpu_int16_convert_float_to_int16_fixedpoint, convert_RGB_to_ZRGB) {
      EXPECT_TRUE(check_result(reinterpret_cast<float *>(input_data->parent->data_buffer),
                               reinterpret_cast<std::int16_t *>(output_data->parent->data_buffer)));
 }
+
+TEST(cpu_int16_convert_float_to_int16_fixedpoint, convert_contiguous) {
+    // 4 feature maps need no reordering, buffer is converted as a whole; its size is not multiple of SIMD width
+    const uint32_t width = 5, height = 3, batch = 2;
+
+    nn_workload_data_layout_t input_layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
+                                              {0, 0, 0, 0, 0, 0}, // alignment
+                                              {NN_DATA_COORD_z,
+                                               NN_DATA_COORD_x,
+                                               NN_DATA_COORD_y,
+                                               NN_DATA_COORD_n,
+                                               NN_DATA_COORD_p,
+                                               NN_DATA_COORD_q}, // ordering
+                                               NN_DATATYPE_FLOAT};
+
+    nn_workload_data_layout_t output_layout = {{0, 0, 0, 0, 0, 0}, // tile in log2(size)
+                                               {0, 0, 0, 0, 0, 0}, // alignment
+                                               {NN_DATA_COORD_p,
+                                                NN_DATA_COORD_x,
+                                                NN_DATA_COORD_y,
+                                                NN_DATA_COORD_z,
+                                                NN_DATA_COORD_n,
+                                                NN_DATA_COORD_q}, // ordering
+                                               NN_DATATYPE_INT16};
+
+    nn_workload_data_coords_t input_coords = {batch, width, height, 4, 1, 1};
+    nn_workload_data_coords_t output_coords = {batch, width, height, 1, 4, 1};
+
+    const uint32_t count = batch * width * height * 4;
+    std::unique_ptr<nn::nn_workload_data_t<float>> input_data(new nn::nn_workload_data_t<float>(input_coords, input_layout));
+    auto input = reinterpret_cast<float *>(input_data->parent->data_buffer);
+    for (uint32_t i = 0; i < count; ++i)
+        input[i] = (i % 2 ? -1.0f : 1.0f) * i * 0.37f;
+
+    std::unique_ptr<nn::nn_workload_data_t<std::int16_t>> output_data(new nn::nn_workload_data_t<std::int16_t>(output_coords, output_layout));
+    auto output = reinterpret_cast<std::int16_t *>(output_data->parent->data_buffer);
+
+    std::unique_ptr<nn_workload_item> input_item(new nn_workload_item());
+    input_item->output = input_data.get();
+
+    std::unique_ptr<nn_workload_item> work_item(new nn_workload_item());
+    work_item->type = NN_WORK_ITEM_TYPE_CONVERT_FLOAT_TO_INT16_FIXEDPOINT;
+    work_item->input.push_back(input_item.get());
+    work_item->output = output_data.get();
+
+    // fractions below & above 8 scale up, negative ones scale down; large values saturate
+    for (int8_t fraction : {-2, 3, 12}) {
+        work_item->arguments.forward_convert_float_to_fixedpoint.output_fraction = fraction;
+        int16_fixedpoint::run_convert_float_to_int16_fp_work_item(work_item.get());
+
+        for (uint32_t i = 0; i < count; ++i) {
+            auto scaled = std::round(std::ldexp(input[i], fraction));
+            scaled = std::max(scaled, static_cast<float>(INT16_MIN));
+            scaled = std::min(scaled, static_cast<float>(INT16_MAX));
+            ASSERT_EQ(static_cast<std::int16_t>(scaled), output[i]) << "fraction " << int(fraction) << ", element " << i;
+        }
+    }
+}
@@ -80,6 +80,7 @@ TEST( cpu_int16_device_load_and_unload, callbacks_test )
             EXPECT_NE(nullptr, di.parameter_get_function);              // non-null function pointer returned
             EXPECT_NE(nullptr, di.parameter_set_function);              // non-null function pointer returned
             EXPECT_NE(nullptr, di.translate_api_status_function);       // non-null function pointer returned
+            EXPECT_NE(nullptr, di.workload_wait_function);              // non-null function pointer returned
             EXPECT_EQ(0, nn_device_interface_close(&di));               // successful close of interface
         }
     }
@@ -28,11 +28,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <immintrin.h>
 #include <cmath>
 #include <algorithm>
+#include <memory>
 #include "gtest/gtest.h"
 
 #include "../../devices/common/nn_workload_data.h"
 #include "../../devices/device_cpu/core/layer_convolution_avx2.h"
 #include "../../devices/device_cpu/api_internal/nn_device_interface_0_internal.h"
+#include "../../devices/device_cpu/api_internal/cpu_jit.h"
 
 const uint32_t C_simd_width = sizeof(__m256)/sizeof(float);
 const uint32_t C_slice_size = 2 * C_simd_width;
@@ -979,6 +981,8 @@ void ult_nn_convolve_naive(
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
+// Device runs AVX2 kernels unless test selects other instruction set - default tuning covers generated kernel;
+// thread count of device is used unless test sets it (0).
 bool ult_perform_test(
     uint_least32_t batch_size,
     uint_least32_t num_output_feature_maps,
@@ -990,7 +994,10 @@ bool ult_perform_test(
     uint_least32_t kernel_stride_x,
     uint_least32_t kernel_stride_y,
     bool check_out_views,
-    NN_ACTIVATION_FUNCTION activation )
+    NN_ACTIVATION_FUNCTION activation,
+    nn_cpu_tuning_t tuning = nn_cpu_tuning_t(),
+    uint32_t isa = NN_CPU_ISA_AVX2,
+    uint32_t num_threads = 0)
 {
     nn_workload_item* work_item = nullptr;
     nn_workload_item* work_items[8];
@@ -1081,6 +1088,9 @@ bool ult_perform_test(
 
     nn_device_load(&device_description);
     nn_device_interface_open(0, &device_interface_0);
+    device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa));
+    if (num_threads)
+        device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_THREAD_COUNT, &num_threads, sizeof(num_threads));
 
     if (check_out_views)
     {
@@ -1107,6 +1117,8 @@ bool ult_perform_test(
             kernel_stride_y,
             activation,
             device_interface_0.device);
+        for (auto item : work_items)
+            static_cast<layer::convolution_f32 *>(item->primitive)->tuning = tuning;
 
         // Optimized convolution.
         passed = ult_nn_convolution_interface_run(work_items, reinterpret_cast<nn_device_internal *>(device_interface_0.device));
@@ -1134,6 +1146,7 @@ bool ult_perform_test(
             kernel_stride_y,
             activation,
             device_interface_0.device);
+        static_cast<layer::convolution_f32 *>(work_item->primitive)->tuning = tuning;
 
         // Optimized convolution.
         passed = ult_nn_convolution_interface_run(work_item, reinterpret_cast<nn_device_internal *>(device_interface_0.device));
@@ -1187,7 +1200,10 @@ bool ult_perform_padding_test(
     uint_least32_t kernel_height,
     uint_least32_t kernel_stride_x,
     uint_least32_t kernel_stride_y,
-    NN_ACTIVATION_FUNCTION activation)
+    NN_ACTIVATION_FUNCTION activation,
+    nn_cpu_tuning_t tuning = nn_cpu_tuning_t(),
+    uint32_t isa = NN_CPU_ISA_AVX2,
+    uint32_t num_threads = 0)
 {
     uint32_t center_offset_x = (kernel_width - 1) / 2;
     uint32_t center_offset_y = (kernel_height - 1) / 2;
@@ -1323,6 +1339,9 @@ bool ult_perform_padding_test(
 
     nn_device_load(&device_description);
     nn_device_interface_open(0, &device_interface_0);
+    device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa));
+    if (num_threads)
+        device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_THREAD_COUNT, &num_threads, sizeof(num_threads));
     device = device_interface_0.device;
 
     nn_workload_item* reference_conv = new nn_workload_item();
@@ -1417,6 +1436,7 @@ bool ult_perform_padding_test(
     }
 
     layer::run_multithreaded_convolve_work_item(reference_conv, reinterpret_cast<nn_device_internal *>(device));
+    static_cast<layer::convolution_f32 *>(tested_conv->primitive)->tuning = tuning;
     layer::run_multithreaded_convolve_work_item(tested_conv, reinterpret_cast<nn_device_internal *>(device));
 
     nn_device_interface_close(&device_interface_0);
@@ -1995,6 +2015,122 @@ TEST(cpu_convolution_real, cpu_convolution_)
     EXPECT_EQ(true, ult_perform_test(1, 3072, 1024, 6, 6, 6, 6, 1, 1, false, NN_ACTIVATION_FUNCTION_NONE));
 }
 
+TEST(cpu_convolution_artificial, cpu_convolution_generated_kernel_loops)
+{
+    // Kernel rows short enough to be unrolled completely & longer ones looping over groups of maps with remainder.
+    uint32_t input_feature_maps[] = { 1, 7, 8, 13, 21, 64, 65 };
+    uint32_t kernel_sizes[] = { 1, 3, 5 };
+    NN_ACTIVATION_FUNCTION activations[] = { NN_ACTIVATION_FUNCTION_NONE, NN_ACTIVATION_FUNCTION_RELU };
+    for (auto num_ifm : input_feature_maps)
+        for (auto kernel_size : kernel_sizes)
+            for (auto activation : activations)
+            {
+                EXPECT_EQ(true, ult_perform_test(1, 32, num_ifm, 11, 9, kernel_size, kernel_size, 1, 1, false, activation));
+                EXPECT_EQ(true, ult_perform_test(2, 16, num_ifm, 17, 9, kernel_size, kernel_size, 2, 1, false, activation));
+            }
+}
+
+TEST(cpu_convolution_artificial, cpu_convolution_row_partition)
+{
+    // Single image with few output feature maps is split into ranges of rows for more jobs than threads,
+    // less & as many jobs as threads; fixed (tuned) slices per job are split into rows as well.
+    const nn_cpu_tuning_t slices_per_job{0, 2};
+    for (uint32_t num_threads : { 3u, 4u, 7u })
+    {
+        EXPECT_EQ(true, ult_perform_test(1, 16, 3, 27, 27, 11, 11, 4, 4, false, NN_ACTIVATION_FUNCTION_RELU, nn_cpu_tuning_t(), NN_CPU_ISA_AVX2, num_threads));
+        EXPECT_EQ(true, ult_perform_test(1, 32, 7, 11, 9, 3, 3, 1, 1, true, NN_ACTIVATION_FUNCTION_NONE, nn_cpu_tuning_t(), NN_CPU_ISA_AVX2, num_threads));
+        EXPECT_EQ(true, ult_perform_test(1, 32, 8, 17, 13, 5, 5, 2, 3, false, NN_ACTIVATION_FUNCTION_RELU, slices_per_job, NN_CPU_ISA_AVX2, num_threads));
+
+        // Rows at borders of ranges read neighbouring rows, rows at borders of image read zeros.
+        for (uint32_t fm_size = 5; fm_size < 10; fm_size += 4)
+            for (uint32_t stride = 1; stride <= 2; ++stride)
+                EXPECT_EQ(true, ult_perform_padding_test(1, 16, 3, fm_size, fm_size, 2, 2, stride, stride, NN_ACTIVATION_FUNCTION_NONE, nn_cpu_tuning_t(), NN_CPU_ISA_AVX2, num_threads));
+    }
+}
+
+TEST(cpu_convolution_artificial, cpu_convolution_implicit_gemm)
+{
+    // Input feature maps fitting packed block with many kernel positions, with single one & split into blocks;
+    // tiles of pixels crossing rows, partial groups of pixels & output feature maps split between jobs.
+    // Micro-kernels of all instruction sets host supports.
+    const nn_cpu_tuning_t gemm{2, 0}, gemm_small_tiles{2, 1};
+    uint32_t input_feature_maps[] = { 1, 7, 64, 300 };
+    NN_ACTIVATION_FUNCTION activations[] = { NN_ACTIVATION_FUNCTION_NONE, NN_ACTIVATION_FUNCTION_RELU };
+    for (uint32_t isa = 0; isa <= nn_cpu_isa_detect(); ++isa)
+    {
+        for (auto num_ifm : input_feature_maps)
+            for (auto activation : activations)
+            {
+                EXPECT_EQ(true, ult_perform_test(1, 32, num_ifm, 11, 9, 3, 3, 1, 1, false, activation, gemm, isa));
+                EXPECT_EQ(true, ult_perform_test(2, 16, num_ifm, 17, 9, 5, 5, 2, 1, false, activation, gemm, isa));
+                EXPECT_EQ(true, ult_perform_test(1, 48, num_ifm, 13, 13, 3, 2, 3, 2, false, activation, gemm_small_tiles, isa));
+                EXPECT_EQ(true, ult_perform_test(8, 32, num_ifm, 10, 10, 3, 3, 1, 1, true, activation, gemm, isa));
+            }
+
+        // Krizhevsky C1 - 3 input feature maps, kernel 11x11 with stride 4.
+        EXPECT_EQ(true, ult_perform_test(1, 96, 3, 227, 227, 11, 11, 4, 4, true, NN_ACTIVATION_FUNCTION_RELU, gemm, isa));
+
+        // Borders read as zeros.
+        for (uint32_t fm_size = 1; fm_size < 8; fm_size += 3)
+            for (uint32_t kernel_size = 1; kernel_size <= 3; ++kernel_size)
+                for (uint32_t stride = 1; stride <= 2; ++stride)
+                {
+                    EXPECT_EQ(true, ult_perform_padding_test(1, 16, 3, fm_size, fm_size, kernel_size, kernel_size, stride, stride, NN_ACTIVATION_FUNCTION_NONE, gemm, isa));
+                    EXPECT_EQ(true, ult_perform_padding_test(8, 32, 2, fm_size, fm_size, kernel_size, kernel_size, stride, stride, NN_ACTIVATION_FUNCTION_RELU, gemm, isa));
+                }
+    }
+}
+
+TEST(cpu_convolution_artificial, cpu_convolution_tuning_candidates)
+{
+    // Default tuning set by create is the first candidate (implicit GEMM on devices running AVX-512 kernels);
+    // every candidate runs the kernel it names & computes the same result as naive convolution.
+    typedef layer::convolution_f32::kernel_type kernel_type;
+    nn_argument_activation_t activation;
+    activation.function = NN_ACTIVATION_FUNCTION_RELU;
+    for (uint32_t isa = 0; isa <= nn_cpu_isa_detect(); ++isa)
+        for (uint32_t num_threads : { 1u, 4u })
+        {
+            nn_device_description_t device_description;
+            nn_device_interface_0_t device_interface_0;
+            nn_device_load(&device_description);
+            nn_device_interface_open(0, &device_interface_0);
+            device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa));
+            device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_THREAD_COUNT, &num_threads, sizeof(num_threads));
+
+            std::unique_ptr<layer::convolution_f32> primitive(
+                layer::convolution_f32::create(3, 3, 8, 32, 9, 9, 0, 0, 1, 1, activation, 1, device_interface_0.device));
+            const auto candidates = primitive->get_tuning_candidates();
+            ASSERT_FALSE(candidates.empty());
+            EXPECT_EQ(candidates.front().kernel, primitive->tuning.kernel);
+            EXPECT_EQ(candidates.front().partition, primitive->tuning.partition);
+            if (isa == NN_CPU_ISA_AVX512)
+                EXPECT_EQ(kernel_type::implicit_gemm, primitive->get_kernel());
+            else
+                EXPECT_NE(kernel_type::implicit_gemm, primitive->get_kernel());
+
+            std::vector<kernel_type> kernels;
+            for (auto candidate : candidates)
+            {
+                primitive->tuning = candidate;
+                kernels.push_back(primitive->get_kernel());
+            }
+            primitive.reset();
+            nn_device_interface_close(&device_interface_0);
+            nn_device_unload();
+
+            for (size_t index = 0; index < candidates.size(); ++index)
+            {
+                const auto &candidate = candidates[index];
+                const auto expected = candidate.kernel == 2 ? kernel_type::implicit_gemm
+                                    : candidate.kernel == 1 ? kernel_type::generic
+                                    : nn_cpu_jit_code::is_supported() ? kernel_type::generated : kernel_type::generic;
+                EXPECT_EQ(expected, kernels[index]);
+                EXPECT_EQ(true, ult_perform_test(1, 32, 8, 11, 11, 3, 3, 1, 1, false, NN_ACTIVATION_FUNCTION_RELU, candidate, isa, num_threads));
+            }
+        }
+}
+
 TEST(cpu_convolution_artificial_view, cpu_convolution_stride1)
 {
     uint32_t batches[] = { 1, 8 };
@@ -214,7 +214,7 @@ static void ult_nn_convolution_fp_deinitialize_work_item(nn_workload_item* &work
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
-static bool ult_nn_convolution_fp_interface_run(nn_workload_item* &work_item)
+static bool ult_nn_convolution_fp_interface_run(nn_workload_item* &work_item, uint32_t num_threads)
 {
     bool retvalue = true;
 
@@ -225,6 +225,8 @@ static bool ult_nn_convolution_fp_interface_run(nn_workload_item* &work_item)
 
     nn_device_load(&device_description);
     nn_device_interface_open(0, &device_interface_0);
+    if (num_threads)
+        device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_THREAD_COUNT, &num_threads, sizeof(num_threads));
 
     int16_fixedpoint::run_multithreaded_convolve_fixedpoint_work_item(work_item, reinterpret_cast<nn_device_internal*>(device_interface_0.device));
 
@@ -754,7 +756,8 @@ static bool ult_perform_test(
     uint8_t output_fraction,
     uint_least32_t center_x,
     uint_least32_t center_y,
-    NN_ACTIVATION_FUNCTION activation )
+    NN_ACTIVATION_FUNCTION activation,
+    uint32_t num_threads = 0)
 {
     nn_workload_item* work_item = nullptr;
     nn_workload_item* work_items[12];
@@ -875,7 +878,7 @@ static bool ult_perform_test(
             activation);
 
         //Optimized convolution.
-        passed = ult_nn_convolution_fp_interface_run(work_item);
+        passed = ult_nn_convolution_fp_interface_run(work_item, num_threads);
     }
 
     if (passed)
@@ -933,3 +936,14 @@ TEST(cpu_int16_convolution_fixed_point, cpu_convolution_)
     //EXPECT_EQ(true, ult_perform_test(3072, 1024, 6, 6, 6, 6, 1, 1, false, 16, 0, 0, 0, NN_ACTIVATION_FUNCTION_RELU));
     //EXPECT_EQ(true, ult_perform_test(3072, 1024, 6, 6, 6, 6, 1, 1, false, 16, 0, 0, 0, NN_ACTIVATION_FUNCTION_NONE));
 }
+
+TEST(cpu_int16_convolution_fixed_point, cpu_convolution_row_partition)
+{
+    // Single image with two groups of output feature maps split into ranges of rows: pairs of rows of even
+    // output height & single rows of odd one.
+    for (uint32_t num_threads : { 3u, 4u, 7u })
+    {
+        EXPECT_EQ(true, ult_perform_test(64, 64, 16, 16, 3, 3, 1, 1, 16, 0, 0, 0, NN_ACTIVATION_FUNCTION_RELU, num_threads));
+        EXPECT_EQ(true, ult_perform_test(64, 32, 15, 15, 3, 3, 2, 2, 16, 0, 0, 0, NN_ACTIVATION_FUNCTION_NONE, num_threads));
+    }
+}
@@ -665,6 +665,7 @@ static bool ult_perform_test(
     EXPECT_EQ(NN_API_STATUS_OK, di.workflow_compile_function(&workload, di.device, workflow, &io_format, &io_format, 1));
 
     EXPECT_EQ(NN_API_STATUS_OK, di.workload_execute_function(workload, (void **)input_datas, (void **)output_datas, &status));
+    EXPECT_EQ(NN_API_STATUS_OK, di.workload_wait_function(workload, &status));
 
 
     // delete workload
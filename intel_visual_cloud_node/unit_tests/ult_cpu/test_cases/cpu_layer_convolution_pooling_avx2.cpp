@@ -771,7 +771,8 @@ bool ult_perform_test(
     uint_least32_t pool_size_y,
     bool check_out_views,
     NN_ACTIVATION_FUNCTION activation,
-    NN_POOLING_MODE mode)
+    NN_POOLING_MODE mode,
+    uint32_t num_threads = 0)
 {
     // TODO ADD TESTS WITH VIEWS
 
@@ -891,6 +892,8 @@ bool ult_perform_test(
 
     nn_device_load(&device_description);
     nn_device_interface_open(0, &device_interface_0);
+    if (num_threads)
+        device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_THREAD_COUNT, &num_threads, sizeof(num_threads));
 
     // Perform data copy to interface test.
     ult_nn_convolution_initialize_work_item(
@@ -998,6 +1001,17 @@ TEST(cpu_convolution_maxpooling2x2_artificial, cpu_convolution_maxpooling2x2_str
     }
 }
 
+TEST(cpu_convolution_maxpooling2x2_artificial, cpu_convolution_maxpooling2x2_row_partition)
+{
+    // Single image split into ranges of pooled rows between more threads than output feature map slices.
+    for (uint32_t num_threads : { 3u, 4u, 7u })
+        for (unsigned int i = 10; i < 23; i += 6)
+        {
+            EXPECT_EQ(true, ult_perform_test(1, 16, 1, i, i, 3, 3, 1, 1, 2, 2, 2, 2, true, NN_ACTIVATION_FUNCTION_RELU, NN_POOLING_MODE_MAX, num_threads));
+            EXPECT_EQ(true, ult_perform_test(1, 32, 1, i, i, 3, 3, 2, 2, 2, 2, 2, 2, true, NN_ACTIVATION_FUNCTION_NONE, NN_POOLING_MODE_MAX, num_threads));
+        }
+}
+
 //TEST(cpu_convolution_maxpooling2x2_padding, cpu_convolution_maxpooling2x2_padding_stride1)
 //{
 //    for (uint32_t num_ofm = 16; num_ofm <= 32; num_ofm += 16)
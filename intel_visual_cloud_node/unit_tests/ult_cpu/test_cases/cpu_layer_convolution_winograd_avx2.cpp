@@ -0,0 +1,164 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "gtest/gtest.h"
+#include "../../devices/common/nn_workload_data.h"
+#include "../../devices/device_cpu/core/layer_convolution_winograd_avx2.h"
+#include "../../devices/device_cpu/api_internal/nn_device_interface_0_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+struct winograd_test_t
+{
+    uint32_t batch;
+    uint32_t num_input;
+    uint32_t num_output;
+    uint32_t output_width;
+    uint32_t output_height;
+    bool same_size;                 // input of output size padded with zeros, otherwise input 2 larger
+    NN_ACTIVATION_FUNCTION activation;
+};
+
+// Runs Winograd convolution of random data; returns largest difference from reference computed in
+// double precision, relative to largest magnitude of reference outputs.
+float winograd_relative_error(size_t tile_size, const winograd_test_t &test, uint32_t num_threads, uint32_t isa)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t di;
+    EXPECT_EQ(0, nn_device_load(&device_description));
+    EXPECT_EQ(0, nn_device_interface_open(0, &di));
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_THREAD_COUNT, &num_threads, sizeof(num_threads)));
+    EXPECT_EQ(NN_API_STATUS_OK, di.parameter_set_function(di.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa)));
+
+    const int32_t center = test.same_size ? 1 : 0;
+    const uint32_t input_width = test.same_size ? test.output_width : test.output_width + 2;
+    const uint32_t input_height = test.same_size ? test.output_height : test.output_height + 2;
+
+    std::mt19937 engine(test.num_input * 31 + test.num_output);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    nn::data<float, 4> input(test.num_input, input_width, input_height, test.batch);
+    nn::data<float, 4> weights(3, 3, test.num_input, test.num_output);
+    nn::data<float, 1> biases(test.num_output);
+    for (size_t index = 0; index < input.count(); ++index) static_cast<float *>(input.buffer)[index] = distribution(engine);
+    for (size_t index = 0; index < weights.count(); ++index) static_cast<float *>(weights.buffer)[index] = distribution(engine);
+    for (size_t index = 0; index < biases.count(); ++index) static_cast<float *>(biases.buffer)[index] = distribution(engine);
+
+    nn_argument_activation_t activation;
+    activation.function = test.activation;
+    std::unique_ptr<layer::convolution_winograd_f32> primitive(layer::convolution_winograd_f32::create(
+        tile_size, test.num_input, test.num_output, test.output_width, test.output_height, center, center, activation, test.batch, di.device));
+
+    std::unique_ptr<nn::nn_workload_data_t<float>> input_buffer(primitive->create_input(input));
+    std::unique_ptr<nn::nn_workload_data_t<float>> weights_buffer(primitive->create_weights(weights));
+    std::unique_ptr<nn::nn_workload_data_t<float>> bias_buffer(primitive->create_bias(biases));
+    std::unique_ptr<nn::nn_workload_data_t<float>> output_buffer(primitive->create_output());
+    primitive->forward(input_buffer.get(), weights_buffer.get(), bias_buffer.get(), output_buffer.get());
+
+    double largest_output = 0.0, largest_error = 0.0;
+    for (uint32_t n = 0; n < test.batch; ++n)
+        for (uint32_t y = 0; y < test.output_height; ++y)
+            for (uint32_t x = 0; x < test.output_width; ++x)
+                for (uint32_t o = 0; o < test.num_output; ++o)
+                {
+                    double sum = biases(o);
+                    for (uint32_t ky = 0; ky < 3; ++ky)
+                        for (uint32_t kx = 0; kx < 3; ++kx)
+                        {
+                            const int32_t ix = x + kx - center, iy = y + ky - center;
+                            if (ix < 0 || iy < 0 || ix >= static_cast<int32_t>(input_width) || iy >= static_cast<int32_t>(input_height))
+                                continue;
+                            for (uint32_t i = 0; i < test.num_input; ++i)
+                                sum += static_cast<double>(input(i, ix, iy, n)) * weights(kx, ky, i, o);
+                        }
+                    if (test.activation == NN_ACTIVATION_FUNCTION_RELU)
+                        sum = std::max(sum, 0.0);
+
+                    largest_output = std::max(largest_output, std::abs(sum));
+                    largest_error = std::max(largest_error, std::abs(sum - (*output_buffer)(n, x, y, o, 0, 0)()));
+                }
+
+    primitive.reset();
+    EXPECT_EQ(0, nn_device_interface_close(&di));
+    EXPECT_EQ(0, nn_device_unload());
+    return static_cast<float>(largest_error / largest_output);
+}
+
+const winograd_test_t C_winograd_tests[] = {
+    // batch, ifm, ofm, width, height, same size, activation
+    { 1,  32,  32, 13, 13, false, NN_ACTIVATION_FUNCTION_NONE },
+    { 1,  45,  64, 13, 13, true,  NN_ACTIVATION_FUNCTION_RELU },
+    { 3,  64,  32,  7,  5, true,  NN_ACTIVATION_FUNCTION_NONE },
+    { 2, 256,  48, 14, 14, false, NN_ACTIVATION_FUNCTION_RELU },
+    { 1,  33, 384,  3, 17, true,  NN_ACTIVATION_FUNCTION_RELU },
+};
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests.
+TEST(cpu_convolution_winograd, tile2x2)
+{
+    for (auto &test : C_winograd_tests)
+        for (uint32_t num_threads : { 1u, 4u })
+            for (uint32_t isa = 0; isa <= nn_cpu_isa_detect(); ++isa)
+                EXPECT_GE(layer::convolution_winograd_f32::get_error(2), winograd_relative_error(2, test, num_threads, isa));
+}
+
+TEST(cpu_convolution_winograd, tile4x4)
+{
+    for (auto &test : C_winograd_tests)
+        for (uint32_t num_threads : { 1u, 4u })
+            for (uint32_t isa = 0; isa <= nn_cpu_isa_detect(); ++isa)
+                EXPECT_GE(layer::convolution_winograd_f32::get_error(4), winograd_relative_error(4, test, num_threads, isa));
+}
+
+TEST(cpu_convolution_winograd, tile_size_choice)
+{
+    nn_argument_activation_t relu;
+    relu.function = NN_ACTIVATION_FUNCTION_RELU;
+    const auto error2 = layer::convolution_winograd_f32::get_error(2), error4 = layer::convolution_winograd_f32::get_error(4);
+    EXPECT_LT(error2, error4);
+
+    EXPECT_EQ(0u, layer::convolution_winograd_f32::choose_tile_size(3, 3, 1, 1, 256, 384, 28, 28, relu, 0.0f));
+    EXPECT_EQ(0u, layer::convolution_winograd_f32::choose_tile_size(3, 3, 1, 1, 256, 384, 28, 28, relu, error2 / 2));
+    EXPECT_EQ(2u, layer::convolution_winograd_f32::choose_tile_size(3, 3, 1, 1, 256, 384, 28, 28, relu, error2));
+    EXPECT_EQ(4u, layer::convolution_winograd_f32::choose_tile_size(3, 3, 1, 1, 256, 384, 28, 28, relu, error4));
+    // 4x4 tiles would compute 16x16 outputs for 13x13 layer
+    EXPECT_EQ(2u, layer::convolution_winograd_f32::choose_tile_size(3, 3, 1, 1, 256, 384, 13, 13, relu, error4));
+
+    // shapes Winograd is not used for
+    EXPECT_EQ(0u, layer::convolution_winograd_f32::choose_tile_size(5, 5, 1, 1, 256, 384, 28, 28, relu, 1.0f));
+    EXPECT_EQ(0u, layer::convolution_winograd_f32::choose_tile_size(3, 3, 2, 2, 256, 384, 28, 28, relu, 1.0f));
+    EXPECT_EQ(0u, layer::convolution_winograd_f32::choose_tile_size(3, 3, 1, 1, 3, 384, 28, 28, relu, 1.0f));
+    nn_argument_activation_t logistic;
+    logistic.function = NN_ACTIVATION_FUNCTION_LOGISTIC;
+    EXPECT_EQ(0u, layer::convolution_winograd_f32::choose_tile_size(3, 3, 1, 1, 256, 384, 28, 28, logistic, 1.0f));
+}
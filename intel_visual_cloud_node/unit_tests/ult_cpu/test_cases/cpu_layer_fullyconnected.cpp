@@ -36,8 +36,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace
 {
-const auto C_max_acc_batch8 = 13u;
-const auto C_max_acc_batch48 = 2u;
+const auto C_gemm_panel = 12u;
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Helper classess and functions.
 bool compare_work_items(
@@ -329,7 +328,7 @@ void create_and_initialize_work_item(
                 }
             }
         }
-        else if (batch_size == 8)
+        else
         {
             nn_workload_data_layout_t weights_layout =
             {
@@ -345,8 +344,8 @@ void create_and_initialize_work_item(
                 input_width,
                 1,
                 1,
-                C_max_acc_batch8,
-                (output_width + C_max_acc_batch8 - 1) / C_max_acc_batch8
+                C_gemm_panel,
+                (output_width + C_gemm_panel - 1) / C_gemm_panel
             };
 
             arguments.weights = new nn::nn_workload_data_t<float>(weights_coords, weights_layout);
@@ -359,41 +358,7 @@ void create_and_initialize_work_item(
                     value *= pow(1.01f, weight_input);
                     value *= pow(1.01f, weight_output);
                     if (weight_output % 2) value *= -1.0f;
-                    nn_workload_data_get<float>(arguments.weights, 0, weight_input, 0, 0, weight_output % C_max_acc_batch8, weight_output / C_max_acc_batch8) = value;
-                }
-            }
-        }
-        else if (batch_size == 48)
-        {
-            nn_workload_data_layout_t weights_layout =
-            {
-                { 0, 0, 0, 0, 0, 0 }, // tile in log2(size)
-                { 0, 0, 0, 0, 0, 0 }, // alignment
-                { NN_DATA_COORD_p, NN_DATA_COORD_x, NN_DATA_COORD_q, NN_DATA_COORD_z, NN_DATA_COORD_y, NN_DATA_COORD_n }, // ordering
-                NN_DATATYPE_FLOAT
-            };
-
-            nn_workload_data_coords_t weights_coords =
-            {
-                1,
-                input_width,
-                1,
-                1,
-                C_max_acc_batch48,
-                (output_width + C_max_acc_batch48 - 1) / C_max_acc_batch48
-            };
-
-            arguments.weights = new nn::nn_workload_data_t<float>(weights_coords, weights_layout);
-
-            for (uint32_t weight_input = 0; weight_input < input_width; ++weight_input)
-            {
-                for (uint32_t weight_output = 0; weight_output < output_width; ++weight_output)
-                {
-                    float value = 0.03125f;
-                    value *= pow(1.01f, weight_input);
-                    value *= pow(1.01f, weight_output);
-                    if (weight_output % 2) value *= -1.0f;
-                    nn_workload_data_get<float>(arguments.weights, 0, weight_input, 0, 0, weight_output % C_max_acc_batch48, weight_output / C_max_acc_batch48) = value;
+                    nn_workload_data_get<float>(arguments.weights, 0, weight_input, 0, 0, weight_output % C_gemm_panel, weight_output / C_gemm_panel) = value;
                 }
             }
         }
@@ -416,12 +381,15 @@ void create_and_initialize_work_item(
     }
 }
 
+// Device runs AVX2 kernels unless test selects other instruction set.
 bool ult_perform_test(
     uint32_t input_width,
     uint32_t output_width,
     uint32_t batch_size,
     bool bias_in_output,
-    NN_ACTIVATION_FUNCTION function)
+    NN_ACTIVATION_FUNCTION function,
+    uint32_t num_threads = 0,
+    uint32_t isa = NN_CPU_ISA_AVX2)
 {
     bool return_value = true;
 
@@ -433,6 +401,9 @@ bool ult_perform_test(
     nn_device_interface_0_t device_interface_0;
     nn_device_load(&device_description);
     nn_device_interface_open(0, &device_interface_0);
+    if (num_threads)
+        device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_THREAD_COUNT, &num_threads, sizeof(num_threads));
+    device_interface_0.parameter_set_function(device_interface_0.device, NN_PARAMETER_CPU_ISA, &isa, sizeof(isa));
 
     // Work item.
     nn_workload_item* work_item = nullptr;
@@ -469,7 +440,7 @@ bool ult_perform_test(
 TEST(cpu_fullyconnected_artificial, cpu_fullyconnected)
 {
     NN_ACTIVATION_FUNCTION activations[] = { NN_ACTIVATION_FUNCTION_NONE, NN_ACTIVATION_FUNCTION_RELU };
-    uint32_t batches[] = { 1, 8, 48 };
+    uint32_t batches[] = { 1, 5, 8, 21, 48 };
     uint32_t biases_modes[] = { false, true };
 
     for (auto batch : batches)
@@ -483,4 +454,41 @@ TEST(cpu_fullyconnected_artificial, cpu_fullyconnected)
                             batch,         // batch size
                             bias_mode,     // bias in output
                             activation));  // activation function
-}
\ No newline at end of file
+}
+
+TEST(cpu_fullyconnected_artificial, cpu_fullyconnected_input_blocks)
+{
+    // Inputs longer than one cache block of batched modes, jobs split over outputs and batch.
+    uint32_t batches[] = { 1, 8, 21, 48 };
+    uint32_t input_sizes[] = { 256, 300, 600 };
+    uint32_t thread_counts[] = { 1, 4 };
+
+    for (auto batch : batches)
+        for (auto input_size : input_sizes)
+            for (uint32_t output_size = 23; output_size < 26; ++output_size)
+                for (auto threads : thread_counts)
+                    EXPECT_EQ(true, ult_perform_test(
+                        input_size,                    // input width
+                        output_size,                   // output width
+                        batch,                         // batch size
+                        false,                         // bias in output
+                        NN_ACTIVATION_FUNCTION_RELU,   // activation function
+                        threads));                     // device threads
+}
+
+TEST(cpu_fullyconnected_artificial, cpu_fullyconnected_instruction_sets)
+{
+    // Batched micro-kernels of all instruction sets host supports, with full & partial blocks of batch items.
+    NN_ACTIVATION_FUNCTION activations[] = { NN_ACTIVATION_FUNCTION_NONE, NN_ACTIVATION_FUNCTION_RELU };
+    uint32_t batches[] = { 5, 16, 21, 48 };
+    uint32_t biases_modes[] = { false, true };
+    uint32_t input_sizes[] = { 7, 300 };
+
+    for (uint32_t isa = 0; isa <= nn_cpu_isa_detect(); ++isa)
+        for (auto batch : batches)
+            for (auto activation : activations)
+                for (auto bias_mode : biases_modes)
+                    for (auto input_size : input_sizes)
+                        for (uint32_t output_size = 11; output_size < 26; output_size += 7)
+                            EXPECT_EQ(true, ult_perform_test(input_size, output_size, batch, bias_mode, activation, 0, isa));
+}
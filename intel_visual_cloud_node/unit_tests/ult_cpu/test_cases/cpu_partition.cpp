@@ -0,0 +1,80 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "gtest/gtest.h"
+
+#include "../../devices/device_cpu/api_internal/cpu_partition.h"
+
+namespace {
+    void expect_partition(uint32_t slices_per_job, uint32_t rows_per_job, uint32_t num_jobs, const nn_cpu_partition &partition) {
+        EXPECT_EQ(slices_per_job, partition.slices_per_job);
+        EXPECT_EQ(rows_per_job, partition.rows_per_job);
+        EXPECT_EQ(num_jobs, partition.num_jobs);
+    }
+
+    // Krizhevsky C1: 96 output feature maps (12 slices of 8), 55 output rows, 11x11x3 kernel on 227 pixel rows.
+    nn_cpu_partition_work krizhevsky_c1(uint32_t num_images) {
+        return nn_cpu_partition_work{ num_images, 12, 55, 1, 11 * 11 * 3 * 8 * sizeof(float), 11 * 227 * 3 * sizeof(float) };
+    }
+} //namespace
+
+TEST(cpu_partition, single_image_split_into_rows)
+{
+    // 12 slices alone leave half of 8 threads idle in the second wave of jobs.
+    expect_partition(3, 28, 8, nn_cpu_partition_choose(krizhevsky_c1(1), 8));
+    // 4 threads are busy with slices alone, fewer & larger jobs do the same work.
+    expect_partition(3, 55, 4, nn_cpu_partition_choose(krizhevsky_c1(1), 4));
+    // Single thread gets the whole layer.
+    expect_partition(12, 55, 1, nn_cpu_partition_choose(krizhevsky_c1(1), 1));
+}
+
+TEST(cpu_partition, images_cover_threads)
+{
+    expect_partition(12, 55, 8, nn_cpu_partition_choose(krizhevsky_c1(8), 4));
+}
+
+TEST(cpu_partition, working_set_limits_slices)
+{
+    // Weights of two slices do not fit in cache of single core, rows are not split as images give enough jobs.
+    const nn_cpu_partition_work work{ 8, 4, 13, 1, C_cpu_job_working_set_bytes / 2, 4096 };
+    expect_partition(1, 13, 32, nn_cpu_partition_choose(work, 4));
+}
+
+TEST(cpu_partition, row_blocks)
+{
+    // Ranges of rows are multiples of rows kernel computes at once, the last one may be shorter.
+    const nn_cpu_partition_work work{ 1, 1, 14, 2, 1024, 1024 };
+    expect_partition(1, 4, 4, nn_cpu_partition_choose(work, 4));
+    expect_partition(1, 2, 7, nn_cpu_partition_choose(work, 7));
+}
+
+TEST(cpu_partition, tuned_slices)
+{
+    const nn_cpu_partition_work work{ 1, 4, 16, 1, 1024, 1024 };
+    expect_partition(2, 4, 8, nn_cpu_partition_choose(work, 8, 2));
+    // Slices that do not divide output feature maps are chosen by partitioner.
+    expect_partition(1, 8, 8, nn_cpu_partition_choose(work, 8, 3));
+}
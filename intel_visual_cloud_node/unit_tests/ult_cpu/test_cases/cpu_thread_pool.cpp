@@ -0,0 +1,188 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+  * Neither the name of Intel Corporation nor the names of its contributors
+    may be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "gtest/gtest.h"
+#include "../../devices/device_cpu/api_internal/cpu_device_internal.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+void increment_callback(void* handle)
+{
+    reinterpret_cast<std::atomic<uint32_t>*>(handle)->fetch_add(1);
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests.
+TEST(cpu_thread_pool, all_requests_processed)
+{
+    for (uint32_t num_threads : { 1u, 2u, 4u })
+    {
+        nn_thread_worker_pool pool(num_threads);
+        EXPECT_EQ(num_threads, pool.get_num_threads());
+
+        // More requests than threads - they must be balanced, not rejected.
+        for (uint32_t job_size : { 1u, 3u, 64u })
+        {
+            std::atomic<uint32_t> counter(0);
+            std::vector<nn_multithreaded_request> job(job_size);
+            for (auto& request : job)
+            {
+                request.callback = increment_callback;
+                request.request_handle = &counter;
+            }
+
+            pool.push_job(job);
+            EXPECT_EQ(job_size, counter.load());
+        }
+    }
+}
+
+TEST(cpu_thread_pool, parallel_for_visits_each_index_once)
+{
+    nn_thread_worker_pool pool(4);
+
+    const uint32_t count = 1000;
+    std::vector<std::atomic<uint32_t>> visits(count);
+    for (auto& visit : visits) visit = 0;
+
+    pool.parallel_for(count, [&](uint32_t index) { visits[index].fetch_add(1); });
+
+    for (auto& visit : visits)
+        EXPECT_EQ(1u, visit.load());
+}
+
+TEST(cpu_thread_pool, nested_parallel_regions)
+{
+    nn_thread_worker_pool pool(4);
+
+    const uint32_t outer_count = 16;
+    const uint32_t inner_count = 32;
+    std::atomic<uint32_t> counter(0);
+
+    // Every outer request forks and joins its own inner job on the same pool.
+    pool.parallel_for(outer_count, [&](uint32_t) {
+        pool.parallel_for(inner_count, [&](uint32_t) { counter.fetch_add(1); });
+    });
+
+    EXPECT_EQ(outer_count * inner_count, counter.load());
+}
+
+TEST(cpu_thread_pool, pinned_workers)
+{
+    nn_thread_worker_pool pool(4);
+    EXPECT_EQ(NN_CPU_THREAD_PLACEMENT_NONE, pool.get_placement());
+    EXPECT_TRUE(pool.get_memory_nodes().empty());
+
+    for (auto placement : { NN_CPU_THREAD_PLACEMENT_COMPACT, NN_CPU_THREAD_PLACEMENT_SCATTER, NN_CPU_THREAD_PLACEMENT_NONE })
+    {
+        pool.set_placement(placement);
+        EXPECT_EQ(placement, pool.get_placement());
+        EXPECT_EQ(placement == NN_CPU_THREAD_PLACEMENT_NONE, pool.get_memory_nodes().empty());
+
+        // Pinned pool keeps working, even if there are less processors than threads.
+        std::atomic<uint32_t> counter(0);
+        pool.parallel_for(256, [&](uint32_t) { counter.fetch_add(1); });
+        EXPECT_EQ(256u, counter.load());
+    }
+}
+
+TEST(cpu_thread_pool, placement_while_resizing)
+{
+    nn_thread_worker_pool pool(4);
+
+    // Placement changed by one thread while another resizes pool - both see consistent set of workers.
+    std::thread placer([&]() {
+        for (uint32_t run = 0; run < 50; ++run)
+        {
+            pool.set_placement(run % 2 ? NN_CPU_THREAD_PLACEMENT_COMPACT : NN_CPU_THREAD_PLACEMENT_SCATTER);
+            EXPECT_GE(pool.get_num_threads(), pool.get_worker_ids().size() + 1);
+        }
+    });
+    for (uint32_t run = 0; run < 50; ++run)
+    {
+        pool.set_num_threads(2 + run % 4);
+        std::atomic<uint32_t> counter(0);
+        pool.parallel_for(16, [&](uint32_t) { counter.fetch_add(1); });
+        EXPECT_EQ(16u, counter.load());
+    }
+    placer.join();
+
+    pool.set_placement(NN_CPU_THREAD_PLACEMENT_COMPACT);
+    EXPECT_EQ(pool.get_num_threads() - 1, pool.get_worker_ids().size());
+    EXPECT_FALSE(pool.get_memory_nodes().empty());
+}
+
+TEST(cpu_thread_pool, concurrent_external_jobs)
+{
+    nn_thread_worker_pool pool(4);
+
+    const uint32_t job_count = 100;
+    std::atomic<uint32_t> counter_a(0), counter_b(0);
+
+    std::thread second_client([&]() {
+        for (uint32_t run = 0; run < job_count; ++run)
+            pool.parallel_for(8, [&](uint32_t) { counter_b.fetch_add(1); });
+    });
+    for (uint32_t run = 0; run < job_count; ++run)
+        pool.parallel_for(8, [&](uint32_t) { counter_a.fetch_add(1); });
+    second_client.join();
+
+    EXPECT_EQ(job_count * 8, counter_a.load());
+    EXPECT_EQ(job_count * 8, counter_b.load());
+}
+
+TEST(cpu_thread_pool, profiled_jobs)
+{
+    nn_thread_worker_pool pool(4);
+    nn_cpu_profile_item item(pool.get_num_threads());
+
+    // Jobs pushed while item is current are accounted to it, nested ones included.
+    nn_cpu_profiler::current_item() = &item;
+    pool.parallel_for(8, [&](uint32_t) {
+        pool.parallel_for(2, [](uint32_t) {});
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    });
+    nn_cpu_profiler::current_item() = nullptr;
+    pool.parallel_for(8, [](uint32_t) { std::this_thread::sleep_for(std::chrono::milliseconds(2)); });
+
+    EXPECT_EQ(9u, item.jobs.load());
+    EXPECT_LT(0u, item.dispatch_ns.load());
+
+    // Every request sleeps - busy time of all threads covers them.
+    uint64_t busy_ns = 0;
+    for (auto& slot : item.busy_ns) busy_ns += slot.load();
+    EXPECT_LE(8u * 2000000u, busy_ns);
+}
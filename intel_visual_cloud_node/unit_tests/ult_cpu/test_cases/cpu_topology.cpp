@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+  * Neither the name of Intel Corporation nor the names of its contributors
+    may be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../../devices/device_cpu/api_internal/cpu_topology.h"
+
+#include <vector>
+
+namespace {
+    // Two sockets, two cores per socket, two hyperthreads per core (linux style numbering).
+    nn_cpu_topology dual_socket_topology() {
+        std::vector<nn_cpu_logical_processor> processors;
+        for (uint32_t thread = 0; thread < 2; ++thread)
+            for (uint32_t package = 0; package < 2; ++package)
+                for (uint32_t core = 0; core < 2; ++core)
+                    processors.push_back(nn_cpu_logical_processor{ thread * 4 + package * 2 + core, package, core, package });
+        return nn_cpu_topology(processors);
+    }
+} //namespace
+
+TEST(cpu_topology, parse_cpu_list)
+{
+    EXPECT_EQ(std::vector<uint32_t>({ 0 }), nn_cpu_topology::parse_cpu_list("0"));
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2, 3, 8, 10, 11 }), nn_cpu_topology::parse_cpu_list("0-3,8,10-11\n"));
+    EXPECT_TRUE(nn_cpu_topology::parse_cpu_list("").empty());
+}
+
+TEST(cpu_topology, compact_placement)
+{
+    auto topology = dual_socket_topology();
+
+    // Physical cores of socket 0 first, then their hyperthreads, then socket 1.
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 4, 5, 2, 3 }), topology.select_cpus(6, NN_CPU_THREAD_PLACEMENT_COMPACT));
+    EXPECT_EQ(std::vector<uint32_t>({ 0 }), topology.get_nodes(topology.select_cpus(3, NN_CPU_THREAD_PLACEMENT_COMPACT)));
+}
+
+TEST(cpu_topology, scatter_placement)
+{
+    auto topology = dual_socket_topology();
+
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 2, 1, 3 }), topology.select_cpus(4, NN_CPU_THREAD_PLACEMENT_SCATTER));
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1 }), topology.get_nodes(topology.select_cpus(2, NN_CPU_THREAD_PLACEMENT_SCATTER)));
+}
+
+TEST(cpu_topology, oversubscription_and_none)
+{
+    auto topology = dual_socket_topology();
+
+    auto cpus = topology.select_cpus(10, NN_CPU_THREAD_PLACEMENT_COMPACT);
+    ASSERT_EQ(10u, cpus.size());
+    EXPECT_EQ(cpus[0], cpus[8]);
+    EXPECT_EQ(cpus[1], cpus[9]);
+
+    EXPECT_TRUE(topology.select_cpus(4, NN_CPU_THREAD_PLACEMENT_NONE).empty());
+    EXPECT_EQ(2u, topology.get_num_nodes());
+}
+
+TEST(cpu_topology, system_topology)
+{
+    auto& topology = nn_cpu_topology::get();
+    ASSERT_FALSE(topology.get_processors().empty());
+    EXPECT_GE(topology.get_num_nodes(), 1u);
+    EXPECT_EQ(3u, topology.select_cpus(3, NN_CPU_THREAD_PLACEMENT_SCATTER).size());
+}
@@ -0,0 +1,202 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../../node_runtime/quantizer/quantizer.h"
+#include "../../devices/api/nn_device_api.h"
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    // float workflow built from items of the test, deleted in reverse order of creation
+    struct float_workflow {
+        nn_device_interface_0_t &di;
+        nn_workflow_t *workflow = nullptr;
+        std::vector<nn_workflow_item_t *> items;
+        std::vector<std::unique_ptr<nn::data<float>>> parameters;
+        std::mt19937 engine{1234};
+
+        float_workflow(nn_device_interface_0_t &di) : di(di) {}
+
+        ~float_workflow() {
+            for (auto item = items.rbegin(); item != items.rend(); ++item)
+                EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_delete_function(*item));
+            if (workflow) EXPECT_EQ(NN_API_STATUS_OK, di.workflow_delete_function(workflow));
+        }
+
+        nn_workflow_item_t *add(NN_WORK_ITEM_TYPE type, nn_workflow_item_t *input, uint32_t x, uint32_t y, uint32_t z) {
+            nn_workflow_item_t *item = nullptr;
+            EXPECT_EQ(NN_API_STATUS_OK, di.workflow_item_create_function(&item, input ? 1 : 0, input ? &input : nullptr));
+            items.push_back(item);
+            item->type = type;
+            if (y == 1 && z == 1) {
+                item->output_format.format = NN_DATA_FORMAT_1D;
+                item->output_format.format_1d = nn_output_format_1d{ { x } };
+            } else {
+                item->output_format.format = NN_DATA_FORMAT_3D;
+                item->output_format.format_3d = nn_output_format_3d{ { x, y, z } };
+            }
+            return item;
+        }
+
+        // random values of magnitude up to scale
+        template<typename... T_sizes> nn::data<float> *random(float scale, T_sizes... sizes) {
+            parameters.emplace_back(new nn::data<float>(sizes...));
+            std::uniform_real_distribution<float> distribution(-scale, scale);
+            auto buffer = static_cast<float *>(parameters.back()->buffer);
+            for (size_t index = 0; index < parameters.back()->count(); ++index)
+                buffer[index] = distribution(engine);
+            return parameters.back().get();
+        }
+
+        nn_workflow_item_t *convolution(nn_workflow_item_t *input, uint32_t kernel, uint32_t size, uint32_t ifm, uint32_t ofm) {
+            auto item = add(NN_WORK_ITEM_TYPE_CONVOLUTION, input, size, size, ofm);
+            auto &arguments = item->arguments.forward_convolution;
+            arguments.padding = NN_PADDING_MODE_DATA_OR_ZERO;
+            arguments.center_offset[0] = arguments.center_offset[1] = 0;
+            arguments.stride[0] = arguments.stride[1] = 1;
+            arguments.weights = random(1.0f / (kernel * kernel * ifm), kernel, kernel, ifm, ofm);
+            arguments.biases = random(0.1f, ofm);
+            arguments.activation.function = NN_ACTIVATION_FUNCTION_RELU;
+            return item;
+        }
+
+        // weights of layer following 3D result are 4D
+        template<typename... T_sizes> nn_workflow_item_t *fully_connected(
+            nn_workflow_item_t *input, uint32_t inputs, uint32_t outputs, NN_ACTIVATION_FUNCTION function, T_sizes... sizes) {
+            auto item = add(NN_WORK_ITEM_TYPE_FULLY_CONNECTED, input, outputs, 1, 1);
+            auto &arguments = item->arguments.forward_fully_connected;
+            arguments.weights = random(4.0f / inputs, sizes...);
+            arguments.biases = random(0.1f, outputs);
+            arguments.activation.function = function;
+            return item;
+        }
+
+        // input 16x16x4 -> convolution 5x5 -> max pooling 2x2 -> response normalization -> convolution 3x3 ->
+        // fully connected with ReLU -> fully connected -> softmax
+        void build(NN_POOLING_MODE pooling_mode) {
+            EXPECT_EQ(NN_API_STATUS_OK, di.workflow_create_function(&workflow, 1, 1));
+
+            auto input = add(NN_WORK_ITEM_TYPE_INPUT, nullptr, 16, 16, 4);
+            input->arguments.input.index = 0;
+            auto conv1 = convolution(input, 5, 12, 4, 32);
+            auto pool1 = add(NN_WORK_ITEM_TYPE_POOLING, conv1, 6, 6, 32);
+            pool1->arguments.forward_pooling = nn_arguments_forward_pooling_t{ { 2, 2 }, { 2, 2 }, pooling_mode };
+            auto norm1 = add(NN_WORK_ITEM_TYPE_NORMALIZATION, pool1, 6, 6, 32);
+            norm1->arguments.forward_normalization.normalization =
+                nn_argument_normalization_t{ NN_NORMALIZATION_MODE_RESPONSE_ACROSS_MAPS, 0.0001f / 5, 0.75f, 1, 5, 0 };
+            auto conv2 = convolution(norm1, 3, 4, 32, 32);
+            auto fc1 = fully_connected(conv2, 4 * 4 * 32, 64, NN_ACTIVATION_FUNCTION_RELU, 4, 4, 32, 64);
+            auto fc2 = fully_connected(fc1, 64, 16, NN_ACTIVATION_FUNCTION_NONE, 64, 16);
+            auto softmax = add(NN_WORK_ITEM_TYPE_SOFTMAX, fc2, 16, 1, 1);
+            auto output = add(NN_WORK_ITEM_TYPE_OUTPUT, softmax, 16, 1, 1);
+            output->arguments.output.index = 0;
+
+            workflow->input[0] = input;
+            workflow->output[0] = output;
+        }
+    };
+
+    // samples in ZXY layout with values in [0, 1)
+    nn::data<float> create_calibration(uint32_t samples) {
+        nn::data<float> result(4, 16, 16, samples);
+        std::mt19937 engine(4321);
+        std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+        for (size_t index = 0; index < result.count(); ++index)
+            static_cast<float *>(result.buffer)[index] = distribution(engine);
+        return result;
+    }
+} //namespace
+
+TEST(quantizer, quantizes_convolutional_network)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t di;
+    nn_device_load(&device_description);
+    ASSERT_EQ(0, nn_device_interface_open(0, &di));
+    {
+        float_workflow network(di);
+        network.build(NN_POOLING_MODE_MAX);
+        auto calibration = create_calibration(16);
+
+        nn_quantizer quantizer(di, network.workflow, NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH,
+                               NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH, &calibration, 8);
+        ASSERT_NE(nullptr, quantizer.get_workflow());
+
+        auto &report = quantizer.get_report();
+        EXPECT_EQ(16u, report.samples);
+        EXPECT_LT(report.max_error, 0.05f);
+        EXPECT_GE(report.top1_agreement, 0.75f);
+
+        // input conversion followed by every layer of the network
+        const NN_WORK_ITEM_TYPE expected[] = {
+            NN_WORK_ITEM_TYPE_CONVERT_FLOAT_TO_INT16_FIXEDPOINT,
+            NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT,
+            NN_WORK_ITEM_TYPE_MAX_POOLING_INT16_FIXEDPOINT,
+            NN_WORK_ITEM_TYPE_NORMALIZATION_RESPONSE_ACROSS_MAPS_FORWARD_I16QN,
+            NN_WORK_ITEM_TYPE_CONVOLUTION_INT16_FIXEDPOINT,
+            NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I16QN,
+            NN_WORK_ITEM_TYPE_FULLY_CONNECTED_FORWARD_I16QN_I32QN,
+            NN_WORK_ITEM_TYPE_SOFTMAX_FIXEDPOINT };
+        ASSERT_EQ(sizeof(expected) / sizeof(expected[0]), report.layers.size());
+        for (size_t index = 0; index < report.layers.size(); ++index) {
+            EXPECT_EQ(expected[index], report.layers[index].type);
+            EXPECT_GE(report.layers[index].output_fraction, 0);
+        }
+
+        // max pooling keeps fraction of convolution it follows
+        EXPECT_EQ(report.layers[1].output_fraction, report.layers[2].output_fraction);
+        EXPECT_EQ(report.layers[2].output_fraction, report.layers[3].input_fraction);
+    }
+    EXPECT_EQ(0, nn_device_interface_close(&di));
+    EXPECT_EQ(0, nn_device_unload());
+}
+
+TEST(quantizer, rejects_average_pooling)
+{
+    nn_device_description_t device_description;
+    nn_device_interface_0_t di;
+    nn_device_load(&device_description);
+    ASSERT_EQ(0, nn_device_interface_open(0, &di));
+    {
+        float_workflow network(di);
+        network.build(NN_POOLING_MODE_AVERAGE);
+        auto calibration = create_calibration(8);
+
+        EXPECT_THROW(nn_quantizer(di, network.workflow, NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH,
+                                  NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH, &calibration, 8),
+                     std::invalid_argument);
+    }
+    EXPECT_EQ(0, nn_device_interface_close(&di));
+    EXPECT_EQ(0, nn_device_unload());
+}
@@ -0,0 +1,200 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../../node_runtime/resource_manager/resource_manager.h"
+
+#include <chrono>
+#include <future>
+#include <map>
+#include <stdexcept>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    // fake devices: number of threads set by resource manager is recorded per device
+    std::map<nn_device_t *, uint32_t> device_threads;
+
+    NN_API_STATUS NN_API_CALL_CONVENTION fake_parameter_set(nn_device_t *device, NN_PARAMETER parameter, void *buffer, uint32_t size) {
+        EXPECT_EQ(NN_PARAMETER_CPU_THREAD_COUNT, parameter);
+        EXPECT_EQ(sizeof(uint32_t), size);
+        device_threads[device] = *static_cast<uint32_t *>(buffer);
+        return NN_API_STATUS_OK;
+    }
+
+    struct fake_device {
+        char id;
+        nn_device_interface_0_t di;
+        fake_device() : di() {
+            di.device = reinterpret_cast<nn_device_t *>(&id);
+            di.parameter_set_function = fake_parameter_set;
+        }
+        uint32_t threads() { return device_threads[di.device]; }
+    };
+
+    struct fake_workload {
+        NN_WORKLOAD_DATA_TYPE format = NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH;
+        nn_workload_t workload;
+        fake_workload(fake_device &device, uint64_t parameters, uint64_t activations)
+            : workload{device.di.device, 1, 1, &format, &format, 1, activations, parameters} {}
+    };
+
+    bool is_ready(const std::future<void> &future) {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+} //namespace
+
+TEST(resource_manager, cores_are_split_between_busy_cpu_devices)
+{
+    fake_device cpu0, cpu1, cpu2, gpu;
+    nn_resource_manager manager(8, 1000);
+    manager.add_device(cpu0.di);
+    manager.add_device(cpu1.di);
+    manager.add_device(cpu2.di);
+    manager.add_device(gpu.di, 1000);
+
+    // idle devices are shrunk to single thread, thread pool of GPU is not touched
+    EXPECT_EQ(1u, cpu0.threads());
+    EXPECT_EQ(1u, cpu1.threads());
+    EXPECT_EQ(0u, device_threads.count(gpu.di.device));
+
+    fake_workload model0(cpu0, 10, 10), model1(cpu1, 10, 10), model2(cpu2, 10, 10), model3(gpu, 10, 10);
+    manager.admit(&model0.workload).get();
+    EXPECT_EQ(8u, cpu0.threads());
+
+    manager.admit(&model1.workload).get();
+    manager.admit(&model3.workload).get();
+    EXPECT_EQ(4u, cpu0.threads());
+    EXPECT_EQ(4u, cpu1.threads());
+
+    // remainder of division goes to devices registered first
+    manager.admit(&model2.workload).get();
+    EXPECT_EQ(3u, cpu0.threads());
+    EXPECT_EQ(3u, cpu1.threads());
+    EXPECT_EQ(2u, cpu2.threads());
+    EXPECT_EQ(0u, manager.get_usage(gpu.di).threads);
+
+    manager.release(&model0.workload);
+    EXPECT_EQ(1u, cpu0.threads());
+    EXPECT_EQ(4u, cpu1.threads());
+    EXPECT_EQ(4u, cpu2.threads());
+    EXPECT_EQ(4u, manager.get_usage(cpu2.di).threads);
+
+    manager.release(&model1.workload);
+    manager.release(&model2.workload);
+    manager.release(&model3.workload);
+    manager.remove_device(cpu0.di);
+    manager.remove_device(cpu1.di);
+    manager.remove_device(cpu2.di);
+    manager.remove_device(gpu.di);
+}
+
+TEST(resource_manager, workloads_wait_for_memory)
+{
+    fake_device cpu0, cpu1;
+    nn_resource_manager manager(4, 100);
+    manager.add_device(cpu0.di);
+    manager.add_device(cpu1.di);
+
+    // CPU devices share host memory budget
+    fake_workload large(cpu0, 40, 20), medium(cpu1, 30, 20), small(cpu0, 5, 5);
+    auto large_admitted = manager.admit(&large.workload);
+    EXPECT_TRUE(is_ready(large_admitted));
+    auto medium_admitted = manager.admit(&medium.workload);
+    EXPECT_FALSE(is_ready(medium_admitted));
+
+    // small one would fit, but is queued behind the medium one
+    auto small_admitted = manager.admit(&small.workload);
+    EXPECT_FALSE(is_ready(small_admitted));
+
+    auto usage = manager.get_usage(cpu1.di);
+    EXPECT_EQ(100u, usage.memory_budget);
+    EXPECT_EQ(60u, usage.memory_committed);
+    EXPECT_EQ(0u, usage.workloads);
+    EXPECT_EQ(1u, usage.queued);
+    EXPECT_EQ(4u, cpu0.threads());
+    EXPECT_EQ(1u, cpu1.threads());
+
+    manager.release(&large.workload);
+    EXPECT_TRUE(is_ready(medium_admitted));
+    EXPECT_TRUE(is_ready(small_admitted));
+    usage = manager.get_usage(cpu0.di);
+    EXPECT_EQ(60u, usage.memory_committed);
+    EXPECT_EQ(1u, usage.workloads);
+    EXPECT_EQ(0u, usage.queued);
+    EXPECT_EQ(2u, cpu0.threads());
+    EXPECT_EQ(2u, cpu1.threads());
+
+    manager.release(&medium.workload);
+    manager.release(&small.workload);
+    EXPECT_EQ(0u, manager.get_usage(cpu0.di).memory_committed);
+}
+
+TEST(resource_manager, device_memory_has_own_budget)
+{
+    fake_device cpu, gpu;
+    nn_resource_manager manager(2, 100);
+    manager.add_device(cpu.di);
+    manager.add_device(gpu.di, 50);
+
+    fake_workload host(cpu, 100, 0), device0(gpu, 30, 0), device1(gpu, 30, 0);
+    EXPECT_TRUE(is_ready(manager.admit(&host.workload)));
+    EXPECT_TRUE(is_ready(manager.admit(&device0.workload)));
+    auto device1_admitted = manager.admit(&device1.workload);
+    EXPECT_FALSE(is_ready(device1_admitted));
+    EXPECT_EQ(50u, manager.get_usage(gpu.di).memory_budget);
+    EXPECT_EQ(30u, manager.get_usage(gpu.di).memory_committed);
+
+    // releasing host memory does not help workload waiting for device memory
+    manager.release(&host.workload);
+    EXPECT_FALSE(is_ready(device1_admitted));
+    manager.release(&device0.workload);
+    EXPECT_TRUE(is_ready(device1_admitted));
+    manager.release(&device1.workload);
+}
+
+TEST(resource_manager, invalid_requests_are_rejected)
+{
+    fake_device cpu, unregistered;
+    nn_resource_manager manager(2, 100);
+    manager.add_device(cpu.di);
+    EXPECT_THROW(manager.add_device(cpu.di), std::invalid_argument);
+
+    fake_workload too_large(cpu, 80, 30), workload(cpu, 10, 10), foreign(unregistered, 10, 10);
+    EXPECT_THROW(manager.admit(&too_large.workload), std::invalid_argument);
+    EXPECT_THROW(manager.admit(&foreign.workload), std::invalid_argument);
+    EXPECT_THROW(manager.admit(nullptr), std::invalid_argument);
+    EXPECT_THROW(manager.release(&workload.workload), std::invalid_argument);
+
+    manager.admit(&workload.workload).get();
+    EXPECT_THROW(manager.admit(&workload.workload), std::invalid_argument);
+    EXPECT_THROW(manager.remove_device(cpu.di), std::invalid_argument);
+    manager.release(&workload.workload);
+    manager.remove_device(cpu.di);
+    EXPECT_THROW(manager.get_usage(cpu.di), std::invalid_argument);
+}
@@ -0,0 +1,185 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../../node_runtime/scheduler/scheduler.h"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    // fake device: output = 2 * input, batch sizes of executed workloads are recorded
+    std::mutex executed_mutex;
+    std::vector<uint32_t> executed_batches;
+
+    NN_API_STATUS NN_API_CALL_CONVENTION fake_execute(nn_workload_t *workload, void **input, void **output, NN_API_STATUS *status) {
+        auto input_data = static_cast<nn_data_t *>(input[0]);
+        auto output_data = static_cast<nn_data_t *>(output[0]);
+        EXPECT_EQ(workload->batch, input_data->size[input_data->dimension - 1]);
+        auto count = nn_data_buffer_size_ptr(1, input_data->dimension, input_data->size);
+        for (size_t index = 0; index < count; ++index)
+            static_cast<float *>(output_data->buffer)[index] = 2.0f * static_cast<float *>(input_data->buffer)[index];
+        std::lock_guard<std::mutex> lock(executed_mutex);
+        executed_batches.push_back(workload->batch);
+        *status = NN_API_WORK_FINISHED;
+        return NN_API_STATUS_OK;
+    }
+
+    NN_API_STATUS NN_API_CALL_CONVENTION fake_wait(nn_workload_t *, NN_API_STATUS *) {
+        return NN_API_STATUS_OK;
+    }
+
+    nn_device_interface_0_t fake_interface() {
+        nn_device_interface_0_t result = {};
+        result.workload_execute_function = fake_execute;
+        result.workload_wait_function = fake_wait;
+        executed_batches.clear();
+        return result;
+    }
+
+    struct fake_workload {
+        NN_WORKLOAD_DATA_TYPE format = NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH;
+        nn_workload_t workload;
+        fake_workload(uint32_t batch) : workload{nullptr, 1, 1, &format, &format, batch, 0, 0} {}
+    };
+
+    // single-sample requests of 4 floats
+    struct request {
+        nn::data<float, 1> input, output;
+        std::future<NN_API_STATUS> status;
+        request(float value) : input(4), output(4) {
+            for (auto index = 0u; index < 4; ++index) input(index) = value + index;
+        }
+        void check() {
+            ASSERT_EQ(NN_API_STATUS_OK, status.get());
+            for (auto index = 0u; index < 4; ++index) EXPECT_EQ(2.0f * input(index), output(index));
+        }
+    };
+
+    std::vector<std::unique_ptr<request>> submit(nn_scheduler &scheduler, uint32_t count) {
+        std::vector<std::unique_ptr<request>> result;
+        for (auto index = 0u; index < count; ++index) {
+            result.emplace_back(new request(static_cast<float>(index * 10)));
+            result.back()->status = scheduler.submit(&result.back()->input, &result.back()->output);
+        }
+        return result;
+    }
+} //namespace
+
+TEST(scheduler, full_batches_are_executed_without_waiting)
+{
+    auto di = fake_interface();
+    fake_workload batch1(1), batch8(8);
+    nn_scheduler scheduler(di, {&batch1.workload, &batch8.workload}, std::chrono::seconds(30));
+
+    auto start = std::chrono::steady_clock::now();
+    auto requests = submit(scheduler, 16);
+    for (auto &request : requests) request->check();
+    EXPECT_GT(std::chrono::seconds(10), std::chrono::steady_clock::now() - start);
+
+    auto statistics = scheduler.get_statistics();
+    EXPECT_EQ(16u, statistics.requests);
+    EXPECT_EQ(2u, statistics.batches);
+    EXPECT_EQ(0u, statistics.padded_slots);
+    EXPECT_EQ(2u, statistics.batches_of_size[8]);
+    EXPECT_EQ(2u, statistics.fill_histogram[8]);
+}
+
+TEST(scheduler, deadline_pads_partial_batch)
+{
+    auto di = fake_interface();
+    fake_workload batch8(8);
+    const auto deadline = std::chrono::milliseconds(20);
+    nn_scheduler scheduler(di, {&batch8.workload}, deadline);
+
+    auto requests = submit(scheduler, 5);
+    for (auto &request : requests) request->check();
+
+    auto statistics = scheduler.get_statistics();
+    EXPECT_EQ(5u, statistics.requests);
+    EXPECT_EQ(1u, statistics.batches);
+    EXPECT_EQ(3u, statistics.padded_slots);
+    EXPECT_EQ(1u, statistics.fill_histogram[5]);
+    EXPECT_LE(deadline, statistics.max_queue_wait);
+    EXPECT_LE(statistics.max_queue_wait, statistics.total_queue_wait);
+}
+
+TEST(scheduler, deadline_falls_back_to_smaller_variant)
+{
+    auto di = fake_interface();
+    fake_workload batch1(1), batch8(8);
+    nn_scheduler scheduler(di, {&batch8.workload, &batch1.workload}, std::chrono::milliseconds(20), 0.5f);
+
+    // 3 of 8 slots would be used - requests run on batch 1 variant instead
+    auto requests = submit(scheduler, 3);
+    for (auto &request : requests) request->check();
+    EXPECT_EQ(std::vector<uint32_t>({1, 1, 1}), executed_batches);
+
+    // 5 of 8 slots are used - batch is padded
+    requests = submit(scheduler, 5);
+    for (auto &request : requests) request->check();
+    EXPECT_EQ(std::vector<uint32_t>({1, 1, 1, 8}), executed_batches);
+
+    auto statistics = scheduler.get_statistics();
+    EXPECT_EQ(8u, statistics.requests);
+    EXPECT_EQ(3u, statistics.batches_of_size[1]);
+    EXPECT_EQ(1u, statistics.batches_of_size[8]);
+    EXPECT_EQ(3u, statistics.padded_slots);
+}
+
+TEST(scheduler, queued_requests_are_executed_on_destruction)
+{
+    auto di = fake_interface();
+    fake_workload batch8(8);
+    std::vector<std::unique_ptr<request>> requests;
+    {
+        nn_scheduler scheduler(di, {&batch8.workload}, std::chrono::seconds(30));
+        requests = submit(scheduler, 3);
+    }
+    for (auto &request : requests) request->check();
+}
+
+TEST(scheduler, requests_of_different_shape_are_rejected)
+{
+    auto di = fake_interface();
+    fake_workload batch2(2);
+    nn_scheduler scheduler(di, {&batch2.workload}, std::chrono::seconds(30));
+
+    nn::data<float, 1> input(4), output(4), other_input(5), other_output(5);
+    auto status = scheduler.submit(&input, &output);
+    auto other_status = scheduler.submit(&other_input, &other_output);
+    EXPECT_EQ(NN_API_STATUS_OK, status.get());
+    EXPECT_EQ(NN_API_STATUS_ERROR_INVALID_MEMORY_LAYOUT, other_status.get());
+    EXPECT_EQ(1u, scheduler.get_statistics().requests);
+    EXPECT_EQ(NN_API_STATUS_ERROR_INVALID_POINTER, scheduler.submit(nullptr, &output).get());
+}
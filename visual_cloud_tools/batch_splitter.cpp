@@ -0,0 +1,180 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "batch_splitter.h"
+#include "nn_data_0.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+C_batch_splitter::C_batch_splitter(std::vector<nn_device_interface_0_t *> devices_list,
+                                   nn_workflow_t *workflow,
+                                   NN_WORKLOAD_DATA_TYPE input_format,
+                                   NN_WORKLOAD_DATA_TYPE output_format,
+                                   uint32_t batch,
+                                   uint32_t step)
+    : workflow(workflow)
+    , input_format(input_format)
+    , output_format(output_format)
+    , batch(batch)
+    , step(std::max(1u, std::min(step, batch)))
+{
+    if(devices_list.empty()) throw std::runtime_error("batch splitter requires at least one device");
+    for(auto di : devices_list)
+        devices.push_back(device_t{di, {}, 0, 0.0, 0});
+    split();
+}
+
+C_batch_splitter::~C_batch_splitter() {
+    try { if(!pending.empty()) wait(); } catch(...) {}
+    for(auto &device : devices)
+        for(auto &workload : device.workloads)
+            device.di->workload_delete_function(workload.second);
+}
+
+nn_workload_t *C_batch_splitter::get_workload(device_t &device, uint32_t size) {
+    auto &workload = device.workloads[size];
+    if(!workload) {
+        auto status = device.di->workflow_compile_function(&workload, device.di->device, workflow, &input_format, &output_format, size);
+        if(status!=NN_API_STATUS_OK || !workload) {
+            device.workloads.erase(size);
+            throw std::runtime_error(std::string("compilation of workload for batch ")+std::to_string(size)+" failed");
+        }
+    }
+    return workload;
+}
+
+void C_batch_splitter::start(nn_data_t *input, nn_data_t *output) {
+    if(!pending.empty()) throw std::runtime_error("previous batch is still executed");
+    if(input->size[input->dimension-1]!=batch || output->size[output->dimension-1]!=batch)
+        throw std::runtime_error("batch splitter got data of wrong batch size");
+
+    // bytes of single sample
+    const auto input_sample  = nn_data_buffer_size_ptr(input->sizeof_value,  static_cast<uint8_t>(input->dimension-1),  input->size);
+    const auto output_sample = nn_data_buffer_size_ptr(output->sizeof_value, static_cast<uint8_t>(output->dimension-1), output->size);
+
+    auto create_view = [this](nn_data_t *data, size_t sample, uint32_t offset, uint32_t count) {
+        std::vector<size_t> size(data->size, data->size+data->dimension);
+        size.back() = count;
+        auto view = nn_data_create_shared_ptr(static_cast<uint8_t *>(data->buffer)+offset*sample, data->sizeof_value, data->dimension, size.data());
+        if(!view) throw std::bad_alloc();
+        views.push_back(view);
+        return view;
+    };
+
+    pending.resize(devices.size());
+    uint32_t offset = 0;
+    for(size_t index=0; index<devices.size(); ++index) {
+        auto &device = devices[index];
+        if(device.share==0) continue;
+
+        auto workload    = get_workload(device, device.share);
+        auto input_view  = create_view(input,  input_sample,  offset, device.share);
+        auto output_view = create_view(output, output_sample, offset, device.share);
+        offset += device.share;
+
+        auto di = device.di;
+        pending[index] = std::async(std::launch::async, [di, workload, input_view, output_view]() -> uint64_t {
+            void *input_buffer = input_view, *output_buffer = output_view;
+            NN_API_STATUS status;
+            auto begin = std::chrono::high_resolution_clock::now();
+            if(di->workload_execute_function(workload, &input_buffer, &output_buffer, &status)!=NN_API_STATUS_OK
+            || di->workload_wait_function(workload, &status)!=NN_API_STATUS_OK)
+                throw std::runtime_error("workload execution failed");
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now()-begin).count();
+        });
+    }
+}
+
+void C_batch_splitter::wait() {
+    std::exception_ptr error;
+    for(size_t index=0; index<pending.size(); ++index) {
+        if(!pending[index].valid()) continue;
+        try {
+            auto &device = devices[index];
+            device.last_time = std::max<uint64_t>(pending[index].get(), 1);
+            const double measured = device.share*1e9/device.last_time;
+            device.throughput = device.throughput>0.0 ? 0.7*device.throughput+0.3*measured : measured;
+        }
+        catch(...) {
+            error = std::current_exception();
+        }
+    }
+    pending.clear();
+    for(auto view : views) nn_data_delete(view);
+    views.clear();
+
+    if(error) std::rethrow_exception(error);
+    split();
+}
+
+void C_batch_splitter::split() {
+    const auto count = static_cast<uint32_t>(devices.size());
+    const uint32_t steps = batch/step;
+
+    // until every device is measured, batch is split evenly
+    bool measured = true;
+    double total = 0.0;
+    for(auto &device : devices) {
+        measured &= device.throughput>0.0;
+        total += device.throughput;
+    }
+    std::vector<double> ideal(count);
+    for(uint32_t index=0; index<count; ++index)
+        ideal[index] = measured ? steps*devices[index].throughput/total : static_cast<double>(steps)/count;
+
+    const uint32_t minimum = steps>=count ? 1 : 0;
+    std::vector<uint32_t> assigned(count);
+    uint32_t sum = 0;
+    for(uint32_t index=0; index<count; ++index)
+        sum += assigned[index] = std::max(minimum, static_cast<uint32_t>(ideal[index]));
+
+    // largest rounding errors are corrected first
+    while(sum>steps) {
+        uint32_t worst = count;
+        for(uint32_t index=0; index<count; ++index)
+            if(assigned[index]>minimum && (worst==count || assigned[index]-ideal[index]>assigned[worst]-ideal[worst])) worst = index;
+        --assigned[worst];
+        --sum;
+    }
+    while(sum<steps) {
+        uint32_t worst = 0;
+        for(uint32_t index=1; index<count; ++index)
+            if(ideal[index]-assigned[index]>ideal[worst]-assigned[worst]) worst = index;
+        ++assigned[worst];
+        ++sum;
+    }
+
+    uint32_t fastest = 0;
+    for(uint32_t index=0; index<count; ++index) {
+        devices[index].share = assigned[index]*step;
+        if(devices[index].throughput>devices[fastest].throughput) fastest = index;
+    }
+    devices[fastest].share += batch%step;
+}
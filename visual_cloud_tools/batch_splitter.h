@@ -0,0 +1,85 @@
+/*
+Copyright (c) 2014, Intel Corporation
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of Intel Corporation nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#include "nn_device_interface_0.h"
+#include <cstdint>
+#include <future>
+#include <map>
+#include <vector>
+
+// Executes each batch on several devices at once - batch is split between devices in proportion to their
+// throughput measured on previous batches, so all of them finish at about the same time.
+//  - every device gets workloads compiled from the same workflow, one per batch size it was given so far
+//    (compiled on first use),
+//  - shares are multiples of step (remainder of batch goes to the fastest device); while batch is large enough,
+//    every device gets at least one step, so its throughput keeps being measured,
+//  - throughput of device is averaged over batches, so single slow batch does not swing the split.
+class C_batch_splitter
+{
+public:
+    struct device_t {
+        nn_device_interface_0_t        *di;
+        std::map<uint32_t, nn_workload_t *> workloads;  // compiled workloads by batch size
+        uint32_t                        share;          // samples of next batch
+        double                          throughput;     // samples per second, 0 until measured
+        uint64_t                        last_time;      // execution time of last batch [ns]
+    };
+
+    C_batch_splitter(std::vector<nn_device_interface_0_t *> devices,
+                     nn_workflow_t *workflow,
+                     NN_WORKLOAD_DATA_TYPE input_format,
+                     NN_WORKLOAD_DATA_TYPE output_format,
+                     uint32_t batch,
+                     uint32_t step);
+    ~C_batch_splitter();
+
+    // Starts execution of batch; input & output have batch as the last dimension.
+    void start(nn_data_t *input, nn_data_t *output);
+
+    // Waits for all parts of batch, then updates throughputs & split of next batch; throws runtime_error
+    // if any device failed.
+    void wait();
+
+    const std::vector<device_t> &get_devices() const { return devices; }
+
+private:
+    C_batch_splitter(const C_batch_splitter &) = delete;
+    void operator=(const C_batch_splitter &) = delete;
+
+    nn_workload_t *get_workload(device_t &device, uint32_t size);
+    void split();
+
+    std::vector<device_t>           devices;
+    nn_workflow_t                  *workflow;
+    NN_WORKLOAD_DATA_TYPE           input_format;
+    NN_WORKLOAD_DATA_TYPE           output_format;
+    const uint32_t                  batch;
+    const uint32_t                  step;
+    std::vector<std::future<uint64_t>> pending;     // execution time of each device [ns]
+    std::vector<nn_data_t *>        views;          // parts of input & output given to devices
+};
@@ -33,7 +33,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <iostream>
 #include <sstream>
 #include <chrono>
+#include <memory>
 #include <regex>
+#include <thread>
+#include <exception>
 
 
 // OS-specific constants & functions
@@ -50,6 +53,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "report_maker.h"
 #include "nn_device_api.h"
 #include "nn_data_tools.h"
+#include "batch_splitter.h"
 
 // returns list of files (path+filename) from specified directory
 std::vector<std::string> get_directory_contents(std::string images_path) {
@@ -157,9 +161,12 @@ int main(int argc, char *argv[])
 R"_help_( <parameters> input_dir
 
 <parameters> include:
-    --device=<name>
+    --device=<name>[,<name>...]
         name of dynamic library (without suffix) with computational device
-        to be used for demo
+        to be used for demo; if several are given (e.g. device_cpu,device_gpu)
+        each batch is split between them in proportion to their throughput
+    --split_step=<value>
+        granularity of batch split between devices, 8 by default
     --batch=<value>
         size of group of images that are classified together;  large batch
         sizes have better performance
@@ -174,6 +181,8 @@ R"_help_( <parameters> input_dir
 
 If last parameters do not fit --key=value format it is assumed to be a --input.
 Instead of "--" "-" or "/" can be used.
+GPU device can run on CPU OpenCL implementation when NN_OPENCL_DEVICE_TYPE=cpu
+is set in environment.
 )_help_";
             return 0;
         }
@@ -204,16 +213,31 @@ Instead of "--" "-" or "/" can be used.
             if(config.find("model") ==not_found) config["model"]="caffenet_float";
             if(config.find("input") ==not_found) throw std::runtime_error("missing input directory; run without arguments to get help");
             if(config.find("loops") ==not_found) config["loops"]="1";
+            if(config.find("split_step")==not_found) config["split_step"]="8";
         }
 
         // load images from input directory
         auto images_list = get_directory_contents(config["input"]);
         if(images_list.empty()) throw std::runtime_error(std::string("directory ")+config["input"]+" does not contain any images that can be processed");
 
-        // RAII for loading library, device initialization and opening interface 0
-        scoped_library      library(config["device"]+dynamic_library_extension);
-        scoped_device       device(library);
-        scoped_interface_0  interface_0(device);
+        // RAII for loading library, device initialization and opening interface 0 - for every device listed
+        std::vector<std::string> device_names;
+        {
+            std::istringstream names(config["device"]);
+            std::string name;
+            while(std::getline(names, name, ','))
+                if(!name.empty()) device_names.push_back(name);
+            if(device_names.empty()) throw std::runtime_error("no device given");
+        }
+        std::vector<std::unique_ptr<scoped_library>>        libraries;
+        std::vector<std::unique_ptr<scoped_device>>         devices;
+        std::vector<std::unique_ptr<scoped_interface_0>>    interfaces;
+        for(auto &name : device_names) {
+            libraries.emplace_back(new scoped_library(name+dynamic_library_extension));
+            devices.emplace_back(new scoped_device(*libraries.back()));
+            interfaces.emplace_back(new scoped_interface_0(*devices.back()));
+        }
+        scoped_interface_0 &interface_0 = *interfaces.front();
 
         // get workflow builder as specified by model parameter
         auto builder = workflow_builder::instance().get(config["model"]);
@@ -225,11 +249,24 @@ Instead of "--" "-" or "/" can be used.
         NN_WORKLOAD_DATA_TYPE input_format = NN_WORKLOAD_DATA_TYPE_F32_ZXY_BATCH;
         NN_WORKLOAD_DATA_TYPE output_format = NN_WORKLOAD_DATA_TYPE_F32_1D_BATCH;
         nn_workload_t *workload = nullptr;
-        C_time_control timer;
-        auto status = interface_0.workflow_compile_function(&workload, interface_0.device, workflow, &input_format, &output_format, config_batch);
-        timer.tock();
-        if(!workload) throw std::runtime_error("workload compilation failed");
-        std::cout << "workload compiled in " << timer.time_diff_string() <<" [" <<timer.clocks_diff_string() <<"]" << std::endl;
+        std::unique_ptr<C_batch_splitter> splitter;
+        if(interfaces.size()==1) {
+            C_time_control timer;
+            auto status = interface_0.workflow_compile_function(&workload, interface_0.device, workflow, &input_format, &output_format, config_batch);
+            timer.tock();
+            if(!workload) throw std::runtime_error("workload compilation failed");
+            std::cout << "workload compiled in " << timer.time_diff_string() <<" [" <<timer.clocks_diff_string() <<"]" << std::endl;
+            if(workload->activation_memory)
+                std::cout << "intermediate results take " << (workload->activation_memory + (1<<20) - 1)/(1<<20) << " MB" << std::endl;
+        } else {
+            // workflow is built once & compiled by every device for sizes of batch parts it gets
+            const int split_step = std::stoi(config["split_step"]);
+            if(split_step<=0) throw std::runtime_error("split_step is 0 or negative");
+            std::vector<nn_device_interface_0_t *> split_interfaces;
+            for(auto &di : interfaces) split_interfaces.push_back(di.get());
+            splitter.reset(new C_batch_splitter(split_interfaces, workflow, input_format, output_format, config_batch, split_step));
+            std::cout << "batches are split between " << interfaces.size() << " devices" << std::endl;
+        }
 
         // 1000 classes as a workload output
         auto workload_output = new nn::data<float, 2>(1000, config_batch);
@@ -246,6 +283,70 @@ Instead of "--" "-" or "/" can be used.
         auto images_list_iterator = images_list.begin();
         auto images_list_end = images_list.end();
 
+        // batch that was pushed to device and is being executed
+        struct pending_batch_t {
+            std::vector<std::string>    images;
+            nn::data<float, 4>         *input = nullptr;
+            NN_API_STATUS               status;     // updated by device until execution is finished
+            C_time_control              timer;
+            std::thread                 completion; // stops timer as soon as execution is finished, not when results are consumed
+            std::exception_ptr          error;
+            ~pending_batch_t() { if(completion.joinable()) completion.join(); }
+        } pending_batch;
+        const auto loops = std::stoi(config["loops"]);
+
+        // waits for batch being executed and adds its results to report
+        auto finish_pending_batch = [&]() {
+            if(!pending_batch.input) return;
+
+            pending_batch.completion.join();
+            delete pending_batch.input;
+            pending_batch.input = nullptr;
+            if(pending_batch.error) std::rethrow_exception(pending_batch.error);
+
+            images_recognition_batch_t  temp_report_recognition_batch;
+            temp_report_recognition_batch.time_of_recognizing = pending_batch.timer.get_time_diff()/loops;
+            temp_report_recognition_batch.clocks_of_recognizing = pending_batch.timer.get_clocks_diff()/loops;
+
+            float* value_cmpl = reinterpret_cast<float*>(workload_output->buffer);
+
+            auto batch_images_iterator = pending_batch.images.begin();
+
+            for(auto b = 0u; b < pending_batch.images.size(); ++b) {
+
+                image_recognition_item_t    temp_report_recognition_item;
+
+                recognition_state_t         temp_recognition_state;
+                std::map <float,int>       output_values;
+
+                temp_report_recognition_item.recognitions.clear();
+                temp_report_recognition_item.recognized_image = *batch_images_iterator++;
+
+                for(int index = 0; index < 1000; ++index) {
+                    output_values.insert(std::make_pair(value_cmpl[index],index));
+                    temp_report_recognition_item.nnet_output.push_back(value_cmpl[index]);
+                }
+
+                temp_report_recognition_item.wwid = temp_report_recognition_item.recognized_image.find('[') != std::string::npos
+                    ? temp_report_recognition_item.recognized_image.substr(temp_report_recognition_item.recognized_image.find('[') + 1,9) 
+                    : "n000000000";
+                auto iterator = --output_values.end();
+                for(int i = 1; i < 6 && iterator != output_values.end(); ++i)
+                {
+                    temp_recognition_state.label    = builder->labels[iterator->second];
+                    temp_recognition_state.wwid     = builder->wwids[iterator->second];
+                    temp_recognition_state.accuracy = iterator->first;
+                    temp_report_recognition_item.recognitions.push_back(temp_recognition_state);
+                    --iterator;
+                }
+                temp_report_recognition_batch.recognized_images.push_back(temp_report_recognition_item);
+                output_values.clear();
+                value_cmpl += 1000;
+            }
+            pending_batch.images.clear();
+            report.recognized_batches.push_back(temp_report_recognition_batch);
+        };
+
         while(images_list_iterator!=images_list_end) {
 
             auto diff_itr = images_list_end - images_list_iterator < config_batch 
@@ -256,67 +357,54 @@ Instead of "--" "-" or "/" can be used.
 
             images_list_iterator+=diff_itr;
 
+            // decoding of this batch overlaps with execution of the previous one
             nn::data<float, 4> *images = nullptr;
             images = nn_data_load_from_image_list(&batch_images, builder->get_img_size(), builder->image_process, config_batch, builder->RGB_order);
 
+            // output buffer is shared between batches - previous results have to be consumed first
+            finish_pending_batch();
+
             if(images) {
-                images_recognition_batch_t  temp_report_recognition_batch;
                 nn_data_t *input_array[1] ={images};
+                pending_batch.images = std::move(batch_images);
+                pending_batch.input = images;
+                pending_batch.timer.tick();
+                for(size_t i=0; i <loops; ++i)
                 {
-                    NN_API_STATUS  status;
-                    C_time_control timer;
-                    auto loops = std::stoi(config["loops"]);
-                    for(size_t i=0; i <loops; ++i)
-                    {
-                        interface_0.workload_execute_function(workload,reinterpret_cast<void**>(input_array),reinterpret_cast<void**>(output_array_cmpl),&status);
+                    if(splitter) {
+                        // parts of one batch run on all devices at once, repetitions follow one another
+                        if(i>0) splitter->wait();
+                        splitter->start(images, workload_output);
                     }
-                    timer.tock();
-                    temp_report_recognition_batch.time_of_recognizing = timer.get_time_diff()/loops;
-                    temp_report_recognition_batch.clocks_of_recognizing = timer.get_clocks_diff()/loops;
+                    else
+                        interface_0.workload_execute_function(workload,reinterpret_cast<void**>(input_array),reinterpret_cast<void**>(output_array_cmpl),&pending_batch.status);
                 }
 
-                delete images;
-
-                float* value_cmpl = reinterpret_cast<float*>(workload_output->buffer);
-
-                auto batch_images_iterator = batch_images.begin();
-
-                for(auto b = 0u; b < batch_images.size(); ++b) {
-
-                    image_recognition_item_t    temp_report_recognition_item;
-
-                    recognition_state_t         temp_recognition_state;
-                    std::map <float,int>       output_values;
-
-                    temp_report_recognition_item.recognitions.clear();
-                    temp_report_recognition_item.recognized_image = *batch_images_iterator++;
-
-                    for(int index = 0; index < 1000; ++index) {
-                        output_values.insert(std::make_pair(value_cmpl[index],index));
-                        temp_report_recognition_item.nnet_output.push_back(value_cmpl[index]);
+                // timing covers execution only - next batch is decoded on this thread meanwhile
+                pending_batch.error = nullptr;
+                pending_batch.completion = std::thread([&]() {
+                    try {
+                        if(splitter)
+                            splitter->wait();
+                        else if(NN_API_STATUS_OK!=interface_0.workload_wait_function(workload, nullptr))
+                            throw std::runtime_error("workload execution failed");
                     }
-
-                    temp_report_recognition_item.wwid = temp_report_recognition_item.recognized_image.find('[') != std::string::npos
-                        ? temp_report_recognition_item.recognized_image.substr(temp_report_recognition_item.recognized_image.find('[') + 1,9) 
-                        : "n000000000";
-                    auto iterator = --output_values.end();
-                    for(int i = 1; i < 6 && iterator != output_values.end(); ++i)
-                    {
-                        temp_recognition_state.label    = builder->labels[iterator->second];
-                        temp_recognition_state.wwid     = builder->wwids[iterator->second];
-                        temp_recognition_state.accuracy = iterator->first;
-                        temp_report_recognition_item.recognitions.push_back(temp_recognition_state);
-                        --iterator;
+                    catch(...) {
+                        pending_batch.error = std::current_exception();
                     }
-                    temp_report_recognition_batch.recognized_images.push_back(temp_report_recognition_item);
-                    output_values.clear();
-                    value_cmpl += 1000;
-                }
-                batch_images.clear();
-                report.recognized_batches.push_back(temp_report_recognition_batch);
-                temp_report_recognition_batch.recognized_images.clear();
+                    pending_batch.timer.tock();
+                });
             }
         }
+        finish_pending_batch();
+
+        if(splitter) {
+            const auto &split_devices = splitter->get_devices();
+            for(size_t index=0; index<split_devices.size(); ++index)
+                std::cout << device_names[index] << ": " << split_devices[index].share << " image(s) of batch, "
+                          << static_cast<uint64_t>(split_devices[index].throughput) << " image(s)/s" << std::endl;
+        }
+
         report.print_to_html_file("index.html", "Results of recognition");
         system((show_HTML_command+"index.html").c_str());
     return 0;